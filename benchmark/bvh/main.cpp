@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+#include "glm/gtc/constants.hpp"
+
+#include "prism/bvh/top_level_bvh.h"
+#include "prism/core/thread_pool.h"
+
+using namespace prism;
+
+// coherent rays come from a camera, packets are 4x2 pixel tiles
+static const uint32_t IMAGE_WIDTH = 1024;
+static const uint32_t IMAGE_HEIGHT = 1024;
+
+static const uint32_t INCOHERENT_RAY_COUNT = 1024 * 1024;
+
+// instances of the scene on a grid of this size
+static const uint32_t INSTANCE_GRID_SIZE = 8;
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Mesh
+{
+  std::string name;
+  std::vector<glm::vec3> vertices;
+  std::vector<uint32_t> indices;
+};
+
+static double elapsed_ms(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static Mesh make_sphere(uint32_t rings, uint32_t segments)
+{
+  Mesh mesh{};
+  mesh.name = "sphere";
+  for (uint32_t ring = 0; ring <= rings; ++ring)
+  {
+    auto theta = glm::pi<float>() * ring / rings;
+    for (uint32_t segment = 0; segment <= segments; ++segment)
+    {
+      auto phi = 2.0f * glm::pi<float>() * segment / segments;
+      mesh.vertices.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+    }
+  }
+
+  for (uint32_t ring = 0; ring < rings; ++ring)
+  {
+    for (uint32_t segment = 0; segment < segments; ++segment)
+    {
+      auto i0 = ring * (segments + 1) + segment;
+      auto i1 = i0 + segments + 1;
+      mesh.indices.insert(mesh.indices.end(), {i0, i1, i0 + 1, i0 + 1, i1, i1 + 1});
+    }
+  }
+
+  return mesh;
+}
+
+// a height field of a few octaves of waves, long thin triangles seen from a grazing angle
+static Mesh make_terrain(uint32_t resolution)
+{
+  Mesh mesh{};
+  mesh.name = "terrain";
+  for (uint32_t z = 0; z <= resolution; ++z)
+  {
+    for (uint32_t x = 0; x <= resolution; ++x)
+    {
+      auto u = static_cast<float>(x) / resolution;
+      auto v = static_cast<float>(z) / resolution;
+      auto height = 0.0f;
+      for (int octave = 0; octave < 4; ++octave)
+      {
+        auto frequency = 4.0f * (1 << octave);
+        height += std::sin(u * frequency + octave) * std::cos(v * frequency * 1.3f) / (2.0f * (1 << octave));
+      }
+      mesh.vertices.emplace_back(u * 2.0f - 1.0f, height * 0.2f, v * 2.0f - 1.0f);
+    }
+  }
+
+  for (uint32_t z = 0; z < resolution; ++z)
+  {
+    for (uint32_t x = 0; x < resolution; ++x)
+    {
+      auto i0 = z * (resolution + 1) + x;
+      auto i1 = i0 + resolution + 1;
+      mesh.indices.insert(mesh.indices.end(), {i0, i1, i0 + 1, i0 + 1, i1, i1 + 1});
+    }
+  }
+
+  return mesh;
+}
+
+// small triangles scattered through a cube, the worst case for overlap
+static Mesh make_soup(uint32_t triangle_count)
+{
+  Mesh mesh{};
+  mesh.name = "soup";
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> offset(-0.02f, 0.02f);
+
+  for (uint32_t i = 0; i < triangle_count; ++i)
+  {
+    glm::vec3 center{position(rng), position(rng), position(rng)};
+    for (int vertex = 0; vertex < 3; ++vertex)
+    {
+      mesh.indices.push_back(static_cast<uint32_t>(mesh.vertices.size()));
+      mesh.vertices.push_back(center + glm::vec3(offset(rng), offset(rng), offset(rng)));
+    }
+  }
+
+  return mesh;
+}
+
+// positions and faces of a wavefront obj, polygons are split into fans
+static Mesh load_obj(const std::string &filename)
+{
+  std::ifstream file(filename);
+  if (!file)
+  {
+    throw std::runtime_error("Failed to open " + filename);
+  }
+
+  Mesh mesh{};
+  mesh.name = filename;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    std::istringstream stream(line);
+    std::string type;
+    stream >> type;
+
+    if (type == "v")
+    {
+      glm::vec3 position;
+      stream >> position.x >> position.y >> position.z;
+      mesh.vertices.push_back(position);
+    }
+    else if (type == "f")
+    {
+      std::vector<uint32_t> face;
+      std::string token;
+      while (stream >> token)
+      {
+        // v, v/vt, v//vn or v/vt/vn, negative indices count back from the last vertex
+        auto index = std::stoi(token.substr(0, token.find('/')));
+        face.push_back(index < 0 ? static_cast<uint32_t>(mesh.vertices.size() + index) : static_cast<uint32_t>(index - 1));
+      }
+
+      for (size_t i = 2; i < face.size(); ++i)
+      {
+        mesh.indices.insert(mesh.indices.end(), {face[0], face[i - 1], face[i]});
+      }
+    }
+  }
+
+  return mesh;
+}
+
+static BottomLevelBvh::Geometry describe(const Mesh &mesh)
+{
+  BottomLevelBvh::Geometry geometry{};
+  geometry.vertex_data = mesh.vertices.data();
+  geometry.vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+  geometry.vertex_stride = sizeof(glm::vec3);
+  geometry.index_data = mesh.indices.data();
+  geometry.index_count = static_cast<uint32_t>(mesh.indices.size());
+  return geometry;
+}
+
+// primary rays of a camera looking at the bounds, in 4x2 pixel tiles so every eight rays form a packet
+static std::vector<Ray> make_camera_rays(const Aabb &bounds)
+{
+  auto center = bounds.get_center();
+  auto radius = glm::length(bounds.max - bounds.min) * 0.5f;
+  auto eye = center + glm::normalize(glm::vec3(0.4f, 0.5f, 1.0f)) * radius * 1.6f;
+
+  auto forward = glm::normalize(center - eye);
+  auto right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+  auto up = glm::cross(right, forward);
+  auto scale = std::tan(glm::radians(30.0f));
+
+  std::vector<Ray> rays;
+  rays.reserve(IMAGE_WIDTH * IMAGE_HEIGHT);
+  for (uint32_t tile_y = 0; tile_y < IMAGE_HEIGHT; tile_y += 2)
+  {
+    for (uint32_t tile_x = 0; tile_x < IMAGE_WIDTH; tile_x += 4)
+    {
+      for (uint32_t i = 0; i < RayPacket::SIZE; ++i)
+      {
+        auto x = (tile_x + i % 4 + 0.5f) / IMAGE_WIDTH * 2.0f - 1.0f;
+        auto y = 1.0f - (tile_y + i / 4 + 0.5f) / IMAGE_HEIGHT * 2.0f;
+
+        Ray ray{};
+        ray.origin = eye;
+        ray.direction = glm::normalize(forward + right * (x * scale) + up * (y * scale));
+        rays.push_back(ray);
+      }
+    }
+  }
+
+  return rays;
+}
+
+// random origins inside the bounds in random directions, like the bounces of a path tracer
+static std::vector<Ray> make_random_rays(const Aabb &bounds)
+{
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+
+  std::vector<Ray> rays(INCOHERENT_RAY_COUNT);
+  for (auto &ray : rays)
+  {
+    ray.origin = bounds.min + (bounds.max - bounds.min) * glm::vec3(unit(rng), unit(rng), unit(rng));
+    ray.direction = glm::normalize(glm::vec3(normal(rng), normal(rng), normal(rng)));
+  }
+
+  return rays;
+}
+
+struct TraceResult
+{
+  double mrays_per_second;
+  std::vector<RayHit> hits;
+};
+
+template <typename Bvh>
+static TraceResult trace(const Bvh &bvh, const std::vector<Ray> &rays, Traversal traversal, bool packets)
+{
+  TraceResult result{};
+  result.hits.resize(rays.size());
+
+  auto start = Clock::now();
+  if (packets)
+  {
+    for (size_t first = 0; first < rays.size(); first += RayPacket::SIZE)
+    {
+      RayPacket packet;
+      for (uint32_t lane = 0; lane < RayPacket::SIZE; ++lane)
+      {
+        packet.set(lane, rays[first + lane]);
+      }
+
+      RayPacketHit hit;
+      if constexpr (std::is_same_v<Bvh, TopLevelBvh>)
+      {
+        bvh.intersect(packet, hit, 0xff, traversal);
+      }
+      else
+      {
+        bvh.intersect(packet, hit, traversal);
+      }
+
+      for (uint32_t lane = 0; lane < RayPacket::SIZE; ++lane)
+      {
+        result.hits[first + lane] = hit.get(lane);
+      }
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+      if constexpr (std::is_same_v<Bvh, TopLevelBvh>)
+      {
+        bvh.intersect(rays[i], result.hits[i], 0xff, traversal);
+      }
+      else
+      {
+        bvh.intersect(rays[i], result.hits[i], traversal);
+      }
+    }
+  }
+  result.mrays_per_second = rays.size() / (elapsed_ms(start) * 1000.0);
+
+  return result;
+}
+
+template <typename Bvh>
+static void run_rays(const std::string &name, const Bvh &bvh, const std::vector<Ray> &rays, const char *ray_kind)
+{
+  struct Variant
+  {
+    const char *label;
+    Traversal traversal;
+    bool packets;
+  };
+
+  std::vector<Variant> variants = {{"scalar", Traversal::Scalar, false}};
+  if (has_avx2())
+  {
+    variants.push_back({"avx2", Traversal::Avx2, false});
+    variants.push_back({"avx2 packets", Traversal::Avx2, true});
+  }
+
+  std::vector<RayHit> reference;
+  for (const auto &variant : variants)
+  {
+    auto result = trace(bvh, rays, variant.traversal, variant.packets);
+
+    uint32_t hit_count = 0;
+    uint32_t mismatch_count = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+      hit_count += result.hits[i].is_valid();
+      // a different primitive at the same distance is a tie between neighbours, not a miss
+      if (!reference.empty() && result.hits[i].primitive_index != reference[i].primitive_index &&
+          std::abs(result.hits[i].t - reference[i].t) > 1e-4f * std::max(1.0f, reference[i].t))
+      {
+        ++mismatch_count;
+      }
+    }
+
+    LOG_INFO("{} {} rays, {}: {:.2f} Mrays/s per thread, {} hits, {} differ from scalar", name, ray_kind,
+             variant.label, result.mrays_per_second, hit_count, mismatch_count);
+
+    if (reference.empty())
+    {
+      reference = std::move(result.hits);
+    }
+  }
+}
+
+static std::unique_ptr<BottomLevelBvh> build(const Mesh &mesh, ThreadPool &thread_pool)
+{
+  auto geometries = std::vector<BottomLevelBvh::Geometry>{describe(mesh)};
+
+  auto start = Clock::now();
+  BottomLevelBvh serial(geometries);
+  auto serial_ms = elapsed_ms(start);
+
+  start = Clock::now();
+  auto bvh = std::make_unique<BottomLevelBvh>(geometries, &thread_pool);
+  auto parallel_ms = elapsed_ms(start);
+
+  LOG_INFO("{}: {} triangles, built in {:.1f} ms on one thread and {:.1f} ms on {}, {} nodes, {} leaves", mesh.name,
+           mesh.indices.size() / 3, serial_ms, parallel_ms, thread_pool.get_thread_count(),
+           bvh->get_bvh().get_nodes().size(), bvh->get_bvh().get_leaf_count());
+
+  return bvh;
+}
+
+int main(int argc, char **argv)
+{
+  ThreadPool thread_pool;
+
+  LOG_INFO("avx2 traversal {}", has_avx2() ? "supported" : "not supported, only the scalar traversal runs");
+
+  // procedural stand-ins for the usual test scenes, obj files given on the command line are traced as well
+  std::vector<Mesh> meshes;
+  meshes.push_back(make_sphere(384, 768));
+  meshes.push_back(make_terrain(512));
+  meshes.push_back(make_soup(256 * 1024));
+  for (int i = 1; i < argc; ++i)
+  {
+    meshes.push_back(load_obj(argv[i]));
+  }
+
+  std::vector<std::unique_ptr<BottomLevelBvh>> bottom_levels;
+  for (const auto &mesh : meshes)
+  {
+    bottom_levels.push_back(build(mesh, thread_pool));
+
+    const auto &bvh = *bottom_levels.back();
+    run_rays(mesh.name, bvh, make_camera_rays(bvh.get_bounds()), "camera");
+    run_rays(mesh.name, bvh, make_random_rays(bvh.get_bounds()), "random");
+  }
+
+  // every mesh instanced on a grid, rotated and scaled, through the top level
+  std::vector<AccelerationStructureInstance> instances;
+  for (uint32_t z = 0; z < INSTANCE_GRID_SIZE; ++z)
+  {
+    for (uint32_t x = 0; x < INSTANCE_GRID_SIZE; ++x)
+    {
+      auto index = static_cast<uint32_t>(instances.size());
+      auto angle = 0.7f * index;
+      auto scale = 0.6f + 0.1f * (index % 4);
+
+      VkTransformMatrixKHR transform{};
+      transform.matrix[0][0] = std::cos(angle) * scale;
+      transform.matrix[0][2] = std::sin(angle) * scale;
+      transform.matrix[1][1] = scale;
+      transform.matrix[2][0] = -std::sin(angle) * scale;
+      transform.matrix[2][2] = std::cos(angle) * scale;
+      transform.matrix[0][3] = 2.5f * x;
+      transform.matrix[2][3] = 2.5f * z;
+
+      const auto &bottom_level = *bottom_levels[index % bottom_levels.size()];
+      instances.push_back(AccelerationStructureInstance()
+                              .transform(transform)
+                              .instance_custom_index(index)
+                              .mask(0xff)
+                              .acceleration_structure(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&bottom_level))));
+    }
+  }
+
+  auto start = Clock::now();
+  TopLevelBvh scene(instances, &thread_pool);
+  LOG_INFO("scene: {} instances, built in {:.2f} ms", instances.size(), elapsed_ms(start));
+
+  run_rays("scene", scene, make_camera_rays(scene.get_bvh().get_bounds()), "camera");
+  run_rays("scene", scene, make_random_rays(scene.get_bvh().get_bounds()), "random");
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "prism/vulkan/instance.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/buffer.h"
+#include "prism/vulkan/device_memory.h"
+#include "prism/vulkan/memory_allocator.h"
+
+using namespace prism;
+
+static const uint32_t BUFFER_COUNT = 100000;
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double elapsed_ms(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void print_statistics(const char *label, const MemoryAllocator::Statistics &stats)
+{
+  LOG_INFO("{}: blocks {}, dedicated {}, allocations {}, block bytes {}, used bytes {}, wasted bytes {}, free bytes {}, largest free {}, fragmentation {:.3f}",
+           label, stats.block_count, stats.dedicated_allocation_count, stats.allocation_count,
+           stats.block_bytes, stats.allocation_bytes, stats.wasted_bytes, stats.free_bytes,
+           stats.largest_free_bytes, stats.fragmentation);
+}
+
+static std::vector<VkDeviceSize> generate_sizes(uint32_t count)
+{
+  // mostly small constant/vertex sized buffers with the occasional larger one
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint32_t> small(256, 8 * 1024);
+  std::uniform_int_distribution<uint32_t> large(64 * 1024, 512 * 1024);
+  std::uniform_int_distribution<uint32_t> pick(0, 99);
+
+  std::vector<VkDeviceSize> sizes(count);
+  for (auto &size : sizes)
+  {
+    size = pick(rng) < 99 ? small(rng) : large(rng);
+  }
+  return sizes;
+}
+
+static void run_sub_allocated(const Device &device, const std::vector<VkDeviceSize> &sizes)
+{
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  std::vector<std::unique_ptr<DeviceMemory>> memories;
+  buffers.reserve(sizes.size());
+  memories.reserve(sizes.size());
+
+  auto start = Clock::now();
+  for (auto size : sizes)
+  {
+    auto buffer = std::make_unique<Buffer>(device, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    auto memory = std::make_unique<DeviceMemory>(*buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    buffer->bind_memory(*memory);
+
+    buffers.push_back(std::move(buffer));
+    memories.push_back(std::move(memory));
+  }
+  auto create_ms = elapsed_ms(start);
+  print_statistics("sub-allocated, all alive", device.get_memory_allocator().get_statistics());
+
+  // free a random half first to leave holes behind
+  std::vector<uint32_t> order(sizes.size());
+  for (uint32_t i = 0; i < order.size(); ++i)
+  {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(7));
+
+  start = Clock::now();
+  for (uint32_t i = 0; i < order.size() / 2; ++i)
+  {
+    memories[order[i]].reset();
+    buffers[order[i]].reset();
+  }
+  auto half_destroy_ms = elapsed_ms(start);
+  print_statistics("sub-allocated, half freed", device.get_memory_allocator().get_statistics());
+
+  start = Clock::now();
+  for (uint32_t i = static_cast<uint32_t>(order.size() / 2); i < order.size(); ++i)
+  {
+    memories[order[i]].reset();
+    buffers[order[i]].reset();
+  }
+  auto destroy_ms = half_destroy_ms + elapsed_ms(start);
+  print_statistics("sub-allocated, all freed", device.get_memory_allocator().get_statistics());
+
+  LOG_INFO("sub-allocated: {} buffers, create {:.2f} ms ({:.3f} us/buffer), destroy {:.2f} ms ({:.3f} us/buffer)",
+           sizes.size(), create_ms, create_ms * 1000.0 / sizes.size(), destroy_ms, destroy_ms * 1000.0 / sizes.size());
+}
+
+static void run_raw(const Device &device, const std::vector<VkDeviceSize> &sizes)
+{
+  // drivers commonly cap maxMemoryAllocationCount at 4096, which is exactly why sub-allocation is needed
+  auto max_count = device.get_physical_device().get_properties().limits.maxMemoryAllocationCount;
+  auto count = std::min<uint32_t>(static_cast<uint32_t>(sizes.size()), max_count / 2);
+
+  std::vector<VkBuffer> buffers(count);
+  std::vector<VkDeviceMemory> memories(count);
+
+  auto start = Clock::now();
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    VkBufferCreateInfo buffer_info{};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = sizes[i];
+    buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VK_CHECK(vkCreateBuffer(device.get_handle(), &buffer_info, nullptr, &buffers[i]));
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device.get_handle(), buffers[i], &requirements);
+
+    VkMemoryAllocateInfo allocate_info{};
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.allocationSize = requirements.size;
+    allocate_info.memoryTypeIndex = device.get_memory_allocator().find_memory_type(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    VK_CHECK(vkAllocateMemory(device.get_handle(), &allocate_info, nullptr, &memories[i]));
+    VK_CHECK(vkBindBufferMemory(device.get_handle(), buffers[i], memories[i], 0));
+  }
+  auto create_ms = elapsed_ms(start);
+
+  start = Clock::now();
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    vkDestroyBuffer(device.get_handle(), buffers[i], nullptr);
+    vkFreeMemory(device.get_handle(), memories[i], nullptr);
+  }
+  auto destroy_ms = elapsed_ms(start);
+
+  LOG_INFO("vkAllocateMemory per buffer: {} buffers (maxMemoryAllocationCount {}), create {:.2f} ms ({:.3f} us/buffer), destroy {:.2f} ms ({:.3f} us/buffer)",
+           count, max_count, create_ms, create_ms * 1000.0 / count, destroy_ms, destroy_ms * 1000.0 / count);
+}
+
+int main()
+{
+  if (volkInitialize())
+  {
+    throw std::runtime_error("Failed to initialize volk.");
+  }
+
+  Instance instance({}, {});
+  DeviceFeatures features{};
+  Device device(instance.pick_physical_device(), {}, features, MemoryAllocator::Backend::Tlsf);
+
+  LOG_INFO("device: {}, bufferImageGranularity {}", device.get_physical_device().get_properties().deviceName,
+           device.get_physical_device().get_properties().limits.bufferImageGranularity);
+
+  auto sizes = generate_sizes(BUFFER_COUNT);
+
+  run_sub_allocated(device, sizes);
+  run_raw(device, sizes);
+
+  return 0;
+}
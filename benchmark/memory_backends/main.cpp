@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "prism/vulkan/instance.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/memory_allocator.h"
+#include "prism/rendering/buffer_data.h"
+#include "prism/rendering/image_data.h"
+
+using namespace prism;
+
+static const uint32_t MESH_COUNT = 4000;
+static const uint32_t TEXTURE_COUNT = 2000;
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Scene
+{
+  struct Mesh
+  {
+    VkDeviceSize vertex_size;
+    VkDeviceSize index_size;
+  };
+
+  std::vector<Mesh> meshes;
+  std::vector<VkExtent2D> textures;
+};
+
+static Scene generate_scene()
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint32_t> vertex_count(64, 8192);
+  std::uniform_int_distribution<uint32_t> texture_size_log2(6, 9);
+
+  Scene scene{};
+  scene.meshes.resize(MESH_COUNT);
+  for (auto &mesh : scene.meshes)
+  {
+    auto count = vertex_count(rng);
+    mesh.vertex_size = count * 32;
+    mesh.index_size = count * 3 * 4;
+  }
+
+  scene.textures.resize(TEXTURE_COUNT);
+  for (auto &texture : scene.textures)
+  {
+    auto size = 1u << texture_size_log2(rng);
+    texture = {size, size};
+  }
+
+  return scene;
+}
+
+static VkDeviceSize get_usage(const MemoryAllocator &allocator)
+{
+  VkDeviceSize usage = 0;
+  for (const auto &budget : allocator.get_budgets())
+  {
+    usage += budget.usage;
+  }
+  return usage;
+}
+
+static void run(const Instance &instance, MemoryAllocator::Backend backend, const char *name, const Scene &scene)
+{
+  DeviceFeatures features{};
+  Device device(instance.pick_physical_device(), {}, features, backend);
+  auto &allocator = device.get_memory_allocator();
+
+  std::vector<double> latencies;
+  latencies.reserve(scene.meshes.size() * 2 + scene.textures.size());
+
+  VkDeviceSize peak_block_bytes = 0;
+  VkDeviceSize peak_usage = 0;
+  auto sample_peak = [&]()
+  {
+    peak_block_bytes = std::max(peak_block_bytes, allocator.get_statistics().block_bytes);
+    peak_usage = std::max(peak_usage, get_usage(allocator));
+  };
+
+  std::vector<std::unique_ptr<BufferData>> buffers;
+  std::vector<std::unique_ptr<Texture>> textures;
+
+  auto total_start = Clock::now();
+  for (uint32_t i = 0; i < scene.meshes.size(); ++i)
+  {
+    auto start = Clock::now();
+    buffers.push_back(std::make_unique<VertexBuffer>(device, scene.meshes[i].vertex_size));
+    latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+
+    start = Clock::now();
+    buffers.push_back(std::make_unique<IndexBuffer>(device, scene.meshes[i].index_size));
+    latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+
+    if (i % 256 == 0)
+    {
+      sample_peak();
+    }
+  }
+
+  for (uint32_t i = 0; i < scene.textures.size(); ++i)
+  {
+    auto start = Clock::now();
+    textures.push_back(std::make_unique<Texture>(device, scene.textures[i], VK_FORMAT_R8G8B8A8_UNORM));
+    latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+
+    if (i % 256 == 0)
+    {
+      sample_peak();
+    }
+  }
+  sample_peak();
+  auto create_ms = std::chrono::duration<double, std::milli>(Clock::now() - total_start).count();
+
+  auto stats = allocator.get_statistics();
+
+  // half the meshes go away and the rest is compacted. the buffers hold no data, so relocating one only recreates it
+  // and binds it to the new location
+  for (size_t i = 0; i < buffers.size(); i += 2)
+  {
+    if (i % 4 == 2)
+    {
+      buffers[i].reset();
+      buffers[i + 1].reset();
+      continue;
+    }
+
+    for (size_t j = i; j < i + 2; ++j)
+    {
+      auto *data = buffers[j].get();
+      auto usage = (j % 2 == 0 ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : VK_BUFFER_USAGE_INDEX_BUFFER_BIT) | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+      data->device_memory->set_relocate_callback([data, usage](DeviceMemory &memory) {
+        data->buffer = std::make_unique<Buffer>(memory.get_device(), data->size, usage);
+        data->buffer->bind_memory(memory);
+      });
+    }
+  }
+
+  auto fragmented_stats = allocator.get_statistics();
+
+  total_start = Clock::now();
+  auto move_count = allocator.defragment();
+  auto defragment_ms = std::chrono::duration<double, std::milli>(Clock::now() - total_start).count();
+
+  auto compacted_stats = allocator.get_statistics();
+
+  total_start = Clock::now();
+  textures.clear();
+  buffers.clear();
+  auto destroy_ms = std::chrono::duration<double, std::milli>(Clock::now() - total_start).count();
+
+  std::sort(latencies.begin(), latencies.end());
+  double mean = 0.0;
+  for (auto latency : latencies)
+  {
+    mean += latency;
+  }
+  mean /= latencies.size();
+
+  LOG_INFO("{}: {} resources, create {:.2f} ms, destroy {:.2f} ms", name, latencies.size(), create_ms, destroy_ms);
+  LOG_INFO("{}: latency mean {:.2f} us, p50 {:.2f} us, p99 {:.2f} us, max {:.2f} us", name, mean,
+           latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back());
+  LOG_INFO("{}: blocks {}, allocated {} bytes in {} bytes of blocks, peak blocks {} bytes, peak heap usage {} bytes, fragmentation {:.3f}",
+           name, stats.block_count, stats.allocation_bytes, stats.block_bytes, peak_block_bytes, peak_usage, stats.fragmentation);
+  LOG_INFO("{}: defragment moved {} allocations in {:.2f} ms, blocks {} -> {}, block bytes {} -> {}, fragmentation {:.3f} -> {:.3f}",
+           name, move_count, defragment_ms, fragmented_stats.block_count, compacted_stats.block_count, fragmented_stats.block_bytes,
+           compacted_stats.block_bytes, fragmented_stats.fragmentation, compacted_stats.fragmentation);
+}
+
+int main()
+{
+  if (volkInitialize())
+  {
+    throw std::runtime_error("Failed to initialize volk.");
+  }
+
+  Instance instance({}, {});
+
+  auto scene = generate_scene();
+
+  run(instance, MemoryAllocator::Backend::Tlsf, "tlsf", scene);
+  run(instance, MemoryAllocator::Backend::Vma, "vma", scene);
+
+  return 0;
+}
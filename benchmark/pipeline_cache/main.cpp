@@ -0,0 +1,80 @@
+#include <chrono>
+
+#include "prism/vulkan/instance.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/compute_pipeline.h"
+#include "prism/vulkan/descriptor_set_layout.h"
+#include "prism/vulkan/pipeline_cache.h"
+#include "prism/vulkan/pipeline_layout.h"
+#include "prism/vulkan/shader_module.h"
+#include "prism/vulkan/shader_stage.h"
+
+using namespace prism;
+
+static const uint32_t PIPELINE_COUNT = 256;
+
+static const char *CACHE_PATH = "benchmark_pipeline_cache.bin";
+
+using Clock = std::chrono::high_resolution_clock;
+
+// creates the permutations through a fresh device, returns the time spent in pipeline creation in ms
+static double run(const Instance &instance, const char *name)
+{
+  DeviceFeatures features{};
+  Device device(instance.pick_physical_device(), {}, features, MemoryAllocator::Backend::Vma, CACHE_PATH);
+
+  DescriptorSetLayout::Bindings bindings{
+      {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT}};
+  DescriptorSetLayout descriptor_set_layout(device, bindings);
+  PipelineLayout pipeline_layout(device, descriptor_set_layout);
+
+  ShaderModule shader_module(device, "../shaders/permutation.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+
+  VkSpecializationMapEntry map_entry{0, 0, sizeof(uint32_t)};
+
+  std::vector<ComputePipeline> pipelines;
+  pipelines.reserve(PIPELINE_COUNT);
+
+  auto start = Clock::now();
+  for (uint32_t permutation = 0; permutation < PIPELINE_COUNT; ++permutation)
+  {
+    VkSpecializationInfo specialization_info{1, &map_entry, sizeof(uint32_t), &permutation};
+
+    ShaderStage shader_stage{};
+    shader_stage.set_stage(shader_module.get_stage())
+        .set_module(shader_module)
+        .set_entry_point(shader_module.get_entry_point())
+        .set_specialization_info(specialization_info);
+
+    pipelines.emplace_back(device, pipeline_layout, shader_stage);
+  }
+  auto total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  LOG_INFO("{}: {} pipelines in {:.2f} ms, {:.3f} ms per pipeline, cache warm {}, {} bytes", name, PIPELINE_COUNT,
+           total_ms, total_ms / PIPELINE_COUNT, device.get_pipeline_cache().is_warm(),
+           device.get_pipeline_cache().get_data().size());
+
+  // the device writes the cache back on destruction
+  return total_ms;
+}
+
+int main()
+{
+  if (volkInitialize())
+  {
+    throw std::runtime_error("Failed to initialize volk.");
+  }
+
+  Instance instance({}, {});
+
+  std::remove(CACHE_PATH);
+
+  auto cold_ms = run(instance, "cold");
+  auto warm_ms = run(instance, "warm");
+
+  LOG_INFO("warm start is {:.2f}x faster", cold_ms / warm_ms);
+
+  std::remove(CACHE_PATH);
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <thread>
+
+#include "prism/vulkan/instance.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/descriptor_set_layout.h"
+#include "prism/vulkan/pipeline_compiler.h"
+#include "prism/vulkan/pipeline_layout.h"
+#include "prism/vulkan/shader_module.h"
+
+using namespace prism;
+
+static const uint32_t PIPELINE_COUNT = 256;
+
+using Clock = std::chrono::high_resolution_clock;
+
+// compiles the permutations on thread_count workers through a fresh device with an empty in-memory cache, returns
+// the time until the last pipeline is ready in ms
+static double run(const Instance &instance, uint32_t thread_count)
+{
+  DeviceFeatures features{};
+  Device device(instance.pick_physical_device(), {}, features, MemoryAllocator::Backend::Vma, "");
+
+  DescriptorSetLayout::Bindings bindings{
+      {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT}};
+  DescriptorSetLayout descriptor_set_layout(device, bindings);
+  PipelineLayout pipeline_layout(device, descriptor_set_layout);
+
+  ShaderModule shader_module(device, "../shaders/permutation.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+
+  VkSpecializationMapEntry map_entry{0, 0, sizeof(uint32_t)};
+
+  // the compiler reads these until the futures are ready
+  std::vector<uint32_t> permutations(PIPELINE_COUNT);
+  std::vector<VkSpecializationInfo> specialization_infos(PIPELINE_COUNT);
+
+  PipelineCompiler compiler(device, thread_count);
+
+  std::vector<std::future<ComputePipeline>> futures;
+  futures.reserve(PIPELINE_COUNT);
+
+  auto start = Clock::now();
+  for (uint32_t permutation = 0; permutation < PIPELINE_COUNT; ++permutation)
+  {
+    permutations[permutation] = permutation;
+    specialization_infos[permutation] = {1, &map_entry, sizeof(uint32_t), &permutations[permutation]};
+
+    ShaderStage shader_stage{};
+    shader_stage.set_stage(shader_module.get_stage())
+        .set_module(shader_module)
+        .set_entry_point(shader_module.get_entry_point())
+        .set_specialization_info(specialization_infos[permutation]);
+
+    futures.push_back(compiler.compile(pipeline_layout, shader_stage));
+  }
+
+  // time to the first pipeline a renderer could draw with
+  futures.front().wait();
+  auto first_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  std::vector<ComputePipeline> pipelines;
+  pipelines.reserve(PIPELINE_COUNT);
+  for (auto &future : futures)
+  {
+    pipelines.push_back(future.get());
+  }
+  auto total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  LOG_INFO("{} thread(s): {} pipelines in {:.2f} ms, first ready after {:.2f} ms", thread_count, PIPELINE_COUNT,
+           total_ms, first_ms);
+
+  return total_ms;
+}
+
+int main()
+{
+  if (volkInitialize())
+  {
+    throw std::runtime_error("Failed to initialize volk.");
+  }
+
+  Instance instance({}, {});
+
+  auto max_thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+  double serial_ms = 0.0;
+  for (uint32_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2)
+  {
+    auto total_ms = run(instance, thread_count);
+    if (thread_count == 1)
+    {
+      serial_ms = total_ms;
+    }
+
+    LOG_INFO("{} thread(s): {:.2f}x vs 1 thread", thread_count, serial_ms / total_ms);
+  }
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+#include <chrono>
+
+#include "prism/vulkan/instance.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/resource_cache.h"
+
+using namespace prism;
+
+static const uint32_t MATERIAL_COUNT = 1024;
+
+// cull modes x blending x shader variants
+static const uint32_t UNIQUE_COUNT = 3 * 2 * 4;
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Material
+{
+  VkCullModeFlags cull_mode;
+  VkBool32 blend_enable;
+  uint32_t variant;
+};
+
+static Material make_material(uint32_t index)
+{
+  const VkCullModeFlags cull_modes[] = {VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_FRONT_BIT};
+  return {cull_modes[index % 3], (index / 3) % 2, (index / 6) % 4};
+}
+
+// builds the full pipeline state of a material and hands it to func, the state only lives for the call
+template <typename Func>
+static void with_create_info(const Material &material, ShaderModule &vert_module, ShaderModule &frag_module,
+                             const PipelineLayout &pipeline_layout, const RenderPass &render_pass, Func func)
+{
+  VkSpecializationMapEntry map_entry{0, 0, sizeof(uint32_t)};
+  VkSpecializationInfo specialization_info{1, &map_entry, sizeof(uint32_t), &material.variant};
+
+  std::vector<ShaderStage> shader_stages(2);
+  shader_stages[0]
+      .set_stage(vert_module.get_stage())
+      .set_module(vert_module)
+      .set_entry_point(vert_module.get_entry_point());
+  shader_stages[1]
+      .set_stage(frag_module.get_stage())
+      .set_module(frag_module)
+      .set_entry_point(frag_module.get_entry_point())
+      .set_specialization_info(specialization_info);
+
+  RasterizationState rasterization_state{};
+  rasterization_state.set_cull_mode(material.cull_mode);
+
+  std::vector<VkPipelineColorBlendAttachmentState> color_blend_attachments(1);
+  color_blend_attachments[0].colorWriteMask =
+      VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+  color_blend_attachments[0].blendEnable = material.blend_enable;
+  color_blend_attachments[0].srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+  color_blend_attachments[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  color_blend_attachments[0].colorBlendOp = VK_BLEND_OP_ADD;
+  color_blend_attachments[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  color_blend_attachments[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+  color_blend_attachments[0].alphaBlendOp = VK_BLEND_OP_ADD;
+  ColorBlendState color_blend_state{};
+  color_blend_state.set_attachments(color_blend_attachments);
+
+  std::vector<VkDynamicState> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+  DynamicState dynamic_state{};
+  dynamic_state.set_dynamic_states(dynamic_states);
+
+  VertexInputState vertex_input_state{};
+  InputAssemblyState input_assembly_state{};
+  ViewportState viewport_state{};
+  MultisampleState multisample_state{};
+  DepthStencilState depth_stencil_state{};
+
+  GraphicsPipelineCreateInfo create_info{};
+  create_info.set_shader_stages(shader_stages)
+      .set_layout(pipeline_layout)
+      .set_render_pass(render_pass)
+      .set_subpass(0)
+      .set_vertex_input_state(vertex_input_state)
+      .set_input_assembly_state(input_assembly_state)
+      .set_viewport_state(viewport_state)
+      .set_rasterization_state(rasterization_state)
+      .set_multisample_state(multisample_state)
+      .set_depth_stencil_state(depth_stencil_state)
+      .set_color_blend_state(color_blend_state)
+      .set_dynamic_state(dynamic_state);
+
+  func(create_info);
+}
+
+int main()
+{
+  if (volkInitialize())
+  {
+    throw std::runtime_error("Failed to initialize volk.");
+  }
+
+  Instance instance({}, {});
+
+  DeviceFeatures features{};
+  // an in-memory vulkan cache, the driver would otherwise serve repeats from a previous run
+  Device device(instance.pick_physical_device(), {}, features, MemoryAllocator::Backend::Vma, "");
+
+  ResourceCache resource_cache(device);
+
+  auto &vert_module = resource_cache.request_shader_module("../shaders/material.vert.spv", VK_SHADER_STAGE_VERTEX_BIT);
+  auto &frag_module = resource_cache.request_shader_module("../shaders/material.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
+
+  auto &pipeline_layout = resource_cache.request_pipeline_layout(std::vector<const DescriptorSetLayout *>{});
+
+  std::vector<AttachmentDescription> attachments(1);
+  attachments[0].format = VK_FORMAT_B8G8R8A8_UNORM;
+  attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+  attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+  auto color_attachment_ref = AttachmentReference{};
+  color_attachment_ref.attachment = 0;
+  color_attachment_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+  std::vector<SubpassDescription> subpasses(1);
+  subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpasses[0].colorAttachmentCount = 1;
+  subpasses[0].pColorAttachments = &color_attachment_ref;
+
+  auto &render_pass = resource_cache.request_render_pass(attachments, subpasses, {});
+
+  // a pass that loads instead of clearing is compatible, its pipelines are shared with the first one
+  attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+  attachments[0].initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  auto &load_render_pass = resource_cache.request_render_pass(attachments, subpasses, {});
+
+  // one pipeline per material
+  std::vector<GraphicsPipeline> pipelines;
+  pipelines.reserve(MATERIAL_COUNT);
+
+  auto start = Clock::now();
+  for (uint32_t i = 0; i < MATERIAL_COUNT; ++i)
+  {
+    with_create_info(make_material(i), vert_module, frag_module, pipeline_layout, render_pass,
+                     [&](const GraphicsPipelineCreateInfo &create_info)
+                     { pipelines.emplace_back(device, create_info); });
+  }
+  auto direct_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  pipelines.clear();
+
+  // one pipeline per unique state
+  start = Clock::now();
+  for (uint32_t i = 0; i < MATERIAL_COUNT; ++i)
+  {
+    with_create_info(make_material(i), vert_module, frag_module, pipeline_layout, render_pass,
+                     [&](const GraphicsPipelineCreateInfo &create_info)
+                     { resource_cache.request_graphics_pipeline(create_info); });
+  }
+  auto cached_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  auto miss_count = resource_cache.get_statistics().miss_count;
+
+  // the per draw path, every request is a hit, half of them against the compatible pass
+  start = Clock::now();
+  for (uint32_t i = 0; i < MATERIAL_COUNT; ++i)
+  {
+    with_create_info(make_material(i), vert_module, frag_module, pipeline_layout, i % 2 ? load_render_pass : render_pass,
+                     [&](const GraphicsPipelineCreateInfo &create_info)
+                     { resource_cache.request_graphics_pipeline(create_info); });
+  }
+  auto lookup_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+  // the modules, the layout and the two render passes were misses as well
+  auto pipeline_count = miss_count - 5;
+
+  LOG_INFO("{} materials, {} unique states", MATERIAL_COUNT, UNIQUE_COUNT);
+  LOG_INFO("direct: {} pipelines in {:.2f} ms", MATERIAL_COUNT, direct_ms);
+  LOG_INFO("cached: {} pipelines in {:.2f} ms, {:.2f}x faster", pipeline_count, cached_ms, direct_ms / cached_ms);
+  LOG_INFO("lookup: {:.3f} us per request, {} new pipelines", lookup_us / MATERIAL_COUNT,
+           resource_cache.get_statistics().miss_count - miss_count);
+
+  return 0;
+}
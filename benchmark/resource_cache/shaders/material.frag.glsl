@@ -0,0 +1,12 @@
+#version 450
+
+// one of a handful of variants a material can select
+layout(constant_id = 0) const uint VARIANT = 0;
+
+layout(location = 0) in vec3 fragColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = vec4(fragColor * (1.0 + float(VARIANT)) * 0.25, 1.0);
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <filesystem>
+
+#include "prism/core/filesystem.h"
+#include "prism/vulkan/instance.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/shader_compiler.h"
+#include "prism/vulkan/shader_module.h"
+
+using namespace prism;
+
+static const uint32_t PERMUTATION_COUNT = 500;
+
+static const char *CACHE_DIRECTORY = "benchmark_shader_cache";
+
+using Clock = std::chrono::high_resolution_clock;
+
+// creates every permutation through a fresh compiler on the cache directory, returns the time in ms
+static double run(const Device &device, const GlslSource &base_source, const char *name)
+{
+  ShaderCompiler compiler(CACHE_DIRECTORY);
+
+  std::vector<ShaderModule> modules;
+  modules.reserve(PERMUTATION_COUNT);
+
+  auto start = Clock::now();
+  for (uint32_t permutation = 0; permutation < PERMUTATION_COUNT; ++permutation)
+  {
+    auto source = base_source;
+    source.defines = {
+        "PERMUTATION=" + std::to_string(permutation),
+        "FEATURE_SQRT=" + std::to_string(permutation & 1),
+        "FEATURE_EXP=" + std::to_string((permutation >> 1) & 1),
+        "FEATURE_NORMALIZE=" + std::to_string((permutation >> 2) & 1),
+    };
+
+    modules.emplace_back(device, compiler, source, VK_SHADER_STAGE_COMPUTE_BIT);
+  }
+  auto total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  auto statistics = compiler.get_statistics();
+  LOG_INFO("{}: {} modules in {:.2f} ms, {:.3f} ms per module, {} compiled, {} from cache", name, PERMUTATION_COUNT,
+           total_ms, total_ms / PERMUTATION_COUNT, statistics.miss_count, statistics.hit_count);
+
+  return total_ms;
+}
+
+int main()
+{
+  if (volkInitialize())
+  {
+    throw std::runtime_error("Failed to initialize volk.");
+  }
+
+  Instance instance({}, {});
+
+  DeviceFeatures features{};
+  Device device(instance.pick_physical_device(), {}, features, MemoryAllocator::Backend::Vma, "");
+
+  GlslSource source{};
+  source.filename = PROJECT_FOLDER "/shaders/permutation.comp";
+  source.code = read_file(source.filename);
+  if (source.code.empty())
+  {
+    throw std::runtime_error("Failed to read " + source.filename);
+  }
+
+  std::filesystem::remove_all(CACHE_DIRECTORY);
+
+  auto cold_ms = run(device, source, "cold");
+  auto warm_ms = run(device, source, "warm");
+
+  LOG_INFO("cache hits are {:.2f}x faster", cold_ms / warm_ms);
+
+  std::filesystem::remove_all(CACHE_DIRECTORY);
+
+  return 0;
+}
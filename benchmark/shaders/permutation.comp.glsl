@@ -0,0 +1,29 @@
+#version 460
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+// every value gives the driver a different pipeline to compile
+layout(constant_id = 0) const uint PERMUTATION = 0;
+
+layout(binding = 0, set = 0) buffer Data
+{
+  vec4 values[];
+};
+
+void main()
+{
+  uint index = gl_GlobalInvocationID.x;
+  vec4 value = values[index];
+
+  // enough arithmetic that compilation is not dominated by fixed costs
+  for (uint i = 0; i < 8 + PERMUTATION % 8; ++i)
+  {
+    value = sin(value * float(PERMUTATION + 1)) + cos(value.yzwx * 0.5);
+    if ((PERMUTATION & (1u << (i % 5))) != 0)
+    {
+      value = sqrt(abs(value)) * exp(-value.wxyz);
+    }
+  }
+
+  values[index] = value;
+}
@@ -33,13 +33,10 @@ void Renderer::render() {
 
 void Renderer::save(const std::string &path) {
 
-  value_type *data;
-  m_framebuffer->device_memory->map(0, WIDTH * HEIGHT * CHANNEl * sizeof(value_type), 0,
-                            reinterpret_cast<void **>(&data));
+  std::vector<value_type> data(WIDTH * HEIGHT * CHANNEl);
+  m_framebuffer->download(data.data(), data.size() * sizeof(value_type));
 
-  stbi_write_hdr(path.c_str(), WIDTH, HEIGHT, CHANNEl, data);
-
-  m_framebuffer->device_memory->unmap();
+  stbi_write_hdr(path.c_str(), WIDTH, HEIGHT, CHANNEl, data.data());
 }
 
 void Renderer::create_instance() {
@@ -64,7 +61,9 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT);
 }
@@ -72,7 +71,7 @@ void Renderer::create_device() {
 void Renderer::create_framebuffer() {
   m_framebuffer = std::make_unique<BufferData>(
       *m_device, WIDTH * HEIGHT * CHANNEl * sizeof(value_type),
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryAllocator::Usage::Readback);
 }
 
 void Renderer::create_command_pool() {
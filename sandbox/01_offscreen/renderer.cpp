@@ -75,9 +75,11 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
-      VK_QUEUE_TRANSFER_BIT);
+      VK_QUEUE_GRAPHICS_BIT);
 }
 
 void Renderer::create_surface() {
@@ -161,8 +163,12 @@ void Renderer::draw() {
 
   // darw to storage image
   auto draw_to_storage_image = [&](const std::vector<glm::u8vec4> &data) {
-    m_storage_data->upload(*m_command_pool, data.data(),
-                            data.size() * sizeof(glm::u8vec4));
+    auto token = m_storage_data->upload(data.data(),
+                                        data.size() * sizeof(glm::u8vec4));
+    // the upload may run on another queue family, take ownership and wait for it before copying
+    auto &upload_manager = m_device->get_upload_manager();
+    upload_manager.acquire(m_command_buffers[m_current_frame], token);
+    upload_manager.wait(token);
   };
 
   if (frame_count % 30 < 10) {
@@ -184,7 +190,7 @@ void Renderer::draw() {
   
   image_memory_barrier.srcAccessMask = 0;
   image_memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-  image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
   image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
   image_memory_barrier.image = m_storage_data->image->get_handle();
 
@@ -264,11 +270,7 @@ void Renderer::draw() {
   VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
   submit_info.pWaitDstStageMask = wait_stages;
 
-  if (vkQueueSubmit(queue.get_handle(), 1, &submit_info,
-                    m_in_flight_fences[m_current_frame].get_handle()) !=
-      VK_SUCCESS) {
-    throw std::runtime_error("failed to submit draw command buffer!");
-  }
+  queue.submit(submit_info, m_in_flight_fences[m_current_frame].get_handle());
 
   // present
   VkPresentInfoKHR present_info{};
@@ -2,8 +2,10 @@
 
 #include "stb_image_write.h"
 
+#include "prism/core/filesystem.h"
 #include "prism/platform/glfw_window.h"
 #include "prism/vulkan/device_features.h"
+#include "prism/vulkan/shader_reflection.h"
 #include "prism/vulkan/utils.h"
 
 static uint32_t WIDTH = 800;
@@ -24,9 +26,9 @@ Renderer::Renderer() {
   create_swapchain();
   create_command_pool();
   create_command_buffer();
+  create_pipeline();
   create_render_target();
   create_sync_object();
-  create_pipeline();
   create_descriptors();
 }
 
@@ -77,7 +79,9 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT);
 }
@@ -104,7 +108,7 @@ void Renderer::create_render_target() {
   ImageCreateInfo image_ci{};
   image_ci.set_extent({WIDTH, HEIGHT, 1})
       .set_image_type(VK_IMAGE_TYPE_2D)
-      .set_format(VK_FORMAT_B8G8R8A8_UNORM)
+      .set_format(m_storage_format)
       .set_usage(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
                  VK_IMAGE_USAGE_TRANSFER_DST_BIT);
   ImageViewCreateInfo image_view_ci{};
@@ -140,26 +144,52 @@ void Renderer::create_command_buffer() {
 }
 
 void Renderer::create_pipeline() {
-  DescriptorSetLayout::Bindings bindings{
-      {0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT}};
-  m_descriptor_set_layout =
-      std::make_unique<DescriptorSetLayout>(*m_device, bindings);
-  m_pipeline_layout =
-      std::make_unique<PipelineLayout>(*m_device, *m_descriptor_set_layout);
-  
-  auto shader_module = ShaderModule(*m_device, "../shaders/raytrace.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
-  ShaderStage shader_stage{};
-  shader_stage.set_stage(shader_module.get_stage())
-      .set_module(shader_module)
-      .set_entry_point(shader_module.get_entry_point());
-  
-  m_compute_pipeline = std::make_unique<ComputePipeline>(
-      *m_device, *m_pipeline_layout, shader_stage);
+  static const char *SHADER = PROJECT_FOLDER "/shaders/raytrace.comp.glsl";
+
+  m_shader_compiler = std::make_unique<ShaderCompiler>();
+  m_shader_reloader = std::make_unique<ShaderReloader>(
+      *m_device, *m_shader_compiler, m_swapchain->get_images().size());
+
+  GlslSource source{};
+  source.filename = SHADER;
+  source.code = read_file(SHADER);
+  auto shader_module = ShaderModule(*m_device, *m_shader_compiler, source,
+                                    VK_SHADER_STAGE_COMPUTE_BIT);
+
+  // the layout and the storage image follow the shader's declarations, they
+  // are kept across reloads
+  ShaderReflection reflection(shader_module);
+  m_descriptor_set_layout = std::make_unique<DescriptorSetLayout>(
+      *m_device, reflection.get_descriptor_set_bindings()[0]);
+  m_pipeline_layout = std::make_unique<PipelineLayout>(
+      *m_device,
+      std::vector<const DescriptorSetLayout *>{m_descriptor_set_layout.get()},
+      reflection.get_push_constant_ranges());
+  m_storage_format = reflection.get_bindings()[0].format;
+
+  m_dispatch = std::make_unique<ComputeDispatch>(m_device->get_physical_device(), 2);
+  const auto &workgroup_size = m_dispatch->get_workgroup_size();
+  m_specialization = std::make_unique<SpecializationInfo<RaytraceConstants>>(
+      RaytraceConstants{workgroup_size[0], workgroup_size[1]});
+  m_specialization->add<0, &RaytraceConstants::local_size_x>()
+      .add<1, &RaytraceConstants::local_size_y>();
+  LOG_INFO("workgroup size {}x{}", workgroup_size[0], workgroup_size[1]);
+
+  m_compute_pipeline = m_shader_reloader->add<ComputePipeline>(
+      {{SHADER, VK_SHADER_STAGE_COMPUTE_BIT}},
+      [this](const std::vector<ShaderModule> &modules) {
+        ShaderStage shader_stage{};
+        shader_stage.set_stage(modules[0].get_stage())
+            .set_module(modules[0])
+            .set_entry_point(modules[0].get_entry_point())
+            .set_specialization_info(*m_specialization);
+
+        return ComputePipeline(*m_device, *m_pipeline_layout, shader_stage);
+      });
 }
 
 void Renderer::create_descriptors() {
-  std::vector<VkDescriptorPoolSize> pool_sizes{
-      {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1}};
+  auto pool_sizes = m_descriptor_set_layout->get_descriptor_pool_sizes();
   m_descriptor_pool =
       std::make_unique<DescriptorPool>(*m_device, pool_sizes, 1);
 
@@ -200,6 +230,9 @@ void Renderer::create_sync_object() {
 void Renderer::draw() {
   m_in_flight_fences[m_current_frame].wait();
 
+  // pipelines recompiled since the last frame are bound from this one on
+  m_shader_reloader->update();
+
   uint32_t image_index;
   auto result = vkAcquireNextImageKHR(
       m_device->get_handle(), m_swapchain->get_handle(), UINT64_MAX,
@@ -220,80 +253,59 @@ void Renderer::draw() {
   m_command_buffers[m_current_frame].begin(
       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
+  auto &cmd_buffer = m_command_buffers[m_current_frame];
+  auto &storage_image = *m_storage_data->image;
+  auto &swapchain_image = m_swapchain->get_images()[image_index];
+
+  // the old contents are discarded, the acquire semaphore is waited on at the
+  // transfer stage
+  swapchain_image.update_layout(VK_IMAGE_LAYOUT_UNDEFINED,
+                                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                VK_ACCESS_2_NONE);
+
+  // both transitions go out in the barrier ahead of the dispatch
+  cmd_buffer.image_barrier(storage_image, VK_IMAGE_LAYOUT_GENERAL,
+                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+  cmd_buffer.image_barrier(swapchain_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_PIPELINE_STAGE_2_BLIT_BIT,
+                           VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
   // darw to storage image
-  m_command_buffers[m_current_frame].bind_pipeline(*m_compute_pipeline);
-
-  m_command_buffers[m_current_frame].bind_descriptor_set(
-      VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline_layout->get_handle(),
-      m_descriptor_set->get_handle());
-
-  m_command_buffers[m_current_frame].dispatch(WIDTH / 8, HEIGHT / 8, 1);
-
-  VkImageMemoryBarrier image_memory_barrier{};
-  image_memory_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-  image_memory_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  image_memory_barrier.subresourceRange.layerCount = 1;
-  image_memory_barrier.subresourceRange.levelCount = 1;
-
-  // transition storage image layout to transfer source
-  image_memory_barrier.srcAccessMask = 0;
-  image_memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-  image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-  image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-  image_memory_barrier.image = m_storage_data->image->get_handle();
-
-  m_command_buffers[m_current_frame].pipeline_barrier(
-      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
-      {}, {}, {image_memory_barrier});
-
-  // transition swapchain image layout to transfer destination
-  auto &swapchain_image = m_swapchain->get_images()[m_current_frame];
-  image_memory_barrier.srcAccessMask = 0;
-  image_memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  image_memory_barrier.image = swapchain_image.get_handle();
-
-  m_command_buffers[m_current_frame].pipeline_barrier(
-      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
-      {}, {}, {image_memory_barrier});
-
-  // copy storage image to swapchain image
-  VkImageCopy image_copy{};
-  image_copy.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  image_copy.srcSubresource.layerCount = 1;
-  image_copy.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  image_copy.dstSubresource.layerCount = 1;
-  image_copy.extent.width = WIDTH;
-  image_copy.extent.height = HEIGHT;
-  image_copy.extent.depth = 1;
-
-  m_command_buffers[m_current_frame].copy_image(*m_storage_data->image,
-                                                swapchain_image, {image_copy});
-
-  // transition swapchain image layout to present source
-  image_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  image_memory_barrier.dstAccessMask = 0;
-  image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-  image_memory_barrier.image = swapchain_image.get_handle();
-
-  m_command_buffers[m_current_frame].pipeline_barrier(
-      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
-      {}, {}, {image_memory_barrier});
-
-  // transition storage image layout to general
-  image_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-  image_memory_barrier.dstAccessMask = 0;
-  image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-  image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-  image_memory_barrier.image = m_storage_data->image->get_handle();
-
-  m_command_buffers[m_current_frame].pipeline_barrier(
-      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
-      {}, {}, {image_memory_barrier});
-
-  m_command_buffers[m_current_frame].end();
+  cmd_buffer.bind_pipeline(m_compute_pipeline.get());
+
+  cmd_buffer.bind_descriptor_set(VK_PIPELINE_BIND_POINT_COMPUTE,
+                                 m_pipeline_layout->get_handle(),
+                                 m_descriptor_set->get_handle());
+
+  cmd_buffer.dispatch(*m_dispatch, WIDTH, HEIGHT);
+
+  cmd_buffer.image_barrier(storage_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           VK_PIPELINE_STAGE_2_BLIT_BIT,
+                           VK_ACCESS_2_TRANSFER_READ_BIT);
+
+  // blit storage image to swapchain image, converting the rgba32f texels to
+  // the swapchain format
+  VkImageBlit image_blit{};
+  image_blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  image_blit.srcSubresource.layerCount = 1;
+  image_blit.srcOffsets[1] = {static_cast<int32_t>(WIDTH),
+                              static_cast<int32_t>(HEIGHT), 1};
+  image_blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  image_blit.dstSubresource.layerCount = 1;
+  image_blit.dstOffsets[1] = image_blit.srcOffsets[1];
+
+  cmd_buffer.blit_image(storage_image, swapchain_image, {image_blit});
+
+  // presentation is ordered by the semaphore, no access to make visible
+  cmd_buffer.image_barrier(swapchain_image, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                           VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+
+  cmd_buffer.end();
+
+  // the hand written version recorded four ALL_COMMANDS barriers per frame,
+  // batching leaves one ahead of the dispatch, the blit and the present
+  assert(cmd_buffer.get_barrier_count() == 3);
 
   auto &queue = m_device->get_queue(m_queue_family_index, 0);
   // queue.submit(m_command_buffers[m_current_frame]);
@@ -302,8 +314,7 @@ void Renderer::draw() {
   VkSubmitInfo submit_info{};
   submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submit_info.commandBufferCount = 1;
-  submit_info.pCommandBuffers =
-      &m_command_buffers[m_current_frame].get_handle();
+  submit_info.pCommandBuffers = &cmd_buffer.get_handle();
   // wait semaphore
   VkSemaphore wait_semaphores[] = {
       m_image_availabel_semaphores[m_current_frame].get_handle()};
@@ -315,14 +326,10 @@ void Renderer::draw() {
   submit_info.signalSemaphoreCount = 1;
   submit_info.pSignalSemaphores = signal_semaphores;
   // wait stage
-  VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+  VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT};
   submit_info.pWaitDstStageMask = wait_stages;
 
-  if (vkQueueSubmit(queue.get_handle(), 1, &submit_info,
-                    m_in_flight_fences[m_current_frame].get_handle()) !=
-      VK_SUCCESS) {
-    throw std::runtime_error("failed to submit draw command buffer!");
-  }
+  queue.submit(submit_info, m_in_flight_fences[m_current_frame].get_handle());
 
   // present
   VkPresentInfoKHR present_info{};
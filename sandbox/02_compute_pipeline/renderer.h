@@ -1,9 +1,11 @@
 #pragma once
 
 #include "prism/platform/window.h"
+#include "prism/rendering/shader_reloader.h"
 #include "prism/rendering/image_data.h"
 #include "prism/vulkan/command_buffer.h"
 #include "prism/vulkan/command_pool.h"
+#include "prism/vulkan/compute_dispatch.h"
 #include "prism/vulkan/compute_pipeline.h"
 #include "prism/vulkan/descriptor_pool.h"
 #include "prism/vulkan/descriptor_set.h"
@@ -13,12 +15,19 @@
 #include "prism/vulkan/instance.h"
 #include "prism/vulkan/pipeline_layout.h"
 #include "prism/vulkan/semaphore.h"
+#include "prism/vulkan/specialization_info.h"
 #include "prism/vulkan/surface.h"
 #include "prism/vulkan/swapchain.h"
 
 
 using namespace prism;
 
+// specialization constants of raytrace.comp.glsl
+struct RaytraceConstants {
+  uint32_t local_size_x;
+  uint32_t local_size_y;
+};
+
 class Renderer {
 
 public:
@@ -54,6 +63,8 @@ private:
 
   uint32_t m_queue_family_index;
 
+  // the format the shader declares for the storage image
+  VkFormat m_storage_format = VK_FORMAT_UNDEFINED;
   std::unique_ptr<ImageData> m_storage_data;
 
   std::unique_ptr<CommandPool> m_command_pool;
@@ -61,7 +72,15 @@ private:
 
   std::unique_ptr<DescriptorSetLayout> m_descriptor_set_layout;
   std::unique_ptr<PipelineLayout> m_pipeline_layout;
-  std::unique_ptr<ComputePipeline> m_compute_pipeline;
+  // the workgroup size picked for the device and the constants that pass it
+  // to the shader
+  std::unique_ptr<ComputeDispatch> m_dispatch;
+  std::unique_ptr<SpecializationInfo<RaytraceConstants>> m_specialization;
+
+  // recompiled in the background when raytrace.comp.glsl is saved
+  std::unique_ptr<ShaderCompiler> m_shader_compiler;
+  std::unique_ptr<ShaderReloader> m_shader_reloader;
+  ShaderReloader::Handle<ComputePipeline> m_compute_pipeline;
 
   std::unique_ptr<DescriptorPool> m_descriptor_pool;
   std::unique_ptr<DescriptorSet> m_descriptor_set;
@@ -3,7 +3,10 @@
 #version 460 
 #extension GL_EXT_scalar_block_layout : require
 
+// The workgroup size is specialized for the device, constants 0 and 1 override
+// the 16x8 default:
 layout(local_size_x = 16, local_size_y = 8, local_size_z = 1) in;
+layout(local_size_x_id = 0, local_size_y_id = 1) in;
 
 // The scalar layout qualifier here means to align types according to the alignment
 // of their scalar components, instead of e.g. padding them to std140 rules.
@@ -11,9 +14,9 @@ layout(binding = 0, set = 0, rgba32f) uniform image2D storageImage;
 
 void main()
 {
-  // The resolution of the buffer, which in this case is a hardcoded vector
-  // of 2 unsigned integers:
-  const uvec2 resolution = uvec2(800, 600);
+  // The resolution of the buffer, taken from the image so it follows the
+  // swapchain:
+  const uvec2 resolution = uvec2(imageSize(storageImage));
 
   // Get the coordinates of the pixel for this invocation:
   //
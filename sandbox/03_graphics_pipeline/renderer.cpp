@@ -76,7 +76,9 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT);
 
@@ -420,11 +422,7 @@ void Renderer::display() {
   VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
   submit_info.pWaitDstStageMask = wait_stages;
 
-  if (vkQueueSubmit(queue.get_handle(), 1, &submit_info,
-                    m_in_flight_fences[m_current_frame].get_handle()) !=
-      VK_SUCCESS) {
-    throw std::runtime_error("failed to submit draw command buffer!");
-  }
+  queue.submit(submit_info, m_in_flight_fences[m_current_frame].get_handle());
 
   vkQueueWaitIdle(queue.get_handle());
 
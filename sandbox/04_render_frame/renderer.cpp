@@ -61,6 +61,7 @@ bool Renderer::resize() {
 
   m_framebuffers.clear();
   m_render_frames.clear();
+  m_render_targets.clear();
   m_swapchain.reset();
 
   create_swapchain();
@@ -119,7 +120,9 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT);
 
@@ -141,9 +144,11 @@ void Renderer::create_swapchain() {
 }
 
 void Renderer::create_render_frame() {
+  m_render_targets.reserve(m_swapchain->get_images().size());
   m_render_frames.reserve(m_swapchain->get_images().size());
   for (size_t i = 0; i < m_swapchain->get_images().size(); ++i) {
-    m_render_frames.emplace_back(*m_device, m_swapchain->get_images()[i]);
+    m_render_targets.emplace_back(*m_device, m_swapchain->get_images()[i]);
+    m_render_frames.emplace_back(*m_device);
   }
 }
 
@@ -224,8 +229,8 @@ void Renderer::create_pipeline() {
 
 void Renderer::create_framebuffer() {
   m_framebuffers.reserve(m_swapchain->get_images().size());
-  for (const auto &render_frame : m_render_frames) {
-    m_framebuffers.emplace_back(*m_device, *m_render_pass, render_frame.get_image_views(), m_extent.width, m_extent.height);
+  for (const auto &render_target : m_render_targets) {
+    m_framebuffers.emplace_back(*m_device, *m_render_pass, render_target.get_image_views(), m_extent.width, m_extent.height);
   }
 }
 
@@ -324,27 +329,21 @@ void Renderer::render_image(uint32_t image_index)
   submit_info.waitSemaphoreCount = 1;
   submit_info.pWaitSemaphores = wait_semaphores;
   // signal semaphore
-  VkSemaphore signal_semaphores = frame.get_semaphore().get_handle();
+  VkSemaphore signal_semaphores = m_render_targets[image_index].get_present_semaphore().get_handle();
   submit_info.signalSemaphoreCount = 1;
   submit_info.pSignalSemaphores = &signal_semaphores;
   // wait stage
   VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
   submit_info.pWaitDstStageMask = wait_stages;
 
-  if (vkQueueSubmit(queue.get_handle(), 1, &submit_info,
-                    frame.get_fence().get_handle()) !=
-      VK_SUCCESS) {
-    throw std::runtime_error("failed to submit draw command buffer!");
-  }
+  queue.submit(submit_info, frame.get_fence().get_handle());
 
   queue.wait_idle();
 }
 
 VkResult Renderer::present_image(uint32_t image_index)
 {
-  auto& frame = m_render_frames[image_index];
-
-  VkSemaphore signal_semaphores = frame.get_semaphore().get_handle();
+  VkSemaphore signal_semaphores = m_render_targets[image_index].get_present_semaphore().get_handle();
 
   // present
   VkPresentInfoKHR present_info{};
@@ -20,6 +20,7 @@
 #include "prism/vulkan/framebuffer.h"
 
 #include "prism/rendering/render_frame.h"
+#include "prism/rendering/render_target.h"
 
 
 using namespace prism;
@@ -89,6 +90,8 @@ private:
   std::unique_ptr<PipelineLayout> m_pipeline_layout;
   std::unique_ptr<GraphicsPipeline> m_graphic_pipeline;
 
+  std::vector<RenderTarget> m_render_targets;
+
   std::vector<RenderFrame> m_render_frames;
 
   std::unique_ptr<Semaphore> m_image_availabel_semaphores;
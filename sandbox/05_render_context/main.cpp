@@ -1,15 +1,47 @@
+#include <cstring>
+
 #include "renderer.h"
 
 using namespace prism;
 
-int main() {
+// compares frame times for 1, 2 and 3 frames in flight with the cpu and the gpu both loaded
+static void benchmark() {
+  const uint32_t frame_count = 500;
+  const uint32_t instance_count = 2000;
+  const double cpu_work_ms = 4.0;
+
+  double baseline = 0.0;
+  for (uint32_t frames_in_flight = 1; frames_in_flight <= 3; ++frames_in_flight) {
+    RenderContext::Properties properties{};
+    properties.frame_count = frames_in_flight;
+    // vsync would hide the overlap
+    properties.present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+
+    Renderer render(properties);
+    auto frame_ms = render.benchmark(frame_count, instance_count, cpu_work_ms);
+
+    if (frames_in_flight == 1) {
+      baseline = frame_ms;
+    }
+
+    LOG_INFO("{} frame(s) in flight: {:.3f} ms/frame, {:.1f} fps, {:.2f}x vs 1 frame", frames_in_flight, frame_ms,
+             1000.0 / frame_ms, baseline / frame_ms);
+  }
+}
+
+int main(int argc, char **argv) {
   if (volkInitialize()) {
     throw std::runtime_error("Failed to initialize volk.");
   }
-  
-    Renderer render;
-    render.render_loop();
-    // render.save("output.hdr");
 
+  if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0) {
+    benchmark();
     return 0;
-}
\ No newline at end of file
+  }
+
+  Renderer render;
+  render.render_loop();
+  // render.save("output.hdr");
+
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include "renderer.h"
 
+#include <chrono>
+
 #include "stb_image_write.h"
 
 #include "prism/platform/glfw_window.h"
@@ -8,7 +10,8 @@
 #include "prism/vulkan/utils.h"
 
 
-Renderer::Renderer() {
+Renderer::Renderer(const RenderContext::Properties &properties)
+    : m_render_context_properties(properties) {
   create_window();
   create_instance();
   create_device();
@@ -26,28 +29,62 @@ void Renderer::render_loop() {
   while (!m_window->should_close()) {
     m_window->process_events();
 
-    auto result = m_render_context->prepare_frame();
+    draw_frame();
+  }
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-      resize();
-      return;
-    } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-      throw std::runtime_error("failed to acquire swapchain image!");
-    }
+  m_device->wait_idle();
+}
 
-    render_image();
+double Renderer::benchmark(uint32_t frame_count, uint32_t instance_count, double cpu_work_ms) {
+  m_instance_count = instance_count;
 
-    result = m_render_context->present_frame();
-    const auto &extent = m_window->get_extent();
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
-        m_extent.width != extent.x || m_extent.height != extent.y) {
-      resize();
-    } else if (result != VK_SUCCESS) {
-      throw std::runtime_error("failed to present swapchain image!");
-    }
+  // let the swapchain and pipeline caches settle before timing
+  for (uint32_t i = 0; i < 16; ++i) {
+    m_window->process_events();
+    draw_frame();
   }
+  m_device->wait_idle();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < frame_count && !m_window->should_close(); ++i) {
+    m_window->process_events();
+
+    // stands in for game logic and scene traversal
+    auto work_end = std::chrono::high_resolution_clock::now() +
+                    std::chrono::duration<double, std::milli>(cpu_work_ms);
+    while (std::chrono::high_resolution_clock::now() < work_end) {
+    }
 
+    draw_frame();
+  }
   m_device->wait_idle();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  m_instance_count = 1;
+
+  return std::chrono::duration<double, std::milli>(end - start).count() / frame_count;
+}
+
+void Renderer::draw_frame() {
+  auto result = m_render_context->prepare_frame();
+
+  if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+    resize();
+    return;
+  } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+    throw std::runtime_error("failed to acquire swapchain image!");
+  }
+
+  render_image();
+
+  result = m_render_context->present_frame();
+  const auto &extent = m_window->get_extent();
+  if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
+      m_extent.width != extent.x || m_extent.height != extent.y) {
+    resize();
+  } else if (result != VK_SUCCESS) {
+    throw std::runtime_error("failed to present swapchain image!");
+  }
 }
 
 void Renderer::create_window() {
@@ -88,7 +125,9 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT);
 
@@ -102,7 +141,8 @@ void Renderer::create_surface() {
 void Renderer::create_render_context() {
   m_render_context = std::make_unique<RenderContext>(*m_window, *m_surface,
                                                      *m_device,
-                                                     m_device->get_queue(m_queue_family_index, 0));
+                                                     m_device->get_queue(m_queue_family_index, 0),
+                                                     m_render_context_properties);
 }
 
 void Renderer::create_render_pass() {
@@ -187,11 +227,11 @@ void Renderer::create_pipeline() {
 }
 
 void Renderer::create_framebuffer() {
-  const auto &render_frames = m_render_context->get_render_frames();
-  m_framebuffers.reserve(render_frames.size());
-  for (const auto &render_frame : render_frames) {
+  const auto &render_targets = m_render_context->get_render_targets();
+  m_framebuffers.reserve(render_targets.size());
+  for (const auto &render_target : render_targets) {
     m_framebuffers.emplace_back(*m_device, *m_render_pass,
-                                render_frame.get_image_views(), m_extent.width,
+                                render_target.get_image_views(), m_extent.width,
                                 m_extent.height);
   }
 }
@@ -254,7 +294,7 @@ void Renderer::render_image()
     VkRenderPassBeginInfo render_pass_bi{};
     render_pass_bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     render_pass_bi.renderPass = m_render_pass->get_handle();
-    render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_frame_index()].get_handle();
+    render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_target_index()].get_handle();
     render_pass_bi.renderArea.offset = {0, 0};
     render_pass_bi.renderArea.extent = m_extent;
 
@@ -282,7 +322,7 @@ void Renderer::render_image()
     scissor.extent = m_extent;
     cmd_buffer.set_scissor(scissor);
 
-    cmd_buffer.draw(3, 1, 0, 0);
+    cmd_buffer.draw(3, m_instance_count, 0, 0);
 
     cmd_buffer.end_render_pass();
 
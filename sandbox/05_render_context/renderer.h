@@ -27,10 +27,13 @@ using namespace prism;
 class Renderer {
 
 public:
-  Renderer();
+  Renderer(const RenderContext::Properties &properties = {});
 
   void render_loop();
 
+  // renders frame_count frames with the given draw load and simulated cpu work, returns the mean frame time in ms
+  double benchmark(uint32_t frame_count, uint32_t instance_count, double cpu_work_ms);
+
 private:
   void create_window();
   void create_instance();
@@ -44,6 +47,8 @@ private:
   
   bool resize();
 
+  void draw_frame();
+
   void render_image();
 
 private:
@@ -57,8 +62,13 @@ private:
 
   std::unique_ptr<Surface> m_surface;
 
+  RenderContext::Properties m_render_context_properties;
+
   std::unique_ptr<RenderContext> m_render_context;
 
+  // the triangle is drawn this many times on top of itself to give the gpu some work
+  uint32_t m_instance_count{1};
+
   uint32_t m_queue_family_index;
 
   // input
@@ -88,7 +88,7 @@ void Renderer::render_loop() {
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
       resize();
-      return;
+      continue;
     } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
       throw std::runtime_error("failed to acquire swapchain image!");
     }
@@ -147,7 +147,9 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT);
 
@@ -277,11 +279,11 @@ void Renderer::create_pipeline() {
 }
 
 void Renderer::create_framebuffer() {
-  const auto &render_frames = m_render_context->get_render_frames();
-  m_framebuffers.reserve(render_frames.size());
-  for (const auto &render_frame : render_frames) {
+  const auto &render_targets = m_render_context->get_render_targets();
+  m_framebuffers.reserve(render_targets.size());
+  for (const auto &render_target : render_targets) {
     m_framebuffers.emplace_back(*m_device, *m_render_pass,
-                                render_frame.get_image_views(), m_extent.width,
+                                render_target.get_image_views(), m_extent.width,
                                 m_extent.height);
   }
 }
@@ -299,7 +301,7 @@ void Renderer::create_descriptors() {
     m_descriptor_sets.emplace_back(*m_device, *m_descriptor_set_layout, *m_descriptor_pool);
 
     VkDescriptorBufferInfo buffer_info{};
-    buffer_info.buffer = m_uniform_buffer->buffer->get_handle();
+    buffer_info.buffer = m_uniform_buffers[i].buffer->get_handle();
     buffer_info.offset = 0;
     buffer_info.range = sizeof(UniformMatrix);
     
@@ -317,21 +319,27 @@ void Renderer::create_descriptors() {
 
 void Renderer::create_uniform_buffer()
 {
-  m_uniform_buffer = utils::create_uniform_buffer(*m_device, sizeof(UniformMatrix));
+  // one per frame in flight, the cpu writes the next frame's matrices while the gpu still reads the previous ones
+  const auto frame_count = m_render_context->get_render_frames().size();
+  m_uniform_buffers.reserve(frame_count);
+  for (size_t i = 0; i < frame_count; i++)
+  {
+    m_uniform_buffers.emplace_back(*m_device, sizeof(UniformMatrix));
+  }
 }
 
 void Renderer::create_vertex_buffer()
 {
   auto buffer_size = sizeof(vertices[0]) * vertices.size();
   m_vertex_buffer = utils::create_vertex_buffer(*m_device, buffer_size);
-  m_vertex_buffer->upload(*m_cmd_pool, vertices.data(), buffer_size);
+  m_vertex_buffer->upload(vertices.data(), buffer_size);
 }
 
 void Renderer::create_index_buffer()
 {
   auto buffer_size = sizeof(indices[0]) * indices.size();
   m_index_buffer = utils::create_index_buffer(*m_device, buffer_size);
-  m_index_buffer->upload(*m_cmd_pool, indices.data(), buffer_size);
+  m_index_buffer->upload(indices.data(), buffer_size);
 }
 
 void Renderer::update_uniform_buffer()
@@ -347,7 +355,7 @@ void Renderer::update_uniform_buffer()
   ubo.proj = glm::perspective(glm::radians(45.0f), m_extent.width / (float) m_extent.height, 0.1f, 10.0f);
   ubo.proj[1][1] *= -1;
 
-  m_uniform_buffer->upload(&ubo, sizeof(UniformMatrix));
+  m_uniform_buffers[m_render_context->get_active_frame_index()].upload(&ubo, sizeof(UniformMatrix));
 }
 
 bool Renderer::resize() {
@@ -382,7 +390,7 @@ void Renderer::render_image()
     VkRenderPassBeginInfo render_pass_bi{};
     render_pass_bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     render_pass_bi.renderPass = m_render_pass->get_handle();
-    render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_frame_index()].get_handle();
+    render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_target_index()].get_handle();
     render_pass_bi.renderArea.offset = {0, 0};
     render_pass_bi.renderArea.extent = m_extent;
 
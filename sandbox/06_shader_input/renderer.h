@@ -80,7 +80,7 @@ private:
 
   // parameter
   // uniform buffer ...
-  std::unique_ptr<BufferData> m_uniform_buffer;
+  std::vector<UniformBuffer> m_uniform_buffers;
 
   // pipeline parameter
   std::unique_ptr<DescriptorPool> m_descriptor_pool;
@@ -59,6 +59,13 @@ const std::vector<Vertex> vertices = {
     {{-0.5f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}}
 };
 
+// the bindings of the set in layout order, the update template reads them as is
+struct DrawDescriptors
+{
+  VkDescriptorBufferInfo uniforms;
+  VkDescriptorImageInfo texture;
+};
+
 const std::vector<uint16_t> indices = {
     0, 1, 2, 2, 3, 0
 };
@@ -80,7 +87,6 @@ Renderer::Renderer() {
   create_index_buffer();
 
   create_descriptor_layout();
-  create_descriptors();
 
   create_render_pass();
   create_pipeline();
@@ -96,7 +102,7 @@ void Renderer::render_loop() {
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
       resize();
-      return;
+      continue;
     } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
       throw std::runtime_error("failed to acquire swapchain image!");
     }
@@ -146,6 +152,7 @@ void Renderer::create_device() {
   dev_exts.push_back(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
   dev_exts.push_back(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
   dev_exts.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+  dev_exts.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
 
   DeviceFeatures dev_features{};
   dev_features.request<VkPhysicalDeviceAccelerationStructureFeaturesKHR>(
@@ -155,7 +162,9 @@ void Renderer::create_device() {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT);
 
@@ -184,7 +193,9 @@ void Renderer::create_descriptor_layout()
     {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT}
   };
 
-  m_descriptor_set_layout = std::make_unique<DescriptorSetLayout>(*m_device, bindings);
+  m_descriptor_set_layout = std::make_unique<DescriptorSetLayout>(
+      *m_device, bindings, std::vector<VkDescriptorBindingFlags>{},
+      VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR);
 }
 
 void Renderer::create_render_pass() {
@@ -249,6 +260,9 @@ void Renderer::create_pipeline() {
 
   m_pipeline_layout = std::make_unique<PipelineLayout>(
       *m_device, *m_descriptor_set_layout);
+  m_update_template = std::make_unique<DescriptorUpdateTemplate>(
+      *m_device, *m_descriptor_set_layout, VK_PIPELINE_BIND_POINT_GRAPHICS,
+      m_pipeline_layout->get_handle(), 0);
 
   RasterizationState rasterization{};
   rasterization.set_cull_mode(VK_CULL_MODE_BACK_BIT)
@@ -286,60 +300,24 @@ void Renderer::create_pipeline() {
 }
 
 void Renderer::create_framebuffer() {
-  const auto &render_frames = m_render_context->get_render_frames();
-  m_framebuffers.reserve(render_frames.size());
-  for (const auto &render_frame : render_frames) {
+  const auto &render_targets = m_render_context->get_render_targets();
+  m_framebuffers.reserve(render_targets.size());
+  for (const auto &render_target : render_targets) {
     m_framebuffers.emplace_back(*m_device, *m_render_pass,
-                                render_frame.get_image_views(), m_extent.width,
+                                render_target.get_image_views(), m_extent.width,
                                 m_extent.height);
   }
 }
 
-void Renderer::create_descriptors() {
-  const auto frame_count = m_render_context->get_render_frames().size();
-
-  std::vector<VkDescriptorPoolSize> pool_sizes{
-      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, (uint32_t)frame_count},
-      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (uint32_t)frame_count}};
-  m_descriptor_pool =
-      std::make_unique<DescriptorPool>(*m_device, pool_sizes, (uint32_t)frame_count);
-
-  m_descriptor_sets.reserve(frame_count);
-  for (size_t i = 0; i < frame_count; i++) {
-    m_descriptor_sets.emplace_back(*m_device, *m_descriptor_set_layout, *m_descriptor_pool);
-
-    VkDescriptorBufferInfo buffer_info{};
-    buffer_info.buffer = m_uniform_buffer->buffer->get_handle();
-    buffer_info.offset = 0;
-    buffer_info.range = sizeof(UniformMatrix);
-
-    VkDescriptorImageInfo image_info{};
-    image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    image_info.imageView = m_texture->image_view->get_handle();
-    image_info.sampler = m_texture->sampler->get_handle();
-    
-    std::vector<VkWriteDescriptorSet> writes(2);
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].dstSet = m_descriptor_sets[i].get_handle();
-    writes[0].dstBinding = 0;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[0].descriptorCount = 1;
-    writes[0].pBufferInfo = &buffer_info;
-
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = m_descriptor_sets[i].get_handle();
-    writes[1].dstBinding = 1;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    writes[1].descriptorCount = 1;
-    writes[1].pImageInfo = &image_info;
-
-    vkUpdateDescriptorSets(m_device->get_handle(), writes.size(), writes.data(), 0, nullptr);
-  }
-}
-
 void Renderer::create_uniform_buffer()
 {
-  m_uniform_buffer = utils::create_uniform_buffer(*m_device, sizeof(UniformMatrix));
+  // one per frame in flight, the cpu writes the next frame's matrices while the gpu still reads the previous ones
+  const auto frame_count = m_render_context->get_render_frames().size();
+  m_uniform_buffers.reserve(frame_count);
+  for (size_t i = 0; i < frame_count; i++)
+  {
+    m_uniform_buffers.emplace_back(*m_device, sizeof(UniformMatrix));
+  }
 }
 
 void Renderer::create_texture()
@@ -352,26 +330,22 @@ void Renderer::create_texture()
   }
 
   m_texture = std::make_unique<Texture>(*m_device, VkExtent2D{256, 256}, VK_FORMAT_R8G8B8A8_UNORM);
-  m_texture->upload(*m_cmd_pool, texture.data(), 256 * 256 * sizeof(glm::u8vec4));
-
-  auto &queue = m_device->get_queue(m_queue_family_index, 0);
-  utils::submit_commands_to_queue(*m_cmd_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-      m_texture->image->set_layout(cmd_buffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-  });
+  // lands in SHADER_READ_ONLY_OPTIMAL, the first render waits for it
+  m_texture->upload(texture.data(), 256 * 256 * sizeof(glm::u8vec4));
 }
 
 void Renderer::create_vertex_buffer()
 {
   auto buffer_size = sizeof(vertices[0]) * vertices.size();
   m_vertex_buffer = utils::create_vertex_buffer(*m_device, buffer_size);
-  m_vertex_buffer->upload(*m_cmd_pool, vertices.data(), buffer_size);
+  m_vertex_buffer->upload(vertices.data(), buffer_size);
 }
 
 void Renderer::create_index_buffer()
 {
   auto buffer_size = sizeof(indices[0]) * indices.size();
   m_index_buffer = utils::create_index_buffer(*m_device, buffer_size);
-  m_index_buffer->upload(*m_cmd_pool, indices.data(), buffer_size);
+  m_index_buffer->upload(indices.data(), buffer_size);
 }
 
 void Renderer::update_uniform_buffer()
@@ -387,7 +361,7 @@ void Renderer::update_uniform_buffer()
   ubo.proj = glm::perspective(glm::radians(45.0f), m_extent.width / (float) m_extent.height, 0.1f, 10.0f);
   ubo.proj[1][1] *= -1;
 
-  m_uniform_buffer->upload(&ubo, sizeof(UniformMatrix));
+  m_uniform_buffers[m_render_context->get_active_frame_index()].upload(&ubo, sizeof(UniformMatrix));
 }
 
 bool Renderer::resize() {
@@ -422,7 +396,7 @@ void Renderer::render_image()
     VkRenderPassBeginInfo render_pass_bi{};
     render_pass_bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     render_pass_bi.renderPass = m_render_pass->get_handle();
-    render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_frame_index()].get_handle();
+    render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_target_index()].get_handle();
     render_pass_bi.renderArea.offset = {0, 0};
     render_pass_bi.renderArea.extent = m_extent;
 
@@ -436,9 +410,15 @@ void Renderer::render_image()
 
     cmd_buffer.bind_pipeline(*m_graphic_pipeline);
 
-    cmd_buffer.bind_descriptor_set(
-        VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_layout->get_handle(),
-        m_descriptor_sets[m_render_context->get_active_frame_index()].get_handle());
+    DrawDescriptors descriptors{};
+    descriptors.uniforms.buffer =
+        m_uniform_buffers[m_render_context->get_active_frame_index()].buffer->get_handle();
+    descriptors.uniforms.offset = 0;
+    descriptors.uniforms.range = sizeof(UniformMatrix);
+    descriptors.texture.sampler = m_texture->sampler->get_handle();
+    descriptors.texture.imageView = m_texture->image_view->get_handle();
+    descriptors.texture.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    cmd_buffer.push_descriptor_set(*m_update_template, &descriptors);
 
     VkViewport viewport{};
     viewport.x = 0.0f;
@@ -9,6 +9,7 @@
 #include "prism/vulkan/descriptor_pool.h"
 #include "prism/vulkan/descriptor_set.h"
 #include "prism/vulkan/descriptor_set_layout.h"
+#include "prism/vulkan/descriptor_update_template.h"
 #include "prism/vulkan/device.h"
 #include "prism/vulkan/fence.h"
 #include "prism/vulkan/graphics_pipeline.h"
@@ -52,7 +53,6 @@ private:
   void create_uniform_buffer();
   void update_uniform_buffer();
 
-  void create_descriptors();
 
   void create_vertex_buffer();
   void create_index_buffer();
@@ -85,11 +85,7 @@ private:
   // parameter
   // uniform buffer ...
   std::unique_ptr<Texture> m_texture;
-  std::unique_ptr<BufferData> m_uniform_buffer;
-
-  // pipeline parameter
-  std::unique_ptr<DescriptorPool> m_descriptor_pool;
-  std::vector<DescriptorSet> m_descriptor_sets;
+  std::vector<UniformBuffer> m_uniform_buffers;
 
   std::unique_ptr<RenderPass> m_render_pass;
   std::vector<Framebuffer> m_framebuffers;
@@ -97,5 +93,7 @@ private:
   // pipeline
   std::unique_ptr<DescriptorSetLayout> m_descriptor_set_layout;
   std::unique_ptr<PipelineLayout> m_pipeline_layout;
+  // pushes the uniform buffer and the texture with each draw, no sets
+  std::unique_ptr<DescriptorUpdateTemplate> m_update_template;
   std::unique_ptr<GraphicsPipeline> m_graphic_pipeline;
 };
\ No newline at end of file
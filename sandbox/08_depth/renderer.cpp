@@ -64,6 +64,8 @@ const std::vector<Vertex> vertices = {
     {{-0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}}
 };
 
+static const VkFormat DEPTH_FORMAT = VK_FORMAT_D16_UNORM;
+
 const std::vector<uint16_t> indices = {
     0, 1, 2, 2, 3, 0,
     4, 5, 6, 6, 7, 4
@@ -78,16 +80,15 @@ Renderer::Renderer() {
 
   create_render_context();
 
+  create_bindless_table();
   create_texture();
 
-  create_uniform_buffer();
-
   create_vertex_buffer();
   create_index_buffer();
 
   create_descriptor_layout();
-  create_descriptors();
 
+  create_render_graph();
   create_render_pass();
   create_pipeline();
   create_framebuffer();
@@ -102,11 +103,16 @@ void Renderer::render_loop() {
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
       resize();
-      return;
+      continue;
     } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
       throw std::runtime_error("failed to acquire swapchain image!");
     }
 
+    // the frame's fence has been waited on, pipelines recompiled since the
+    // last frame are bound from this one on
+    m_shader_reloader->update();
+    m_bindless_table->update();
+
     update_uniform_buffer();
     render_image();
 
@@ -160,8 +166,25 @@ void Renderer::create_device() {
   dev_features.request<VkPhysicalDeviceRayQueryFeaturesKHR>(
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
       &VkPhysicalDeviceRayQueryFeaturesKHR::rayQuery);
+  // the bindless table
+  for (auto member : {&VkPhysicalDeviceDescriptorIndexingFeatures::runtimeDescriptorArray,
+                      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingPartiallyBound,
+                      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingVariableDescriptorCount,
+                      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingUpdateUnusedWhilePending,
+                      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingSampledImageUpdateAfterBind,
+                      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingStorageImageUpdateAfterBind,
+                      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingStorageBufferUpdateAfterBind}) {
+    dev_features.request<VkPhysicalDeviceDescriptorIndexingFeatures>(
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES, member);
+  }
+  // shaders index the arrays with a push constant
+  dev_features.request(&VkPhysicalDeviceFeatures::shaderSampledImageArrayDynamicIndexing);
+  dev_features.request(&VkPhysicalDeviceFeatures::shaderStorageImageArrayDynamicIndexing);
+  dev_features.request(&VkPhysicalDeviceFeatures::shaderStorageBufferArrayDynamicIndexing);
   m_device = std::make_unique<Device>(m_instance->pick_physical_device(),
-                                      dev_exts, dev_features);
+                                      dev_exts, dev_features,
+                                      MemoryAllocator::Backend::Vma,
+                                      PIPELINE_CACHE_PATH);
   m_queue_family_index = m_device->get_physical_device().get_queue_family_index(
       VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT);
 
@@ -181,15 +204,36 @@ void Renderer::create_render_context() {
   m_render_context = std::make_unique<RenderContext>(*m_window, *m_surface,
                                                      *m_device,
                                                      m_device->get_queue(m_queue_family_index, 0));
+}
+
+void Renderer::create_render_graph() {
+  m_render_graph = std::make_unique<RenderGraph>(*m_device);
+
+  RenderGraph::ImageDesc depth_desc{};
+  depth_desc.extent = {m_extent.width, m_extent.height, 1};
+  depth_desc.format = DEPTH_FORMAT;
+  m_depth = m_render_graph->create_image("depth", depth_desc);
+
+  // the swapchain image is transitioned by the render pass, presenting it makes the pass a side effect
+  m_render_graph->add_pass("forward")
+      .write(m_depth, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+             VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+             VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT)
+      .set_side_effect()
+      .set_execute([this](const CommandBuffer &cmd_buffer) { draw(cmd_buffer); });
+
+  m_render_graph->compile();
 
-  m_depth_attachment = std::make_unique<DepthAttachment>(*m_device, m_extent, VK_FORMAT_D16_UNORM);
+  const auto &statistics = m_render_graph->get_statistics();
+  LOG_INFO("render graph: {} passes, {} culled, {} transient images, {} transient buffers, {} bytes aliased into {} bytes",
+           statistics.pass_count, statistics.culled_pass_count, statistics.transient_image_count,
+           statistics.transient_buffer_count, statistics.unaliased_bytes, statistics.transient_bytes);
 }
 
 void Renderer::create_descriptor_layout()
 {
   DescriptorSetLayout::Bindings bindings{
-    {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT},
-    {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT}
+    {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT}
   };
 
   m_descriptor_set_layout = std::make_unique<DescriptorSetLayout>(*m_device, bindings);
@@ -204,11 +248,12 @@ void Renderer::create_render_pass() {
   attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
   attachments[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
-  attachments[1].format = m_depth_attachment->format;
+  // the render graph has the depth buffer in its layout before the pass begins
+  attachments[1].format = DEPTH_FORMAT;
   attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
   attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
   attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
   attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
   auto color_attachment_ref = AttachmentReference{};
@@ -238,133 +283,97 @@ void Renderer::create_render_pass() {
 }
 
 void Renderer::create_pipeline() {
-  auto vert_module = ShaderModule(*m_device, "../shaders/shader.vert.spv",
-                                  VK_SHADER_STAGE_VERTEX_BIT);
-  auto frag_module = ShaderModule(*m_device, "../shaders/shader.frag.spv",
-                                  VK_SHADER_STAGE_FRAGMENT_BIT);
-
-  std::vector<ShaderStage> shader_stages(2);
-  shader_stages[0]
-      .set_stage(vert_module.get_stage())
-      .set_module(vert_module)
-      .set_entry_point(vert_module.get_entry_point());
-
-  shader_stages[1]
-      .set_stage(frag_module.get_stage())
-      .set_module(frag_module)
-      .set_entry_point(frag_module.get_entry_point());
-
-  std::vector<VkPipelineColorBlendAttachmentState> color_blend_attachments(1);
-  color_blend_attachments[0].colorWriteMask =
-      VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-      VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-  color_blend_attachments[0].blendEnable = VK_FALSE;
-  ColorBlendState color_blend_state{};
-  color_blend_state.set_attachments(color_blend_attachments);
-
-  std::vector<VkDynamicState> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
-                                                VK_DYNAMIC_STATE_SCISSOR};
-  DynamicState dynamic_state{};
-  dynamic_state.set_dynamic_states(dynamic_states);
-
+  // set 1 is the bindless table, the push constant selects the texture
   m_pipeline_layout = std::make_unique<PipelineLayout>(
-      *m_device, *m_descriptor_set_layout);
-
-  RasterizationState rasterization{};
-  rasterization.set_cull_mode(VK_CULL_MODE_BACK_BIT)
-      .set_front_face(VK_FRONT_FACE_COUNTER_CLOCKWISE)
-      .set_polygon_mode(VK_POLYGON_MODE_FILL)
-      .set_line_width(1.0f)
-      .set_rasterizer_discard_enable(VK_FALSE);
-
-  auto binding_descriptions = Vertex::getBindingDescription();
-  auto attribute_descriptions = Vertex::getAttributeDescriptions();
-
-  VertexInputState vertex_input_state{};
-  vertex_input_state.set_binding_descriptions(binding_descriptions)
-      .set_attribute_descriptions(attribute_descriptions);
-
-  InputAssemblyState input_assembly{};
-  input_assembly.set_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-
-  GraphicsPipelineCreateInfo pipeline_ci{};
-  pipeline_ci.set_shader_stages(shader_stages)
-      .set_layout(*m_pipeline_layout)
-      .set_render_pass(*m_render_pass)
-      .set_subpass(0)
-      .set_color_blend_state(color_blend_state)
-      .set_dynamic_state(dynamic_state)
-      .set_tesellation_state(TessellationState{})
-      .set_input_assembly_state(input_assembly)
-      .set_depth_stencil_state(DepthStencilState{})
-      .set_multisample_state(MultisampleState{})
-      .set_rasterization_state(rasterization)
-      .set_viewport_state(ViewportState{})
-      .set_vertex_input_state(vertex_input_state);
-  m_graphic_pipeline =
-      std::make_unique<GraphicsPipeline>(*m_device, pipeline_ci);
+      *m_device,
+      std::vector<const DescriptorSetLayout *>{m_descriptor_set_layout.get(),
+                                               &m_bindless_table->get_layout()},
+      std::vector<VkPushConstantRange>{
+          {VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uint32_t)}});
+
+  m_shader_compiler = std::make_unique<ShaderCompiler>();
+  m_shader_reloader = std::make_unique<ShaderReloader>(
+      *m_device, *m_shader_compiler,
+      m_render_context->get_render_frames().size());
+
+  std::vector<ShaderReloader::Stage> stages{
+      {PROJECT_FOLDER "/shaders/shader.vert.glsl", VK_SHADER_STAGE_VERTEX_BIT},
+      {PROJECT_FOLDER "/shaders/shader.frag.glsl", VK_SHADER_STAGE_FRAGMENT_BIT}};
+
+  // everything the pipeline is made from besides the modules outlives the
+  // reloader
+  m_graphic_pipeline = m_shader_reloader->add<GraphicsPipeline>(
+      stages, [this](const std::vector<ShaderModule> &modules) {
+    std::vector<ShaderStage> shader_stages(modules.size());
+    for (size_t i = 0; i < modules.size(); ++i) {
+      shader_stages[i]
+          .set_stage(modules[i].get_stage())
+          .set_module(modules[i])
+          .set_entry_point(modules[i].get_entry_point());
+    }
+
+    std::vector<VkPipelineColorBlendAttachmentState> color_blend_attachments(1);
+    color_blend_attachments[0].colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    color_blend_attachments[0].blendEnable = VK_FALSE;
+    ColorBlendState color_blend_state{};
+    color_blend_state.set_attachments(color_blend_attachments);
+
+    std::vector<VkDynamicState> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                  VK_DYNAMIC_STATE_SCISSOR};
+    DynamicState dynamic_state{};
+    dynamic_state.set_dynamic_states(dynamic_states);
+
+    RasterizationState rasterization{};
+    rasterization.set_cull_mode(VK_CULL_MODE_BACK_BIT)
+        .set_front_face(VK_FRONT_FACE_COUNTER_CLOCKWISE)
+        .set_polygon_mode(VK_POLYGON_MODE_FILL)
+        .set_line_width(1.0f)
+        .set_rasterizer_discard_enable(VK_FALSE);
+
+    auto binding_descriptions = Vertex::getBindingDescription();
+    auto attribute_descriptions = Vertex::getAttributeDescriptions();
+
+    VertexInputState vertex_input_state{};
+    vertex_input_state.set_binding_descriptions(binding_descriptions)
+        .set_attribute_descriptions(attribute_descriptions);
+
+    InputAssemblyState input_assembly{};
+    input_assembly.set_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+
+    GraphicsPipelineCreateInfo pipeline_ci{};
+    pipeline_ci.set_shader_stages(shader_stages)
+        .set_layout(*m_pipeline_layout)
+        .set_render_pass(*m_render_pass)
+        .set_subpass(0)
+        .set_color_blend_state(color_blend_state)
+        .set_dynamic_state(dynamic_state)
+        .set_tesellation_state(TessellationState{})
+        .set_input_assembly_state(input_assembly)
+        .set_depth_stencil_state(DepthStencilState{})
+        .set_multisample_state(MultisampleState{})
+        .set_rasterization_state(rasterization)
+        .set_viewport_state(ViewportState{})
+        .set_vertex_input_state(vertex_input_state);
+    return GraphicsPipeline(*m_device, pipeline_ci);
+  });
 }
 
 void Renderer::create_framebuffer() {
-  const auto &render_frames = m_render_context->get_render_frames();
-  m_framebuffers.reserve(render_frames.size());
-  for (const auto &render_frame : render_frames) {
+  const auto &render_targets = m_render_context->get_render_targets();
+  m_framebuffers.reserve(render_targets.size());
+  for (const auto &render_target : render_targets) {
     m_framebuffers.emplace_back(*m_device, *m_render_pass,
-                                render_frame.get_image_views(), *m_depth_attachment->image_view, m_extent.width,
+                                render_target.get_image_views(), m_render_graph->get_image_view(m_depth), m_extent.width,
                                 m_extent.height);
   }
 }
 
-void Renderer::create_descriptors() {
-  const auto frame_count = m_render_context->get_render_frames().size();
-
-  std::vector<VkDescriptorPoolSize> pool_sizes{
-      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, (uint32_t)frame_count},
-      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (uint32_t)frame_count}};
-  m_descriptor_pool =
-      std::make_unique<DescriptorPool>(*m_device, pool_sizes, (uint32_t)frame_count);
-
-  m_descriptor_sets.reserve(frame_count);
-  for (size_t i = 0; i < frame_count; i++) {
-    m_descriptor_sets.emplace_back(*m_device, *m_descriptor_set_layout, *m_descriptor_pool);
-
-    VkDescriptorBufferInfo buffer_info{};
-    buffer_info.buffer = m_uniform_buffers[i].buffer->get_handle();
-    buffer_info.offset = 0;
-    buffer_info.range = sizeof(UniformMatrix);
-
-    VkDescriptorImageInfo image_info{};
-    image_info.imageLayout = m_texture->image->get_layout();
-    image_info.imageView = m_texture->image_view->get_handle();
-    image_info.sampler = m_texture->sampler->get_handle();
-    
-    std::vector<VkWriteDescriptorSet> writes(2);
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].dstSet = m_descriptor_sets[i].get_handle();
-    writes[0].dstBinding = 0;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[0].descriptorCount = 1;
-    writes[0].pBufferInfo = &buffer_info;
-
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = m_descriptor_sets[i].get_handle();
-    writes[1].dstBinding = 1;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    writes[1].descriptorCount = 1;
-    writes[1].pImageInfo = &image_info;
-
-    vkUpdateDescriptorSets(m_device->get_handle(), writes.size(), writes.data(), 0, nullptr);
-  }
-}
-
-void Renderer::create_uniform_buffer()
+void Renderer::create_bindless_table()
 {
-  const auto frame_count = m_render_context->get_render_frames().size();
-  m_uniform_buffers.reserve(frame_count);
-  for (size_t i = 0; i < frame_count; i++)
-  {
-    m_uniform_buffers.emplace_back(*m_device, sizeof(UniformMatrix));
-  }
+  m_bindless_table = std::make_unique<BindlessTable>(
+      *m_device, m_render_context->get_render_frames().size());
 }
 
 void Renderer::create_texture()
@@ -377,26 +386,26 @@ void Renderer::create_texture()
   }
 
   m_texture = std::make_unique<Texture>(*m_device, VkExtent2D{256, 256}, VK_FORMAT_R8G8B8A8_UNORM);
-  m_texture->upload(*m_cmd_pool, texture.data(), 256 * 256 * sizeof(glm::u8vec4));
+  // lands in SHADER_READ_ONLY_OPTIMAL, the first render waits for it
+  m_texture->upload(texture.data(), 256 * 256 * sizeof(glm::u8vec4));
 
-  auto &queue = m_device->get_queue(m_queue_family_index, 0);
-  utils::submit_commands_to_queue(*m_cmd_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-      m_texture->image->set_layout(cmd_buffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-  });
+  m_texture_handle = m_bindless_table->add_sampled_image(
+      m_texture->image_view->get_handle(), m_texture->sampler->get_handle(),
+      m_texture->image->get_layout());
 }
 
 void Renderer::create_vertex_buffer()
 {
   auto buffer_size = sizeof(vertices[0]) * vertices.size();
   m_vertex_buffer = utils::create_vertex_buffer(*m_device, buffer_size);
-  m_vertex_buffer->upload(*m_cmd_pool, vertices.data(), buffer_size);
+  m_vertex_buffer->upload(vertices.data(), buffer_size);
 }
 
 void Renderer::create_index_buffer()
 {
   auto buffer_size = sizeof(indices[0]) * indices.size();
   m_index_buffer = utils::create_index_buffer(*m_device, buffer_size);
-  m_index_buffer->upload(*m_cmd_pool, indices.data(), buffer_size);
+  m_index_buffer->upload(indices.data(), buffer_size);
 }
 
 void Renderer::update_uniform_buffer()
@@ -412,7 +421,7 @@ void Renderer::update_uniform_buffer()
   ubo.proj = glm::perspective(glm::radians(45.0f), m_extent.width / (float) m_extent.height, 0.1f, 10.0f);
   ubo.proj[1][1] *= -1;
 
-  m_uniform_buffers[m_render_context->get_active_frame_index()].upload(&ubo, sizeof(UniformMatrix));
+  m_uniforms = m_render_context->get_active_frame().get_linear_allocator().push(ubo);
 }
 
 bool Renderer::resize() {
@@ -430,6 +439,7 @@ bool Renderer::resize() {
 
   m_render_context->update(m_extent);
 
+  create_render_graph();
   create_framebuffer();
 
   return true;
@@ -442,53 +452,78 @@ void Renderer::render_image()
   auto &cmd_buffer = frame.request_command_buffer(queue);
 
   auto record_func = [&](const CommandBuffer &cmd_buffer) -> void {
-      // record command buffer
-    // render pass begin
-    VkRenderPassBeginInfo render_pass_bi{};
-    render_pass_bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    render_pass_bi.renderPass = m_render_pass->get_handle();
-    render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_frame_index()].get_handle();
-    render_pass_bi.renderArea.offset = {0, 0};
-    render_pass_bi.renderArea.extent = m_extent;
-
-    std::array<VkClearValue, 2> clear_values{};
-    clear_values[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
-    clear_values[1].color = {1.0f, 0};
-
-    render_pass_bi.clearValueCount = clear_values.size();
-    render_pass_bi.pClearValues = clear_values.data();
-
-    cmd_buffer.begin_render_pass(render_pass_bi, VK_SUBPASS_CONTENTS_INLINE);
-
-    cmd_buffer.bind_pipeline(*m_graphic_pipeline);
-
-    cmd_buffer.bind_descriptor_set(
-        VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_layout->get_handle(),
-        m_descriptor_sets[m_render_context->get_active_frame_index()].get_handle());
-
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(m_extent.width);
-    viewport.height = static_cast<float>(m_extent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    cmd_buffer.set_viewport(viewport);
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = m_extent;
-    cmd_buffer.set_scissor(scissor);
-
-    cmd_buffer.bind_vertex_buffer(0, *m_vertex_buffer->buffer, 0);
-
-    cmd_buffer.bind_index_buffer(*m_index_buffer->buffer, 0, VK_INDEX_TYPE_UINT16);
-
-    cmd_buffer.draw_indexed(indices.size(), 1, 0, 0, 0);
-
-    cmd_buffer.end_render_pass();
-
+    m_render_graph->execute(cmd_buffer);
   };
 
   m_render_context->render(cmd_buffer, record_func);
 }
+
+void Renderer::draw(const CommandBuffer &cmd_buffer)
+{
+  // render pass begin
+  VkRenderPassBeginInfo render_pass_bi{};
+  render_pass_bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  render_pass_bi.renderPass = m_render_pass->get_handle();
+  render_pass_bi.framebuffer = m_framebuffers[m_render_context->get_active_target_index()].get_handle();
+  render_pass_bi.renderArea.offset = {0, 0};
+  render_pass_bi.renderArea.extent = m_extent;
+
+  std::array<VkClearValue, 2> clear_values{};
+  clear_values[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
+  clear_values[1].color = {1.0f, 0};
+
+  render_pass_bi.clearValueCount = clear_values.size();
+  render_pass_bi.pClearValues = clear_values.data();
+
+  cmd_buffer.begin_render_pass(render_pass_bi, VK_SUBPASS_CONTENTS_INLINE);
+
+  cmd_buffer.bind_pipeline(m_graphic_pipeline.get());
+
+  // allocated from the frame's pools, recycled once the frame is reused. the
+  // set only names the allocator's buffer, every object drawn from it shares
+  // the set with its own dynamic offset
+  DescriptorBuffer uniform_buffer{};
+  uniform_buffer.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  uniform_buffer.binding = 0;
+  uniform_buffer.info.set_buffer(m_uniforms.buffer)
+      .set_offset(0)
+      .set_range(sizeof(UniformMatrix));
+  auto descriptor_set = m_render_context->get_active_frame()
+                            .get_descriptor_allocator()
+                            .request(*m_descriptor_set_layout, {uniform_buffer});
+
+  auto dynamic_offset = m_uniforms.get_dynamic_offset();
+  cmd_buffer.bind_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                 m_pipeline_layout->get_handle(),
+                                 descriptor_set, 0, 1, &dynamic_offset);
+
+  cmd_buffer.bind_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                 m_pipeline_layout->get_handle(),
+                                 m_bindless_table->get_handle(), 1);
+
+  cmd_buffer.push_constants(m_pipeline_layout->get_handle(),
+                            VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                            sizeof(m_texture_handle), &m_texture_handle);
+
+  VkViewport viewport{};
+  viewport.x = 0.0f;
+  viewport.y = 0.0f;
+  viewport.width = static_cast<float>(m_extent.width);
+  viewport.height = static_cast<float>(m_extent.height);
+  viewport.minDepth = 0.0f;
+  viewport.maxDepth = 1.0f;
+  cmd_buffer.set_viewport(viewport);
+
+  VkRect2D scissor{};
+  scissor.offset = {0, 0};
+  scissor.extent = m_extent;
+  cmd_buffer.set_scissor(scissor);
+
+  cmd_buffer.bind_vertex_buffer(0, *m_vertex_buffer->buffer, 0);
+
+  cmd_buffer.bind_index_buffer(*m_index_buffer->buffer, 0, VK_INDEX_TYPE_UINT16);
+
+  cmd_buffer.draw_indexed(indices.size(), 1, 0, 0, 0);
+
+  cmd_buffer.end_render_pass();
+}
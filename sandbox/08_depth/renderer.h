@@ -3,6 +3,7 @@
 #include "prism/platform/window.h"
 #include "prism/rendering/buffer_data.h"
 #include "prism/rendering/image_data.h"
+#include "prism/vulkan/bindless_table.h"
 #include "prism/vulkan/command_buffer.h"
 #include "prism/vulkan/command_pool.h"
 #include "prism/vulkan/descriptor_pool.h"
@@ -18,6 +19,8 @@
 #include "prism/vulkan/framebuffer.h"
 
 #include "prism/rendering/render_context.h"
+#include "prism/rendering/render_graph.h"
+#include "prism/rendering/shader_reloader.h"
 
 
 using namespace prism;
@@ -37,19 +40,18 @@ private:
   void create_command_pool();
 
   void create_render_context();
+  void create_render_graph();
 
   void create_descriptor_layout();
   void create_render_pass();
   void create_pipeline();
   void create_framebuffer();
 
+  void create_bindless_table();
   void create_texture();
 
-  void create_uniform_buffer();
   void update_uniform_buffer();
 
-  void create_descriptors();
-
   void create_vertex_buffer();
   void create_index_buffer();
   
@@ -57,6 +59,8 @@ private:
 
   void render_image();
 
+  void draw(const CommandBuffer &cmd_buffer);
+
 private:
   VkExtent2D m_extent = {800, 800};
 
@@ -71,7 +75,10 @@ private:
   std::unique_ptr<CommandPool> m_cmd_pool;
 
   std::unique_ptr<RenderContext> m_render_context;
-  std::unique_ptr<DepthAttachment> m_depth_attachment;
+
+  // owns the depth buffer as a transient attachment
+  std::unique_ptr<RenderGraph> m_render_graph;
+  RenderGraph::ImageHandle m_depth;
 
   uint32_t m_queue_family_index;
 
@@ -82,11 +89,13 @@ private:
   // parameter
   // uniform buffer ...
   std::unique_ptr<Texture> m_texture;
-  std::vector<UniformBuffer> m_uniform_buffers;
+  BindlessTable::Handle m_texture_handle = BindlessTable::INVALID_HANDLE;
+  // this frame's matrices in the frame's linear allocator
+  LinearAllocator::Allocation m_uniforms;
 
   // pipeline parameter
-  std::unique_ptr<DescriptorPool> m_descriptor_pool;
-  std::vector<DescriptorSet> m_descriptor_sets;
+  // textures are indexed by handle, the table is bound once per frame
+  std::unique_ptr<BindlessTable> m_bindless_table;
 
   std::unique_ptr<RenderPass> m_render_pass;
   std::vector<Framebuffer> m_framebuffers;
@@ -94,5 +103,8 @@ private:
   // pipeline
   std::unique_ptr<DescriptorSetLayout> m_descriptor_set_layout;
   std::unique_ptr<PipelineLayout> m_pipeline_layout;
-  std::unique_ptr<GraphicsPipeline> m_graphic_pipeline;
+  // rebuilt in the background when the shaders are saved
+  std::unique_ptr<ShaderCompiler> m_shader_compiler;
+  std::unique_ptr<ShaderReloader> m_shader_reloader;
+  ShaderReloader::Handle<GraphicsPipeline> m_graphic_pipeline;
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "prism/bvh/bottom_level_bvh.h"
+
+#include <cstring>
+
+#include "prism/bvh/traversal.h"
+#include "prism/bvh/traversal_avx2.h"
+
+using namespace prism;
+
+namespace
+{
+  glm::vec3 transform_point(const VkTransformMatrixKHR &transform, const glm::vec3 &point)
+  {
+    glm::vec3 result;
+    for (int row = 0; row < 3; ++row)
+    {
+      const auto *m = transform.matrix[row];
+      result[row] = m[0] * point.x + m[1] * point.y + m[2] * point.z + m[3];
+    }
+    return result;
+  }
+}
+
+BottomLevelBvh::BottomLevelBvh(const std::vector<Geometry> &geometries, ThreadPool *thread_pool)
+{
+  std::vector<Triangle> triangles;
+  std::vector<Aabb> bounds;
+
+  for (uint32_t geometry_index = 0; geometry_index < geometries.size(); ++geometry_index)
+  {
+    const auto &geometry = geometries[geometry_index];
+    if (geometry.index_data != nullptr && geometry.index_count == 0)
+    {
+      throw std::runtime_error("Indexed geometry needs an index count.");
+    }
+
+    const auto *vertices = static_cast<const uint8_t *>(geometry.vertex_data);
+    const auto *indices = geometry.index_data;
+    const auto *transform = geometry.transform;
+    auto stride = geometry.vertex_stride == 0 ? sizeof(glm::vec3) : geometry.vertex_stride;
+
+    auto vertex = [&](uint32_t index) {
+      if (index >= geometry.vertex_count)
+      {
+        throw std::runtime_error("Triangle index " + std::to_string(index) + " is out of range of the vertices.");
+      }
+
+      glm::vec3 position;
+      std::memcpy(&position, vertices + index * stride, sizeof(position));
+      return transform == nullptr ? position : transform_point(*transform, position);
+    };
+
+    auto primitive_count = (indices == nullptr ? geometry.vertex_count : geometry.index_count) / 3;
+    triangles.reserve(triangles.size() + primitive_count);
+    bounds.reserve(bounds.size() + primitive_count);
+
+    for (uint32_t primitive_index = 0; primitive_index < primitive_count; ++primitive_index)
+    {
+      glm::vec3 v[3];
+      for (uint32_t i = 0; i < 3; ++i)
+      {
+        auto index = 3 * primitive_index + i;
+        v[i] = vertex(indices == nullptr ? index : indices[index]);
+      }
+
+      triangles.push_back({v[0], v[1] - v[0], v[2] - v[0], primitive_index, geometry_index});
+
+      Aabb aabb{};
+      aabb.extend(v[0]);
+      aabb.extend(v[1]);
+      aabb.extend(v[2]);
+      bounds.push_back(aabb);
+    }
+  }
+
+  m_bvh = WideBvh(bounds, thread_pool);
+
+  m_triangles.reserve(triangles.size());
+  for (auto index : m_bvh.get_primitive_indices())
+  {
+    m_triangles.push_back(triangles[index]);
+  }
+}
+
+bool BottomLevelBvh::intersect(const Ray &ray, RayHit &hit, Traversal traversal) const
+{
+  if (use_avx2(traversal))
+  {
+    return avx2::intersect(*this, ray, hit);
+  }
+
+  auto t_max = std::min(ray.t_max, hit.t);
+  bool found = false;
+
+  traverse(m_bvh, ray, t_max, [&](uint32_t first, uint32_t count) {
+    for (auto i = first; i < first + count; ++i)
+    {
+      if (intersect_triangle(m_triangles[i], ray, t_max, hit))
+      {
+        t_max = hit.t;
+        found = true;
+      }
+    }
+  });
+
+  return found;
+}
+
+void BottomLevelBvh::intersect(const RayPacket &packet, RayPacketHit &hit, Traversal traversal) const
+{
+  if (use_avx2(traversal))
+  {
+    avx2::intersect(*this, packet, hit);
+    return;
+  }
+
+  for (uint32_t lane = 0; lane < RayPacket::SIZE; ++lane)
+  {
+    auto lane_hit = hit.get(lane);
+    if (intersect(packet.get(lane), lane_hit, Traversal::Scalar))
+    {
+      hit.set(lane, lane_hit);
+    }
+  }
+}
+
+const WideBvh &BottomLevelBvh::get_bvh() const
+{
+  return m_bvh;
+}
+
+const std::vector<BottomLevelBvh::Triangle> &BottomLevelBvh::get_triangles() const
+{
+  return m_triangles;
+}
+
+const Aabb &BottomLevelBvh::get_bounds() const
+{
+  return m_bvh.get_bounds();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "prism/bvh/wide_bvh.h"
+
+namespace prism
+{
+  // the software counterpart of a bottom level acceleration structure, built on the cpu from triangle meshes in host
+  // memory. the data is copied, it does not have to outlive the build
+  class BottomLevelBvh
+  {
+  public:
+    // the host side of AccelerationStructureGeometry::Triangles, positions are the first three floats of a vertex
+    struct Geometry
+    {
+      const void *vertex_data{nullptr};
+      uint32_t vertex_count{0};
+      // 0 for tightly packed positions
+      size_t vertex_stride{0};
+      // three per triangle, null for a triangle list without indices
+      const uint32_t *index_data{nullptr};
+      uint32_t index_count{0};
+      const VkTransformMatrixKHR *transform{nullptr};
+    };
+
+    // v0 and the two edges from it, as the intersection test wants them
+    struct Triangle
+    {
+      glm::vec3 v0;
+      glm::vec3 e1;
+      glm::vec3 e2;
+      uint32_t primitive_index;
+      uint32_t geometry_index;
+    };
+
+  public:
+    BottomLevelBvh(const std::vector<Geometry> &geometries, ThreadPool *thread_pool = nullptr);
+
+    BottomLevelBvh(const BottomLevelBvh &) = delete;
+
+    BottomLevelBvh(BottomLevelBvh &&) = default;
+
+    ~BottomLevelBvh() = default;
+
+    BottomLevelBvh &operator=(const BottomLevelBvh &) = delete;
+
+    BottomLevelBvh &operator=(BottomLevelBvh &&) = default;
+
+    // hits closer than hit.t replace it, returns whether one did
+    bool intersect(const Ray &ray, RayHit &hit, Traversal traversal = Traversal::Auto) const;
+
+    void intersect(const RayPacket &packet, RayPacketHit &hit, Traversal traversal = Traversal::Auto) const;
+
+    const WideBvh &get_bvh() const;
+
+    // in bvh order
+    const std::vector<Triangle> &get_triangles() const;
+
+    const Aabb &get_bounds() const;
+
+  private:
+    WideBvh m_bvh;
+
+    std::vector<Triangle> m_triangles;
+
+  }; // class BottomLevelBvh
+
+} // namespace prism
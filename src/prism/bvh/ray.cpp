@@ -0,0 +1,90 @@
+#include "prism/bvh/ray.h"
+
+#include "prism/bvh/traversal_avx2.h"
+
+#if defined(PRISM_BVH_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace prism;
+
+void RayPacket::set(uint32_t lane, const Ray &ray)
+{
+  origin_x[lane] = ray.origin.x;
+  origin_y[lane] = ray.origin.y;
+  origin_z[lane] = ray.origin.z;
+  direction_x[lane] = ray.direction.x;
+  direction_y[lane] = ray.direction.y;
+  direction_z[lane] = ray.direction.z;
+  t_min[lane] = ray.t_min;
+  t_max[lane] = ray.t_max;
+}
+
+Ray RayPacket::get(uint32_t lane) const
+{
+  Ray ray{};
+  ray.origin = {origin_x[lane], origin_y[lane], origin_z[lane]};
+  ray.direction = {direction_x[lane], direction_y[lane], direction_z[lane]};
+  ray.t_min = t_min[lane];
+  ray.t_max = t_max[lane];
+  return ray;
+}
+
+RayPacketHit::RayPacketHit()
+{
+  for (uint32_t lane = 0; lane < RayPacket::SIZE; ++lane)
+  {
+    set(lane, RayHit{});
+  }
+}
+
+void RayPacketHit::set(uint32_t lane, const RayHit &hit)
+{
+  t[lane] = hit.t;
+  u[lane] = hit.u;
+  v[lane] = hit.v;
+  primitive_index[lane] = hit.primitive_index;
+  geometry_index[lane] = hit.geometry_index;
+  instance_index[lane] = hit.instance_index;
+  instance_custom_index[lane] = hit.instance_custom_index;
+}
+
+RayHit RayPacketHit::get(uint32_t lane) const
+{
+  RayHit hit{};
+  hit.t = t[lane];
+  hit.u = u[lane];
+  hit.v = v[lane];
+  hit.primitive_index = primitive_index[lane];
+  hit.geometry_index = geometry_index[lane];
+  hit.instance_index = instance_index[lane];
+  hit.instance_custom_index = instance_custom_index[lane];
+  return hit;
+}
+
+bool prism::has_avx2()
+{
+#if !defined(PRISM_BVH_AVX2)
+  return false;
+#elif defined(_MSC_VER)
+  static const bool supported = []() {
+    int info[4];
+    __cpuid(info, 1);
+    // fma, and avx with the ymm state enabled by the os
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    {
+      return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+  }();
+  return supported;
+#else
+  static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return supported;
+#endif
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace prism
+{
+  constexpr uint32_t INVALID_INDEX = ~0u;
+
+  // rays are traversed in [t_min, t_max] of the parametric distance along the direction, which need not be normalized
+  struct Ray
+  {
+    glm::vec3 origin{0.0f};
+    float t_min{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, 1.0f};
+    float t_max{std::numeric_limits<float>::infinity()};
+  };
+
+  // the closest hit with the same indices a ray query reports for a committed triangle
+  struct RayHit
+  {
+    float t{std::numeric_limits<float>::infinity()};
+    // barycentrics of the second and third vertex
+    float u{0.0f};
+    float v{0.0f};
+    uint32_t primitive_index{INVALID_INDEX};
+    uint32_t geometry_index{INVALID_INDEX};
+    uint32_t instance_index{INVALID_INDEX};
+    uint32_t instance_custom_index{0};
+
+    bool is_valid() const { return primitive_index != INVALID_INDEX; }
+  };
+
+  // eight rays as structure of arrays, one avx2 register per component. packets pay off for coherent rays like the
+  // primary rays of a tile, which visit mostly the same nodes
+  struct alignas(32) RayPacket
+  {
+    static constexpr uint32_t SIZE = 8;
+
+    float origin_x[SIZE];
+    float origin_y[SIZE];
+    float origin_z[SIZE];
+    float direction_x[SIZE];
+    float direction_y[SIZE];
+    float direction_z[SIZE];
+    float t_min[SIZE];
+    float t_max[SIZE];
+
+    void set(uint32_t lane, const Ray &ray);
+
+    Ray get(uint32_t lane) const;
+  };
+
+  struct alignas(32) RayPacketHit
+  {
+    float t[RayPacket::SIZE];
+    float u[RayPacket::SIZE];
+    float v[RayPacket::SIZE];
+    uint32_t primitive_index[RayPacket::SIZE];
+    uint32_t geometry_index[RayPacket::SIZE];
+    uint32_t instance_index[RayPacket::SIZE];
+    uint32_t instance_custom_index[RayPacket::SIZE];
+
+    RayPacketHit();
+
+    void set(uint32_t lane, const RayHit &hit);
+
+    RayHit get(uint32_t lane) const;
+  };
+
+  enum class Traversal
+  {
+    // avx2 when the cpu supports it
+    Auto,
+    Scalar,
+    // throws when the cpu does not support it
+    Avx2,
+  };
+
+  // whether the avx2 traversal was compiled in and the cpu supports avx2 and fma
+  bool has_avx2();
+
+} // namespace prism
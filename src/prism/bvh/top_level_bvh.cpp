@@ -0,0 +1,151 @@
+#include "prism/bvh/top_level_bvh.h"
+
+#include "prism/bvh/traversal.h"
+#include "prism/bvh/traversal_avx2.h"
+
+using namespace prism;
+
+namespace
+{
+  // the direction is not normalized again, distances along the ray stay the same in both spaces
+  Ray transform_ray(const TopLevelBvh::Entry &entry, const Ray &ray)
+  {
+    Ray result = ray;
+    for (int row = 0; row < 3; ++row)
+    {
+      const auto *m = entry.world_to_object[row];
+      result.origin[row] = m[0] * ray.origin.x + m[1] * ray.origin.y + m[2] * ray.origin.z + m[3];
+      result.direction[row] = m[0] * ray.direction.x + m[1] * ray.direction.y + m[2] * ray.direction.z;
+    }
+    return result;
+  }
+}
+
+TopLevelBvh::TopLevelBvh(const std::vector<AccelerationStructureInstance> &instances, ThreadPool *thread_pool)
+{
+  std::vector<Entry> entries;
+  std::vector<Aabb> bounds;
+  entries.reserve(instances.size());
+  bounds.reserve(instances.size());
+
+  for (uint32_t instance_index = 0; instance_index < instances.size(); ++instance_index)
+  {
+    const auto &handle = instances[instance_index].get_handle();
+    const auto *bottom_level = reinterpret_cast<const BottomLevelBvh *>(static_cast<uintptr_t>(handle.accelerationStructureReference));
+    if (bottom_level == nullptr || handle.mask == 0)
+    {
+      continue;
+    }
+
+    const auto &object_bounds = bottom_level->get_bounds();
+    if (object_bounds.min.x > object_bounds.max.x)
+    {
+      continue;
+    }
+
+    glm::mat4 object_to_world(1.0f);
+    for (int row = 0; row < 3; ++row)
+    {
+      for (int column = 0; column < 4; ++column)
+      {
+        object_to_world[column][row] = handle.transform.matrix[row][column];
+      }
+    }
+    auto world_to_object = glm::inverse(object_to_world);
+
+    Entry entry{};
+    for (int row = 0; row < 3; ++row)
+    {
+      for (int column = 0; column < 4; ++column)
+      {
+        entry.world_to_object[row][column] = world_to_object[column][row];
+      }
+    }
+    entry.bottom_level = bottom_level;
+    entry.instance_index = instance_index;
+    entry.custom_index = handle.instanceCustomIndex;
+    entry.mask = handle.mask;
+    entries.push_back(entry);
+
+    Aabb aabb{};
+    for (uint32_t corner = 0; corner < 8; ++corner)
+    {
+      glm::vec4 point{corner & 1 ? object_bounds.max.x : object_bounds.min.x,
+                      corner & 2 ? object_bounds.max.y : object_bounds.min.y,
+                      corner & 4 ? object_bounds.max.z : object_bounds.min.z, 1.0f};
+      aabb.extend(glm::vec3(object_to_world * point));
+    }
+    bounds.push_back(aabb);
+  }
+
+  // an instance per leaf, entering an instance costs a transform and a traversal of its own
+  m_bvh = WideBvh(bounds, thread_pool, 1);
+
+  m_entries.reserve(entries.size());
+  for (auto index : m_bvh.get_primitive_indices())
+  {
+    m_entries.push_back(entries[index]);
+  }
+}
+
+bool TopLevelBvh::intersect(const Ray &ray, RayHit &hit, uint32_t cull_mask, Traversal traversal) const
+{
+  if (use_avx2(traversal))
+  {
+    return avx2::intersect(*this, ray, hit, cull_mask);
+  }
+
+  auto t_max = std::min(ray.t_max, hit.t);
+  bool found = false;
+
+  traverse(m_bvh, ray, t_max, [&](uint32_t first, uint32_t count) {
+    for (auto i = first; i < first + count; ++i)
+    {
+      const auto &entry = m_entries[i];
+      if ((entry.mask & cull_mask) == 0)
+      {
+        continue;
+      }
+
+      auto object_ray = transform_ray(entry, ray);
+      object_ray.t_max = t_max;
+      if (entry.bottom_level->intersect(object_ray, hit, Traversal::Scalar))
+      {
+        hit.instance_index = entry.instance_index;
+        hit.instance_custom_index = entry.custom_index;
+        t_max = hit.t;
+        found = true;
+      }
+    }
+  });
+
+  return found;
+}
+
+void TopLevelBvh::intersect(const RayPacket &packet, RayPacketHit &hit, uint32_t cull_mask, Traversal traversal) const
+{
+  if (use_avx2(traversal))
+  {
+    avx2::intersect(*this, packet, hit, cull_mask);
+    return;
+  }
+
+  for (uint32_t lane = 0; lane < RayPacket::SIZE; ++lane)
+  {
+    auto lane_hit = hit.get(lane);
+    if (intersect(packet.get(lane), lane_hit, cull_mask, Traversal::Scalar))
+    {
+      hit.set(lane, lane_hit);
+    }
+  }
+}
+
+const WideBvh &TopLevelBvh::get_bvh() const
+{
+  return m_bvh;
+}
+
+const std::vector<TopLevelBvh::Entry> &TopLevelBvh::get_entries() const
+{
+  return m_entries;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "prism/bvh/bottom_level_bvh.h"
+#include "prism/vulkan/acceleration_structure_instance.h"
+
+namespace prism
+{
+  // the software counterpart of a top level acceleration structure. instances are described like the ones of a
+  // TopLevelAccelerationStructure, with the address of a BottomLevelBvh as their acceleration structure reference.
+  // instances without one are inactive, rays only hit instances whose mask shares a bit with the cull mask. the
+  // bottom levels have to outlive the top level
+  class TopLevelBvh
+  {
+  public:
+    // an active instance in bvh order, with the inverse of its transform
+    struct Entry
+    {
+      float world_to_object[3][4];
+      const BottomLevelBvh *bottom_level;
+      uint32_t instance_index;
+      uint32_t custom_index;
+      uint32_t mask;
+    };
+
+  public:
+    TopLevelBvh(const std::vector<AccelerationStructureInstance> &instances, ThreadPool *thread_pool = nullptr);
+
+    TopLevelBvh(const TopLevelBvh &) = delete;
+
+    TopLevelBvh(TopLevelBvh &&) = default;
+
+    ~TopLevelBvh() = default;
+
+    TopLevelBvh &operator=(const TopLevelBvh &) = delete;
+
+    TopLevelBvh &operator=(TopLevelBvh &&) = default;
+
+    // hits closer than hit.t replace it, returns whether one did
+    bool intersect(const Ray &ray, RayHit &hit, uint32_t cull_mask = 0xff, Traversal traversal = Traversal::Auto) const;
+
+    void intersect(const RayPacket &packet, RayPacketHit &hit, uint32_t cull_mask = 0xff, Traversal traversal = Traversal::Auto) const;
+
+    const WideBvh &get_bvh() const;
+
+    const std::vector<Entry> &get_entries() const;
+
+  private:
+    WideBvh m_bvh;
+
+    std::vector<Entry> m_entries;
+
+  }; // class TopLevelBvh
+
+} // namespace prism
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "prism/bvh/bottom_level_bvh.h"
+
+// the scalar traversal shared by both levels
+namespace prism
+{
+  inline bool use_avx2(Traversal traversal)
+  {
+    if (traversal == Traversal::Scalar)
+    {
+      return false;
+    }
+
+    if (has_avx2())
+    {
+      return true;
+    }
+
+    if (traversal == Traversal::Avx2)
+    {
+      throw std::runtime_error("AVX2 traversal is not supported on this CPU.");
+    }
+
+    return false;
+  }
+
+  inline glm::vec3 safe_inverse(const glm::vec3 &direction)
+  {
+    glm::vec3 inverse;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      auto d = direction[axis];
+      inverse[axis] = 1.0f / (std::abs(d) < WideBvh::MIN_DIRECTION ? std::copysign(WideBvh::MIN_DIRECTION, d) : d);
+    }
+    return inverse;
+  }
+
+  // moller-trumbore, both sides of the triangle are hit
+  inline bool intersect_triangle(const BottomLevelBvh::Triangle &triangle, const Ray &ray, float t_max, RayHit &hit)
+  {
+    auto p = glm::cross(ray.direction, triangle.e2);
+    auto det = glm::dot(triangle.e1, p);
+    if (det == 0.0f)
+    {
+      return false;
+    }
+    auto inverse_det = 1.0f / det;
+
+    auto s = ray.origin - triangle.v0;
+    auto u = glm::dot(s, p) * inverse_det;
+    if (u < 0.0f || u > 1.0f)
+    {
+      return false;
+    }
+
+    auto q = glm::cross(s, triangle.e1);
+    auto v = glm::dot(ray.direction, q) * inverse_det;
+    if (v < 0.0f || u + v > 1.0f)
+    {
+      return false;
+    }
+
+    auto t = glm::dot(triangle.e2, q) * inverse_det;
+    if (t < ray.t_min || t >= t_max)
+    {
+      return false;
+    }
+
+    hit.t = t;
+    hit.u = u;
+    hit.v = v;
+    hit.primitive_index = triangle.primitive_index;
+    hit.geometry_index = triangle.geometry_index;
+    return true;
+  }
+
+  // visits the leaves the ray enters nearest first, intersect_leaf(first, count) may lower t_max to cull the rest
+  template <typename Func>
+  void traverse(const WideBvh &bvh, const Ray &ray, const float &t_max, Func &&intersect_leaf)
+  {
+    struct Entry
+    {
+      uint32_t index;
+      uint32_t count;
+      float t;
+    };
+
+    Entry stack[WideBvh::STACK_SIZE];
+    uint32_t stack_size = 0;
+    stack[stack_size++] = {0, 0, ray.t_min};
+
+    auto inverse = safe_inverse(ray.direction);
+    auto origin = ray.origin * inverse;
+    const auto *nodes = bvh.get_nodes().data();
+
+    while (stack_size > 0)
+    {
+      auto entry = stack[--stack_size];
+      if (entry.t > t_max)
+      {
+        continue;
+      }
+
+      if (entry.count > 0)
+      {
+        intersect_leaf(entry.index, entry.count);
+        continue;
+      }
+
+      const auto &node = nodes[entry.index];
+      const auto *near_x = inverse.x < 0.0f ? node.max_x : node.min_x;
+      const auto *far_x = inverse.x < 0.0f ? node.min_x : node.max_x;
+      const auto *near_y = inverse.y < 0.0f ? node.max_y : node.min_y;
+      const auto *far_y = inverse.y < 0.0f ? node.min_y : node.max_y;
+      const auto *near_z = inverse.z < 0.0f ? node.max_z : node.min_z;
+      const auto *far_z = inverse.z < 0.0f ? node.min_z : node.max_z;
+
+      // sorted far to near, so the nearest child is popped first
+      Entry hits[WideNode::WIDTH];
+      uint32_t hit_count = 0;
+      for (uint32_t lane = 0; lane < WideNode::WIDTH; ++lane)
+      {
+        auto t0 = std::max(std::max(near_x[lane] * inverse.x - origin.x, near_y[lane] * inverse.y - origin.y),
+                           std::max(near_z[lane] * inverse.z - origin.z, ray.t_min));
+        auto t1 = std::min(std::min(far_x[lane] * inverse.x - origin.x, far_y[lane] * inverse.y - origin.y),
+                           std::min(far_z[lane] * inverse.z - origin.z, t_max));
+        if (!(t0 <= t1))
+        {
+          continue;
+        }
+
+        auto i = hit_count++;
+        for (; i > 0 && hits[i - 1].t < t0; --i)
+        {
+          hits[i] = hits[i - 1];
+        }
+        hits[i] = {node.children[lane], node.counts[lane], t0};
+      }
+
+      for (uint32_t i = 0; i < hit_count; ++i)
+      {
+        stack[stack_size++] = hits[i];
+      }
+    }
+  }
+
+} // namespace prism
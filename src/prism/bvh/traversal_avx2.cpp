@@ -0,0 +1,592 @@
+#include "prism/bvh/traversal_avx2.h"
+
+#include "prism/bvh/top_level_bvh.h"
+
+#if defined(PRISM_BVH_AVX2)
+
+#include <immintrin.h>
+
+using namespace prism;
+
+// the kernels are compiled for avx2 and fma function by function, the rest of the library and its consumers keep the
+// baseline instruction set. every helper here carries it, a legacy sse helper called with the upper halves of the ymm
+// registers dirty stalls on each transition. msvc emits avx2 for the intrinsics without any flag
+#if defined(_MSC_VER) && !defined(__clang__)
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+
+namespace
+{
+  struct Entry
+  {
+    uint32_t index;
+    uint32_t count;
+    float t;
+  };
+
+  struct PacketEntry
+  {
+    uint32_t index;
+    uint32_t count;
+    float t;
+    // the rays that entered the child
+    int lanes;
+  };
+
+  struct SingleRay
+  {
+    float origin[3];
+    float direction[3];
+    float t_min;
+  };
+
+  // a packet with the state of its closest hits
+  struct Packet
+  {
+    __m256 origin_x, origin_y, origin_z;
+    __m256 direction_x, direction_y, direction_z;
+    __m256 inverse_x, inverse_y, inverse_z;
+    // origin times inverse, the slab test is then one fmsub per plane
+    __m256 scaled_x, scaled_y, scaled_z;
+    __m256 t_min, t_max;
+    __m256 u, v;
+    __m256i primitive_index, geometry_index;
+  };
+
+  AVX2_TARGET uint32_t first_lane(int lanes)
+  {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long lane;
+    _BitScanForward(&lane, static_cast<unsigned long>(lanes));
+    return static_cast<uint32_t>(lane);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(static_cast<unsigned int>(lanes)));
+#endif
+  }
+
+  // far to near, so the nearest is pushed last and popped first
+  template <typename T>
+  AVX2_TARGET void insert_sorted(T *entries, uint32_t &count, const T &entry)
+  {
+    auto i = count++;
+    for (; i > 0 && entries[i - 1].t < entry.t; --i)
+    {
+      entries[i] = entries[i - 1];
+    }
+    entries[i] = entry;
+  }
+
+  AVX2_TARGET __m256 safe_inverse(__m256 direction)
+  {
+    const auto sign_bit = _mm256_set1_ps(-0.0f);
+    const auto min_direction = _mm256_set1_ps(WideBvh::MIN_DIRECTION);
+
+    auto sign = _mm256_and_ps(direction, sign_bit);
+    auto magnitude = _mm256_andnot_ps(sign_bit, direction);
+    auto small = _mm256_cmp_ps(magnitude, min_direction, _CMP_LT_OQ);
+    direction = _mm256_blendv_ps(direction, _mm256_or_ps(min_direction, sign), small);
+
+    return _mm256_div_ps(_mm256_set1_ps(1.0f), direction);
+  }
+
+  AVX2_TARGET float horizontal_min(__m256 x)
+  {
+    auto m = _mm_min_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+  }
+
+  // all bits set in the lanes whose bit is set in lanes
+  AVX2_TARGET __m256 lane_mask(int lanes)
+  {
+    const auto bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    auto mask = _mm256_and_si256(_mm256_set1_epi32(lanes), bits);
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(mask, bits));
+  }
+
+  AVX2_TARGET __m256i blend(__m256i a, __m256i b, __m256 mask)
+  {
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), mask));
+  }
+
+  // ---- single rays, the eight children of a node against one ray ----
+
+  // visits the leaves nearest first, intersect_leaf(first, count) may lower t_max to cull the rest
+  template <typename Func>
+  AVX2_TARGET void traverse(const WideBvh &bvh, const SingleRay &ray, const float &t_max, Func &intersect_leaf)
+  {
+    Entry stack[WideBvh::STACK_SIZE];
+    uint32_t stack_size = 0;
+    stack[stack_size++] = {0, 0, ray.t_min};
+
+    alignas(32) float inverse[8];
+    _mm256_store_ps(inverse, safe_inverse(_mm256_setr_ps(ray.direction[0], ray.direction[1], ray.direction[2], 1.0f, 1.0f, 1.0f, 1.0f, 1.0f)));
+
+    const auto inverse_x = _mm256_set1_ps(inverse[0]);
+    const auto inverse_y = _mm256_set1_ps(inverse[1]);
+    const auto inverse_z = _mm256_set1_ps(inverse[2]);
+    const auto scaled_x = _mm256_set1_ps(ray.origin[0] * inverse[0]);
+    const auto scaled_y = _mm256_set1_ps(ray.origin[1] * inverse[1]);
+    const auto scaled_z = _mm256_set1_ps(ray.origin[2] * inverse[2]);
+    const auto t_min = _mm256_set1_ps(ray.t_min);
+
+    const bool negative_x = inverse[0] < 0.0f;
+    const bool negative_y = inverse[1] < 0.0f;
+    const bool negative_z = inverse[2] < 0.0f;
+
+    const auto *nodes = bvh.get_nodes().data();
+
+    while (stack_size > 0)
+    {
+      auto entry = stack[--stack_size];
+      if (entry.t > t_max)
+      {
+        continue;
+      }
+
+      if (entry.count > 0)
+      {
+        intersect_leaf(entry.index, entry.count);
+        continue;
+      }
+
+      const auto &node = nodes[entry.index];
+      auto t0_x = _mm256_fmsub_ps(_mm256_load_ps(negative_x ? node.max_x : node.min_x), inverse_x, scaled_x);
+      auto t1_x = _mm256_fmsub_ps(_mm256_load_ps(negative_x ? node.min_x : node.max_x), inverse_x, scaled_x);
+      auto t0_y = _mm256_fmsub_ps(_mm256_load_ps(negative_y ? node.max_y : node.min_y), inverse_y, scaled_y);
+      auto t1_y = _mm256_fmsub_ps(_mm256_load_ps(negative_y ? node.min_y : node.max_y), inverse_y, scaled_y);
+      auto t0_z = _mm256_fmsub_ps(_mm256_load_ps(negative_z ? node.max_z : node.min_z), inverse_z, scaled_z);
+      auto t1_z = _mm256_fmsub_ps(_mm256_load_ps(negative_z ? node.min_z : node.max_z), inverse_z, scaled_z);
+
+      auto t0 = _mm256_max_ps(_mm256_max_ps(t0_x, t0_y), _mm256_max_ps(t0_z, t_min));
+      auto t1 = _mm256_min_ps(_mm256_min_ps(t1_x, t1_y), _mm256_min_ps(t1_z, _mm256_set1_ps(t_max)));
+      auto lanes = _mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ));
+      if (lanes == 0)
+      {
+        continue;
+      }
+
+      alignas(32) float distances[WideNode::WIDTH];
+      _mm256_store_ps(distances, t0);
+
+      Entry hits[WideNode::WIDTH];
+      uint32_t hit_count = 0;
+      for (; lanes != 0; lanes &= lanes - 1)
+      {
+        auto lane = first_lane(lanes);
+        insert_sorted(hits, hit_count, {node.children[lane], node.counts[lane], distances[lane]});
+      }
+
+      for (uint32_t i = 0; i < hit_count; ++i)
+      {
+        stack[stack_size++] = hits[i];
+      }
+    }
+  }
+
+  // moller-trumbore like the scalar test, both sides of the triangle are hit
+  AVX2_TARGET bool intersect_triangle(const BottomLevelBvh::Triangle &triangle, const SingleRay &ray, float t_max, RayHit &hit)
+  {
+    const auto *d = ray.direction;
+
+    float p[3] = {d[1] * triangle.e2.z - d[2] * triangle.e2.y,
+                  d[2] * triangle.e2.x - d[0] * triangle.e2.z,
+                  d[0] * triangle.e2.y - d[1] * triangle.e2.x};
+    auto det = triangle.e1.x * p[0] + triangle.e1.y * p[1] + triangle.e1.z * p[2];
+    if (det == 0.0f)
+    {
+      return false;
+    }
+    auto inverse_det = 1.0f / det;
+
+    float s[3] = {ray.origin[0] - triangle.v0.x, ray.origin[1] - triangle.v0.y, ray.origin[2] - triangle.v0.z};
+    auto u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse_det;
+    if (u < 0.0f || u > 1.0f)
+    {
+      return false;
+    }
+
+    float q[3] = {s[1] * triangle.e1.z - s[2] * triangle.e1.y,
+                  s[2] * triangle.e1.x - s[0] * triangle.e1.z,
+                  s[0] * triangle.e1.y - s[1] * triangle.e1.x};
+    auto v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse_det;
+    if (v < 0.0f || u + v > 1.0f)
+    {
+      return false;
+    }
+
+    auto t = (triangle.e2.x * q[0] + triangle.e2.y * q[1] + triangle.e2.z * q[2]) * inverse_det;
+    if (t < ray.t_min || t >= t_max)
+    {
+      return false;
+    }
+
+    hit.t = t;
+    hit.u = u;
+    hit.v = v;
+    hit.primitive_index = triangle.primitive_index;
+    hit.geometry_index = triangle.geometry_index;
+    return true;
+  }
+
+  AVX2_TARGET bool intersect_bottom_level(const BottomLevelBvh &bvh, const SingleRay &ray, float t_max, RayHit &hit)
+  {
+    const auto *triangles = bvh.get_triangles().data();
+    bool found = false;
+
+    auto intersect_leaf = [&](uint32_t first, uint32_t count) {
+      for (auto i = first; i < first + count; ++i)
+      {
+        if (intersect_triangle(triangles[i], ray, t_max, hit))
+        {
+          t_max = hit.t;
+          found = true;
+        }
+      }
+    };
+    traverse(bvh.get_bvh(), ray, t_max, intersect_leaf);
+
+    return found;
+  }
+
+  AVX2_TARGET SingleRay to_single_ray(const Ray &ray)
+  {
+    return {{ray.origin.x, ray.origin.y, ray.origin.z}, {ray.direction.x, ray.direction.y, ray.direction.z}, ray.t_min};
+  }
+
+  // the direction is not normalized again, distances along the ray stay the same in both spaces
+  AVX2_TARGET SingleRay transform_ray(const TopLevelBvh::Entry &entry, const SingleRay &ray)
+  {
+    SingleRay result = ray;
+    for (int row = 0; row < 3; ++row)
+    {
+      const auto *m = entry.world_to_object[row];
+      result.origin[row] = m[0] * ray.origin[0] + m[1] * ray.origin[1] + m[2] * ray.origin[2] + m[3];
+      result.direction[row] = m[0] * ray.direction[0] + m[1] * ray.direction[1] + m[2] * ray.direction[2];
+    }
+    return result;
+  }
+
+  // ---- packets, one child of a node against eight rays ----
+
+  AVX2_TARGET void prepare(Packet &packet)
+  {
+    packet.inverse_x = safe_inverse(packet.direction_x);
+    packet.inverse_y = safe_inverse(packet.direction_y);
+    packet.inverse_z = safe_inverse(packet.direction_z);
+    packet.scaled_x = _mm256_mul_ps(packet.origin_x, packet.inverse_x);
+    packet.scaled_y = _mm256_mul_ps(packet.origin_y, packet.inverse_y);
+    packet.scaled_z = _mm256_mul_ps(packet.origin_z, packet.inverse_z);
+  }
+
+  AVX2_TARGET void load(const RayPacket &rays, const RayPacketHit &hit, Packet &packet)
+  {
+    packet.origin_x = _mm256_load_ps(rays.origin_x);
+    packet.origin_y = _mm256_load_ps(rays.origin_y);
+    packet.origin_z = _mm256_load_ps(rays.origin_z);
+    packet.direction_x = _mm256_load_ps(rays.direction_x);
+    packet.direction_y = _mm256_load_ps(rays.direction_y);
+    packet.direction_z = _mm256_load_ps(rays.direction_z);
+    packet.t_min = _mm256_load_ps(rays.t_min);
+    packet.t_max = _mm256_min_ps(_mm256_load_ps(rays.t_max), _mm256_load_ps(hit.t));
+    packet.u = _mm256_load_ps(hit.u);
+    packet.v = _mm256_load_ps(hit.v);
+    packet.primitive_index = _mm256_load_si256(reinterpret_cast<const __m256i *>(hit.primitive_index));
+    packet.geometry_index = _mm256_load_si256(reinterpret_cast<const __m256i *>(hit.geometry_index));
+    prepare(packet);
+  }
+
+  // writes the lanes that found a closer hit
+  AVX2_TARGET void store(const Packet &packet, int lanes, RayPacketHit &hit)
+  {
+    auto mask = lane_mask(lanes);
+    _mm256_store_ps(hit.t, _mm256_blendv_ps(_mm256_load_ps(hit.t), packet.t_max, mask));
+    _mm256_store_ps(hit.u, _mm256_blendv_ps(_mm256_load_ps(hit.u), packet.u, mask));
+    _mm256_store_ps(hit.v, _mm256_blendv_ps(_mm256_load_ps(hit.v), packet.v, mask));
+
+    auto *primitive_index = reinterpret_cast<__m256i *>(hit.primitive_index);
+    auto *geometry_index = reinterpret_cast<__m256i *>(hit.geometry_index);
+    _mm256_store_si256(primitive_index, blend(_mm256_load_si256(primitive_index), packet.primitive_index, mask));
+    _mm256_store_si256(geometry_index, blend(_mm256_load_si256(geometry_index), packet.geometry_index, mask));
+  }
+
+  // leaves get the rays that entered them, intersect_leaf(first, count, lanes) may lower the packet's t_max
+  template <typename Leaf>
+  AVX2_TARGET void traverse(const WideBvh &bvh, const Packet &packet, int lanes, Leaf &intersect_leaf)
+  {
+    PacketEntry stack[WideBvh::STACK_SIZE];
+    uint32_t stack_size = 0;
+    stack[stack_size++] = {0, 0, 0.0f, lanes};
+
+    const auto infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    const auto *nodes = bvh.get_nodes().data();
+
+    while (stack_size > 0)
+    {
+      auto entry = stack[--stack_size];
+      if (entry.count > 0)
+      {
+        intersect_leaf(entry.index, entry.count, entry.lanes);
+        continue;
+      }
+
+      const auto &node = nodes[entry.index];
+
+      // children in order of the nearest ray entering them
+      PacketEntry hits[WideNode::WIDTH];
+      uint32_t hit_count = 0;
+
+      // empty lanes only follow the used ones
+      for (uint32_t child = 0; child < WideNode::WIDTH && node.children[child] != INVALID_INDEX; ++child)
+      {
+        // the rays of a packet may point different ways, the planes are ordered per ray
+        auto plane0_x = _mm256_fmsub_ps(_mm256_set1_ps(node.min_x[child]), packet.inverse_x, packet.scaled_x);
+        auto plane1_x = _mm256_fmsub_ps(_mm256_set1_ps(node.max_x[child]), packet.inverse_x, packet.scaled_x);
+        auto plane0_y = _mm256_fmsub_ps(_mm256_set1_ps(node.min_y[child]), packet.inverse_y, packet.scaled_y);
+        auto plane1_y = _mm256_fmsub_ps(_mm256_set1_ps(node.max_y[child]), packet.inverse_y, packet.scaled_y);
+        auto plane0_z = _mm256_fmsub_ps(_mm256_set1_ps(node.min_z[child]), packet.inverse_z, packet.scaled_z);
+        auto plane1_z = _mm256_fmsub_ps(_mm256_set1_ps(node.max_z[child]), packet.inverse_z, packet.scaled_z);
+
+        auto t0 = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(plane0_x, plane1_x), _mm256_min_ps(plane0_y, plane1_y)),
+                                _mm256_max_ps(_mm256_min_ps(plane0_z, plane1_z), packet.t_min));
+        auto t1 = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(plane0_x, plane1_x), _mm256_max_ps(plane0_y, plane1_y)),
+                                _mm256_min_ps(_mm256_max_ps(plane0_z, plane1_z), packet.t_max));
+
+        auto child_lanes = _mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ)) & entry.lanes;
+        if (child_lanes == 0)
+        {
+          continue;
+        }
+
+        auto t = horizontal_min(_mm256_blendv_ps(infinity, t0, lane_mask(child_lanes)));
+        insert_sorted(hits, hit_count, {node.children[child], node.counts[child], t, child_lanes});
+      }
+
+      for (uint32_t i = 0; i < hit_count; ++i)
+      {
+        stack[stack_size++] = hits[i];
+      }
+    }
+  }
+
+  // eight rays against the triangles of a leaf, one triangle at a time
+  struct TriangleLeaf
+  {
+    const BottomLevelBvh::Triangle *triangles;
+    Packet &packet;
+    int hit_lanes;
+
+    AVX2_TARGET void operator()(uint32_t first, uint32_t count, int lanes)
+    {
+      const auto active = lane_mask(lanes);
+      const auto zero = _mm256_setzero_ps();
+      const auto one = _mm256_set1_ps(1.0f);
+
+      for (auto i = first; i < first + count; ++i)
+      {
+        const auto &triangle = triangles[i];
+        auto e1_x = _mm256_set1_ps(triangle.e1.x);
+        auto e1_y = _mm256_set1_ps(triangle.e1.y);
+        auto e1_z = _mm256_set1_ps(triangle.e1.z);
+        auto e2_x = _mm256_set1_ps(triangle.e2.x);
+        auto e2_y = _mm256_set1_ps(triangle.e2.y);
+        auto e2_z = _mm256_set1_ps(triangle.e2.z);
+
+        // p = cross(direction, e2)
+        auto p_x = _mm256_fmsub_ps(packet.direction_y, e2_z, _mm256_mul_ps(packet.direction_z, e2_y));
+        auto p_y = _mm256_fmsub_ps(packet.direction_z, e2_x, _mm256_mul_ps(packet.direction_x, e2_z));
+        auto p_z = _mm256_fmsub_ps(packet.direction_x, e2_y, _mm256_mul_ps(packet.direction_y, e2_x));
+        auto det = _mm256_fmadd_ps(e1_x, p_x, _mm256_fmadd_ps(e1_y, p_y, _mm256_mul_ps(e1_z, p_z)));
+        auto inverse_det = _mm256_div_ps(one, det);
+
+        // s = origin - v0
+        auto s_x = _mm256_sub_ps(packet.origin_x, _mm256_set1_ps(triangle.v0.x));
+        auto s_y = _mm256_sub_ps(packet.origin_y, _mm256_set1_ps(triangle.v0.y));
+        auto s_z = _mm256_sub_ps(packet.origin_z, _mm256_set1_ps(triangle.v0.z));
+        auto u = _mm256_mul_ps(_mm256_fmadd_ps(s_x, p_x, _mm256_fmadd_ps(s_y, p_y, _mm256_mul_ps(s_z, p_z))), inverse_det);
+
+        // q = cross(s, e1)
+        auto q_x = _mm256_fmsub_ps(s_y, e1_z, _mm256_mul_ps(s_z, e1_y));
+        auto q_y = _mm256_fmsub_ps(s_z, e1_x, _mm256_mul_ps(s_x, e1_z));
+        auto q_z = _mm256_fmsub_ps(s_x, e1_y, _mm256_mul_ps(s_y, e1_x));
+        auto v = _mm256_mul_ps(_mm256_fmadd_ps(packet.direction_x, q_x, _mm256_fmadd_ps(packet.direction_y, q_y, _mm256_mul_ps(packet.direction_z, q_z))), inverse_det);
+        auto t = _mm256_mul_ps(_mm256_fmadd_ps(e2_x, q_x, _mm256_fmadd_ps(e2_y, q_y, _mm256_mul_ps(e2_z, q_z))), inverse_det);
+
+        auto mask = _mm256_and_ps(active, _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ));
+        mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(u, one, _CMP_LE_OQ)));
+        mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ)));
+        mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(t, packet.t_min, _CMP_GE_OQ), _mm256_cmp_ps(t, packet.t_max, _CMP_LT_OQ)));
+
+        auto triangle_lanes = _mm256_movemask_ps(mask);
+        if (triangle_lanes == 0)
+        {
+          continue;
+        }
+
+        packet.t_max = _mm256_blendv_ps(packet.t_max, t, mask);
+        packet.u = _mm256_blendv_ps(packet.u, u, mask);
+        packet.v = _mm256_blendv_ps(packet.v, v, mask);
+        packet.primitive_index = blend(packet.primitive_index, _mm256_set1_epi32(static_cast<int>(triangle.primitive_index)), mask);
+        packet.geometry_index = blend(packet.geometry_index, _mm256_set1_epi32(static_cast<int>(triangle.geometry_index)), mask);
+        hit_lanes |= triangle_lanes;
+      }
+    }
+  };
+
+  // returns the lanes that found a closer hit
+  AVX2_TARGET int intersect_bottom_level(const BottomLevelBvh &bvh, Packet &packet, int lanes)
+  {
+    TriangleLeaf leaf{bvh.get_triangles().data(), packet, 0};
+    traverse(bvh.get_bvh(), packet, lanes, leaf);
+    return leaf.hit_lanes;
+  }
+
+  AVX2_TARGET __m256 transform_row(const float *row, __m256 x, __m256 y, __m256 z, float w)
+  {
+    return _mm256_fmadd_ps(_mm256_set1_ps(row[0]), x, _mm256_fmadd_ps(_mm256_set1_ps(row[1]), y, _mm256_fmadd_ps(_mm256_set1_ps(row[2]), z, _mm256_set1_ps(w))));
+  }
+
+  // eight rays against the instances of a leaf. the closest hit so far travels into an instance and comes back for
+  // the lanes that found a closer one
+  struct InstanceLeaf
+  {
+    const TopLevelBvh::Entry *entries;
+    uint32_t cull_mask;
+    Packet &packet;
+    __m256i instance_index;
+    __m256i custom_index;
+    int hit_lanes;
+
+    AVX2_TARGET void operator()(uint32_t first, uint32_t count, int lanes)
+    {
+      for (auto i = first; i < first + count; ++i)
+      {
+        const auto &entry = entries[i];
+        if ((entry.mask & cull_mask) == 0)
+        {
+          continue;
+        }
+
+        const auto &m = entry.world_to_object;
+        Packet object = packet;
+        object.origin_x = transform_row(m[0], packet.origin_x, packet.origin_y, packet.origin_z, m[0][3]);
+        object.origin_y = transform_row(m[1], packet.origin_x, packet.origin_y, packet.origin_z, m[1][3]);
+        object.origin_z = transform_row(m[2], packet.origin_x, packet.origin_y, packet.origin_z, m[2][3]);
+        object.direction_x = transform_row(m[0], packet.direction_x, packet.direction_y, packet.direction_z, 0.0f);
+        object.direction_y = transform_row(m[1], packet.direction_x, packet.direction_y, packet.direction_z, 0.0f);
+        object.direction_z = transform_row(m[2], packet.direction_x, packet.direction_y, packet.direction_z, 0.0f);
+        prepare(object);
+
+        auto instance_lanes = intersect_bottom_level(*entry.bottom_level, object, lanes);
+        if (instance_lanes == 0)
+        {
+          continue;
+        }
+
+        auto mask = lane_mask(instance_lanes);
+        packet.t_max = _mm256_blendv_ps(packet.t_max, object.t_max, mask);
+        packet.u = _mm256_blendv_ps(packet.u, object.u, mask);
+        packet.v = _mm256_blendv_ps(packet.v, object.v, mask);
+        packet.primitive_index = blend(packet.primitive_index, object.primitive_index, mask);
+        packet.geometry_index = blend(packet.geometry_index, object.geometry_index, mask);
+        instance_index = blend(instance_index, _mm256_set1_epi32(static_cast<int>(entry.instance_index)), mask);
+        custom_index = blend(custom_index, _mm256_set1_epi32(static_cast<int>(entry.custom_index)), mask);
+        hit_lanes |= instance_lanes;
+      }
+    }
+  };
+}
+
+AVX2_TARGET bool avx2::intersect(const BottomLevelBvh &bvh, const Ray &ray, RayHit &hit)
+{
+  auto t_max = std::min(ray.t_max, hit.t);
+  return intersect_bottom_level(bvh, to_single_ray(ray), t_max, hit);
+}
+
+AVX2_TARGET void avx2::intersect(const BottomLevelBvh &bvh, const RayPacket &packet, RayPacketHit &hit)
+{
+  Packet state;
+  load(packet, hit, state);
+  auto lanes = intersect_bottom_level(bvh, state, 0xff);
+  store(state, lanes, hit);
+}
+
+AVX2_TARGET bool avx2::intersect(const TopLevelBvh &bvh, const Ray &ray, RayHit &hit, uint32_t cull_mask)
+{
+  const auto *entries = bvh.get_entries().data();
+  auto single_ray = to_single_ray(ray);
+  auto t_max = std::min(ray.t_max, hit.t);
+  bool found = false;
+
+  auto intersect_leaf = [&](uint32_t first, uint32_t count) {
+    for (auto i = first; i < first + count; ++i)
+    {
+      const auto &entry = entries[i];
+      if ((entry.mask & cull_mask) == 0)
+      {
+        continue;
+      }
+
+      if (intersect_bottom_level(*entry.bottom_level, transform_ray(entry, single_ray), t_max, hit))
+      {
+        hit.instance_index = entry.instance_index;
+        hit.instance_custom_index = entry.custom_index;
+        t_max = hit.t;
+        found = true;
+      }
+    }
+  };
+  traverse(bvh.get_bvh(), single_ray, t_max, intersect_leaf);
+
+  return found;
+}
+
+AVX2_TARGET void avx2::intersect(const TopLevelBvh &bvh, const RayPacket &packet, RayPacketHit &hit, uint32_t cull_mask)
+{
+  Packet state;
+  load(packet, hit, state);
+
+  InstanceLeaf leaf{bvh.get_entries().data(), cull_mask, state,
+                    _mm256_load_si256(reinterpret_cast<const __m256i *>(hit.instance_index)),
+                    _mm256_load_si256(reinterpret_cast<const __m256i *>(hit.instance_custom_index)), 0};
+  traverse(bvh.get_bvh(), state, 0xff, leaf);
+
+  store(state, leaf.hit_lanes, hit);
+
+  auto mask = lane_mask(leaf.hit_lanes);
+  auto *instance_index = reinterpret_cast<__m256i *>(hit.instance_index);
+  auto *custom_index = reinterpret_cast<__m256i *>(hit.instance_custom_index);
+  _mm256_store_si256(instance_index, blend(_mm256_load_si256(instance_index), leaf.instance_index, mask));
+  _mm256_store_si256(custom_index, blend(_mm256_load_si256(custom_index), leaf.custom_index, mask));
+}
+
+#else
+
+using namespace prism;
+
+// has_avx2() is false where the kernels are not built, nothing calls these
+
+bool avx2::intersect(const BottomLevelBvh &, const Ray &, RayHit &)
+{
+  throw std::runtime_error("The AVX2 traversal is not built for this architecture.");
+}
+
+void avx2::intersect(const BottomLevelBvh &, const RayPacket &, RayPacketHit &)
+{
+  throw std::runtime_error("The AVX2 traversal is not built for this architecture.");
+}
+
+bool avx2::intersect(const TopLevelBvh &, const Ray &, RayHit &, uint32_t)
+{
+  throw std::runtime_error("The AVX2 traversal is not built for this architecture.");
+}
+
+void avx2::intersect(const TopLevelBvh &, const RayPacket &, RayPacketHit &, uint32_t)
+{
+  throw std::runtime_error("The AVX2 traversal is not built for this architecture.");
+}
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "prism/bvh/ray.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PRISM_BVH_AVX2
+#endif
+
+namespace prism
+{
+  class BottomLevelBvh;
+  class TopLevelBvh;
+
+  // compiled for avx2 and fma on x86-64, only to be called when has_avx2() is true. single rays test the eight
+  // children of a node at once, packets test one child against eight rays at once
+  namespace avx2
+  {
+    bool intersect(const BottomLevelBvh &bvh, const Ray &ray, RayHit &hit);
+
+    void intersect(const BottomLevelBvh &bvh, const RayPacket &packet, RayPacketHit &hit);
+
+    bool intersect(const TopLevelBvh &bvh, const Ray &ray, RayHit &hit, uint32_t cull_mask);
+
+    void intersect(const TopLevelBvh &bvh, const RayPacket &packet, RayPacketHit &hit, uint32_t cull_mask);
+  }
+
+} // namespace prism
@@ -0,0 +1,525 @@
+#include "prism/bvh/wide_bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <future>
+
+#include "prism/core/thread_pool.h"
+
+using namespace prism;
+
+namespace
+{
+  const uint32_t BIN_COUNT = 16;
+
+  // relative costs of visiting a node and intersecting a primitive
+  const float TRAVERSAL_COST = 1.0f;
+  const float INTERSECTION_COST = 1.0f;
+
+  // binary depth below which splits fall back to the median, which bounds the depth at 64 for 2^32 primitives and
+  // keeps a traversal within STACK_SIZE entries of seven pushes per level
+  const uint32_t MAX_SAH_DEPTH = 32;
+
+  // ranges at least this large bin in chunks on the thread pool
+  const uint32_t PARALLEL_BIN_CHUNK = 16 * 1024;
+
+  // ranges below this are built as a single task
+  const uint32_t MIN_SUBTREE_SIZE = 4 * 1024;
+
+  struct Bin
+  {
+    Aabb bounds;
+    uint32_t count{0};
+  };
+
+  using Bins = std::array<std::array<Bin, BIN_COUNT>, 3>;
+
+  struct BinaryNode
+  {
+    Aabb bounds;
+    uint32_t children[2]{INVALID_INDEX, INVALID_INDEX};
+    uint32_t first{0};
+    // zero for inner nodes
+    uint32_t count{0};
+  };
+
+  struct Range
+  {
+    uint32_t begin;
+    uint32_t end;
+    uint32_t depth;
+  };
+
+  // bounds of the primitives and of their centers
+  struct RangeBounds
+  {
+    Aabb bounds;
+    Aabb center_bounds;
+
+    void extend(const RangeBounds &other)
+    {
+      bounds.extend(other.bounds);
+      center_bounds.extend(other.center_bounds);
+    }
+  };
+
+  class Builder
+  {
+  public:
+    Builder(const std::vector<Aabb> &bounds, std::vector<uint32_t> &indices, ThreadPool *thread_pool, uint32_t max_leaf_size)
+        : m_bounds(bounds), m_indices(indices), m_thread_pool(thread_pool), m_max_leaf_size(std::max(1u, max_leaf_size))
+    {
+      m_centers.resize(bounds.size());
+      for (size_t i = 0; i < bounds.size(); ++i)
+      {
+        m_centers[i] = bounds[i].get_center();
+      }
+    }
+
+    std::vector<BinaryNode> build()
+    {
+      std::vector<BinaryNode> nodes;
+      Range root{0, static_cast<uint32_t>(m_indices.size()), 0};
+
+      if (m_thread_pool == nullptr || m_thread_pool->get_thread_count() < 2 || root.end < 2 * MIN_SUBTREE_SIZE)
+      {
+        nodes.reserve(2 * m_indices.size() / m_max_leaf_size + 1);
+        build_subtree(nodes, root);
+        return nodes;
+      }
+
+      // the top splits run on this thread and bin in parallel, until the ranges are small enough to give every
+      // worker a few subtrees to build on its own
+      auto subtree_size = std::max(MIN_SUBTREE_SIZE, root.end / (4 * m_thread_pool->get_thread_count()));
+
+      std::vector<std::pair<Range, uint32_t>> pending{{root, 0}};
+      std::vector<std::pair<Range, uint32_t>> subtrees;
+      nodes.emplace_back();
+
+      while (!pending.empty())
+      {
+        auto [range, node_index] = pending.back();
+        pending.pop_back();
+
+        if (range.end - range.begin <= subtree_size)
+        {
+          subtrees.emplace_back(range, node_index);
+          continue;
+        }
+
+        auto range_bounds = compute_bounds(range, true);
+        nodes[node_index].bounds = range_bounds.bounds;
+
+        Range left{}, right{};
+        if (!split(range, range_bounds, true, left, right))
+        {
+          make_leaf(nodes[node_index], range);
+          continue;
+        }
+
+        auto left_index = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[node_index].children[0] = left_index;
+        nodes[node_index].children[1] = left_index + 1;
+
+        pending.emplace_back(left, left_index);
+        pending.emplace_back(right, left_index + 1);
+      }
+
+      // subtrees own disjoint ranges of the indices, their nodes are spliced in behind the top nodes
+      std::vector<std::future<std::vector<BinaryNode>>> futures;
+      futures.reserve(subtrees.size());
+      for (const auto &subtree : subtrees)
+      {
+        futures.push_back(m_thread_pool->submit([this, range = subtree.first]() {
+          std::vector<BinaryNode> subtree_nodes;
+          build_subtree(subtree_nodes, range);
+          return subtree_nodes;
+        }));
+      }
+
+      for (size_t i = 0; i < subtrees.size(); ++i)
+      {
+        auto subtree_nodes = futures[i].get();
+
+        // the subtree's root replaces its placeholder, the rest move by the offset
+        auto offset = static_cast<uint32_t>(nodes.size()) - 1;
+        for (auto &node : subtree_nodes)
+        {
+          if (node.count == 0)
+          {
+            node.children[0] += offset;
+            node.children[1] += offset;
+          }
+        }
+
+        nodes[subtrees[i].second] = subtree_nodes[0];
+        nodes.insert(nodes.end(), subtree_nodes.begin() + 1, subtree_nodes.end());
+      }
+
+      return nodes;
+    }
+
+  private:
+    uint32_t build_subtree(std::vector<BinaryNode> &nodes, const Range &range)
+    {
+      auto node_index = static_cast<uint32_t>(nodes.size());
+      nodes.emplace_back();
+
+      auto range_bounds = compute_bounds(range, false);
+      nodes[node_index].bounds = range_bounds.bounds;
+
+      Range left{}, right{};
+      if (!split(range, range_bounds, false, left, right))
+      {
+        make_leaf(nodes[node_index], range);
+        return node_index;
+      }
+
+      auto left_index = build_subtree(nodes, left);
+      auto right_index = build_subtree(nodes, right);
+      nodes[node_index].children[0] = left_index;
+      nodes[node_index].children[1] = right_index;
+
+      return node_index;
+    }
+
+    void make_leaf(BinaryNode &node, const Range &range)
+    {
+      node.first = range.begin;
+      node.count = range.end - range.begin;
+    }
+
+    // runs func over chunks of the range, on the thread pool when the range is large enough
+    template <typename Result, typename Func>
+    Result reduce(const Range &range, bool parallel, Func &&func)
+    {
+      auto count = range.end - range.begin;
+      if (!parallel || count < 2 * PARALLEL_BIN_CHUNK)
+      {
+        return func(range.begin, range.end);
+      }
+
+      std::vector<std::future<Result>> futures;
+      for (auto begin = range.begin; begin < range.end; begin += PARALLEL_BIN_CHUNK)
+      {
+        auto end = std::min(range.end, begin + PARALLEL_BIN_CHUNK);
+        futures.push_back(m_thread_pool->submit([&func, begin, end]() { return func(begin, end); }));
+      }
+
+      auto result = futures[0].get();
+      for (size_t i = 1; i < futures.size(); ++i)
+      {
+        result.extend(futures[i].get());
+      }
+      return result;
+    }
+
+    RangeBounds compute_bounds(const Range &range, bool parallel)
+    {
+      return reduce<RangeBounds>(range, parallel, [this](uint32_t begin, uint32_t end) {
+        RangeBounds result{};
+        for (auto i = begin; i < end; ++i)
+        {
+          auto index = m_indices[i];
+          result.bounds.extend(m_bounds[index]);
+          result.center_bounds.extend(m_centers[index]);
+        }
+        return result;
+      });
+    }
+
+    // finds the cheapest of the binned splits on every axis and partitions the range by it. returns false when a
+    // leaf is cheaper
+    bool split(const Range &range, const RangeBounds &range_bounds, bool parallel, Range &left, Range &right)
+    {
+      auto count = range.end - range.begin;
+      if (count <= 1)
+      {
+        return false;
+      }
+
+      auto extent = range_bounds.center_bounds.max - range_bounds.center_bounds.min;
+      if (range.depth >= MAX_SAH_DEPTH || glm::max(extent.x, glm::max(extent.y, extent.z)) <= 0.0f)
+      {
+        // coincident centers can not be binned
+        if (count <= m_max_leaf_size)
+        {
+          return false;
+        }
+        return split_median(range, left, right);
+      }
+
+      // scaled slightly down so the largest center lands in the last bin
+      glm::vec3 scale{0.0f};
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        if (extent[axis] > 0.0f)
+        {
+          scale[axis] = BIN_COUNT * (1.0f - 1e-5f) / extent[axis];
+        }
+      }
+      auto origin = range_bounds.center_bounds.min;
+
+      auto bin_index = [scale, origin](const glm::vec3 &center, int axis) {
+        auto bin = static_cast<int32_t>((center[axis] - origin[axis]) * scale[axis]);
+        return static_cast<uint32_t>(std::clamp(bin, 0, static_cast<int32_t>(BIN_COUNT) - 1));
+      };
+
+      struct BinReduction
+      {
+        Bins bins{};
+
+        void extend(const BinReduction &other)
+        {
+          for (int axis = 0; axis < 3; ++axis)
+          {
+            for (uint32_t bin = 0; bin < BIN_COUNT; ++bin)
+            {
+              bins[axis][bin].bounds.extend(other.bins[axis][bin].bounds);
+              bins[axis][bin].count += other.bins[axis][bin].count;
+            }
+          }
+        }
+      };
+
+      auto reduction = reduce<BinReduction>(range, parallel, [this, &bin_index](uint32_t begin, uint32_t end) {
+        BinReduction result{};
+        for (auto i = begin; i < end; ++i)
+        {
+          auto index = m_indices[i];
+          for (int axis = 0; axis < 3; ++axis)
+          {
+            auto &bin = result.bins[axis][bin_index(m_centers[index], axis)];
+            bin.bounds.extend(m_bounds[index]);
+            ++bin.count;
+          }
+        }
+        return result;
+      });
+
+      auto best_cost = std::numeric_limits<float>::infinity();
+      int best_axis = -1;
+      uint32_t best_bin = 0;
+
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        if (extent[axis] <= 0.0f)
+        {
+          continue;
+        }
+
+        const auto &bins = reduction.bins[axis];
+
+        // right_costs[i] covers the bins after i
+        std::array<float, BIN_COUNT> right_costs{};
+        Aabb right_bounds{};
+        uint32_t right_count = 0;
+        for (auto bin = BIN_COUNT - 1; bin > 0; --bin)
+        {
+          right_bounds.extend(bins[bin].bounds);
+          right_count += bins[bin].count;
+          right_costs[bin - 1] = right_count == 0 ? 0.0f : right_bounds.get_half_area() * right_count;
+        }
+
+        Aabb left_bounds{};
+        uint32_t left_count = 0;
+        for (uint32_t bin = 0; bin + 1 < BIN_COUNT; ++bin)
+        {
+          left_bounds.extend(bins[bin].bounds);
+          left_count += bins[bin].count;
+          if (left_count == 0 || left_count == count)
+          {
+            continue;
+          }
+
+          auto cost = left_bounds.get_half_area() * left_count + right_costs[bin];
+          if (cost < best_cost)
+          {
+            best_cost = cost;
+            best_axis = axis;
+            best_bin = bin;
+          }
+        }
+      }
+
+      if (best_axis < 0)
+      {
+        return count <= m_max_leaf_size ? false : split_median(range, left, right);
+      }
+
+      auto area = range_bounds.bounds.get_half_area();
+      auto split_cost = TRAVERSAL_COST + INTERSECTION_COST * best_cost / std::max(area, std::numeric_limits<float>::min());
+      if (count <= m_max_leaf_size && split_cost >= INTERSECTION_COST * count)
+      {
+        return false;
+      }
+
+      auto middle = std::partition(m_indices.begin() + range.begin, m_indices.begin() + range.end, [&](uint32_t index) {
+        return bin_index(m_centers[index], best_axis) <= best_bin;
+      });
+      auto middle_index = static_cast<uint32_t>(middle - m_indices.begin());
+
+      left = {range.begin, middle_index, range.depth + 1};
+      right = {middle_index, range.end, range.depth + 1};
+      return true;
+    }
+
+    bool split_median(const Range &range, Range &left, Range &right)
+    {
+      auto middle = range.begin + (range.end - range.begin) / 2;
+      left = {range.begin, middle, range.depth + 1};
+      right = {middle, range.end, range.depth + 1};
+      return true;
+    }
+
+  private:
+    const std::vector<Aabb> &m_bounds;
+
+    std::vector<glm::vec3> m_centers;
+
+    std::vector<uint32_t> &m_indices;
+
+    ThreadPool *m_thread_pool;
+
+    uint32_t m_max_leaf_size;
+  };
+
+  void clear_lane(WideNode &node, uint32_t lane)
+  {
+    node.min_x[lane] = node.min_y[lane] = node.min_z[lane] = std::numeric_limits<float>::infinity();
+    node.max_x[lane] = node.max_y[lane] = node.max_z[lane] = -std::numeric_limits<float>::infinity();
+    node.children[lane] = INVALID_INDEX;
+    node.counts[lane] = 0;
+  }
+
+  void set_lane(WideNode &node, uint32_t lane, const Aabb &bounds)
+  {
+    node.min_x[lane] = bounds.min.x;
+    node.min_y[lane] = bounds.min.y;
+    node.min_z[lane] = bounds.min.z;
+    node.max_x[lane] = bounds.max.x;
+    node.max_y[lane] = bounds.max.y;
+    node.max_z[lane] = bounds.max.z;
+  }
+
+  // the children of a wide node are the binary children with the inner one of the largest area opened up until
+  // the node is full, which keeps the nodes most rays enter wide
+  uint32_t collapse(const std::vector<BinaryNode> &binary_nodes, uint32_t binary_index, std::vector<WideNode> &nodes, uint32_t &leaf_count)
+  {
+    auto node_index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    for (uint32_t lane = 0; lane < WideNode::WIDTH; ++lane)
+    {
+      clear_lane(nodes[node_index], lane);
+    }
+
+    std::vector<uint32_t> children;
+    children.reserve(WideNode::WIDTH);
+
+    const auto &binary_node = binary_nodes[binary_index];
+    if (binary_node.count > 0)
+    {
+      children.push_back(binary_index);
+    }
+    else
+    {
+      children.push_back(binary_node.children[0]);
+      children.push_back(binary_node.children[1]);
+    }
+
+    while (children.size() < WideNode::WIDTH)
+    {
+      auto largest = children.end();
+      auto largest_area = -1.0f;
+      for (auto it = children.begin(); it != children.end(); ++it)
+      {
+        const auto &child = binary_nodes[*it];
+        if (child.count == 0 && child.bounds.get_half_area() > largest_area)
+        {
+          largest = it;
+          largest_area = child.bounds.get_half_area();
+        }
+      }
+
+      if (largest == children.end())
+      {
+        break;
+      }
+
+      const auto &opened = binary_nodes[*largest];
+      *largest = opened.children[0];
+      children.push_back(opened.children[1]);
+    }
+
+    for (uint32_t lane = 0; lane < children.size(); ++lane)
+    {
+      const auto &child = binary_nodes[children[lane]];
+
+      uint32_t child_index = child.first;
+      if (child.count == 0)
+      {
+        child_index = collapse(binary_nodes, children[lane], nodes, leaf_count);
+      }
+      else
+      {
+        ++leaf_count;
+      }
+
+      // written after the recursion, which may have moved the nodes
+      auto &node = nodes[node_index];
+      set_lane(node, lane, child.bounds);
+      node.children[lane] = child_index;
+      node.counts[lane] = child.count;
+    }
+
+    return node_index;
+  }
+}
+
+WideBvh::WideBvh(const std::vector<Aabb> &bounds, ThreadPool *thread_pool, uint32_t max_leaf_size)
+{
+  m_primitive_indices.resize(bounds.size());
+  for (uint32_t i = 0; i < m_primitive_indices.size(); ++i)
+  {
+    m_primitive_indices[i] = i;
+  }
+
+  if (bounds.empty())
+  {
+    m_nodes.emplace_back();
+    for (uint32_t lane = 0; lane < WideNode::WIDTH; ++lane)
+    {
+      clear_lane(m_nodes[0], lane);
+    }
+    return;
+  }
+
+  Builder builder(bounds, m_primitive_indices, thread_pool, max_leaf_size);
+  auto binary_nodes = builder.build();
+
+  m_bounds = binary_nodes[0].bounds;
+  m_nodes.reserve(binary_nodes.size() / 4 + 1);
+  collapse(binary_nodes, 0, m_nodes, m_leaf_count);
+}
+
+const std::vector<WideNode> &WideBvh::get_nodes() const
+{
+  return m_nodes;
+}
+
+const std::vector<uint32_t> &WideBvh::get_primitive_indices() const
+{
+  return m_primitive_indices;
+}
+
+const Aabb &WideBvh::get_bounds() const
+{
+  return m_bounds;
+}
+
+uint32_t WideBvh::get_leaf_count() const
+{
+  return m_leaf_count;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <limits>
+
+#include "prism/bvh/ray.h"
+
+namespace prism
+{
+  class ThreadPool;
+
+  struct Aabb
+  {
+    glm::vec3 min{std::numeric_limits<float>::infinity()};
+    glm::vec3 max{-std::numeric_limits<float>::infinity()};
+
+    void extend(const glm::vec3 &point)
+    {
+      min = glm::min(min, point);
+      max = glm::max(max, point);
+    }
+
+    void extend(const Aabb &aabb)
+    {
+      min = glm::min(min, aabb.min);
+      max = glm::max(max, aabb.max);
+    }
+
+    glm::vec3 get_center() const
+    {
+      return (min + max) * 0.5f;
+    }
+
+    // half the surface area, the sah only compares ratios of areas
+    float get_half_area() const
+    {
+      auto extent = glm::max(max - min, glm::vec3(0.0f));
+      return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+  };
+
+  // the children of a node are stored as structure of arrays so one avx2 register tests all of them against a ray.
+  // empty lanes hold an inverted box no ray hits
+  struct alignas(32) WideNode
+  {
+    static constexpr uint32_t WIDTH = 8;
+
+    float min_x[WIDTH];
+    float max_x[WIDTH];
+    float min_y[WIDTH];
+    float max_y[WIDTH];
+    float min_z[WIDTH];
+    float max_z[WIDTH];
+    // the node of an inner child, the first primitive of a leaf
+    uint32_t children[WIDTH];
+    // the primitive count of a leaf, zero for inner and empty children
+    uint32_t counts[WIDTH];
+  };
+
+  // a binned sah build over the bounds of primitives, collapsed into eight wide nodes. the root is the first node,
+  // leaves reference ranges of get_primitive_indices() which owners use to store their primitives in bvh order.
+  // with a thread pool the top splits bin in parallel and the subtrees below them are built as separate tasks, the
+  // pool's workers must not be the ones waiting on the build
+  class WideBvh
+  {
+  public:
+    // entries of a traversal stack, the build keeps the depth within 64 levels of up to seven pushes each
+    static constexpr uint32_t STACK_SIZE = 512;
+
+    // traversals clamp ray directions away from zero by this, so the slab test never multiplies zero by infinity
+    static constexpr float MIN_DIRECTION = 1e-18f;
+
+  public:
+    WideBvh() = default;
+
+    WideBvh(const std::vector<Aabb> &bounds, ThreadPool *thread_pool = nullptr, uint32_t max_leaf_size = 4);
+
+    WideBvh(const WideBvh &) = delete;
+
+    WideBvh(WideBvh &&) = default;
+
+    ~WideBvh() = default;
+
+    WideBvh &operator=(const WideBvh &) = delete;
+
+    WideBvh &operator=(WideBvh &&) = default;
+
+    const std::vector<WideNode> &get_nodes() const;
+
+    const std::vector<uint32_t> &get_primitive_indices() const;
+
+    const Aabb &get_bounds() const;
+
+    uint32_t get_leaf_count() const;
+
+  private:
+    std::vector<WideNode> m_nodes;
+
+    std::vector<uint32_t> m_primitive_indices;
+
+    Aabb m_bounds;
+
+    uint32_t m_leaf_count{0};
+
+  }; // class WideBvh
+
+} // namespace prism
@@ -0,0 +1,144 @@
+#include "prism/core/file_watcher.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace prism
+{
+    namespace
+    {
+        std::string canonical_path(const std::filesystem::path &path)
+        {
+            std::error_code error;
+            auto result = std::filesystem::weakly_canonical(path, error);
+            return error ? path.string() : result.string();
+        }
+    }
+
+#ifdef __linux__
+    FileWatcher::FileWatcher()
+    {
+        m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0)
+        {
+            throw std::runtime_error("Failed to initialize inotify.");
+        }
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        close(m_fd);
+    }
+
+    void FileWatcher::watch(const std::string &path)
+    {
+        auto file = canonical_path(path);
+        if (std::find(m_files.begin(), m_files.end(), file) != m_files.end())
+        {
+            return;
+        }
+        m_files.push_back(file);
+
+        // the directory is watched, saving through a temporary file and a rename replaces the inode
+        auto directory = std::filesystem::path(file).parent_path().string();
+        auto wd = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd < 0)
+        {
+            LOG_WARN("failed to watch {}", directory);
+            return;
+        }
+        m_directories[wd] = directory;
+    }
+
+    std::vector<std::string> FileWatcher::wait(std::chrono::milliseconds timeout)
+    {
+        pollfd fd{m_fd, POLLIN, 0};
+        if (poll(&fd, 1, static_cast<int>(timeout.count())) <= 0)
+        {
+            return {};
+        }
+
+        std::vector<std::string> changed;
+
+        alignas(inotify_event) char buffer[4096];
+        ssize_t size;
+        while ((size = read(m_fd, buffer, sizeof(buffer))) > 0)
+        {
+            for (ssize_t offset = 0; offset < size;)
+            {
+                auto event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                auto directory = m_directories.find(event->wd);
+                if (directory == m_directories.end() || event->len == 0)
+                {
+                    continue;
+                }
+
+                auto file = canonical_path(std::filesystem::path(directory->second) / event->name);
+                if (std::find(m_files.begin(), m_files.end(), file) != m_files.end() &&
+                    std::find(changed.begin(), changed.end(), file) == changed.end())
+                {
+                    changed.push_back(file);
+                }
+            }
+        }
+
+        return changed;
+    }
+#else
+    namespace
+    {
+        std::filesystem::file_time_type write_time(const std::string &path)
+        {
+            std::error_code error;
+            auto time = std::filesystem::last_write_time(path, error);
+            return error ? std::filesystem::file_time_type::min() : time;
+        }
+    }
+
+    FileWatcher::FileWatcher()
+    {
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+    }
+
+    void FileWatcher::watch(const std::string &path)
+    {
+        auto file = canonical_path(path);
+        if (std::find(m_files.begin(), m_files.end(), file) != m_files.end())
+        {
+            return;
+        }
+        m_files.push_back(file);
+        m_write_times.push_back(write_time(file));
+    }
+
+    std::vector<std::string> FileWatcher::wait(std::chrono::milliseconds timeout)
+    {
+        std::this_thread::sleep_for(timeout);
+
+        std::vector<std::string> changed;
+        for (size_t i = 0; i < m_files.size(); ++i)
+        {
+            auto time = write_time(m_files[i]);
+            if (time != m_write_times[i])
+            {
+                m_write_times[i] = time;
+                changed.push_back(m_files[i]);
+            }
+        }
+
+        return changed;
+    }
+#endif
+
+} // namespace prism
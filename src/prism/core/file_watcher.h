@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+
+namespace prism
+{
+    // reports files that were written since the last call to wait(). uses inotify on linux, elsewhere the
+    // modification times of the watched files are polled
+    class FileWatcher
+    {
+    public:
+        FileWatcher();
+
+        FileWatcher(const FileWatcher &) = delete;
+
+        FileWatcher(FileWatcher &&) = delete;
+
+        ~FileWatcher();
+
+        FileWatcher &operator=(const FileWatcher &) = delete;
+
+        FileWatcher &operator=(FileWatcher &&) = delete;
+
+        // the file does not have to exist yet, editors that save by replacing the file are handled
+        void watch(const std::string &path);
+
+        // blocks for up to timeout, returns the canonical paths of the watched files that changed
+        std::vector<std::string> wait(std::chrono::milliseconds timeout);
+
+    private:
+        std::vector<std::string> m_files;
+
+#ifdef __linux__
+        int m_fd{-1};
+
+        // watch descriptor to directory
+        std::map<int, std::string> m_directories;
+#else
+        std::vector<std::filesystem::file_time_type> m_write_times;
+#endif
+    };
+
+} // namespace prism
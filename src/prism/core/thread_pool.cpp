@@ -0,0 +1,76 @@
+#include "prism/core/thread_pool.h"
+
+#include <algorithm>
+
+namespace prism
+{
+    ThreadPool::ThreadPool(uint32_t thread_count)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_threads.reserve(thread_count);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            m_threads.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+
+        for (auto &thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::wait_idle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle_condition.wait(lock, [this]() { return m_pending == 0; });
+    }
+
+    uint32_t ThreadPool::get_thread_count() const
+    {
+        return static_cast<uint32_t>(m_threads.size());
+    }
+
+    void ThreadPool::work()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            // packaged_task stores exceptions in the future
+            task();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_pending == 0)
+                {
+                    m_idle_condition.notify_all();
+                }
+            }
+        }
+    }
+} // namespace prism
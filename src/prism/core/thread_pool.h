@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace prism
+{
+  // a fixed set of worker threads draining a shared queue, submit() returns a future of the task's result
+  class ThreadPool
+  {
+  public:
+    // zero uses one thread per hardware thread
+    explicit ThreadPool(uint32_t thread_count = 0);
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool(ThreadPool &&) = delete;
+
+    // runs the tasks still queued before joining
+    ~ThreadPool();
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    template <typename Func>
+    auto submit(Func &&func) -> std::future<std::invoke_result_t<std::decay_t<Func>>>
+    {
+      using Result = std::invoke_result_t<std::decay_t<Func>>;
+
+      // std::function needs a copyable target
+      auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+      auto future = task->get_future();
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.emplace_back([task]() { (*task)(); });
+        ++m_pending;
+      }
+      m_condition.notify_one();
+
+      return future;
+    }
+
+    // blocks until every submitted task has finished
+    void wait_idle();
+
+    uint32_t get_thread_count() const;
+
+  private:
+    void work();
+
+  private:
+    std::vector<std::thread> m_threads;
+
+    std::deque<std::function<void()>> m_tasks;
+
+    // queued plus running tasks
+    uint32_t m_pending{0};
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_condition;
+
+    std::condition_variable m_idle_condition;
+
+    bool m_stop{false};
+
+  }; // class ThreadPool
+
+} // namespace prism
@@ -1,15 +1,22 @@
 #include "prism/rendering/buffer_data.h"
 
-#include "prism/vulkan/command_buffer.h"
-#include "prism/vulkan/utils.h"
+#include "prism/vulkan/upload_manager.h"
 
 using namespace prism;
 
-BufferData::BufferData(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+BufferData::BufferData(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkMemoryPropertyFlags preferred_properties)
   : size(size)
 {
   buffer = std::make_unique<Buffer>(device, size, usage);
-  device_memory = std::make_unique<DeviceMemory>(device, buffer->get_memory_requirements(), properties);
+  device_memory = std::make_unique<DeviceMemory>(*buffer, properties, 0, preferred_properties);
+  buffer->bind_memory(*device_memory);
+}
+
+BufferData::BufferData(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, MemoryAllocator::Usage memory_usage)
+  : size(size)
+{
+  buffer = std::make_unique<Buffer>(device, size, usage);
+  device_memory = std::make_unique<DeviceMemory>(*buffer, memory_usage);
   buffer->bind_memory(*device_memory);
 }
 
@@ -28,55 +35,54 @@ BufferInfo BufferData::get_info() const
   return info;
 }
 
-void BufferData::upload(const void* data, VkDeviceSize size, VkDeviceSize offset)
+uint64_t BufferData::upload(const void* data, VkDeviceSize size, VkDeviceSize offset)
 {
-  device_memory->upload(offset, size, data);
+  if (device_memory->get_properties() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+  {
+    device_memory->upload(offset, size, data);
+    return 0;
+  }
+
+  // device local memory goes through the device's staging ring
+  return buffer->get_device().get_upload_manager().upload(*buffer, data, size, offset);
 }
 
-void BufferData::upload(const CommandPool& cmd_pool, const void* data, VkDeviceSize size, VkDeviceSize offset)
+void BufferData::download(void* data, VkDeviceSize size, VkDeviceSize offset)
 {
-  const auto& device = buffer->get_device();
-
-  auto stage_buffer = Buffer(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-  auto stage_memory = DeviceMemory(device, stage_buffer.get_memory_requirements(), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-  stage_buffer.bind_memory(stage_memory);
-  stage_memory.upload(0, size, data);
-
-  auto queue_family_index = device.get_physical_device().get_queue_family_index(VK_QUEUE_GRAPHICS_BIT);
-  auto &queue = device.get_queue(queue_family_index, 0);
-  utils::submit_commands_to_queue(cmd_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-    VkBufferCopy copy_region{};
-    copy_region.size = size;
-    cmd_buffer.copy_buffer(stage_buffer, *buffer, {copy_region});
-  });
+  if (!(device_memory->get_properties() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+  {
+    throw std::runtime_error("Buffer memory is not host visible");
+  }
+
+  device_memory->download(offset, size, data);
 }
 
 UniformBuffer::UniformBuffer(const Device& device, VkDeviceSize size)
-  : BufferData(device, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+  : BufferData(device, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryAllocator::Usage::Dynamic)
 {
 }
 
-void UniformBuffer::upload(const void* data, VkDeviceSize size)
+uint64_t UniformBuffer::upload(const void* data, VkDeviceSize size)
 {
-  BufferData::upload(data, size);
+  return BufferData::upload(data, size);
 }
 
 VertexBuffer::VertexBuffer(const Device& device, VkDeviceSize size)
-  : BufferData(device, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+  : BufferData(device, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryAllocator::Usage::GpuOnly)
 {
 }
 
-void VertexBuffer::upload(const CommandPool& cmd_pool, const void* data, VkDeviceSize size)
+uint64_t VertexBuffer::upload(const void* data, VkDeviceSize size)
 {
-  BufferData::upload(cmd_pool, data, size);
+  return BufferData::upload(data, size);
 }
 
 IndexBuffer::IndexBuffer(const Device& device, VkDeviceSize size)
-  : BufferData(device, size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+  : BufferData(device, size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryAllocator::Usage::GpuOnly)
 {
 }
 
-void IndexBuffer::upload(const CommandPool& cmd_pool, const void* data, VkDeviceSize size)
+uint64_t IndexBuffer::upload(const void* data, VkDeviceSize size)
 {
-  BufferData::upload(cmd_pool, data, size);
+  return BufferData::upload(data, size);
 }
\ No newline at end of file
@@ -13,7 +13,11 @@ namespace prism
     std::unique_ptr<DeviceMemory> device_memory;
     VkDeviceSize size;
 
-    BufferData(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+    // preferred properties are taken when available, e.g. HOST_CACHED for buffers that are read back
+    BufferData(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkMemoryPropertyFlags preferred_properties = 0);
+
+    // host visible picks are written directly, e.g. dynamic buffers in resizable bar memory skip the staging copy
+    BufferData(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, MemoryAllocator::Usage memory_usage);
     
     ~BufferData();
 
@@ -27,9 +31,11 @@ namespace prism
 
     BufferInfo get_info() const;
 
-    void upload(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
-  
-    void upload(const CommandPool& cmd_pool, const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+    // returns the upload manager token to wait on, 0 when the memory was written directly
+    uint64_t upload(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+    // host visible memory only, the gpu writes have to be complete
+    void download(void* data, VkDeviceSize size, VkDeviceSize offset = 0);
 
   }; // struct BufferData
 
@@ -37,7 +43,7 @@ namespace prism
   {
     UniformBuffer(const Device& device, VkDeviceSize size);
 
-    void upload(const void* data, VkDeviceSize size);
+    uint64_t upload(const void* data, VkDeviceSize size);
 
   }; // struct UniformBuffer
 
@@ -45,14 +51,14 @@ namespace prism
   {
     VertexBuffer(const Device& device, VkDeviceSize size);
 
-    void upload(const CommandPool& cmd_pool, const void* data, VkDeviceSize size);
+    uint64_t upload(const void* data, VkDeviceSize size);
   }; // struct VertexBuffer
 
   struct IndexBuffer : public BufferData
   {
     IndexBuffer(const Device& device, VkDeviceSize size);
 
-    void upload(const CommandPool& cmd_pool, const void* data, VkDeviceSize size);
+    uint64_t upload(const void* data, VkDeviceSize size);
   }; // struct IndexBuffer
 
 } // namespace prism
\ No newline at end of file
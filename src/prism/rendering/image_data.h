@@ -26,9 +26,8 @@ struct ImageData {
 
   ImageData &operator=(ImageData &&) = default;
 
-  void upload(const CommandPool &cmd_pool, const void *data,
-              const VkDeviceSize size,
-              VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+  uint64_t upload(const void *data, const VkDeviceSize size,
+                  VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
 
 }; // struct ImageData
 
@@ -50,9 +49,8 @@ struct Texture {
 
   Texture &operator=(Texture &&) = default;
 
-  void upload(const CommandPool &cmd_pool, const void *data,
-              const VkDeviceSize size,
-              VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+  uint64_t upload(const void *data, const VkDeviceSize size,
+                  VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
 
 }; // struct Texture
 
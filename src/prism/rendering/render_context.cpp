@@ -1,17 +1,25 @@
 #include "prism/rendering/render_context.h"
 
+#include "prism/vulkan/upload_manager.h"
+
 using namespace prism;
 
 RenderContext::RenderContext(const Window &window, const Surface &surface,
                              const Device &device, const Queue &queue)
+    : RenderContext(window, surface, device, queue, Properties{}) {}
+
+RenderContext::RenderContext(const Window &window, const Surface &surface,
+                             const Device &device, const Queue &queue,
+                             const Properties &properties)
     : m_surface(surface), m_device(device), m_queue(queue),
-      m_extent{window.get_extent().x, window.get_extent().y} {
+      m_extent{window.get_extent().x, window.get_extent().y},
+      m_properties(properties) {
 
   create_swapchain();
 
   create_render_frames();
 
-  create_sync_objects();
+  create_render_targets();
 }
 
 VkFormat RenderContext::get_format() const { return m_swapchain->get_format(); }
@@ -20,10 +28,18 @@ const std::vector<RenderFrame> &RenderContext::get_render_frames() const {
   return m_render_frames;
 }
 
+const std::vector<RenderTarget> &RenderContext::get_render_targets() const {
+  return m_render_targets;
+}
+
 uint32_t RenderContext::get_active_frame_index() const {
   return m_active_frame_index;
 }
 
+uint32_t RenderContext::get_active_target_index() const {
+  return m_active_target_index;
+}
+
 RenderFrame &RenderContext::get_active_frame() {
   return m_render_frames[m_active_frame_index];
 }
@@ -35,53 +51,76 @@ void RenderContext::update(const VkExtent2D &extent) {
 }
 
 VkResult RenderContext::prepare_frame() {
+  auto &frame = m_render_frames[m_active_frame_index];
+
+  // the only cpu wait, for the gpu to finish the frame that last used this slot
+  frame.get_fence().wait();
+
+  m_device.get_memory_allocator().update_budgets();
+
   auto result = m_swapchain->acquire_next_image(
-      UINT64_MAX, *m_image_availabel_semaphores, m_active_frame_index);
+      UINT64_MAX, frame.get_acquire_semaphore(), m_active_target_index);
 
-  m_render_frames[m_active_frame_index].reset();
+  // nothing gets submitted when the swapchain is out of date, keep the fence signaled
+  if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+    frame.reset();
+  }
 
   return result;
 }
 
 void RenderContext::render(
     const CommandBuffer &cmd_buffer,
-    const std::function<void(const CommandBuffer &cmd_buffer)> &record_func) {
+    const std::function<void(const CommandBuffer &cmd_buffer)> &record_func,
+    std::optional<uint64_t> upload_token) {
   auto &frame = m_render_frames[m_active_frame_index];
+  auto &target = m_render_targets[m_active_target_index];
+
+  auto &upload_manager = m_device.get_upload_manager();
+  auto token = upload_token.value_or(upload_manager.get_token());
 
   cmd_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
+  upload_manager.acquire(cmd_buffer, token);
+
   record_func(cmd_buffer);
 
   cmd_buffer.end();
 
-  // queue.submit(cmd_buffer);
-
   // submit command buffer
   VkSubmitInfo submit_info{};
   submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submit_info.commandBufferCount = 1;
   submit_info.pCommandBuffers = &cmd_buffer.get_handle();
-  // wait semaphore
-  VkSemaphore wait_semaphores[] = {m_image_availabel_semaphores->get_handle()};
-  submit_info.waitSemaphoreCount = 1;
+  // wait semaphore, the binary acquire semaphore ignores its value
+  VkSemaphore wait_semaphores[] = {frame.get_acquire_semaphore().get_handle(),
+                                   upload_manager.get_semaphore().get_handle()};
+  uint64_t wait_values[] = {0, token};
+  submit_info.waitSemaphoreCount = token > 0 ? 2 : 1;
   submit_info.pWaitSemaphores = wait_semaphores;
   // signal semaphore
-  VkSemaphore signal_semaphores = frame.get_semaphore().get_handle();
+  VkSemaphore signal_semaphores = target.get_present_semaphore().get_handle();
   submit_info.signalSemaphoreCount = 1;
   submit_info.pSignalSemaphores = &signal_semaphores;
   // wait stage
   VkPipelineStageFlags wait_stages[] = {
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
   submit_info.pWaitDstStageMask = wait_stages;
 
+  VkTimelineSemaphoreSubmitInfo timeline_info{};
+  timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timeline_info.waitSemaphoreValueCount = submit_info.waitSemaphoreCount;
+  timeline_info.pWaitSemaphoreValues = wait_values;
+  submit_info.pNext = &timeline_info;
+
   m_queue.submit(submit_info, frame.get_fence());
-  m_queue.wait_idle();
 }
 
 VkResult RenderContext::present_frame() {
-  auto &frame = m_render_frames[m_active_frame_index];
+  auto &target = m_render_targets[m_active_target_index];
 
-  VkSemaphore signal_semaphores = frame.get_semaphore().get_handle();
+  VkSemaphore signal_semaphores = target.get_present_semaphore().get_handle();
 
   // present
   VkPresentInfoKHR present_info{};
@@ -91,14 +130,19 @@ VkResult RenderContext::present_frame() {
   VkSwapchainKHR swapchains[] = {m_swapchain->get_handle()};
   present_info.swapchainCount = 1;
   present_info.pSwapchains = swapchains;
-  present_info.pImageIndices = &m_active_frame_index;
+  present_info.pImageIndices = &m_active_target_index;
+
+  auto result = m_queue.present(present_info);
+
+  m_active_frame_index = (m_active_frame_index + 1) % m_render_frames.size();
 
-  return m_queue.present(present_info);
+  return result;
 }
 
 void RenderContext::create_swapchain() {
   Swapchain::Properties props{};
   props.extent = m_extent;
+  props.present_mode = m_properties.present_mode;
   props.image_usage =
       VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
   props.surface_format = {VK_FORMAT_B8G8R8A8_UNORM,
@@ -107,24 +151,28 @@ void RenderContext::create_swapchain() {
 }
 
 void RenderContext::create_render_frames() {
-  m_render_frames.reserve(m_swapchain->get_images().size());
-  for (size_t i = 0; i < m_swapchain->get_images().size(); ++i) {
-    m_render_frames.emplace_back(m_device, m_swapchain->get_images()[i]);
+  m_render_frames.reserve(m_properties.frame_count);
+  for (uint32_t i = 0; i < m_properties.frame_count; ++i) {
+    m_render_frames.emplace_back(m_device);
   }
 }
 
-void RenderContext::create_sync_objects() {
-  m_image_availabel_semaphores = std::make_unique<Semaphore>(m_device);
+void RenderContext::create_render_targets() {
+  m_render_targets.reserve(m_swapchain->get_images().size());
+  for (size_t i = 0; i < m_swapchain->get_images().size(); ++i) {
+    m_render_targets.emplace_back(m_device, m_swapchain->get_images()[i]);
+  }
 }
 
 void RenderContext::recreate() {
+  // frames are submitted and presented on this queue, once it is idle the gpu and the presentation engine are done
+  // with the swapchain images and the present semaphores
+  m_queue.wait_idle();
 
-  // TODO: implement update render target in render frame
-  m_image_availabel_semaphores.reset();
-  m_render_frames.clear();
+  // frames in flight do not depend on the swapchain and survive the resize
+  m_render_targets.clear();
   m_swapchain.reset();
 
   create_swapchain();
-  create_render_frames();
-  create_sync_objects();
+  create_render_targets();
 }
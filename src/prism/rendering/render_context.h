@@ -2,6 +2,7 @@
 
 #include "prism/platform/window.h"
 #include "prism/rendering/render_frame.h"
+#include "prism/rendering/render_target.h"
 #include "prism/vulkan/queue.h"
 #include "prism/vulkan/device.h"
 #include "prism/vulkan/surface.h"
@@ -12,22 +13,40 @@ namespace prism
 
 class RenderContext
 {
+public:
+  struct Properties
+  {
+    // frames the cpu may record ahead of the gpu, independent of the swapchain image count
+    uint32_t frame_count{2};
+    VkPresentModeKHR present_mode{VK_PRESENT_MODE_FIFO_KHR};
+  };
+
 public:
   RenderContext(const Window& window, const Surface &surface, const Device &device, const Queue& queue);
 
+  RenderContext(const Window& window, const Surface &surface, const Device &device, const Queue& queue, const Properties &properties);
+
   VkFormat get_format() const;
 
   const std::vector<RenderFrame>& get_render_frames() const;
 
+  const std::vector<RenderTarget>& get_render_targets() const;
+
   RenderFrame& get_active_frame();
 
+  // index of the frame in flight, selects per frame resources such as uniform buffers
   uint32_t get_active_frame_index() const;
 
+  // index of the acquired swapchain image, selects per image resources such as framebuffers
+  uint32_t get_active_target_index() const;
+
+  // recreates the swapchain, waits for the queue first so callers do not have to
   void update(const VkExtent2D& extent);
 
   VkResult prepare_frame();
 
-  void render(const CommandBuffer &cmd_buffer, const std::function<void(const CommandBuffer&)> &record_func);
+  // waits on the upload manager token before executing, defaults to every upload issued so far
+  void render(const CommandBuffer &cmd_buffer, const std::function<void(const CommandBuffer&)> &record_func, std::optional<uint64_t> upload_token = std::nullopt);
 
   VkResult present_frame();
 
@@ -36,7 +55,7 @@ private:
 
   void create_render_frames();
 
-  void create_sync_objects();
+  void create_render_targets();
 
   void recreate();
 
@@ -49,14 +68,18 @@ private:
 
   VkExtent2D m_extent;
 
+  Properties m_properties;
+
   std::unique_ptr<Swapchain> m_swapchain;
 
-  uint32_t m_active_frame_index;
+  uint32_t m_active_frame_index{0};
+
+  uint32_t m_active_target_index{0};
 
   std::vector<RenderFrame> m_render_frames;
 
-  std::unique_ptr<Semaphore> m_image_availabel_semaphores;
+  std::vector<RenderTarget> m_render_targets;
 
 }; // class RenderContext
 
-} // namespace prism
\ No newline at end of file
+} // namespace prism
@@ -2,39 +2,30 @@
 
 using namespace prism;
 
-RenderFrame::RenderFrame(const Device &device, const Image &image)
+RenderFrame::RenderFrame(const Device &device)
     : m_device(device) {
-  ImageViewCreateInfo image_view_ci{};
-  image_view_ci.set_view_type(VK_IMAGE_VIEW_TYPE_2D)
-      .set_level_count(1)
-      .set_layer_count(1)
-      .set_aspect_mask(VK_IMAGE_ASPECT_COLOR_BIT);
-  image_view_ci.set_format(image.get_format());
-  m_image_views.emplace_back(image, image_view_ci);
-
-  m_semaphore = std::make_unique<Semaphore>(m_device);
+  m_acquire_semaphore = std::make_unique<Semaphore>(m_device);
   m_fence = std::make_unique<Fence>(m_device, VK_FENCE_CREATE_SIGNALED_BIT);
+  m_descriptor_allocator = std::make_unique<DescriptorAllocator>(m_device);
+  m_linear_allocator = std::make_unique<LinearAllocator>(m_device);
 }
 
 RenderFrame::RenderFrame(RenderFrame && other)
     : m_device(other.m_device),
-      m_image_views(std::move(other.m_image_views)),
       m_cmd_pools(std::move(other.m_cmd_pools)),
-      m_descriptor_pool(std::move(other.m_descriptor_pool)),
-      m_descriptor_set(std::move(other.m_descriptor_set)),
-      m_semaphore(std::move(other.m_semaphore)),
+      m_descriptor_allocator(std::move(other.m_descriptor_allocator)),
+      m_linear_allocator(std::move(other.m_linear_allocator)),
+      m_acquire_semaphore(std::move(other.m_acquire_semaphore)),
       m_fence(std::move(other.m_fence))
 {
 }
 
 RenderFrame::~RenderFrame() {}
 
-const std::vector<ImageView> &RenderFrame::get_image_views() const {
-  return m_image_views;
+const Semaphore &RenderFrame::get_acquire_semaphore() const {
+  return *m_acquire_semaphore;
 }
 
-const Semaphore &RenderFrame::get_semaphore() const { return *m_semaphore; }
-
 Fence &RenderFrame::get_fence() const { return *m_fence; }
 
 CommandBuffer &RenderFrame::request_command_buffer(const Queue &queue) {
@@ -42,6 +33,14 @@ CommandBuffer &RenderFrame::request_command_buffer(const Queue &queue) {
   return cmd_pool.request_command_buffer();
 }
 
+DescriptorAllocator &RenderFrame::get_descriptor_allocator() {
+  return *m_descriptor_allocator;
+}
+
+LinearAllocator &RenderFrame::get_linear_allocator() {
+  return *m_linear_allocator;
+}
+
 CommandPool &RenderFrame::get_command_pool(const Queue &queue) {
   auto cmd_pool_it = m_cmd_pools.find(queue.get_family_index());
   if (cmd_pool_it == m_cmd_pools.end()) {
@@ -61,4 +60,7 @@ void RenderFrame::reset()
   {
     cmd_pool.second->reset();
   }
+
+  m_descriptor_allocator->reset();
+  m_linear_allocator->reset();
 }
\ No newline at end of file
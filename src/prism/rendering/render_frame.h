@@ -2,17 +2,17 @@
 
 #include "prism/vulkan/command_buffer.h"
 #include "prism/vulkan/command_pool.h"
-#include "prism/vulkan/descriptor_pool.h"
-#include "prism/vulkan/descriptor_set.h"
+#include "prism/vulkan/descriptor_allocator.h"
 #include "prism/vulkan/device.h"
 #include "prism/vulkan/fence.h"
+#include "prism/vulkan/linear_allocator.h"
 #include "prism/vulkan/semaphore.h"
-#include "prism/vulkan/image_view.h"
 
 namespace prism {
+// per frame in flight state, reused once the gpu has finished the frame that last used it
 class RenderFrame {
 public:
-  RenderFrame(const Device &device, const Image& image);
+  RenderFrame(const Device &device);
 
   ~RenderFrame();
 
@@ -24,14 +24,20 @@ public:
 
   RenderFrame &operator=(RenderFrame &&) = delete;
 
-  const std::vector<ImageView> &get_image_views() const;
-
-  const Semaphore &get_semaphore() const;
+  // signaled when the swapchain image acquired for this frame is ready
+  const Semaphore &get_acquire_semaphore() const;
 
   Fence &get_fence() const;
 
   CommandBuffer &request_command_buffer(const Queue &queue);
 
+  // sets valid until the frame is reset
+  DescriptorAllocator &get_descriptor_allocator();
+
+  // mapped memory for the frame's uniforms and other transient data, valid until the frame is reset
+  LinearAllocator &get_linear_allocator();
+
+  // waits for the previous use of this frame and recycles its command buffers, descriptor sets and transient memory
   void reset();
 
 private:
@@ -40,16 +46,14 @@ private:
 private:
   const Device &m_device;
 
-  std::vector<ImageView> m_image_views;
-
   std::map<uint32_t, std::unique_ptr<CommandPool>> m_cmd_pools;
 
-  std::unique_ptr<DescriptorPool> m_descriptor_pool;
-  std::unique_ptr<DescriptorSet> m_descriptor_set;
+  std::unique_ptr<DescriptorAllocator> m_descriptor_allocator;
+  std::unique_ptr<LinearAllocator> m_linear_allocator;
 
-  std::unique_ptr<Semaphore> m_semaphore;
+  std::unique_ptr<Semaphore> m_acquire_semaphore;
   std::unique_ptr<Fence> m_fence;
 
 }; // class RenderFrame
 
-} // namespace prism
\ No newline at end of file
+} // namespace prism
@@ -0,0 +1,613 @@
+#include "prism/rendering/render_graph.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/utils.h"
+
+using namespace prism;
+
+namespace {
+
+VkImageAspectFlags aspect_flags(VkFormat format) {
+  switch (format) {
+  case VK_FORMAT_D16_UNORM_S8_UINT:
+  case VK_FORMAT_D24_UNORM_S8_UINT:
+  case VK_FORMAT_D32_SFLOAT_S8_UINT:
+    return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+  case VK_FORMAT_D16_UNORM:
+  case VK_FORMAT_D32_SFLOAT:
+  case VK_FORMAT_X8_D24_UNORM_PACK32:
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+  case VK_FORMAT_S8_UINT:
+    return VK_IMAGE_ASPECT_STENCIL_BIT;
+  default:
+    return VK_IMAGE_ASPECT_COLOR_BIT;
+  }
+}
+
+VkImageUsageFlags image_usage(VkImageLayout layout, VkAccessFlags2 access) {
+  VkImageUsageFlags usage = 0;
+  if (access & (VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT)) {
+    usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  }
+  if (access & (VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT)) {
+    usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  }
+  if (access & VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT) {
+    usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+  }
+  if (access & VK_ACCESS_2_TRANSFER_READ_BIT) {
+    usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  }
+  if (access & VK_ACCESS_2_TRANSFER_WRITE_BIT) {
+    usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  }
+  if (access & (VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT)) {
+    usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+  }
+  if (access & VK_ACCESS_2_SHADER_SAMPLED_READ_BIT) {
+    usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+  }
+  // the generic shader bits leave it to the layout
+  if (access & (VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT)) {
+    usage |= layout == VK_IMAGE_LAYOUT_GENERAL ? VK_IMAGE_USAGE_STORAGE_BIT
+                                                : VK_IMAGE_USAGE_SAMPLED_BIT;
+  }
+  return usage;
+}
+
+VkBufferUsageFlags buffer_usage(VkAccessFlags2 access) {
+  VkBufferUsageFlags usage = 0;
+  if (access & VK_ACCESS_2_TRANSFER_READ_BIT) {
+    usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  }
+  if (access & VK_ACCESS_2_TRANSFER_WRITE_BIT) {
+    usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  }
+  if (access & VK_ACCESS_2_UNIFORM_READ_BIT) {
+    usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+  }
+  if (access & (VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+                VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT)) {
+    usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+  }
+  if (access & VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT) {
+    usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+  }
+  if (access & VK_ACCESS_2_INDEX_READ_BIT) {
+    usage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+  }
+  if (access & VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT) {
+    usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+  }
+  return usage;
+}
+
+} // namespace
+
+RenderGraph::Pass::Pass(const std::string &name) : m_name(name) {}
+
+RenderGraph::Pass &RenderGraph::Pass::read(ImageHandle image, VkImageLayout layout,
+                                           VkPipelineStageFlags2 stage, VkAccessFlags2 access) {
+  return add_access({true, image.index, false, layout, stage, access});
+}
+
+RenderGraph::Pass &RenderGraph::Pass::write(ImageHandle image, VkImageLayout layout,
+                                            VkPipelineStageFlags2 stage, VkAccessFlags2 access) {
+  return add_access({true, image.index, true, layout, stage, access});
+}
+
+RenderGraph::Pass &RenderGraph::Pass::read(BufferHandle buffer, VkPipelineStageFlags2 stage,
+                                           VkAccessFlags2 access) {
+  return add_access({false, buffer.index, false, VK_IMAGE_LAYOUT_UNDEFINED, stage, access});
+}
+
+RenderGraph::Pass &RenderGraph::Pass::write(BufferHandle buffer, VkPipelineStageFlags2 stage,
+                                            VkAccessFlags2 access) {
+  return add_access({false, buffer.index, true, VK_IMAGE_LAYOUT_UNDEFINED, stage, access});
+}
+
+RenderGraph::Pass &RenderGraph::Pass::set_side_effect() {
+  m_side_effect = true;
+  return *this;
+}
+
+RenderGraph::Pass &RenderGraph::Pass::set_execute(ExecuteFunc func) {
+  m_execute = std::move(func);
+  return *this;
+}
+
+const std::string &RenderGraph::Pass::get_name() const { return m_name; }
+
+RenderGraph::Pass &RenderGraph::Pass::add_access(const Access &access) {
+  // a pass sees a single state per resource, a read and a write of the same resource become one access
+  for (auto &existing : m_accesses) {
+    if (existing.image == access.image && existing.index == access.index) {
+      assert(!access.image || existing.layout == access.layout);
+      existing.write = existing.write || access.write;
+      existing.stage |= access.stage;
+      existing.access |= access.access;
+      return *this;
+    }
+  }
+
+  m_accesses.push_back(access);
+  return *this;
+}
+
+RenderGraph::RenderGraph(const Device &device) : m_device(device) {}
+
+RenderGraph::~RenderGraph() { reset(); }
+
+RenderGraph::ImageHandle RenderGraph::create_image(const std::string &name, const ImageDesc &desc) {
+  ImageResource resource{};
+  resource.name = name;
+  resource.desc = desc;
+  m_images.push_back(std::move(resource));
+
+  m_compiled = false;
+
+  return {static_cast<uint32_t>(m_images.size() - 1)};
+}
+
+RenderGraph::BufferHandle RenderGraph::create_buffer(const std::string &name, const BufferDesc &desc) {
+  BufferResource resource{};
+  resource.name = name;
+  resource.desc = desc;
+  m_buffers.push_back(std::move(resource));
+
+  m_compiled = false;
+
+  return {static_cast<uint32_t>(m_buffers.size() - 1)};
+}
+
+RenderGraph::ImageHandle RenderGraph::import_image(const std::string &name, Image &image,
+                                                   const ImageView *image_view) {
+  ImageResource resource{};
+  resource.name = name;
+  resource.desc.extent = image.get_extent();
+  resource.desc.format = image.get_format();
+  resource.desc.mip_levels = image.get_mip_level_count();
+  resource.desc.array_layers = image.get_array_layer_count();
+  resource.imported = true;
+  resource.image = &image;
+  resource.image_view = image_view;
+  m_images.push_back(std::move(resource));
+
+  m_compiled = false;
+
+  return {static_cast<uint32_t>(m_images.size() - 1)};
+}
+
+RenderGraph::BufferHandle RenderGraph::import_buffer(const std::string &name, const Buffer &buffer) {
+  BufferResource resource{};
+  resource.name = name;
+  resource.imported = true;
+  resource.buffer = &buffer;
+  m_buffers.push_back(std::move(resource));
+
+  m_compiled = false;
+
+  return {static_cast<uint32_t>(m_buffers.size() - 1)};
+}
+
+void RenderGraph::set_image(ImageHandle handle, Image &image, const ImageView *image_view) {
+  auto &resource = m_images[handle.index];
+  assert(resource.imported);
+  resource.image = &image;
+  resource.image_view = image_view;
+}
+
+void RenderGraph::set_buffer(BufferHandle handle, const Buffer &buffer) {
+  auto &resource = m_buffers[handle.index];
+  assert(resource.imported);
+  resource.buffer = &buffer;
+}
+
+void RenderGraph::set_output(ImageHandle handle) {
+  m_images[handle.index].output = true;
+  m_compiled = false;
+}
+
+void RenderGraph::set_output(BufferHandle handle) {
+  m_buffers[handle.index].output = true;
+  m_compiled = false;
+}
+
+RenderGraph::Pass &RenderGraph::add_pass(const std::string &name) {
+  m_passes.push_back(std::unique_ptr<Pass>(new Pass(name)));
+  m_compiled = false;
+  return *m_passes.back();
+}
+
+void RenderGraph::compile() {
+  // the previous transient resources may still be referenced by command buffers in flight
+  for (auto &resource : m_images) {
+    resource.transient_image_view.reset();
+    resource.transient_image.reset();
+    if (!resource.imported) {
+      resource.image = nullptr;
+      resource.image_view = nullptr;
+    }
+    resource.lifetime = {};
+    resource.usage = resource.desc.usage;
+    resource.aliases.clear();
+  }
+  for (auto &resource : m_buffers) {
+    resource.transient_buffer.reset();
+    if (!resource.imported) {
+      resource.buffer = nullptr;
+    }
+    resource.lifetime = {};
+    resource.usage = resource.desc.usage;
+    resource.stage = VK_PIPELINE_STAGE_2_NONE;
+    resource.access = VK_ACCESS_2_NONE;
+    resource.read_stage = VK_PIPELINE_STAGE_2_NONE;
+    resource.read_access = VK_ACCESS_2_NONE;
+    resource.aliases.clear();
+  }
+  m_memories.clear();
+
+  m_statistics = {};
+  m_statistics.pass_count = static_cast<uint32_t>(m_passes.size());
+
+  cull();
+
+  m_statistics.culled_pass_count = static_cast<uint32_t>(m_passes.size() - m_schedule.size());
+
+  for (uint32_t position = 0; position < m_schedule.size(); ++position) {
+    for (const auto &access : m_passes[m_schedule[position]]->m_accesses) {
+      auto &lifetime = access.image ? m_images[access.index].lifetime : m_buffers[access.index].lifetime;
+      lifetime.first = std::min(lifetime.first, position);
+      lifetime.last = std::max(lifetime.last, position);
+
+      if (access.image) {
+        m_images[access.index].usage |= image_usage(access.layout, access.access);
+      } else {
+        m_buffers[access.index].usage |= buffer_usage(access.access);
+      }
+    }
+  }
+
+  create_transient_images();
+  create_transient_buffers();
+
+  m_compiled = true;
+}
+
+void RenderGraph::execute(const CommandBuffer &cmd_buffer) {
+  assert(m_compiled);
+
+  // transient contents do not survive between executions, the first access discards them
+  std::vector<bool> image_discarded(m_images.size(), false);
+  std::vector<bool> buffer_discarded(m_buffers.size(), false);
+
+  for (auto pass_index : m_schedule) {
+    const auto &pass = *m_passes[pass_index];
+
+    for (const auto &access : pass.m_accesses) {
+      bool write = access.write || utils::is_write_access(access.access);
+
+      if (access.image) {
+        auto &resource = m_images[access.index];
+        if (!resource.imported && !image_discarded[access.index]) {
+          discard(resource);
+          image_discarded[access.index] = true;
+        }
+
+        cmd_buffer.image_barrier(*resource.image, access.layout, access.stage, access.access,
+                                 aspect_flags(resource.desc.format));
+      } else {
+        auto &resource = m_buffers[access.index];
+        if (!resource.imported && !buffer_discarded[access.index]) {
+          discard(resource);
+          buffer_discarded[access.index] = true;
+        }
+
+        auto src_access = utils::is_write_access(resource.access) ? resource.access : VK_ACCESS_2_NONE;
+        if (write) {
+          // a writer waits on the last write and every reader since
+          cmd_buffer.memory_barrier(resource.stage | resource.read_stage, src_access, access.stage, access.access);
+          resource.stage = access.stage;
+          resource.access = access.access;
+          resource.read_stage = VK_PIPELINE_STAGE_2_NONE;
+          resource.read_access = VK_ACCESS_2_NONE;
+        } else {
+          // a reader only waits on the last write when it is not covered by an earlier barrier from it
+          if (resource.stage != VK_PIPELINE_STAGE_2_NONE &&
+              ((access.stage & ~resource.read_stage) != 0 || (access.access & ~resource.read_access) != 0)) {
+            cmd_buffer.memory_barrier(resource.stage, src_access, access.stage, access.access);
+          }
+          resource.read_stage |= access.stage;
+          resource.read_access |= access.access;
+        }
+      }
+    }
+
+    // the queued barriers are recorded by the first command of the pass
+    if (pass.m_execute) {
+      pass.m_execute(cmd_buffer);
+    }
+  }
+
+  cmd_buffer.flush_barriers();
+}
+
+void RenderGraph::reset() {
+  m_passes.clear();
+  m_schedule.clear();
+  m_images.clear();
+  m_buffers.clear();
+  m_memories.clear();
+  m_statistics = {};
+  m_compiled = false;
+}
+
+Image &RenderGraph::get_image(ImageHandle handle) const {
+  assert(m_images[handle.index].image != nullptr);
+  return *m_images[handle.index].image;
+}
+
+const ImageView &RenderGraph::get_image_view(ImageHandle handle) const {
+  assert(m_images[handle.index].image_view != nullptr);
+  return *m_images[handle.index].image_view;
+}
+
+const Buffer &RenderGraph::get_buffer(BufferHandle handle) const {
+  assert(m_buffers[handle.index].buffer != nullptr);
+  return *m_buffers[handle.index].buffer;
+}
+
+const RenderGraph::Statistics &RenderGraph::get_statistics() const { return m_statistics; }
+
+void RenderGraph::cull() {
+  // imported resources are visible outside of the graph, walk backwards from them and from the passes with side
+  // effects, keeping every pass that writes something a kept pass accesses
+  std::vector<bool> image_needed(m_images.size());
+  std::vector<bool> buffer_needed(m_buffers.size());
+  for (uint32_t i = 0; i < m_images.size(); ++i) {
+    image_needed[i] = m_images[i].imported || m_images[i].output;
+  }
+  for (uint32_t i = 0; i < m_buffers.size(); ++i) {
+    buffer_needed[i] = m_buffers[i].imported || m_buffers[i].output;
+  }
+
+  std::vector<bool> alive(m_passes.size(), false);
+  for (auto i = static_cast<int32_t>(m_passes.size()) - 1; i >= 0; --i) {
+    const auto &pass = *m_passes[i];
+
+    bool keep = pass.m_side_effect;
+    for (const auto &access : pass.m_accesses) {
+      if (access.write && (access.image ? image_needed[access.index] : buffer_needed[access.index])) {
+        keep = true;
+      }
+    }
+
+    if (!keep) {
+      continue;
+    }
+
+    alive[i] = true;
+
+    // writes may be partial, earlier writers of the same resource stay alive too
+    for (const auto &access : pass.m_accesses) {
+      if (access.image) {
+        image_needed[access.index] = true;
+      } else {
+        buffer_needed[access.index] = true;
+      }
+    }
+  }
+
+  m_schedule.clear();
+  for (uint32_t i = 0; i < m_passes.size(); ++i) {
+    if (alive[i]) {
+      m_schedule.push_back(i);
+    }
+  }
+}
+
+void RenderGraph::create_transient_images() {
+  std::vector<Placement> placements;
+
+  for (uint32_t i = 0; i < m_images.size(); ++i) {
+    auto &resource = m_images[i];
+    if (resource.imported || resource.lifetime.first == UINT32_MAX) {
+      continue;
+    }
+
+    ImageCreateInfo create_info{};
+    create_info.set_image_type(resource.desc.extent.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D)
+        .set_format(resource.desc.format)
+        .set_extent(resource.desc.extent)
+        .set_mip_levels(resource.desc.mip_levels)
+        .set_array_layers(resource.desc.array_layers)
+        .set_usage(resource.usage)
+        .set_initial_layout(VK_IMAGE_LAYOUT_UNDEFINED);
+
+    resource.transient_image = std::make_unique<Image>(m_device, create_info);
+    resource.image = resource.transient_image.get();
+
+    const auto &requirements = resource.image->get_memory_requirements();
+    m_statistics.transient_image_count++;
+    m_statistics.unaliased_bytes += requirements.size;
+
+    if (resource.image->requires_dedicated_allocation()) {
+      m_memories.push_back(std::make_unique<DeviceMemory>(*resource.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+      resource.image->bind_memory(*m_memories.back());
+      m_statistics.transient_bytes += requirements.size;
+    } else {
+      placements.push_back({i, resource.lifetime, requirements});
+    }
+  }
+
+  for (auto &group : place(std::move(placements))) {
+    VkMemoryRequirements requirements{0, 1, UINT32_MAX};
+    for (const auto &placement : group) {
+      requirements.size = std::max(requirements.size, placement.offset + placement.requirements.size);
+      requirements.alignment = std::max(requirements.alignment, placement.requirements.alignment);
+      requirements.memoryTypeBits &= placement.requirements.memoryTypeBits;
+    }
+
+    m_memories.push_back(std::make_unique<DeviceMemory>(m_device, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+    m_statistics.transient_bytes += requirements.size;
+
+    for (const auto &placement : group) {
+      m_images[placement.index].image->bind_memory(*m_memories.back(), placement.offset);
+
+      for (const auto &other : group) {
+        if (other.index != placement.index && placement.offset < other.offset + other.requirements.size &&
+            other.offset < placement.offset + placement.requirements.size) {
+          m_images[placement.index].aliases.push_back(other.index);
+        }
+      }
+    }
+  }
+
+  // views need bound memory
+  for (auto &resource : m_images) {
+    if (!resource.transient_image) {
+      continue;
+    }
+
+    ImageViewCreateInfo view_create_info{};
+    view_create_info.set_view_type(resource.desc.extent.depth > 1     ? VK_IMAGE_VIEW_TYPE_3D
+                                   : resource.desc.array_layers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY
+                                                                    : VK_IMAGE_VIEW_TYPE_2D)
+        .set_level_count(resource.desc.mip_levels)
+        .set_layer_count(resource.desc.array_layers);
+
+    resource.transient_image_view = std::make_unique<ImageView>(*resource.transient_image, view_create_info);
+    resource.image_view = resource.transient_image_view.get();
+  }
+}
+
+void RenderGraph::create_transient_buffers() {
+  std::vector<Placement> placements;
+  VkMemoryAllocateFlags allocate_flags = 0;
+
+  for (uint32_t i = 0; i < m_buffers.size(); ++i) {
+    auto &resource = m_buffers[i];
+    if (resource.imported || resource.lifetime.first == UINT32_MAX) {
+      continue;
+    }
+
+    resource.transient_buffer = std::make_unique<Buffer>(m_device, resource.desc.size, resource.usage);
+    resource.buffer = resource.transient_buffer.get();
+
+    if (resource.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+      allocate_flags |= VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    }
+
+    const auto &requirements = resource.buffer->get_memory_requirements();
+    m_statistics.transient_buffer_count++;
+    m_statistics.unaliased_bytes += requirements.size;
+
+    placements.push_back({i, resource.lifetime, requirements});
+  }
+
+  for (auto &group : place(std::move(placements))) {
+    VkMemoryRequirements requirements{0, 1, UINT32_MAX};
+    for (const auto &placement : group) {
+      requirements.size = std::max(requirements.size, placement.offset + placement.requirements.size);
+      requirements.alignment = std::max(requirements.alignment, placement.requirements.alignment);
+      requirements.memoryTypeBits &= placement.requirements.memoryTypeBits;
+    }
+
+    m_memories.push_back(
+        std::make_unique<DeviceMemory>(m_device, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, allocate_flags));
+    m_statistics.transient_bytes += requirements.size;
+
+    for (const auto &placement : group) {
+      m_buffers[placement.index].transient_buffer->bind_memory(*m_memories.back(), placement.offset);
+
+      for (const auto &other : group) {
+        if (other.index != placement.index && placement.offset < other.offset + other.requirements.size &&
+            other.offset < placement.offset + placement.requirements.size) {
+          m_buffers[placement.index].aliases.push_back(other.index);
+        }
+      }
+    }
+  }
+}
+
+std::vector<std::vector<RenderGraph::Placement>> RenderGraph::place(std::vector<Placement> placements) {
+  // largest first keeps the small resources filling the gaps
+  std::sort(placements.begin(), placements.end(), [](const Placement &lhs, const Placement &rhs) {
+    return lhs.requirements.size > rhs.requirements.size;
+  });
+
+  std::vector<std::vector<Placement>> groups;
+  std::vector<uint32_t> group_memory_type_bits;
+
+  for (auto &placement : placements) {
+    uint32_t group_index = 0;
+    while (group_index < groups.size() &&
+           (group_memory_type_bits[group_index] & placement.requirements.memoryTypeBits) == 0) {
+      group_index++;
+    }
+    if (group_index == groups.size()) {
+      groups.emplace_back();
+      group_memory_type_bits.push_back(UINT32_MAX);
+    }
+
+    auto &group = groups[group_index];
+
+    auto overlaps_lifetime = [&](const Placement &other) {
+      return placement.lifetime.first <= other.lifetime.last && other.lifetime.first <= placement.lifetime.last;
+    };
+
+    // the lowest offset is either the start of the allocation or the end of a resource alive at the same time
+    std::vector<VkDeviceSize> candidates{0};
+    for (const auto &other : group) {
+      if (overlaps_lifetime(other)) {
+        candidates.push_back(
+            utils::align_up(other.offset + other.requirements.size, placement.requirements.alignment));
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto candidate : candidates) {
+      bool fits = true;
+      for (const auto &other : group) {
+        if (overlaps_lifetime(other) && candidate < other.offset + other.requirements.size &&
+            other.offset < candidate + placement.requirements.size) {
+          fits = false;
+          break;
+        }
+      }
+
+      if (fits) {
+        placement.offset = candidate;
+        break;
+      }
+    }
+
+    group.push_back(placement);
+    group_memory_type_bits[group_index] &= placement.requirements.memoryTypeBits;
+  }
+
+  return groups;
+}
+
+void RenderGraph::discard(ImageResource &resource) {
+  // whatever used the memory last, this image in the previous execution or an alias, has to finish first
+  auto state = resource.image->get_state(0, 0);
+  state.stage |= state.read_stage;
+  for (auto alias : resource.aliases) {
+    const auto &alias_state = m_images[alias].image->get_state(0, 0);
+    state.stage |= alias_state.stage | alias_state.read_stage;
+    state.access |= alias_state.access;
+  }
+
+  resource.image->update_layout(VK_IMAGE_LAYOUT_UNDEFINED, state.stage, state.access);
+}
+
+void RenderGraph::discard(BufferResource &resource) {
+  for (auto alias : resource.aliases) {
+    resource.stage |= m_buffers[alias].stage;
+    resource.access |= m_buffers[alias].access;
+    resource.read_stage |= m_buffers[alias].read_stage;
+    resource.read_access |= m_buffers[alias].read_access;
+  }
+}
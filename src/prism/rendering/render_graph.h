@@ -0,0 +1,237 @@
+#pragma once
+
+#include <functional>
+
+#include "prism/vulkan/buffer.h"
+#include "prism/vulkan/command_buffer.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/device_memory.h"
+#include "prism/vulkan/image.h"
+#include "prism/vulkan/image_view.h"
+
+namespace prism {
+
+// passes declare the buffers and images they read and write. compile() culls the passes that do not contribute to
+// an output and places transient resources with disjoint lifetimes in shared memory, execute() records the remaining
+// passes in declaration order with the barriers their accesses require
+class RenderGraph {
+public:
+  struct ImageHandle {
+    uint32_t index{UINT32_MAX};
+  };
+
+  struct BufferHandle {
+    uint32_t index{UINT32_MAX};
+  };
+
+  struct ImageDesc {
+    VkExtent3D extent{};
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    uint32_t mip_levels{1};
+    uint32_t array_layers{1};
+    // added to the usage derived from the declared accesses
+    VkImageUsageFlags usage{0};
+  };
+
+  struct BufferDesc {
+    VkDeviceSize size{0};
+    // added to the usage derived from the declared accesses
+    VkBufferUsageFlags usage{0};
+  };
+
+  struct Statistics {
+    uint32_t pass_count{0};
+    uint32_t culled_pass_count{0};
+    uint32_t transient_image_count{0};
+    uint32_t transient_buffer_count{0};
+    // memory backing the transient resources and what it would take without aliasing
+    VkDeviceSize transient_bytes{0};
+    VkDeviceSize unaliased_bytes{0};
+  };
+
+  using ExecuteFunc = std::function<void(const CommandBuffer &)>;
+
+  class Pass {
+  public:
+    Pass &read(ImageHandle image, VkImageLayout layout, VkPipelineStageFlags2 stage, VkAccessFlags2 access);
+
+    Pass &write(ImageHandle image, VkImageLayout layout, VkPipelineStageFlags2 stage, VkAccessFlags2 access);
+
+    Pass &read(BufferHandle buffer, VkPipelineStageFlags2 stage, VkAccessFlags2 access);
+
+    Pass &write(BufferHandle buffer, VkPipelineStageFlags2 stage, VkAccessFlags2 access);
+
+    // the pass has effects outside of the graph, e.g. it renders to the swapchain, and is never culled
+    Pass &set_side_effect();
+
+    Pass &set_execute(ExecuteFunc func);
+
+    const std::string &get_name() const;
+
+  private:
+    friend class RenderGraph;
+
+    struct Access {
+      bool image;
+      uint32_t index;
+      bool write;
+      VkImageLayout layout;
+      VkPipelineStageFlags2 stage;
+      VkAccessFlags2 access;
+    };
+
+    explicit Pass(const std::string &name);
+
+    Pass &add_access(const Access &access);
+
+  private:
+    std::string m_name;
+
+    std::vector<Access> m_accesses;
+
+    ExecuteFunc m_execute;
+
+    bool m_side_effect{false};
+
+  }; // class Pass
+
+public:
+  RenderGraph(const Device &device);
+
+  RenderGraph(const RenderGraph &) = delete;
+
+  RenderGraph(RenderGraph &&) = delete;
+
+  ~RenderGraph();
+
+  RenderGraph &operator=(const RenderGraph &) = delete;
+
+  RenderGraph &operator=(RenderGraph &&) = delete;
+
+  // transient resources are created by compile() and only live for the duration of the graph
+  ImageHandle create_image(const std::string &name, const ImageDesc &desc);
+
+  BufferHandle create_buffer(const std::string &name, const BufferDesc &desc);
+
+  // imported resources are never aliased and count as outputs, their state carries over between executions
+  ImageHandle import_image(const std::string &name, Image &image, const ImageView *image_view = nullptr);
+
+  BufferHandle import_buffer(const std::string &name, const Buffer &buffer);
+
+  // points an imported resource at another object without recompiling, e.g. the acquired swapchain image
+  void set_image(ImageHandle handle, Image &image, const ImageView *image_view = nullptr);
+
+  void set_buffer(BufferHandle handle, const Buffer &buffer);
+
+  // keeps the passes writing a transient resource alive although no pass reads it
+  void set_output(ImageHandle handle);
+
+  void set_output(BufferHandle handle);
+
+  Pass &add_pass(const std::string &name);
+
+  // recreates the transient resources, the previous ones must no longer be in use by the gpu
+  void compile();
+
+  void execute(const CommandBuffer &cmd_buffer);
+
+  // drops all passes and resources
+  void reset();
+
+  Image &get_image(ImageHandle handle) const;
+
+  const ImageView &get_image_view(ImageHandle handle) const;
+
+  const Buffer &get_buffer(BufferHandle handle) const;
+
+  // filled by compile, reporting is left to the caller
+  const Statistics &get_statistics() const;
+
+private:
+  struct Lifetime {
+    uint32_t first{UINT32_MAX};
+    uint32_t last{0};
+  };
+
+  struct ImageResource {
+    std::string name;
+    ImageDesc desc;
+    bool imported{false};
+    bool output{false};
+    Lifetime lifetime;
+    VkImageUsageFlags usage{0};
+
+    Image *image{nullptr};
+    const ImageView *image_view{nullptr};
+
+    std::unique_ptr<Image> transient_image;
+    std::unique_ptr<ImageView> transient_image_view;
+
+    // transient images sharing memory with this one
+    std::vector<uint32_t> aliases;
+  };
+
+  struct BufferResource {
+    std::string name;
+    BufferDesc desc;
+    bool imported{false};
+    bool output{false};
+    Lifetime lifetime;
+    VkBufferUsageFlags usage{0};
+
+    const Buffer *buffer{nullptr};
+
+    std::unique_ptr<Buffer> transient_buffer;
+
+    // buffers have no state of their own, the graph tracks the last write and the readers it was made visible to
+    VkPipelineStageFlags2 stage{VK_PIPELINE_STAGE_2_NONE};
+    VkAccessFlags2 access{VK_ACCESS_2_NONE};
+    VkPipelineStageFlags2 read_stage{VK_PIPELINE_STAGE_2_NONE};
+    VkAccessFlags2 read_access{VK_ACCESS_2_NONE};
+
+    std::vector<uint32_t> aliases;
+  };
+
+  // a transient resource waiting to be placed in a shared allocation
+  struct Placement {
+    uint32_t index;
+    Lifetime lifetime;
+    VkMemoryRequirements requirements;
+    VkDeviceSize offset{0};
+  };
+
+  void cull();
+
+  void create_transient_images();
+
+  void create_transient_buffers();
+
+  // assigns offsets to placements so that resources whose lifetimes overlap never share memory, returns one
+  // allocation per group of compatible memory types
+  std::vector<std::vector<Placement>> place(std::vector<Placement> placements);
+
+  void discard(ImageResource &resource);
+
+  void discard(BufferResource &resource);
+
+private:
+  const Device &m_device;
+
+  std::vector<std::unique_ptr<Pass>> m_passes;
+
+  std::vector<ImageResource> m_images;
+
+  std::vector<BufferResource> m_buffers;
+
+  // indices of the passes that survived culling, in execution order
+  std::vector<uint32_t> m_schedule;
+
+  std::vector<std::unique_ptr<DeviceMemory>> m_memories;
+
+  Statistics m_statistics;
+
+  bool m_compiled{false};
+
+}; // class RenderGraph
+
+} // namespace prism
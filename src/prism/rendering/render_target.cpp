@@ -0,0 +1,33 @@
+#include "prism/rendering/render_target.h"
+
+using namespace prism;
+
+RenderTarget::RenderTarget(const Device &device, const Image &image)
+    : m_device(device) {
+  ImageViewCreateInfo image_view_ci{};
+  image_view_ci.set_view_type(VK_IMAGE_VIEW_TYPE_2D)
+      .set_level_count(1)
+      .set_layer_count(1)
+      .set_aspect_mask(VK_IMAGE_ASPECT_COLOR_BIT);
+  image_view_ci.set_format(image.get_format());
+  m_image_views.emplace_back(image, image_view_ci);
+
+  m_present_semaphore = std::make_unique<Semaphore>(m_device);
+}
+
+RenderTarget::RenderTarget(RenderTarget &&other)
+    : m_device(other.m_device),
+      m_image_views(std::move(other.m_image_views)),
+      m_present_semaphore(std::move(other.m_present_semaphore))
+{
+}
+
+RenderTarget::~RenderTarget() {}
+
+const std::vector<ImageView> &RenderTarget::get_image_views() const {
+  return m_image_views;
+}
+
+const Semaphore &RenderTarget::get_present_semaphore() const {
+  return *m_present_semaphore;
+}
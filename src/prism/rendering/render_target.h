@@ -0,0 +1,37 @@
+#pragma once
+
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/image_view.h"
+#include "prism/vulkan/semaphore.h"
+
+namespace prism {
+// per swapchain image state, lives as long as the swapchain
+class RenderTarget {
+public:
+  RenderTarget(const Device &device, const Image &image);
+
+  ~RenderTarget();
+
+  RenderTarget(const RenderTarget &) = delete;
+
+  RenderTarget(RenderTarget &&);
+
+  RenderTarget &operator=(const RenderTarget &) = delete;
+
+  RenderTarget &operator=(RenderTarget &&) = delete;
+
+  const std::vector<ImageView> &get_image_views() const;
+
+  // signaled by the render submit and waited on by present, one per image so it is never reused while a present is pending
+  const Semaphore &get_present_semaphore() const;
+
+private:
+  const Device &m_device;
+
+  std::vector<ImageView> m_image_views;
+
+  std::unique_ptr<Semaphore> m_present_semaphore;
+
+}; // class RenderTarget
+
+} // namespace prism
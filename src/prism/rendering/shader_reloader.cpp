@@ -0,0 +1,138 @@
+#include "prism/rendering/shader_reloader.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "prism/core/filesystem.h"
+
+using namespace prism;
+
+namespace {
+const std::chrono::milliseconds WATCH_TIMEOUT{100};
+
+std::string canonical_path(const std::string &path) {
+  std::error_code error;
+  auto result = std::filesystem::weakly_canonical(path, error);
+  return error ? path : result.string();
+}
+} // namespace
+
+ShaderReloader::ShaderReloader(const Device &device, ShaderCompiler &compiler, uint32_t frames_in_flight)
+    : m_device(device), m_compiler(compiler), m_frames_in_flight(frames_in_flight) {
+  m_thread = std::thread(&ShaderReloader::run, this);
+}
+
+ShaderReloader::~ShaderReloader() {
+  m_stop = true;
+  m_thread.join();
+}
+
+uint32_t ShaderReloader::update() {
+  ++m_update_count;
+
+  uint32_t swap_count = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &entry : m_entries) {
+      if (entry->pending) {
+        m_retired.emplace_back(m_update_count, std::move(entry->current));
+        entry->current = std::move(entry->pending);
+        ++swap_count;
+      }
+    }
+  }
+
+  // the last frame recorded with a retired pipeline was recorded before the update that retired it
+  while (!m_retired.empty() && m_update_count - m_retired.front().first >= m_frames_in_flight) {
+    m_retired.pop_front();
+  }
+
+  return swap_count;
+}
+
+const ShaderReloader::Entry *ShaderReloader::add(std::unique_ptr<Entry> entry) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_new_files.insert(m_new_files.end(), entry->files.begin(), entry->files.end());
+  m_entries.push_back(std::move(entry));
+  return m_entries.back().get();
+}
+
+std::shared_ptr<void> ShaderReloader::build(const Entry &entry, std::vector<std::string> &files) {
+  files.clear();
+
+  std::vector<ShaderModule> modules;
+  modules.reserve(entry.stages.size());
+  for (const auto &stage : entry.stages) {
+    GlslSource source{};
+    source.filename = canonical_path(stage.filename);
+    source.code = read_file(source.filename);
+    source.defines = stage.defines;
+    if (source.code.empty()) {
+      throw std::runtime_error("Failed to read " + source.filename);
+    }
+
+    // an edit that adds an include starts watching it
+    files.push_back(source.filename);
+    for (const auto &include : m_compiler.get_includes(source)) {
+      files.push_back(canonical_path(include));
+    }
+
+    modules.emplace_back(m_device, m_compiler, source, stage.stage, stage.entry_point);
+  }
+
+  return entry.build(modules);
+}
+
+void ShaderReloader::run() {
+  FileWatcher watcher;
+
+  while (!m_stop) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (const auto &file : m_new_files) {
+        watcher.watch(file);
+      }
+      m_new_files.clear();
+    }
+
+    auto changed = watcher.wait(WATCH_TIMEOUT);
+    if (changed.empty()) {
+      continue;
+    }
+
+    // entries are never removed and their stages never change, only the affected ones are rebuilt
+    std::vector<Entry *> affected;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto &entry : m_entries) {
+        auto is_affected = std::any_of(entry->files.begin(), entry->files.end(), [&changed](const std::string &file) {
+          return std::find(changed.begin(), changed.end(), file) != changed.end();
+        });
+        if (is_affected) {
+          affected.push_back(entry.get());
+        }
+      }
+    }
+
+    for (auto *entry : affected) {
+      std::vector<std::string> files;
+      std::shared_ptr<void> pipeline;
+      try {
+        pipeline = build(*entry, files);
+      } catch (const std::exception &e) {
+        LOG_ERROR("shader reload failed, keeping the previous pipeline: {}", e.what());
+        continue;
+      }
+
+      LOG_INFO("reloaded pipeline from {}", entry->stages.front().filename);
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (const auto &file : files) {
+        watcher.watch(file);
+      }
+      entry->files = std::move(files);
+      // a pipeline rebuilt twice before an update was never bound, it can go right away
+      entry->pending = std::move(pipeline);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "prism/core/file_watcher.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/shader_compiler.h"
+#include "prism/vulkan/shader_module.h"
+
+namespace prism {
+// rebuilds pipelines when the glsl they are made from changes on disk. sources are recompiled on a background
+// thread and the rebuilt pipelines wait there until update() swaps them in at a frame boundary, so the render loop
+// never waits on a compile. a source that fails to compile is logged and the pipeline built from the last good
+// version stays in use
+class ShaderReloader {
+public:
+  struct Stage {
+    std::string filename;
+    VkShaderStageFlagBits stage;
+    std::vector<std::string> defines;
+    std::string entry_point{"main"};
+  };
+
+  // creates the pipeline from modules compiled in the order of the stages, called on the reload thread after the
+  // first build, everything else it uses has to outlive the reloader
+  template <typename Pipeline>
+  using BuildFunc = std::function<Pipeline(const std::vector<ShaderModule> &)>;
+
+private:
+  struct Entry {
+    std::vector<Stage> stages;
+
+    std::function<std::shared_ptr<void>(const std::vector<ShaderModule> &)> build;
+
+    // sources and everything they include
+    std::vector<std::string> files;
+
+    // only touched by the thread calling update()
+    std::shared_ptr<void> current;
+
+    std::shared_ptr<void> pending;
+  };
+
+public:
+  template <typename Pipeline>
+  class Handle {
+  public:
+    Handle() = default;
+
+    // the pipeline in use since the last update()
+    const Pipeline &get() const { return *static_cast<const Pipeline *>(m_entry->current.get()); }
+
+  private:
+    friend class ShaderReloader;
+
+    explicit Handle(const Entry *entry) : m_entry(entry) {}
+
+  private:
+    const Entry *m_entry{nullptr};
+  };
+
+public:
+  // a replaced pipeline is destroyed frames_in_flight updates later, once no frame recorded with it can be pending
+  ShaderReloader(const Device &device, ShaderCompiler &compiler, uint32_t frames_in_flight);
+
+  ShaderReloader(const ShaderReloader &) = delete;
+
+  ShaderReloader(ShaderReloader &&) = delete;
+
+  ~ShaderReloader();
+
+  ShaderReloader &operator=(const ShaderReloader &) = delete;
+
+  ShaderReloader &operator=(ShaderReloader &&) = delete;
+
+  // builds the pipeline right away, throws if the sources do not compile
+  template <typename Pipeline>
+  Handle<Pipeline> add(const std::vector<Stage> &stages, const BuildFunc<Pipeline> &build) {
+    auto entry = std::make_unique<Entry>();
+    entry->stages = stages;
+    entry->build = [build](const std::vector<ShaderModule> &modules) -> std::shared_ptr<void> {
+      return std::make_shared<Pipeline>(build(modules));
+    };
+    entry->current = this->build(*entry, entry->files);
+
+    return Handle<Pipeline>(add(std::move(entry)));
+  }
+
+  // swaps in the pipelines rebuilt since the last call and destroys the retired ones the gpu is done with, call it
+  // once per frame after waiting on the frame's fence. returns the number of pipelines swapped
+  uint32_t update();
+
+private:
+  const Entry *add(std::unique_ptr<Entry> entry);
+
+  std::shared_ptr<void> build(const Entry &entry, std::vector<std::string> &files);
+
+  void run();
+
+private:
+  const Device &m_device;
+
+  ShaderCompiler &m_compiler;
+
+  uint32_t m_frames_in_flight;
+
+  std::mutex m_mutex;
+
+  std::vector<std::unique_ptr<Entry>> m_entries;
+
+  // files added since the watcher last looked, the watcher belongs to the reload thread
+  std::vector<std::string> m_new_files;
+
+  // replaced pipelines and the update they were replaced in
+  std::deque<std::pair<uint64_t, std::shared_ptr<void>>> m_retired;
+
+  uint64_t m_update_count{0};
+
+  std::atomic<bool> m_stop{false};
+
+  std::thread m_thread;
+
+}; // class ShaderReloader
+
+} // namespace prism
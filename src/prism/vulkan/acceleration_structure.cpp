@@ -1,58 +1,36 @@
 #include "prism/vulkan/acceleration_structure.h"
 
-#include "prism/vulkan/utils.h"
-#include "prism/vulkan/command_pool.h"
+#include <algorithm>
+
+#include "prism/vulkan/acceleration_structure_builder.h"
 #include "prism/vulkan/command_buffer.h"
 
 using namespace prism;
 
-AccelerationStructure::AccelerationStructure(const Device &device, VkAccelerationStructureTypeKHR type, const std::vector<AccelerationStructureGeometry> &geometries)
-    : m_device(device)
+AccelerationStructure::AccelerationStructure(const Device &device, VkAccelerationStructureTypeKHR type, const std::vector<AccelerationStructureGeometry> &geometries,
+                                             VkBuildAccelerationStructureFlagsKHR flags)
+    : AccelerationStructure(device, type, get_build_sizes(device, type, geometries, flags).accelerationStructureSize, flags)
 {
-  auto geometry_count = geometries.size();
-  std::vector<VkAccelerationStructureGeometryKHR> geometry_data(geometry_count);
-  std::vector<uint32_t> primitive_counts(geometry_count);
-  std::vector<VkAccelerationStructureBuildRangeInfoKHR> build_range_infos(geometry_count);
-  for (size_t i = 0; i < geometry_count; ++i)
-  {
-    geometry_data[i] = geometries[i].get_handle();
-    primitive_counts[i] = geometries[i].get_primitive_count();
-
-    build_range_infos[i].primitiveCount = primitive_counts[i];
-    build_range_infos[i].primitiveOffset = 0;
-    build_range_infos[i].firstVertex = 0;
-    build_range_infos[i].transformOffset = geometries[i].get_transform_offset();
-  }
-
-  VkAccelerationStructureBuildGeometryInfoKHR build_geometry_info{};
-  build_geometry_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-  build_geometry_info.type = type;
-  build_geometry_info.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
-  build_geometry_info.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-  build_geometry_info.geometryCount = static_cast<uint32_t>(geometry_data.size());
-  build_geometry_info.pGeometries = geometry_data.data();
-
-  VkAccelerationStructureBuildSizesInfoKHR build_sizes_info = {};
-  build_sizes_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-  m_device.get_extension_functions().get_acceleration_structure_build_sizes(
-      device.get_handle(),
-      VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-      &build_geometry_info,
-      primitive_counts.data(),
-      &build_sizes_info);
+  AccelerationStructureBuilder builder(m_device);
+  builder.add(*this, geometries);
+  builder.build();
+}
 
+AccelerationStructure::AccelerationStructure(const Device &device, VkAccelerationStructureTypeKHR type, VkDeviceSize size, VkBuildAccelerationStructureFlagsKHR flags)
+    : m_device(device), m_type(type), m_size(size), m_flags(flags)
+{
   m_buffer = std::make_unique<Buffer>(
       device,
-      build_sizes_info.accelerationStructureSize,
+      size,
       VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
-  m_memory = std::make_unique<DeviceMemory>(device, m_buffer->get_memory_requirements(), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT);
+  m_memory = std::make_unique<DeviceMemory>(*m_buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT);
   m_buffer->bind_memory(*m_memory);
 
   VkAccelerationStructureCreateInfoKHR create_info = {};
   create_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
   create_info.type = type;
   create_info.buffer = m_buffer->get_handle();
-  create_info.size = build_sizes_info.accelerationStructureSize;
+  create_info.size = size;
 
   VK_CHECK(m_device.get_extension_functions().create_acceleration_structure(m_device.get_handle(), &create_info, nullptr, &m_handle));
 
@@ -60,32 +38,6 @@ AccelerationStructure::AccelerationStructure(const Device &device, VkAcceleratio
   device_address_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
   device_address_info.accelerationStructure = m_handle;
   m_device_address = m_device.get_extension_functions().get_acceleration_structure_device_address(m_device.get_handle(), &device_address_info);
-
-  auto queue_family_index = m_device.get_physical_device().get_queue_family_index(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT);
-  const auto &queue = m_device.get_queue(queue_family_index, 0);
-  CommandPool command_pool(m_device, queue_family_index);
-  utils::submit_commands_to_queue(
-      command_pool,
-      queue,
-      [&](const CommandBuffer &cmd_buffer)
-      {
-        m_scratch_buffer = std::make_unique<Buffer>(
-            device,
-            build_sizes_info.buildScratchSize,
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
-        m_scratch_memory = std::make_unique<DeviceMemory>(device, m_scratch_buffer->get_memory_requirements(), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT);
-        m_scratch_buffer->bind_memory(*m_scratch_memory);
-
-        build_geometry_info.dstAccelerationStructure = m_handle;
-        build_geometry_info.scratchData.deviceAddress = m_scratch_buffer->get_device_address();
-
-        auto build_range_info_data = &*build_range_infos.data();
-        m_device.get_extension_functions().cmd_build_acceleration_structures(
-            cmd_buffer.get_handle(),
-            1,
-            &build_geometry_info,
-            &build_range_info_data);
-      });
 }
 
 AccelerationStructure::~AccelerationStructure()
@@ -96,6 +48,94 @@ AccelerationStructure::~AccelerationStructure()
   }
 }
 
+void AccelerationStructure::build(const CommandBuffer &cmd_buffer, const std::vector<AccelerationStructureGeometry> &geometries)
+{
+  record(cmd_buffer, geometries, VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR);
+  m_update_count = 0;
+}
+
+void AccelerationStructure::update(const CommandBuffer &cmd_buffer, const std::vector<AccelerationStructureGeometry> &geometries)
+{
+  if (!(m_flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR))
+  {
+    throw std::runtime_error("Acceleration structure was not built with ALLOW_UPDATE");
+  }
+
+  if (m_rebuild_interval != 0 && m_update_count >= m_rebuild_interval)
+  {
+    build(cmd_buffer, geometries);
+    return;
+  }
+
+  record(cmd_buffer, geometries, VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR);
+  m_update_count++;
+}
+
+void AccelerationStructure::reserve_scratch(const std::vector<AccelerationStructureGeometry> &geometries)
+{
+  auto build_sizes = get_build_sizes(m_device, m_type, geometries, m_flags);
+  auto scratch_size = std::max(build_sizes.updateScratchSize, build_sizes.buildScratchSize);
+  if (m_scratch_size >= scratch_size)
+  {
+    return;
+  }
+
+  auto scratch_alignment = std::max<VkDeviceSize>(m_device.get_physical_device().get_acceleration_structure_properties().minAccelerationStructureScratchOffsetAlignment, 1);
+
+  m_scratch_memory.reset();
+  m_scratch_buffer = std::make_unique<Buffer>(
+      m_device,
+      scratch_size,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+  auto scratch_requirements = m_scratch_buffer->get_memory_requirements();
+  scratch_requirements.alignment = std::max(scratch_requirements.alignment, scratch_alignment);
+  m_scratch_memory = std::make_unique<DeviceMemory>(m_device, scratch_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT);
+  m_scratch_buffer->bind_memory(*m_scratch_memory);
+  m_scratch_size = scratch_size;
+}
+
+void AccelerationStructure::set_rebuild_interval(uint32_t rebuild_interval)
+{
+  m_rebuild_interval = rebuild_interval;
+}
+
+uint32_t AccelerationStructure::get_update_count() const
+{
+  return m_update_count;
+}
+
+VkAccelerationStructureBuildSizesInfoKHR AccelerationStructure::get_build_sizes(const Device &device, VkAccelerationStructureTypeKHR type,
+                                                                                const std::vector<AccelerationStructureGeometry> &geometries,
+                                                                                VkBuildAccelerationStructureFlagsKHR flags)
+{
+  std::vector<VkAccelerationStructureGeometryKHR> geometry_data(geometries.size());
+  std::vector<uint32_t> primitive_counts(geometries.size());
+  for (size_t i = 0; i < geometries.size(); ++i)
+  {
+    geometry_data[i] = geometries[i].get_handle();
+    primitive_counts[i] = geometries[i].get_primitive_count();
+  }
+
+  VkAccelerationStructureBuildGeometryInfoKHR build_geometry_info{};
+  build_geometry_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+  build_geometry_info.type = type;
+  build_geometry_info.flags = flags;
+  build_geometry_info.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+  build_geometry_info.geometryCount = static_cast<uint32_t>(geometry_data.size());
+  build_geometry_info.pGeometries = geometry_data.data();
+
+  VkAccelerationStructureBuildSizesInfoKHR build_sizes_info = {};
+  build_sizes_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+  device.get_extension_functions().get_acceleration_structure_build_sizes(
+      device.get_handle(),
+      VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+      &build_geometry_info,
+      primitive_counts.data(),
+      &build_sizes_info);
+
+  return build_sizes_info;
+}
+
 const VkAccelerationStructureKHR &AccelerationStructure::get_handle() const
 {
   return m_handle;
@@ -104,4 +144,70 @@ const VkAccelerationStructureKHR &AccelerationStructure::get_handle() const
 VkDeviceAddress AccelerationStructure::get_device_address() const
 {
   return m_device_address;
-}
\ No newline at end of file
+}
+
+void AccelerationStructure::record(const CommandBuffer &cmd_buffer, const std::vector<AccelerationStructureGeometry> &geometries, VkBuildAccelerationStructureModeKHR mode)
+{
+  if (!m_scratch_buffer)
+  {
+    reserve_scratch(geometries);
+  }
+
+  auto build_sizes = get_build_sizes(m_device, m_type, geometries, m_flags);
+  auto scratch_size = mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR ? build_sizes.updateScratchSize : build_sizes.buildScratchSize;
+  if (scratch_size > m_scratch_size)
+  {
+    throw std::runtime_error("Acceleration structure scratch is too small, reserve it for the largest geometries");
+  }
+
+  std::vector<VkAccelerationStructureGeometryKHR> geometry_data(geometries.size());
+  std::vector<VkAccelerationStructureBuildRangeInfoKHR> build_range_infos(geometries.size());
+  for (size_t i = 0; i < geometries.size(); ++i)
+  {
+    geometry_data[i] = geometries[i].get_handle();
+    build_range_infos[i].primitiveCount = geometries[i].get_primitive_count();
+    build_range_infos[i].transformOffset = geometries[i].get_transform_offset();
+  }
+
+  VkAccelerationStructureBuildGeometryInfoKHR build_geometry_info{};
+  build_geometry_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+  build_geometry_info.type = m_type;
+  build_geometry_info.flags = m_flags;
+  build_geometry_info.mode = mode;
+  build_geometry_info.srcAccelerationStructure = mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR ? m_handle : VK_NULL_HANDLE;
+  build_geometry_info.dstAccelerationStructure = m_handle;
+  build_geometry_info.geometryCount = static_cast<uint32_t>(geometry_data.size());
+  build_geometry_info.pGeometries = geometry_data.data();
+  build_geometry_info.scratchData.deviceAddress = m_scratch_buffer->get_device_address();
+
+  // the previous frame may still trace the structure or build it with the same scratch
+  cmd_buffer.memory_barrier(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                            VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
+  cmd_buffer.flush_barriers();
+
+  auto build_range_info_data = build_range_infos.data();
+  m_device.get_extension_functions().cmd_build_acceleration_structures(
+      cmd_buffer.get_handle(),
+      1,
+      &build_geometry_info,
+      &build_range_info_data);
+
+  // flushed ahead of the next dispatch or draw that traces it
+  cmd_buffer.memory_barrier(VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+}
+
+VkAccelerationStructureTypeKHR AccelerationStructure::get_type() const
+{
+  return m_type;
+}
+
+VkDeviceSize AccelerationStructure::get_size() const
+{
+  return m_size;
+}
+
+VkBuildAccelerationStructureFlagsKHR AccelerationStructure::get_flags() const
+{
+  return m_flags;
+}
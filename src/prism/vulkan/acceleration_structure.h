@@ -7,29 +7,89 @@
 
 namespace prism
 {
+  class CommandBuffer;
+
   class AccelerationStructure
   {
   public:
-    AccelerationStructure(const Device& device, VkAccelerationStructureTypeKHR type, const std::vector<AccelerationStructureGeometry> &geometries);
+    // sizes the build, creates the structure and builds it right away, prefer AccelerationStructureBuilder for many
+    AccelerationStructure(const Device& device, VkAccelerationStructureTypeKHR type, const std::vector<AccelerationStructureGeometry> &geometries,
+                          VkBuildAccelerationStructureFlagsKHR flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR);
+
+    // creates a structure of the given size without building it, flags are the ones it is going to be built with
+    AccelerationStructure(const Device& device, VkAccelerationStructureTypeKHR type, VkDeviceSize size,
+                          VkBuildAccelerationStructureFlagsKHR flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR);
+
+    AccelerationStructure(const AccelerationStructure&) = delete;
+
+    AccelerationStructure(AccelerationStructure&&) = delete;
 
     ~AccelerationStructure();
 
+    AccelerationStructure& operator=(const AccelerationStructure&) = delete;
+
+    AccelerationStructure& operator=(AccelerationStructure&&) = delete;
+
+    // records a full build in place, the scratch is created on first use and kept for the next call
+    void build(const CommandBuffer& cmd_buffer, const std::vector<AccelerationStructureGeometry> &geometries);
+
+    // records a refit for geometries that moved but kept their primitive counts, the structure has to be built with
+    // ALLOW_UPDATE. refits lose trace quality as primitives drift from where the hierarchy was built for them, every
+    // rebuild interval-th call rebuilds in place instead. the scratch is kept for the next call
+    void update(const CommandBuffer& cmd_buffer, const std::vector<AccelerationStructureGeometry> &geometries);
+
+    // sizes the scratch for the largest geometries the structure is going to be built from, e.g. the instance
+    // capacity of a top level. grows it only when nothing that uses the old scratch is in flight
+    void reserve_scratch(const std::vector<AccelerationStructureGeometry> &geometries);
+
+    // 0 never rebuilds
+    void set_rebuild_interval(uint32_t rebuild_interval);
+
+    // refits since the last build
+    uint32_t get_update_count() const;
+
+    static VkAccelerationStructureBuildSizesInfoKHR get_build_sizes(const Device& device, VkAccelerationStructureTypeKHR type,
+                                                                    const std::vector<AccelerationStructureGeometry> &geometries,
+                                                                    VkBuildAccelerationStructureFlagsKHR flags);
+
     const VkAccelerationStructureKHR &get_handle() const;
 
     VkDeviceAddress get_device_address() const;
 
+    VkAccelerationStructureTypeKHR get_type() const;
+
+    VkDeviceSize get_size() const;
+
+    VkBuildAccelerationStructureFlagsKHR get_flags() const;
+
   private:
-    VkAccelerationStructureKHR m_handle;
+    void record(const CommandBuffer& cmd_buffer, const std::vector<AccelerationStructureGeometry> &geometries, VkBuildAccelerationStructureModeKHR mode);
+
+  private:
+    VkAccelerationStructureKHR m_handle{VK_NULL_HANDLE};
 
     const Device& m_device;
 
+    VkAccelerationStructureTypeKHR m_type;
+
+    VkDeviceSize m_size{0};
+
+    VkBuildAccelerationStructureFlagsKHR m_flags;
+
     std::unique_ptr<Buffer> m_buffer;
     std::unique_ptr<DeviceMemory> m_memory;
 
     VkDeviceAddress m_device_address;
 
+    uint32_t m_rebuild_interval{64};
+
+    uint32_t m_update_count{0};
+
+    // sized for both a refit and a rebuild
     std::unique_ptr<Buffer> m_scratch_buffer;
     std::unique_ptr<DeviceMemory> m_scratch_memory;
 
+    VkDeviceSize m_scratch_size{0};
+
   }; // class AccelerationStructure
 } // namespace prism
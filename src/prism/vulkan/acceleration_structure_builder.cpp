@@ -0,0 +1,241 @@
+#include "prism/vulkan/acceleration_structure_builder.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/command_buffer.h"
+#include "prism/vulkan/query_pool.h"
+#include "prism/vulkan/upload_manager.h"
+#include "prism/vulkan/utils.h"
+
+using namespace prism;
+
+AccelerationStructureBuilder::AccelerationStructureBuilder(const Device &device, VkDeviceSize scratch_budget)
+    : m_device(device), m_scratch_budget(scratch_budget)
+{
+  // zero when the properties were not reported, 256 is the largest alignment the spec allows
+  m_scratch_alignment = m_device.get_physical_device().get_acceleration_structure_properties().minAccelerationStructureScratchOffsetAlignment;
+  if (m_scratch_alignment == 0)
+  {
+    m_scratch_alignment = 256;
+  }
+
+  auto queue_family_index = m_device.get_physical_device().get_queue_family_index(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT);
+  m_queue = &m_device.get_queue(queue_family_index, 0);
+  m_cmd_pool = std::make_unique<CommandPool>(m_device, queue_family_index, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+}
+
+std::unique_ptr<AccelerationStructure> AccelerationStructureBuilder::add(VkAccelerationStructureTypeKHR type, const std::vector<AccelerationStructureGeometry> &geometries,
+                                                                         VkBuildAccelerationStructureFlagsKHR flags)
+{
+  auto build_sizes = AccelerationStructure::get_build_sizes(m_device, type, geometries, flags);
+
+  auto acceleration_structure = std::make_unique<AccelerationStructure>(m_device, type, build_sizes.accelerationStructureSize, flags);
+  add(*acceleration_structure, geometries);
+
+  return acceleration_structure;
+}
+
+void AccelerationStructureBuilder::add(AccelerationStructure &dst, const std::vector<AccelerationStructureGeometry> &geometries)
+{
+  Build build{};
+  build.dst = &dst;
+  build.flags = dst.get_flags();
+  build.scratch_size = AccelerationStructure::get_build_sizes(m_device, dst.get_type(), geometries, build.flags).buildScratchSize;
+
+  build.geometries.reserve(geometries.size());
+  build.ranges.reserve(geometries.size());
+  for (const auto &geometry : geometries)
+  {
+    build.geometries.push_back(geometry.get_handle());
+
+    VkAccelerationStructureBuildRangeInfoKHR range{};
+    range.primitiveCount = geometry.get_primitive_count();
+    range.transformOffset = geometry.get_transform_offset();
+    build.ranges.push_back(range);
+  }
+
+  m_builds.push_back(std::move(build));
+}
+
+void AccelerationStructureBuilder::build()
+{
+  m_statistics = {};
+  if (m_builds.empty())
+  {
+    return;
+  }
+
+  // bottom levels first, a top level build reads the bottom levels it references
+  std::stable_partition(m_builds.begin(), m_builds.end(), [](const Build &build) {
+    return build.dst->get_type() != VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+  });
+
+  VkDeviceSize largest_size = 0;
+  VkDeviceSize total_size = 0;
+  for (const auto &build : m_builds)
+  {
+    auto size = utils::align_up(build.scratch_size, m_scratch_alignment);
+    largest_size = std::max(largest_size, size);
+    total_size += size;
+  }
+  auto scratch_size = std::max(std::min(total_size, m_scratch_budget), largest_size);
+
+  Buffer scratch_buffer(m_device, scratch_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+  auto scratch_requirements = scratch_buffer.get_memory_requirements();
+  scratch_requirements.alignment = std::max(scratch_requirements.alignment, m_scratch_alignment);
+  DeviceMemory scratch_memory(m_device, scratch_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT);
+  scratch_buffer.bind_memory(scratch_memory);
+
+  // the geometry buffers may still be in flight on the transfer queue, waiting on the host also satisfies the
+  // semaphore wait an acquire needs
+  auto &upload_manager = m_device.get_upload_manager();
+  auto upload_token = upload_manager.get_token();
+  upload_manager.wait(upload_token);
+
+  utils::submit_commands_to_queue(*m_cmd_pool, *m_queue, [&](const CommandBuffer &cmd_buffer) {
+    upload_manager.acquire(cmd_buffer, upload_token);
+    record(cmd_buffer, scratch_buffer.get_device_address(), scratch_size);
+  });
+
+  m_statistics.structure_count = static_cast<uint32_t>(m_builds.size());
+  m_statistics.scratch_size = scratch_size;
+
+  m_builds.clear();
+}
+
+std::vector<AccelerationStructureBuilder::Compaction> AccelerationStructureBuilder::compact(std::vector<std::unique_ptr<AccelerationStructure>> &structures)
+{
+  std::vector<Compaction> compactions(structures.size());
+
+  std::vector<uint32_t> indices;
+  std::vector<VkAccelerationStructureKHR> handles;
+  for (uint32_t i = 0; i < structures.size(); ++i)
+  {
+    compactions[i].original_size = structures[i]->get_size();
+    compactions[i].compacted_size = structures[i]->get_size();
+
+    if (structures[i]->get_flags() & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR)
+    {
+      indices.push_back(i);
+      handles.push_back(structures[i]->get_handle());
+    }
+  }
+
+  if (indices.empty())
+  {
+    return compactions;
+  }
+
+  const auto &functions = m_device.get_extension_functions();
+
+  QueryPool query_pool(m_device, VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, static_cast<uint32_t>(handles.size()));
+  utils::submit_commands_to_queue(*m_cmd_pool, *m_queue, [&](const CommandBuffer &cmd_buffer) {
+    query_pool.reset(cmd_buffer);
+
+    cmd_buffer.memory_barrier(VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                              VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+    cmd_buffer.flush_barriers();
+
+    functions.cmd_write_acceleration_structures_properties(cmd_buffer.get_handle(), static_cast<uint32_t>(handles.size()), handles.data(),
+                                                           VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, query_pool.get_handle(), 0);
+  });
+  auto compacted_sizes = query_pool.get_results();
+
+  std::vector<std::unique_ptr<AccelerationStructure>> compacted(indices.size());
+  utils::submit_commands_to_queue(*m_cmd_pool, *m_queue, [&](const CommandBuffer &cmd_buffer) {
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      const auto &src = *structures[indices[i]];
+      compacted[i] = std::make_unique<AccelerationStructure>(m_device, src.get_type(), compacted_sizes[i], src.get_flags());
+
+      VkCopyAccelerationStructureInfoKHR copy_info{};
+      copy_info.sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR;
+      copy_info.src = src.get_handle();
+      copy_info.dst = compacted[i]->get_handle();
+      copy_info.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+      functions.cmd_copy_acceleration_structure(cmd_buffer.get_handle(), &copy_info);
+    }
+  });
+
+  VkDeviceSize original_size = 0;
+  VkDeviceSize compacted_size = 0;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    compactions[indices[i]].compacted_size = compacted_sizes[i];
+    original_size += structures[indices[i]]->get_size();
+    compacted_size += compacted_sizes[i];
+
+    // the copy has completed, the original goes
+    structures[indices[i]] = std::move(compacted[i]);
+  }
+
+  LOG_INFO("compacted {} acceleration structures from {} to {} bytes, saved {} bytes", indices.size(), original_size, compacted_size, original_size - compacted_size);
+
+  return compactions;
+}
+
+const AccelerationStructureBuilder::Statistics &AccelerationStructureBuilder::get_statistics() const
+{
+  return m_statistics;
+}
+
+void AccelerationStructureBuilder::record(const CommandBuffer &cmd_buffer, VkDeviceAddress scratch_address, VkDeviceSize scratch_size)
+{
+  std::vector<VkAccelerationStructureBuildGeometryInfoKHR> build_infos;
+  std::vector<const VkAccelerationStructureBuildRangeInfoKHR *> build_ranges;
+  build_infos.reserve(m_builds.size());
+  build_ranges.reserve(m_builds.size());
+
+  auto flush = [&]() {
+    if (build_infos.empty())
+    {
+      return;
+    }
+
+    cmd_buffer.flush_barriers();
+    m_device.get_extension_functions().cmd_build_acceleration_structures(
+        cmd_buffer.get_handle(),
+        static_cast<uint32_t>(build_infos.size()),
+        build_infos.data(),
+        build_ranges.data());
+    m_statistics.build_call_count++;
+
+    build_infos.clear();
+    build_ranges.clear();
+  };
+
+  VkDeviceSize offset = 0;
+  auto type = m_builds.front().dst->get_type();
+  for (const auto &build : m_builds)
+  {
+    auto size = utils::align_up(build.scratch_size, m_scratch_alignment);
+    if (offset + size > scratch_size || build.dst->get_type() != type)
+    {
+      flush();
+      offset = 0;
+      type = build.dst->get_type();
+
+      // the next batch reuses the scratch or reads the structures built so far
+      cmd_buffer.memory_barrier(VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                                VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                                VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
+    }
+
+    VkAccelerationStructureBuildGeometryInfoKHR build_info{};
+    build_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+    build_info.type = build.dst->get_type();
+    build_info.flags = build.flags;
+    build_info.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+    build_info.dstAccelerationStructure = build.dst->get_handle();
+    build_info.geometryCount = static_cast<uint32_t>(build.geometries.size());
+    build_info.pGeometries = build.geometries.data();
+    build_info.scratchData.deviceAddress = scratch_address + offset;
+
+    build_infos.push_back(build_info);
+    build_ranges.push_back(build.ranges.data());
+
+    offset += size;
+  }
+
+  flush();
+}
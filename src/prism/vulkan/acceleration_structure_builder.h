@@ -0,0 +1,91 @@
+#pragma once
+
+#include "prism/vulkan/acceleration_structure.h"
+#include "prism/vulkan/command_pool.h"
+
+namespace prism
+{
+  // builds many acceleration structures with few vkCmdBuildAccelerationStructuresKHR calls. every queued build gets
+  // a slice of one pooled scratch buffer, builds are recorded in batches that fit the pool and the pool is reused
+  // behind a barrier once it runs out. bottom levels are built before top levels, the scratch is freed once build()
+  // returns
+  class AccelerationStructureBuilder
+  {
+  public:
+    struct Statistics
+    {
+      uint32_t structure_count{0};
+      uint32_t build_call_count{0};
+      VkDeviceSize scratch_size{0};
+    };
+
+    struct Compaction
+    {
+      VkDeviceSize original_size{0};
+      VkDeviceSize compacted_size{0};
+    };
+
+  public:
+    // the scratch pool grows up to scratch_budget, or to the largest single build when that is larger
+    AccelerationStructureBuilder(const Device &device, VkDeviceSize scratch_budget = 128ull * 1024 * 1024);
+
+    AccelerationStructureBuilder(const AccelerationStructureBuilder &) = delete;
+
+    AccelerationStructureBuilder(AccelerationStructureBuilder &&) = delete;
+
+    ~AccelerationStructureBuilder() = default;
+
+    AccelerationStructureBuilder &operator=(const AccelerationStructureBuilder &) = delete;
+
+    AccelerationStructureBuilder &operator=(AccelerationStructureBuilder &&) = delete;
+
+    // creates a structure sized for the geometries and queues its build, it may not be used before build() returned
+    std::unique_ptr<AccelerationStructure> add(VkAccelerationStructureTypeKHR type, const std::vector<AccelerationStructureGeometry> &geometries,
+                                               VkBuildAccelerationStructureFlagsKHR flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR);
+
+    // queues a build into a structure that was created large enough for the geometries, with its flags
+    void add(AccelerationStructure &dst, const std::vector<AccelerationStructureGeometry> &geometries);
+
+    // records every queued build into one command buffer, submits it and waits for it. vertex, index and transform
+    // data is usually written through the device's UploadManager, build() waits for every upload issued so far and
+    // acquires them when uploads run on a dedicated transfer family, data written otherwise has to be visible already
+    void build();
+
+    // replaces every built structure that allows compaction by a copy of its compacted size and releases the
+    // original, returns the sizes per structure. compacted structures have new addresses, compact bottom levels
+    // before the top levels that reference them are built
+    std::vector<Compaction> compact(std::vector<std::unique_ptr<AccelerationStructure>> &structures);
+
+    // of the last build()
+    const Statistics &get_statistics() const;
+
+  private:
+    struct Build
+    {
+      AccelerationStructure *dst{nullptr};
+      VkBuildAccelerationStructureFlagsKHR flags{0};
+      std::vector<VkAccelerationStructureGeometryKHR> geometries;
+      std::vector<VkAccelerationStructureBuildRangeInfoKHR> ranges;
+      VkDeviceSize scratch_size{0};
+    };
+
+    void record(const CommandBuffer &cmd_buffer, VkDeviceAddress scratch_address, VkDeviceSize scratch_size);
+
+  private:
+    const Device &m_device;
+
+    VkDeviceSize m_scratch_budget;
+
+    VkDeviceSize m_scratch_alignment;
+
+    const Queue *m_queue{nullptr};
+
+    std::unique_ptr<CommandPool> m_cmd_pool;
+
+    std::vector<Build> m_builds;
+
+    Statistics m_statistics;
+
+  }; // class AccelerationStructureBuilder
+
+} // namespace prism
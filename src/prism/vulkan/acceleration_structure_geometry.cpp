@@ -16,7 +16,8 @@ AccelerationStructureGeometry::AccelerationStructureGeometry(const Triangles &tr
   m_handle.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
   m_handle.geometry.triangles.transformData.deviceAddress = triangles.transform_data;
 
-  m_primitive_count = triangles.vertex_count / 3;
+  assert(triangles.index_data == 0 || triangles.index_count != 0);
+  m_primitive_count = (triangles.index_data == 0 ? triangles.vertex_count : triangles.index_count) / 3;
 }
 
 AccelerationStructureGeometry::AccelerationStructureGeometry(const Aabbs &aabbs, VkGeometryFlagsKHR flags)
@@ -40,7 +41,7 @@ AccelerationStructureGeometry::AccelerationStructureGeometry(const Instances &in
   m_handle.geometry.instances.data.deviceAddress = instances.data;
   m_handle.geometry.instances.arrayOfPointers = instances.array_of_pointers;
 
-  m_primitive_count = 1;
+  m_primitive_count = instances.count;
 }
 
 const VkAccelerationStructureGeometryKHR &AccelerationStructureGeometry::get_handle() const
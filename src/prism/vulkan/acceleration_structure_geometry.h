@@ -12,6 +12,8 @@ namespace prism
       VkDeviceSize vertex_stride;
       uint32_t vertex_count;
       VkDeviceAddress index_data;
+      // used when there is index data, three per triangle
+      uint32_t index_count;
       VkDeviceAddress transform_data;
     };
 
@@ -25,6 +27,7 @@ namespace prism
     {
       VkDeviceAddress data;
       VkBool32 array_of_pointers;
+      uint32_t count;
     };
 
   public:
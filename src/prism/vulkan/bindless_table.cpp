@@ -0,0 +1,224 @@
+#include "prism/vulkan/bindless_table.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/device.h"
+
+using namespace prism;
+
+BindlessTable::BindlessTable(const Device &device, uint32_t frames_in_flight, const Properties &properties)
+    : m_device(device), m_frames_in_flight(frames_in_flight)
+{
+  VkPhysicalDeviceDescriptorIndexingProperties indexing_properties{};
+  indexing_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+  VkPhysicalDeviceProperties2 properties2{};
+  properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties2.pNext = &indexing_properties;
+  vkGetPhysicalDeviceProperties2(m_device.get_physical_device().get_handle(), &properties2);
+
+  auto clamp = [](uint32_t count, uint32_t limit, const char *name) {
+    if (count > limit)
+    {
+      LOG_WARN("bindless table: {} {} clamped to the device limit {}", count, name, limit);
+      return limit;
+    }
+    return count;
+  };
+
+  // the bindings are visible to every stage, so the per stage limits apply to each array as well as the set limits
+  m_slots[SAMPLED_IMAGE_BINDING].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  m_slots[SAMPLED_IMAGE_BINDING].capacity = clamp(properties.sampled_image_count,
+                                                  std::min({indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                                            indexing_properties.maxDescriptorSetUpdateAfterBindSamplers,
+                                                            indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                                            indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers}),
+                                                  "sampled images");
+  m_slots[STORAGE_IMAGE_BINDING].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  m_slots[STORAGE_IMAGE_BINDING].capacity = clamp(properties.storage_image_count,
+                                                  std::min(indexing_properties.maxDescriptorSetUpdateAfterBindStorageImages,
+                                                           indexing_properties.maxPerStageDescriptorUpdateAfterBindStorageImages),
+                                                  "storage images");
+  m_slots[STORAGE_BUFFER_BINDING].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  m_slots[STORAGE_BUFFER_BINDING].capacity = clamp(properties.storage_buffer_count,
+                                                   std::min(indexing_properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                                            indexing_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers),
+                                                   "storage buffers");
+
+  // together the arrays have to fit the per stage resource budget, each one gives up its share of the excess
+  uint64_t total_count = 0;
+  for (const auto &slots : m_slots)
+  {
+    total_count += slots.capacity;
+  }
+  uint64_t resource_budget = indexing_properties.maxPerStageUpdateAfterBindResources;
+  if (total_count > resource_budget)
+  {
+    LOG_WARN("bindless table: {} descriptors scaled down to the per stage resource limit {}", total_count, resource_budget);
+    for (auto &slots : m_slots)
+    {
+      slots.capacity = static_cast<uint32_t>(slots.capacity * resource_budget / total_count);
+    }
+  }
+
+  for (auto &slots : m_slots)
+  {
+    slots.handed_out.resize(slots.capacity, false);
+  }
+
+  DescriptorSetLayout::Bindings bindings(BINDING_COUNT);
+  std::vector<VkDescriptorBindingFlags> binding_flags(BINDING_COUNT);
+  for (uint32_t i = 0; i < BINDING_COUNT; ++i)
+  {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = m_slots[i].type;
+    bindings[i].descriptorCount = m_slots[i].capacity;
+    bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+
+    // slots that are free or written while a frame using other slots is pending are fine
+    binding_flags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                       VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                       VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+  }
+  // only the last binding may have a variable count, the arrays are allocated at their full capacity anyway
+  binding_flags[BINDING_COUNT - 1] |= VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+
+  m_layout = std::make_unique<DescriptorSetLayout>(m_device, bindings, binding_flags, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+  m_pool = std::make_unique<DescriptorPool>(m_device, m_layout->get_descriptor_pool_sizes(), 1, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT);
+
+  auto variable_count = m_slots[BINDING_COUNT - 1].capacity;
+  VkDescriptorSetVariableDescriptorCountAllocateInfo variable_count_info{};
+  variable_count_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+  variable_count_info.descriptorSetCount = 1;
+  variable_count_info.pDescriptorCounts = &variable_count;
+
+  VkDescriptorSetAllocateInfo alloc_info{};
+  alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  alloc_info.pNext = &variable_count_info;
+  alloc_info.descriptorPool = m_pool->get_handle();
+  alloc_info.descriptorSetCount = 1;
+  alloc_info.pSetLayouts = &m_layout->get_handle();
+
+  VK_CHECK(vkAllocateDescriptorSets(m_device.get_handle(), &alloc_info, &m_handle));
+}
+
+BindlessTable::~BindlessTable()
+{
+  // the set goes with the pool
+}
+
+BindlessTable::Handle BindlessTable::add_sampled_image(VkImageView image_view, VkSampler sampler, VkImageLayout layout)
+{
+  VkDescriptorImageInfo image_info{sampler, image_view, layout};
+
+  auto handle = allocate(SAMPLED_IMAGE_BINDING);
+  write(SAMPLED_IMAGE_BINDING, handle, &image_info, nullptr);
+  return handle;
+}
+
+BindlessTable::Handle BindlessTable::add_storage_image(VkImageView image_view, VkImageLayout layout)
+{
+  VkDescriptorImageInfo image_info{VK_NULL_HANDLE, image_view, layout};
+
+  auto handle = allocate(STORAGE_IMAGE_BINDING);
+  write(STORAGE_IMAGE_BINDING, handle, &image_info, nullptr);
+  return handle;
+}
+
+BindlessTable::Handle BindlessTable::add_storage_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+  VkDescriptorBufferInfo buffer_info{buffer, offset, range};
+
+  auto handle = allocate(STORAGE_BUFFER_BINDING);
+  write(STORAGE_BUFFER_BINDING, handle, nullptr, &buffer_info);
+  return handle;
+}
+
+void BindlessTable::remove(Binding binding, Handle handle)
+{
+  auto &slots = m_slots[binding];
+  if (handle >= slots.high_water_mark)
+  {
+    throw std::runtime_error("Bindless handle " + std::to_string(handle) + " was never handed out");
+  }
+  if (!slots.handed_out[handle])
+  {
+    throw std::runtime_error("Bindless handle " + std::to_string(handle) + " was already removed");
+  }
+
+  slots.handed_out[handle] = false;
+  slots.retired.emplace_back(m_update_count, handle);
+}
+
+void BindlessTable::update()
+{
+  ++m_update_count;
+
+  // the last frame that could index a removed handle was recorded before the update that follows the removal, its
+  // fence has been waited on frames_in_flight updates after that
+  for (auto &slots : m_slots)
+  {
+    while (!slots.retired.empty() && m_update_count - slots.retired.front().first > m_frames_in_flight)
+    {
+      slots.free.push_back(slots.retired.front().second);
+      slots.retired.pop_front();
+    }
+  }
+}
+
+const DescriptorSetLayout &BindlessTable::get_layout() const
+{
+  return *m_layout;
+}
+
+VkDescriptorSet BindlessTable::get_handle() const
+{
+  return m_handle;
+}
+
+uint32_t BindlessTable::get_capacity(Binding binding) const
+{
+  return m_slots[binding].capacity;
+}
+
+uint32_t BindlessTable::get_count(Binding binding) const
+{
+  const auto &slots = m_slots[binding];
+  return slots.high_water_mark - static_cast<uint32_t>(slots.free.size());
+}
+
+BindlessTable::Handle BindlessTable::allocate(Binding binding)
+{
+  auto &slots = m_slots[binding];
+
+  // most recently released first, its descriptor is likely still in cache
+  if (!slots.free.empty())
+  {
+    auto handle = slots.free.back();
+    slots.free.pop_back();
+    slots.handed_out[handle] = true;
+    return handle;
+  }
+
+  if (slots.high_water_mark == slots.capacity)
+  {
+    throw std::runtime_error("Bindless table is full");
+  }
+
+  slots.handed_out[slots.high_water_mark] = true;
+  return slots.high_water_mark++;
+}
+
+void BindlessTable::write(Binding binding, Handle handle, const VkDescriptorImageInfo *image_info, const VkDescriptorBufferInfo *buffer_info)
+{
+  VkWriteDescriptorSet write{};
+  write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write.dstSet = m_handle;
+  write.dstBinding = binding;
+  write.dstArrayElement = handle;
+  write.descriptorCount = 1;
+  write.descriptorType = m_slots[binding].type;
+  write.pImageInfo = image_info;
+  write.pBufferInfo = buffer_info;
+
+  vkUpdateDescriptorSets(m_device.get_handle(), 1, &write, 0, nullptr);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <deque>
+
+#include "prism/vulkan/descriptor_pool.h"
+#include "prism/vulkan/descriptor_set_layout.h"
+
+namespace prism
+{
+  // one descriptor set with large arrays of sampled images, storage images and storage buffers. resources are added
+  // once and shaders index the arrays with the handle they got, so the set is bound once per frame instead of a set
+  // per material. slots are partially bound and written after bind, removed handles are reused once no frame in
+  // flight can still index them
+  class BindlessTable
+  {
+  public:
+    using Handle = uint32_t;
+
+    static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+    // the bindings the shaders declare the arrays at, e.g. layout(set = N, binding = 0) uniform sampler2D textures[]
+    enum Binding : uint32_t
+    {
+      SAMPLED_IMAGE_BINDING = 0,
+      STORAGE_IMAGE_BINDING = 1,
+      STORAGE_BUFFER_BINDING = 2,
+      BINDING_COUNT = 3,
+    };
+
+    // clamped to the device's per set and per stage update after bind limits
+    struct Properties
+    {
+      uint32_t sampled_image_count{16384};
+      uint32_t storage_image_count{1024};
+      uint32_t storage_buffer_count{16384};
+    };
+
+  public:
+    // removed handles are reused frames_in_flight updates later. needs the descriptor indexing features for update
+    // after bind, partially bound and variable count bindings and runtime descriptor arrays, and the core array
+    // dynamic indexing features of the three descriptor types
+    BindlessTable(const Device &device, uint32_t frames_in_flight, const Properties &properties = {});
+
+    BindlessTable(const BindlessTable &) = delete;
+
+    BindlessTable(BindlessTable &&) = delete;
+
+    ~BindlessTable();
+
+    BindlessTable &operator=(const BindlessTable &) = delete;
+
+    BindlessTable &operator=(BindlessTable &&) = delete;
+
+    Handle add_sampled_image(VkImageView image_view, VkSampler sampler, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    Handle add_storage_image(VkImageView image_view, VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
+
+    Handle add_storage_buffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    // the shaders may not index the handle in frames recorded afterwards, throws for handles that are not in use
+    void remove(Binding binding, Handle handle);
+
+    // releases the handles removed frames_in_flight updates ago, call it once per frame after waiting on the
+    // frame's fence
+    void update();
+
+    const DescriptorSetLayout &get_layout() const;
+
+    VkDescriptorSet get_handle() const;
+
+    uint32_t get_capacity(Binding binding) const;
+
+    // handles in use, including removed ones not released yet
+    uint32_t get_count(Binding binding) const;
+
+  private:
+    struct Slots
+    {
+      VkDescriptorType type;
+
+      uint32_t capacity{0};
+
+      // slots below are handed out or free
+      uint32_t high_water_mark{0};
+
+      std::vector<Handle> free;
+
+      // handles that were added and not removed since
+      std::vector<bool> handed_out;
+
+      // handles and the update they were removed in
+      std::deque<std::pair<uint64_t, Handle>> retired;
+    };
+
+  private:
+    Handle allocate(Binding binding);
+
+    void write(Binding binding, Handle handle, const VkDescriptorImageInfo *image_info, const VkDescriptorBufferInfo *buffer_info);
+
+  private:
+    const Device &m_device;
+
+    uint32_t m_frames_in_flight;
+
+    uint64_t m_update_count{0};
+
+    std::array<Slots, BINDING_COUNT> m_slots;
+
+    std::unique_ptr<DescriptorSetLayout> m_layout;
+
+    std::unique_ptr<DescriptorPool> m_pool;
+
+    VkDescriptorSet m_handle{VK_NULL_HANDLE};
+
+  }; // class BindlessTable
+
+} // namespace prism
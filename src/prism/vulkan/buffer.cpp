@@ -16,7 +16,21 @@ Buffer::Buffer(const Device &m_device, VkDeviceSize size, VkBufferUsageFlags usa
 
   VK_CHECK(vkCreateBuffer(m_device.get_handle(), &buffer_info, nullptr, &m_handle));
 
-  vkGetBufferMemoryRequirements(m_device.get_handle(), m_handle, &m_memory_requirements);
+  VkMemoryDedicatedRequirements dedicated_requirements{};
+  dedicated_requirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+
+  VkMemoryRequirements2 memory_requirements{};
+  memory_requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+  memory_requirements.pNext = &dedicated_requirements;
+
+  VkBufferMemoryRequirementsInfo2 requirements_info{};
+  requirements_info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+  requirements_info.buffer = m_handle;
+
+  vkGetBufferMemoryRequirements2(m_device.get_handle(), &requirements_info, &memory_requirements);
+
+  m_memory_requirements = memory_requirements.memoryRequirements;
+  m_requires_dedicated_allocation = dedicated_requirements.requiresDedicatedAllocation == VK_TRUE;
 }
 
 Buffer::~Buffer()
@@ -42,6 +56,11 @@ const VkMemoryRequirements &Buffer::get_memory_requirements() const
   return m_memory_requirements;
 }
 
+bool Buffer::requires_dedicated_allocation() const
+{
+  return m_requires_dedicated_allocation;
+}
+
 VkDeviceAddress Buffer::get_device_address() const
 {
   VkBufferDeviceAddressInfoKHR info{};
@@ -52,5 +71,5 @@ VkDeviceAddress Buffer::get_device_address() const
 
 void Buffer::bind_memory(const DeviceMemory &memory, VkDeviceSize offset)
 {
-  VK_CHECK(vkBindBufferMemory(m_device.get_handle(), m_handle, memory.get_handle(), offset));
+  VK_CHECK(vkBindBufferMemory(m_device.get_handle(), m_handle, memory.get_handle(), memory.get_offset() + offset));
 }
@@ -19,6 +19,8 @@ namespace prism
 
     const VkMemoryRequirements &get_memory_requirements() const;
 
+    bool requires_dedicated_allocation() const;
+
     VkDeviceAddress get_device_address() const;
 
     void bind_memory(const DeviceMemory &memory, VkDeviceSize offset = 0);
@@ -30,5 +32,7 @@ namespace prism
 
     VkMemoryRequirements m_memory_requirements;
 
+    bool m_requires_dedicated_allocation{false};
+
   }; // class Buffer
 } // namespace prism
\ No newline at end of file
@@ -2,13 +2,27 @@
 
 #include "prism/vulkan/buffer.h"
 #include "prism/vulkan/command_pool.h"
+#include "prism/vulkan/compute_dispatch.h"
 #include "prism/vulkan/compute_pipeline.h"
+#include "prism/vulkan/descriptor_update_template.h"
 #include "prism/vulkan/graphics_pipeline.h"
 #include "prism/vulkan/image.h"
+#include "prism/vulkan/utils.h"
 
 
 using namespace prism;
 
+namespace {
+
+bool is_same_state(const Image::SubresourceState &lhs,
+                   const Image::SubresourceState &rhs) {
+  return lhs.layout == rhs.layout && lhs.stage == rhs.stage &&
+         lhs.access == rhs.access && lhs.read_stage == rhs.read_stage &&
+         lhs.read_access == rhs.read_access;
+}
+
+} // namespace
+
 CommandBuffer::CommandBuffer(const CommandPool &cmd_pool,
                              VkCommandBufferLevel level)
     : m_device(cmd_pool.get_device()), m_cmd_pool(cmd_pool) {
@@ -24,7 +38,10 @@ CommandBuffer::CommandBuffer(const CommandPool &cmd_pool,
 
 CommandBuffer::CommandBuffer(CommandBuffer &&other) noexcept
     : m_handle(std::exchange(other.m_handle, VK_NULL_HANDLE)),
-      m_device(other.m_device), m_cmd_pool(other.m_cmd_pool) {}
+      m_device(other.m_device), m_cmd_pool(other.m_cmd_pool),
+      m_image_barriers(std::move(other.m_image_barriers)),
+      m_memory_barrier(other.m_memory_barrier),
+      m_barrier_count(other.m_barrier_count) {}
 
 CommandBuffer::~CommandBuffer() {
   if (m_handle != VK_NULL_HANDLE) {
@@ -41,9 +58,17 @@ void CommandBuffer::begin(VkCommandBufferUsageFlags flags) const {
   begin_info.flags = flags;
 
   VK_CHECK(vkBeginCommandBuffer(m_handle, &begin_info));
+
+  m_image_barriers.clear();
+  m_memory_barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+  m_barrier_count = 0;
 }
 
-void CommandBuffer::end() const { VK_CHECK(vkEndCommandBuffer(m_handle)); }
+void CommandBuffer::end() const {
+  flush_barriers();
+
+  VK_CHECK(vkEndCommandBuffer(m_handle));
+}
 
 void CommandBuffer::reset() const {
   VK_CHECK(vkResetCommandBuffer(m_handle, 0));
@@ -52,6 +77,8 @@ void CommandBuffer::reset() const {
 void CommandBuffer::copy_buffer(
     const Buffer &src, const Buffer &dst,
     const std::vector<VkBufferCopy> &regions) const {
+  flush_barriers();
+
   vkCmdCopyBuffer(m_handle, src.get_handle(), dst.get_handle(), regions.size(),
                   regions.data());
 }
@@ -59,7 +86,7 @@ void CommandBuffer::copy_buffer(
 void CommandBuffer::copy_buffer_to_image(
     const Buffer &src, const Image &dst,
     const std::vector<VkBufferImageCopy> &regions) const {
-  VkBufferImageCopy region = {};
+  flush_barriers();
 
   vkCmdCopyBufferToImage(m_handle, src.get_handle(), dst.get_handle(),
                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(),
@@ -68,14 +95,29 @@ void CommandBuffer::copy_buffer_to_image(
 
 void CommandBuffer::copy_image(const Image &src, const Image &dst,
                                const std::vector<VkImageCopy> &regions) const {
+  flush_barriers();
+
   vkCmdCopyImage(m_handle, src.get_handle(),
                  VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst.get_handle(),
                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(),
                  regions.data());
 }
 
+void CommandBuffer::blit_image(const Image &src, const Image &dst,
+                               const std::vector<VkImageBlit> &regions,
+                               VkFilter filter) const {
+  flush_barriers();
+
+  vkCmdBlitImage(m_handle, src.get_handle(),
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst.get_handle(),
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(),
+                 regions.data(), filter);
+}
+
 void CommandBuffer::fill_buffer(const Buffer &buffer, VkDeviceSize offset,
                                 VkDeviceSize size, uint32_t data) const {
+  flush_barriers();
+
   vkCmdFillBuffer(m_handle, buffer.get_handle(), offset, size, data);
 }
 
@@ -85,13 +127,174 @@ void CommandBuffer::pipeline_barrier(
     const std::vector<VkMemoryBarrier> &memory_barriers,
     const std::vector<VkBufferMemoryBarrier> &buffer_memory_barriers,
     const std::vector<VkImageMemoryBarrier> &image_memory_barriers) const {
+  flush_barriers();
+
   vkCmdPipelineBarrier(
       m_handle, src_stage, dst_stage, dependency_flags, memory_barriers.size(),
       memory_barriers.data(), buffer_memory_barriers.size(),
       buffer_memory_barriers.data(), image_memory_barriers.size(),
       image_memory_barriers.data());
+  m_barrier_count++;
 }
 
+void CommandBuffer::image_barrier(
+    Image &image, VkImageLayout new_layout, VkPipelineStageFlags2 dst_stage,
+    VkAccessFlags2 dst_access,
+    const VkImageSubresourceRange &subresource_range) const {
+  // barriers inside one call are unordered, a second transition of the same
+  // image has to go into the next call
+  for (const auto &barrier : m_image_barriers) {
+    if (barrier.image == image.get_handle()) {
+      flush_barriers();
+      break;
+    }
+  }
+
+  auto level_count = subresource_range.levelCount == VK_REMAINING_MIP_LEVELS
+                         ? image.get_mip_level_count() - subresource_range.baseMipLevel
+                         : subresource_range.levelCount;
+  auto layer_count = subresource_range.layerCount == VK_REMAINING_ARRAY_LAYERS
+                         ? image.get_array_layer_count() - subresource_range.baseArrayLayer
+                         : subresource_range.layerCount;
+
+  auto first_barrier = m_image_barriers.size();
+
+  for (uint32_t level = subresource_range.baseMipLevel;
+       level < subresource_range.baseMipLevel + level_count; ++level) {
+    auto layer = subresource_range.baseArrayLayer;
+    while (layer < subresource_range.baseArrayLayer + layer_count) {
+      // runs of layers that share a state go into one barrier
+      auto state = image.get_state(level, layer);
+      auto run_end = layer + 1;
+      while (run_end < subresource_range.baseArrayLayer + layer_count &&
+             is_same_state(image.get_state(level, run_end), state)) {
+        run_end++;
+      }
+
+      Image::SubresourceState new_state;
+      VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+      bool needs_barrier = true;
+      if (state.layout == new_layout && !utils::is_write_access(dst_access)) {
+        // read after write, only wait for the last write when these stages
+        // and accesses have not been made visible yet
+        new_state = state;
+        new_state.read_stage |= dst_stage;
+        new_state.read_access |= dst_access;
+
+        needs_barrier = state.stage != VK_PIPELINE_STAGE_2_NONE &&
+                        ((dst_stage & ~state.read_stage) != 0 ||
+                         (dst_access & ~state.read_access) != 0);
+        barrier.srcStageMask = state.stage;
+      } else {
+        // write or layout transition, has to wait for every reader as well
+        new_state.layout = new_layout;
+        new_state.stage = dst_stage;
+        if (utils::is_write_access(dst_access)) {
+          new_state.access = dst_access;
+        } else {
+          // the transition is visible to the reader that requested it
+          new_state.read_stage = dst_stage;
+          new_state.read_access = dst_access;
+        }
+
+        barrier.srcStageMask = state.stage | state.read_stage;
+      }
+
+      if (needs_barrier) {
+        // only writes have to be made available
+        barrier.srcAccessMask =
+            utils::is_write_access(state.access) ? state.access : VK_ACCESS_2_NONE;
+        barrier.dstStageMask = dst_stage;
+        barrier.dstAccessMask = dst_access;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.get_handle();
+        barrier.subresourceRange.aspectMask = subresource_range.aspectMask;
+        barrier.subresourceRange.baseMipLevel = level;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = layer;
+        barrier.subresourceRange.layerCount = run_end - layer;
+
+        // extend the barrier of the previous mip level when it covers the
+        // same layers with the same source scope
+        bool merged = false;
+        for (auto i = first_barrier; i < m_image_barriers.size(); ++i) {
+          auto &previous = m_image_barriers[i];
+          if (previous.oldLayout == barrier.oldLayout &&
+              previous.srcStageMask == barrier.srcStageMask &&
+              previous.srcAccessMask == barrier.srcAccessMask &&
+              previous.subresourceRange.baseArrayLayer == layer &&
+              previous.subresourceRange.layerCount == barrier.subresourceRange.layerCount &&
+              previous.subresourceRange.baseMipLevel + previous.subresourceRange.levelCount == level) {
+            previous.subresourceRange.levelCount++;
+            merged = true;
+            break;
+          }
+        }
+
+        if (!merged) {
+          m_image_barriers.push_back(barrier);
+        }
+      }
+
+      for (auto i = layer; i < run_end; ++i) {
+        image.set_state(new_state, level, i);
+      }
+
+      layer = run_end;
+    }
+  }
+}
+
+void CommandBuffer::image_barrier(Image &image, VkImageLayout new_layout,
+                                  VkPipelineStageFlags2 dst_stage,
+                                  VkAccessFlags2 dst_access,
+                                  VkImageAspectFlags aspect) const {
+  VkImageSubresourceRange subresource_range{};
+  subresource_range.aspectMask = aspect;
+  subresource_range.baseMipLevel = 0;
+  subresource_range.levelCount = image.get_mip_level_count();
+  subresource_range.baseArrayLayer = 0;
+  subresource_range.layerCount = image.get_array_layer_count();
+
+  image_barrier(image, new_layout, dst_stage, dst_access, subresource_range);
+}
+
+void CommandBuffer::memory_barrier(VkPipelineStageFlags2 src_stage,
+                                   VkAccessFlags2 src_access,
+                                   VkPipelineStageFlags2 dst_stage,
+                                   VkAccessFlags2 dst_access) const {
+  m_memory_barrier.srcStageMask |= src_stage;
+  m_memory_barrier.srcAccessMask |= src_access;
+  m_memory_barrier.dstStageMask |= dst_stage;
+  m_memory_barrier.dstAccessMask |= dst_access;
+}
+
+void CommandBuffer::flush_barriers() const {
+  bool has_memory_barrier = m_memory_barrier.srcStageMask != 0 ||
+                            m_memory_barrier.dstStageMask != 0;
+  if (m_image_barriers.empty() && !has_memory_barrier) {
+    return;
+  }
+
+  VkDependencyInfo dependency_info{};
+  dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+  dependency_info.memoryBarrierCount = has_memory_barrier ? 1 : 0;
+  dependency_info.pMemoryBarriers = &m_memory_barrier;
+  dependency_info.imageMemoryBarrierCount = m_image_barriers.size();
+  dependency_info.pImageMemoryBarriers = m_image_barriers.data();
+
+  vkCmdPipelineBarrier2(m_handle, &dependency_info);
+  m_barrier_count++;
+
+  m_image_barriers.clear();
+  m_memory_barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+}
+
+uint32_t CommandBuffer::get_barrier_count() const { return m_barrier_count; }
+
 void CommandBuffer::bind_pipeline(const ComputePipeline &pipeline) const {
   vkCmdBindPipeline(m_handle, VK_PIPELINE_BIND_POINT_COMPUTE,
                     pipeline.get_handle());
@@ -104,18 +307,60 @@ void CommandBuffer::bind_pipeline(const GraphicsPipeline &pipeline) const {
 
 void CommandBuffer::bind_descriptor_set(const VkPipelineBindPoint bind_point,
                                         const VkPipelineLayout layout,
-                                        const VkDescriptorSet descriptor_set) const {
-  vkCmdBindDescriptorSets(m_handle, bind_point, layout, 0, 1, &descriptor_set,
+                                        const VkDescriptorSet descriptor_set,
+                                        uint32_t set) const {
+  vkCmdBindDescriptorSets(m_handle, bind_point, layout, set, 1, &descriptor_set,
                           0, nullptr);
 }
 
+void CommandBuffer::bind_descriptor_set(const VkPipelineBindPoint bind_point,
+                                        const VkPipelineLayout layout,
+                                        const VkDescriptorSet descriptor_set,
+                                        uint32_t set,
+                                        uint32_t dynamic_offset_count,
+                                        const uint32_t *dynamic_offsets) const {
+  vkCmdBindDescriptorSets(m_handle, bind_point, layout, set, 1, &descriptor_set,
+                          dynamic_offset_count, dynamic_offsets);
+}
+
+void CommandBuffer::push_descriptor_set(
+    const VkPipelineBindPoint bind_point, const VkPipelineLayout layout,
+    uint32_t set, const std::vector<VkWriteDescriptorSet> &writes) const {
+  vkCmdPushDescriptorSetKHR(m_handle, bind_point, layout, set,
+                            static_cast<uint32_t>(writes.size()),
+                            writes.data());
+}
+
+void CommandBuffer::push_descriptor_set(
+    const DescriptorUpdateTemplate &update_template, const void *data) const {
+  vkCmdPushDescriptorSetWithTemplateKHR(
+      m_handle, update_template.get_handle(),
+      update_template.get_pipeline_layout(), update_template.get_set(), data);
+}
+
+void CommandBuffer::push_constants(const VkPipelineLayout layout,
+                                   VkShaderStageFlags stages, uint32_t offset,
+                                   uint32_t size, const void *data) const {
+  vkCmdPushConstants(m_handle, layout, stages, offset, size, data);
+}
+
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y,
                              uint32_t group_count_z) const {
+  flush_barriers();
+
   vkCmdDispatch(m_handle, group_count_x, group_count_y, group_count_z);
 }
 
+void CommandBuffer::dispatch(const ComputeDispatch &dispatch, uint32_t width,
+                             uint32_t height, uint32_t depth) const {
+  auto group_count = dispatch.get_group_count(width, height, depth);
+  this->dispatch(group_count[0], group_count[1], group_count[2]);
+}
+
 void CommandBuffer::begin_render_pass(const VkRenderPassBeginInfo &begin_info,
                                       VkSubpassContents contents) const {
+  flush_barriers();
+
   vkCmdBeginRenderPass(m_handle, &begin_info, contents);
 }
 
@@ -123,6 +368,8 @@ void CommandBuffer::end_render_pass() const { vkCmdEndRenderPass(m_handle); }
 
 void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count,
                          uint32_t first_vertex, uint32_t first_instance) const {
+  flush_barriers();
+
   vkCmdDraw(m_handle, vertex_count, instance_count, first_vertex,
             first_instance);
 }
@@ -130,6 +377,8 @@ void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count,
 void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count,
                                  uint32_t first_index, int32_t vertex_offset,
                                  uint32_t first_instance) const {
+  flush_barriers();
+
   vkCmdDrawIndexed(m_handle, index_count, instance_count, first_index,
                    vertex_offset, first_instance);
 }
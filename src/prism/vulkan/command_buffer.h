@@ -7,9 +7,13 @@ namespace prism
   class Buffer;
   class Image;
   class CommandPool;
+  class ComputeDispatch;
+  class DescriptorUpdateTemplate;
   class ComputePipeline;
   class GraphicsPipeline;
 
+  // image transitions and memory dependencies are queued and recorded as a single vkCmdPipelineBarrier2 right before
+  // the next draw, dispatch, copy or render pass, image barriers take their source scope from the tracked image state
   class CommandBuffer
   {
   public:
@@ -39,6 +43,9 @@ namespace prism
 
     void copy_image(const Image &src, const Image &dst, const std::vector<VkImageCopy>& regions) const;
 
+    // converts between formats, unlike copy_image
+    void blit_image(const Image &src, const Image &dst, const std::vector<VkImageBlit>& regions, VkFilter filter = VK_FILTER_NEAREST) const;
+
     void fill_buffer(const Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data) const;
 
     void pipeline_barrier(VkPipelineStageFlags src_stage, VkPipelineStageFlags dst_stage,
@@ -47,14 +54,46 @@ namespace prism
                           const std::vector<VkBufferMemoryBarrier> &buffer_memory_barriers,
                           const std::vector<VkImageMemoryBarrier> &image_memory_barriers) const;
 
+    // queues a transition of the subresources to new_layout for the given consumer stages and accesses,
+    // reads in the current layout need no barrier once the last write is visible to their stages and accesses
+    void image_barrier(Image &image, VkImageLayout new_layout, VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
+                       const VkImageSubresourceRange &subresource_range) const;
+
+    void image_barrier(Image &image, VkImageLayout new_layout, VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
+                       VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT) const;
+
+    // queues a global memory dependency, used for buffers
+    void memory_barrier(VkPipelineStageFlags2 src_stage, VkAccessFlags2 src_access,
+                        VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access) const;
+
+    // records every queued barrier in one call
+    void flush_barriers() const;
+
+    // number of pipeline barrier calls recorded since begin
+    uint32_t get_barrier_count() const;
+
     void bind_pipeline(const ComputePipeline &pipeline) const;
 
     void bind_pipeline(const GraphicsPipeline &pipeline) const;
 
-    void bind_descriptor_set(const VkPipelineBindPoint bind_point, const VkPipelineLayout layout, const VkDescriptorSet descriptor_set) const;
+    void bind_descriptor_set(const VkPipelineBindPoint bind_point, const VkPipelineLayout layout, const VkDescriptorSet descriptor_set, uint32_t set = 0) const;
+
+    // one offset per dynamic descriptor of the set, in binding order
+    void bind_descriptor_set(const VkPipelineBindPoint bind_point, const VkPipelineLayout layout, const VkDescriptorSet descriptor_set, uint32_t set, uint32_t dynamic_offset_count, const uint32_t *dynamic_offsets) const;
+
+    // records the writes into the command buffer instead of a set, the set layout needs the push descriptor flag
+    void push_descriptor_set(const VkPipelineBindPoint bind_point, const VkPipelineLayout layout, uint32_t set, const std::vector<VkWriteDescriptorSet> &writes) const;
+
+    // the packed struct is read while recording
+    void push_descriptor_set(const DescriptorUpdateTemplate &update_template, const void *data) const;
+
+    void push_constants(const VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void *data) const;
 
     void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) const;
 
+    // enough workgroups to cover a grid of width x height x depth invocations
+    void dispatch(const ComputeDispatch &dispatch, uint32_t width, uint32_t height = 1, uint32_t depth = 1) const;
+
     void begin_render_pass(const VkRenderPassBeginInfo &begin_info, VkSubpassContents contents) const;
 
     void end_render_pass() const;
@@ -77,6 +116,12 @@ namespace prism
     const Device &m_device;
     const CommandPool &m_cmd_pool;
 
+    mutable std::vector<VkImageMemoryBarrier2> m_image_barriers;
+
+    mutable VkMemoryBarrier2 m_memory_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+
+    mutable uint32_t m_barrier_count{0};
+
   }; // class CommandBuffer
 
 } // namespace prism
\ No newline at end of file
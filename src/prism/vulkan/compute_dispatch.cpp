@@ -0,0 +1,99 @@
+#include "prism/vulkan/compute_dispatch.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/physical_device.h"
+
+using namespace prism;
+
+namespace
+{
+  const uint32_t MIN_INVOCATIONS = 64;
+
+  // the size workgroups are rounded to, keeps the group at a handful of waves so occupancy is not limited by it
+  const uint32_t MAX_INVOCATIONS = 256;
+
+  uint32_t floor_power_of_two(uint32_t value)
+  {
+    uint32_t result = 1;
+    while (result * 2 <= value)
+    {
+      result *= 2;
+    }
+    return result;
+  }
+}
+
+ComputeDispatch::ComputeDispatch(const PhysicalDevice &physical_device, uint32_t dimensions)
+{
+  if (dimensions == 0 || dimensions > 3)
+  {
+    throw std::runtime_error("Compute dispatches have one to three dimensions");
+  }
+
+  const auto &limits = physical_device.get_properties().limits;
+  std::copy(std::begin(limits.maxComputeWorkGroupCount), std::end(limits.maxComputeWorkGroupCount), m_max_group_count.begin());
+
+  auto subgroup_size = std::max(physical_device.get_subgroup_properties().subgroupSize, 1u);
+  auto invocations = std::max(subgroup_size, MIN_INVOCATIONS);
+  invocations = std::min({invocations, MAX_INVOCATIONS, limits.maxComputeWorkGroupInvocations});
+  invocations = floor_power_of_two(invocations);
+
+  // doubles the dimensions in turn until the invocations are spent, 64 becomes 8x8 or 4x4x4
+  auto remaining = invocations;
+  bool grown = true;
+  while (remaining > 1 && grown)
+  {
+    grown = false;
+    for (uint32_t i = 0; i < dimensions && remaining > 1; ++i)
+    {
+      if (m_workgroup_size[i] * 2 <= limits.maxComputeWorkGroupSize[i])
+      {
+        m_workgroup_size[i] *= 2;
+        remaining /= 2;
+        grown = true;
+      }
+    }
+  }
+}
+
+ComputeDispatch::ComputeDispatch(const PhysicalDevice &physical_device, const std::array<uint32_t, 3> &workgroup_size)
+    : m_workgroup_size(workgroup_size)
+{
+  const auto &limits = physical_device.get_properties().limits;
+  std::copy(std::begin(limits.maxComputeWorkGroupCount), std::end(limits.maxComputeWorkGroupCount), m_max_group_count.begin());
+
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    if (m_workgroup_size[i] == 0 || m_workgroup_size[i] > limits.maxComputeWorkGroupSize[i])
+    {
+      throw std::runtime_error("Workgroup size is outside the device limits");
+    }
+  }
+  if (m_workgroup_size[0] * m_workgroup_size[1] * m_workgroup_size[2] > limits.maxComputeWorkGroupInvocations)
+  {
+    throw std::runtime_error("Workgroup has more invocations than the device supports");
+  }
+}
+
+const std::array<uint32_t, 3> &ComputeDispatch::get_workgroup_size() const
+{
+  return m_workgroup_size;
+}
+
+std::array<uint32_t, 3> ComputeDispatch::get_group_count(uint32_t width, uint32_t height, uint32_t depth) const
+{
+  std::array<uint32_t, 3> extent{width, height, depth};
+
+  std::array<uint32_t, 3> group_count{};
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    group_count[i] = (extent[i] + m_workgroup_size[i] - 1) / m_workgroup_size[i];
+    if (group_count[i] > m_max_group_count[i])
+    {
+      throw std::runtime_error("Dispatch exceeds the maximum workgroup count");
+    }
+  }
+
+  return group_count;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+
+namespace prism
+{
+  class PhysicalDevice;
+
+  // the workgroup size of a compute kernel and the group counts that cover a grid of invocations with it. the
+  // size is either picked for the device, for kernels that take it from specialization constants, or the one the
+  // shader declares
+  class ComputeDispatch
+  {
+  public:
+    // a power of two number of invocations, a multiple of the subgroup size and at least 64, spread over the
+    // given number of dimensions and clamped to the device limits
+    ComputeDispatch(const PhysicalDevice &physical_device, uint32_t dimensions = 2);
+
+    ComputeDispatch(const PhysicalDevice &physical_device, const std::array<uint32_t, 3> &workgroup_size);
+
+    const std::array<uint32_t, 3> &get_workgroup_size() const;
+
+    // rounded up, the kernel has to discard the invocations past the grid. throws when the count is over the limit
+    std::array<uint32_t, 3> get_group_count(uint32_t width, uint32_t height = 1, uint32_t depth = 1) const;
+
+  private:
+    std::array<uint32_t, 3> m_workgroup_size{1, 1, 1};
+
+    std::array<uint32_t, 3> m_max_group_count;
+
+  }; // class ComputeDispatch
+
+} // namespace prism
@@ -1,5 +1,7 @@
 #include "prism/vulkan/compute_pipeline.h"
 
+#include "prism/vulkan/pipeline_cache.h"
+
 using namespace prism;
 
 ComputePipeline::ComputePipeline(const Device &device, const PipelineLayout &pipeline_layout, const ShaderStage& shader_stage)
@@ -10,7 +12,7 @@ ComputePipeline::ComputePipeline(const Device &device, const PipelineLayout &pip
   pipeline_info.layout = pipeline_layout.get_handle();
   pipeline_info.stage = shader_stage;
 
-  VK_CHECK(vkCreateComputePipelines(m_device.get_handle(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &m_handle));
+  VK_CHECK(vkCreateComputePipelines(m_device.get_handle(), m_device.get_pipeline_cache().get_handle(), 1, &pipeline_info, nullptr, &m_handle));
 }
 
 ComputePipeline::ComputePipeline(ComputePipeline &&other) noexcept
@@ -0,0 +1,213 @@
+#include "prism/vulkan/descriptor_allocator.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/utils.h"
+
+using namespace prism;
+
+namespace
+{
+  // pools stop growing here, larger ones only waste memory when a frame needs a few more sets
+  const uint32_t MAX_SETS_PER_POOL = 4096;
+
+  void hash_descriptor(uint64_t &hash, const Descriptor &descriptor)
+  {
+    utils::hash_combine(hash, descriptor.type);
+    utils::hash_combine(hash, descriptor.binding);
+    utils::hash_combine(hash, descriptor.array_element);
+  }
+
+  bool is_same_descriptor(const Descriptor &lhs, const Descriptor &rhs)
+  {
+    return lhs.type == rhs.type && lhs.binding == rhs.binding && lhs.array_element == rhs.array_element;
+  }
+
+  bool is_same_buffer(const DescriptorBuffer &lhs, const DescriptorBuffer &rhs)
+  {
+    return is_same_descriptor(lhs, rhs) && lhs.info.buffer == rhs.info.buffer && lhs.info.offset == rhs.info.offset &&
+           lhs.info.range == rhs.info.range;
+  }
+
+  bool is_same_image(const DescriptorImage &lhs, const DescriptorImage &rhs)
+  {
+    return is_same_descriptor(lhs, rhs) && lhs.info.sampler == rhs.info.sampler &&
+           lhs.info.imageView == rhs.info.imageView && lhs.info.imageLayout == rhs.info.imageLayout;
+  }
+}
+
+bool DescriptorAllocator::SetKey::operator==(const SetKey &other) const
+{
+  return layout == other.layout &&
+         std::equal(buffers.begin(), buffers.end(), other.buffers.begin(), other.buffers.end(), is_same_buffer) &&
+         std::equal(images.begin(), images.end(), other.images.begin(), other.images.end(), is_same_image);
+}
+
+size_t DescriptorAllocator::SetKeyHash::operator()(const SetKey &key) const
+{
+  uint64_t hash = 0;
+  utils::hash_combine(hash, key.layout);
+  for (const auto &buffer : key.buffers)
+  {
+    hash_descriptor(hash, buffer);
+    utils::hash_combine(hash, buffer.info.buffer);
+    utils::hash_combine(hash, buffer.info.offset);
+    utils::hash_combine(hash, buffer.info.range);
+  }
+  for (const auto &image : key.images)
+  {
+    hash_descriptor(hash, image);
+    utils::hash_combine(hash, image.info.sampler);
+    utils::hash_combine(hash, image.info.imageView);
+    utils::hash_combine(hash, image.info.imageLayout);
+  }
+  return static_cast<size_t>(hash);
+}
+
+DescriptorAllocator::DescriptorAllocator(const Device &device, uint32_t sets_per_pool, const std::vector<PoolRatio> &pool_ratios)
+    : m_device(device), m_sets_per_pool(sets_per_pool), m_pool_ratios(pool_ratios)
+{
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+}
+
+std::vector<DescriptorAllocator::PoolRatio> DescriptorAllocator::default_pool_ratios()
+{
+  return {
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
+      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f},
+      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f},
+      {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+      {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
+      {VK_DESCRIPTOR_TYPE_SAMPLER, 1.0f},
+  };
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(const DescriptorSetLayout &layout)
+{
+  if (m_used_pools.empty())
+  {
+    create_pool();
+  }
+
+  VkDescriptorSetAllocateInfo alloc_info = {};
+  alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  alloc_info.descriptorPool = m_used_pools.back()->get_handle();
+  alloc_info.descriptorSetCount = 1;
+  alloc_info.pSetLayouts = &layout.get_handle();
+
+  VkDescriptorSet descriptor_set;
+  auto result = vkAllocateDescriptorSets(m_device.get_handle(), &alloc_info, &descriptor_set);
+
+  // the pool is full, continue in the next one
+  if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+  {
+    alloc_info.descriptorPool = create_pool().get_handle();
+    result = vkAllocateDescriptorSets(m_device.get_handle(), &alloc_info, &descriptor_set);
+  }
+
+  VK_CHECK(result);
+
+  ++m_statistics.allocation_count;
+
+  return descriptor_set;
+}
+
+VkDescriptorSet DescriptorAllocator::request(const DescriptorSetLayout &layout, const std::vector<DescriptorBuffer> &buffers, const std::vector<DescriptorImage> &images)
+{
+  SetKey key{layout.get_handle(), buffers, images};
+
+  auto it = m_sets.find(key);
+  if (it != m_sets.end())
+  {
+    ++m_statistics.hit_count;
+    return it->second;
+  }
+
+  auto descriptor_set = allocate(layout);
+
+  std::vector<VkWriteDescriptorSet> writes;
+  writes.reserve(buffers.size() + images.size());
+  for (const auto &buffer : buffers)
+  {
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptor_set;
+    write.dstBinding = buffer.binding;
+    write.dstArrayElement = buffer.array_element;
+    write.descriptorType = buffer.type;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &buffer.info;
+    writes.push_back(write);
+  }
+  for (const auto &image : images)
+  {
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptor_set;
+    write.dstBinding = image.binding;
+    write.dstArrayElement = image.array_element;
+    write.descriptorType = image.type;
+    write.descriptorCount = 1;
+    write.pImageInfo = &image.info;
+    writes.push_back(write);
+  }
+
+  vkUpdateDescriptorSets(m_device.get_handle(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+  m_sets.emplace(std::move(key), descriptor_set);
+
+  return descriptor_set;
+}
+
+void DescriptorAllocator::reset()
+{
+  for (auto &pool : m_used_pools)
+  {
+    pool->reset();
+    m_free_pools.push_back(std::move(pool));
+  }
+  m_used_pools.clear();
+
+  m_sets.clear();
+
+  auto pool_count = m_statistics.pool_count;
+  m_statistics = {};
+  m_statistics.pool_count = pool_count;
+}
+
+const DescriptorAllocator::Statistics &DescriptorAllocator::get_statistics() const
+{
+  return m_statistics;
+}
+
+DescriptorPool &DescriptorAllocator::create_pool()
+{
+  if (!m_free_pools.empty())
+  {
+    m_used_pools.push_back(std::move(m_free_pools.back()));
+    m_free_pools.pop_back();
+    return *m_used_pools.back();
+  }
+
+  std::vector<VkDescriptorPoolSize> pool_sizes;
+  pool_sizes.reserve(m_pool_ratios.size());
+  for (const auto &pool_ratio : m_pool_ratios)
+  {
+    auto count = static_cast<uint32_t>(pool_ratio.ratio * m_sets_per_pool);
+    pool_sizes.push_back({pool_ratio.type, std::max(count, 1u)});
+  }
+
+  // sets are only returned through reset
+  m_used_pools.push_back(std::make_unique<DescriptorPool>(m_device, pool_sizes, m_sets_per_pool, 0));
+  ++m_statistics.pool_count;
+
+  // a frame that filled this pool likely needs as much again next time
+  m_sets_per_pool = std::min(m_sets_per_pool * 2, MAX_SETS_PER_POOL);
+
+  return *m_used_pools.back();
+}
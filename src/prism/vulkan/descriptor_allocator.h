@@ -0,0 +1,96 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "prism/vulkan/descriptor.h"
+#include "prism/vulkan/descriptor_pool.h"
+#include "prism/vulkan/descriptor_set_layout.h"
+
+namespace prism
+{
+  // hands out descriptor sets that live until the next reset(). sets come from a chain of pools, a new and larger
+  // pool is added when the current one runs out, and reset() recycles every pool at once instead of freeing sets
+  // one by one. requested sets are cached by their layout and writes, so binding the same resources twice between
+  // resets returns the same set. one allocator per frame in flight, reset once the frame's fence has signaled
+  class DescriptorAllocator
+  {
+  public:
+    // descriptors of a type per set, pools hold sets_per_pool times as many
+    struct PoolRatio
+    {
+      VkDescriptorType type;
+      float ratio;
+    };
+
+    struct Statistics
+    {
+      uint32_t pool_count{0};
+      uint32_t allocation_count{0};
+      uint32_t hit_count{0};
+    };
+
+  public:
+    DescriptorAllocator(const Device &device, uint32_t sets_per_pool = 64, const std::vector<PoolRatio> &pool_ratios = default_pool_ratios());
+
+    DescriptorAllocator(const DescriptorAllocator &) = delete;
+
+    DescriptorAllocator(DescriptorAllocator &&) = delete;
+
+    ~DescriptorAllocator();
+
+    DescriptorAllocator &operator=(const DescriptorAllocator &) = delete;
+
+    DescriptorAllocator &operator=(DescriptorAllocator &&) = delete;
+
+    static std::vector<PoolRatio> default_pool_ratios();
+
+    // an unwritten set
+    VkDescriptorSet allocate(const DescriptorSetLayout &layout);
+
+    // a set with the given descriptors written, or the one already requested with the same layout and descriptors
+    VkDescriptorSet request(const DescriptorSetLayout &layout, const std::vector<DescriptorBuffer> &buffers, const std::vector<DescriptorImage> &images = {});
+
+    // every set handed out becomes invalid, the gpu must be done with them
+    void reset();
+
+    // since the last reset, the pool count is the total
+    const Statistics &get_statistics() const;
+
+  private:
+    // the layout and every descriptor of a requested set, compared in full so only equal requests share a set
+    struct SetKey
+    {
+      VkDescriptorSetLayout layout;
+      std::vector<DescriptorBuffer> buffers;
+      std::vector<DescriptorImage> images;
+
+      bool operator==(const SetKey &other) const;
+    };
+
+    struct SetKeyHash
+    {
+      size_t operator()(const SetKey &key) const;
+    };
+
+  private:
+    DescriptorPool &create_pool();
+
+  private:
+    const Device &m_device;
+
+    uint32_t m_sets_per_pool;
+
+    std::vector<PoolRatio> m_pool_ratios;
+
+    // the last used pool is the one allocated from, the others in front of it are full
+    std::vector<std::unique_ptr<DescriptorPool>> m_used_pools;
+
+    std::vector<std::unique_ptr<DescriptorPool>> m_free_pools;
+
+    std::unordered_map<SetKey, VkDescriptorSet, SetKeyHash> m_sets;
+
+    Statistics m_statistics;
+
+  }; // class DescriptorAllocator
+
+} // namespace prism
@@ -2,7 +2,7 @@
 
 using namespace prism;
 
-DescriptorPool::DescriptorPool(const Device &device, const std::vector<VkDescriptorPoolSize> &pool_sizes, uint32_t max_sets)
+DescriptorPool::DescriptorPool(const Device &device, const std::vector<VkDescriptorPoolSize> &pool_sizes, uint32_t max_sets, VkDescriptorPoolCreateFlags flags)
     : m_device(device), m_max_sets(max_sets), m_sizes(pool_sizes)
 {
   VkDescriptorPoolCreateInfo pool_info = {};
@@ -10,7 +10,7 @@ DescriptorPool::DescriptorPool(const Device &device, const std::vector<VkDescrip
   pool_info.poolSizeCount = static_cast<uint32_t>(m_sizes.size());
   pool_info.pPoolSizes = m_sizes.data();
   pool_info.maxSets = m_max_sets;
-  pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+  pool_info.flags = flags;
 
   VK_CHECK(vkCreateDescriptorPool(m_device.get_handle(), &pool_info, nullptr, &m_handle));
 }
@@ -50,6 +50,11 @@ void DescriptorPool::free(const VkDescriptorSet &descriptor_set)
   VK_CHECK(vkFreeDescriptorSets(m_device.get_handle(), m_handle, 1, &descriptor_set));
 }
 
+void DescriptorPool::reset()
+{
+  VK_CHECK(vkResetDescriptorPool(m_device.get_handle(), m_handle, 0));
+}
+
 VkDescriptorPool DescriptorPool::get_handle() const
 {
   return m_handle;
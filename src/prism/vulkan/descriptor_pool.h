@@ -7,7 +7,7 @@ namespace prism
   class DescriptorPool
   {
   public:
-    DescriptorPool(const Device &device, const std::vector<VkDescriptorPoolSize> &pool_sizes, uint32_t max_sets);
+    DescriptorPool(const Device &device, const std::vector<VkDescriptorPoolSize> &pool_sizes, uint32_t max_sets, VkDescriptorPoolCreateFlags flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
 
     DescriptorPool(const DescriptorPool &) = delete;
 
@@ -23,6 +23,9 @@ namespace prism
 
     void free(const VkDescriptorSet &descriptor_set);
 
+    // returns every set allocated from the pool to it
+    void reset();
+
     VkDescriptorPool get_handle() const;
 
   private:
@@ -70,10 +70,27 @@ void DescriptorSet::write(const std::vector<DescriptorBuffer> &buffers, const st
     write.dstSet = m_handle;
     write.dstBinding = buffers[i].binding;
     write.dstArrayElement = buffers[i].array_element;
-    write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    write.descriptorType = buffers[i].type;
     write.descriptorCount = 1;
     write.pBufferInfo = &buffers[i].info;
   }
 
+  for (size_t i = 0; i < images.size(); i++)
+  {
+    auto &write = writes[buffers.size() + i];
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_handle;
+    write.dstBinding = images[i].binding;
+    write.dstArrayElement = images[i].array_element;
+    write.descriptorType = images[i].type;
+    write.descriptorCount = 1;
+    write.pImageInfo = &images[i].info;
+  }
+
   vkUpdateDescriptorSets(m_device.get_handle(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
-}
\ No newline at end of file
+}
+
+void DescriptorSet::update(const DescriptorUpdateTemplate &update_template, const void *data)
+{
+  update_template.update(m_handle, data);
+}
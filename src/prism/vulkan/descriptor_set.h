@@ -4,6 +4,7 @@
 #include "prism/vulkan/descriptor_set_layout.h"
 #include "prism/vulkan/descriptor_pool.h"
 #include "prism/vulkan/descriptor.h"
+#include "prism/vulkan/descriptor_update_template.h"
 
 namespace prism
 {
@@ -26,8 +27,12 @@ namespace prism
 
     void write(const std::vector<VkDescriptorBufferInfo> &buffer_infos);
 
+    // each descriptor is written with its own type
     void write(const std::vector<DescriptorBuffer> &buffers, const std::vector<DescriptorImage> &images);
 
+    // every binding from the packed struct of the template, nothing is allocated
+    void update(const DescriptorUpdateTemplate &update_template, const void *data);
+
   private:
     VkDescriptorSet m_handle;
 
@@ -3,10 +3,27 @@
 using namespace prism;
 
 DescriptorSetLayout::DescriptorSetLayout(const Device &device, const Bindings &bindings)
+    : DescriptorSetLayout(device, bindings, {}, 0)
+{
+}
+
+DescriptorSetLayout::DescriptorSetLayout(const Device &device, const Bindings &bindings, const std::vector<VkDescriptorBindingFlags> &binding_flags, VkDescriptorSetLayoutCreateFlags flags)
     : m_device(device), m_bindings(bindings)
 {
+  if (!binding_flags.empty() && binding_flags.size() != m_bindings.size())
+  {
+    throw std::runtime_error("Descriptor binding flags have to be given for every binding");
+  }
+
+  VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info = {};
+  binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+  binding_flags_info.bindingCount = static_cast<uint32_t>(binding_flags.size());
+  binding_flags_info.pBindingFlags = binding_flags.data();
+
   VkDescriptorSetLayoutCreateInfo layout_info = {};
   layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layout_info.pNext = binding_flags.empty() ? nullptr : &binding_flags_info;
+  layout_info.flags = flags;
   layout_info.bindingCount = static_cast<uint32_t>(m_bindings.size());
   layout_info.pBindings = m_bindings.data();
 
@@ -33,6 +50,11 @@ const VkDescriptorSetLayout &DescriptorSetLayout::get_handle() const
   return m_handle;
 }
 
+const DescriptorSetLayout::Bindings &DescriptorSetLayout::get_bindings() const
+{
+  return m_bindings;
+}
+
 std::vector<VkDescriptorPoolSize> DescriptorSetLayout::get_descriptor_pool_sizes() const
 {
   std::vector<VkDescriptorPoolSize> pool_sizes;
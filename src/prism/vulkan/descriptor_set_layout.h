@@ -12,6 +12,9 @@ namespace prism
   public:
     DescriptorSetLayout(const Device &device, const Bindings &bindings);
 
+    // binding flags are per binding, e.g. partially bound or update after bind for descriptor indexing
+    DescriptorSetLayout(const Device &device, const Bindings &bindings, const std::vector<VkDescriptorBindingFlags> &binding_flags, VkDescriptorSetLayoutCreateFlags flags = 0);
+
     DescriptorSetLayout(const DescriptorSetLayout &) = delete;
 
     DescriptorSetLayout(DescriptorSetLayout &&other) noexcept;
@@ -24,6 +27,8 @@ namespace prism
 
     const VkDescriptorSetLayout &get_handle() const;
 
+    const Bindings &get_bindings() const;
+
     std::vector<VkDescriptorPoolSize> get_descriptor_pool_sizes() const;
 
   private:
@@ -0,0 +1,145 @@
+#include "prism/vulkan/descriptor_update_template.h"
+
+using namespace prism;
+
+namespace
+{
+  size_t descriptor_size(VkDescriptorType type)
+  {
+    switch (type)
+    {
+    case VK_DESCRIPTOR_TYPE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+      return sizeof(VkDescriptorImageInfo);
+    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+      return sizeof(VkDescriptorBufferInfo);
+    case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+    case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+      return sizeof(VkBufferView);
+    case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+      return sizeof(VkAccelerationStructureKHR);
+    default:
+      throw std::runtime_error("Unsupported descriptor type for update templates");
+    }
+  }
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Device &device, const DescriptorSetLayout &layout)
+    : m_device(device)
+{
+  create(layout, VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET, VK_PIPELINE_BIND_POINT_GRAPHICS);
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Device &device, const DescriptorSetLayout &layout, VkPipelineBindPoint bind_point, VkPipelineLayout pipeline_layout, uint32_t set)
+    : m_device(device), m_pipeline_layout(pipeline_layout), m_set(set)
+{
+  create(layout, VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR, bind_point);
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(DescriptorUpdateTemplate &&other) noexcept
+    : m_handle(std::exchange(other.m_handle, VK_NULL_HANDLE)),
+      m_device(other.m_device),
+      m_pipeline_layout(other.m_pipeline_layout),
+      m_set(other.m_set),
+      m_offsets(std::move(other.m_offsets)),
+      m_size(other.m_size)
+{
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate()
+{
+  if (m_handle != VK_NULL_HANDLE)
+  {
+    vkDestroyDescriptorUpdateTemplate(m_device.get_handle(), m_handle, nullptr);
+  }
+}
+
+VkDescriptorUpdateTemplate DescriptorUpdateTemplate::get_handle() const
+{
+  return m_handle;
+}
+
+VkPipelineLayout DescriptorUpdateTemplate::get_pipeline_layout() const
+{
+  return m_pipeline_layout;
+}
+
+uint32_t DescriptorUpdateTemplate::get_set() const
+{
+  return m_set;
+}
+
+size_t DescriptorUpdateTemplate::get_offset(uint32_t binding) const
+{
+  for (const auto &offset : m_offsets)
+  {
+    if (offset.first == binding)
+    {
+      return offset.second;
+    }
+  }
+
+  throw std::runtime_error("Binding " + std::to_string(binding) + " is not in the update template");
+}
+
+size_t DescriptorUpdateTemplate::get_size() const
+{
+  return m_size;
+}
+
+void DescriptorUpdateTemplate::update(VkDescriptorSet descriptor_set, const void *data) const
+{
+  vkUpdateDescriptorSetWithTemplate(m_device.get_handle(), descriptor_set, m_handle, data);
+}
+
+void DescriptorUpdateTemplate::create(const DescriptorSetLayout &layout, VkDescriptorUpdateTemplateType type, VkPipelineBindPoint bind_point)
+{
+  const auto &bindings = layout.get_bindings();
+
+  std::vector<VkDescriptorUpdateTemplateEntry> entries;
+  entries.reserve(bindings.size());
+  for (const auto &binding : bindings)
+  {
+    if (binding.descriptorCount == 0)
+    {
+      continue;
+    }
+
+    auto stride = descriptor_size(binding.descriptorType);
+
+    VkDescriptorUpdateTemplateEntry entry{};
+    entry.dstBinding = binding.binding;
+    entry.dstArrayElement = 0;
+    entry.descriptorCount = binding.descriptorCount;
+    entry.descriptorType = binding.descriptorType;
+    entry.offset = m_size;
+    entry.stride = stride;
+    entries.push_back(entry);
+
+    m_offsets.emplace_back(binding.binding, m_size);
+    m_size += stride * binding.descriptorCount;
+  }
+
+  if (entries.empty())
+  {
+    throw std::runtime_error("Update templates need a layout with descriptors");
+  }
+
+  VkDescriptorUpdateTemplateCreateInfo template_info{};
+  template_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+  template_info.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+  template_info.pDescriptorUpdateEntries = entries.data();
+  template_info.templateType = type;
+  template_info.descriptorSetLayout = layout.get_handle();
+  template_info.pipelineBindPoint = bind_point;
+  template_info.pipelineLayout = m_pipeline_layout;
+  template_info.set = m_set;
+
+  VK_CHECK(vkCreateDescriptorUpdateTemplate(m_device.get_handle(), &template_info, nullptr, &m_handle));
+}
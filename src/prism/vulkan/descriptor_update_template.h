@@ -0,0 +1,62 @@
+#pragma once
+
+#include "prism/vulkan/descriptor_set_layout.h"
+
+namespace prism
+{
+  // writes every binding of a set layout from one packed struct. the struct holds the bindings in the order of the
+  // layout, each descriptor as its VkDescriptorImageInfo, VkDescriptorBufferInfo, VkBufferView or
+  // VkAccelerationStructureKHR, so updating a set is a memcpy of the struct and one call with nothing allocated.
+  // all of them are 8 byte aligned and sized, a struct of them has no padding
+  class DescriptorUpdateTemplate
+  {
+  public:
+    // for vkUpdateDescriptorSetWithTemplate on sets of the layout
+    DescriptorUpdateTemplate(const Device &device, const DescriptorSetLayout &layout);
+
+    // for vkCmdPushDescriptorSetWithTemplateKHR, the layout has to be created with the push descriptor flag
+    DescriptorUpdateTemplate(const Device &device, const DescriptorSetLayout &layout, VkPipelineBindPoint bind_point, VkPipelineLayout pipeline_layout, uint32_t set);
+
+    DescriptorUpdateTemplate(const DescriptorUpdateTemplate &) = delete;
+
+    DescriptorUpdateTemplate(DescriptorUpdateTemplate &&other) noexcept;
+
+    ~DescriptorUpdateTemplate();
+
+    DescriptorUpdateTemplate &operator=(const DescriptorUpdateTemplate &) = delete;
+
+    DescriptorUpdateTemplate &operator=(DescriptorUpdateTemplate &&) = delete;
+
+    VkDescriptorUpdateTemplate get_handle() const;
+
+    VkPipelineLayout get_pipeline_layout() const;
+
+    uint32_t get_set() const;
+
+    // where the descriptors of a binding start in the packed struct
+    size_t get_offset(uint32_t binding) const;
+
+    // the size of the packed struct
+    size_t get_size() const;
+
+    void update(VkDescriptorSet descriptor_set, const void *data) const;
+
+  private:
+    void create(const DescriptorSetLayout &layout, VkDescriptorUpdateTemplateType type, VkPipelineBindPoint bind_point);
+
+  private:
+    VkDescriptorUpdateTemplate m_handle{VK_NULL_HANDLE};
+
+    const Device &m_device;
+
+    VkPipelineLayout m_pipeline_layout{VK_NULL_HANDLE};
+
+    uint32_t m_set{0};
+
+    std::vector<std::pair<uint32_t, size_t>> m_offsets;
+
+    size_t m_size{0};
+
+  }; // class DescriptorUpdateTemplate
+
+} // namespace prism
@@ -1,11 +1,16 @@
 #include "prism/vulkan/device.h"
 
+#include <algorithm>
+
+#include "prism/vulkan/pipeline_cache.h"
+#include "prism/vulkan/upload_manager.h"
 #include "prism/vulkan/utils.h"
 
 using namespace prism;
 
-Device::Device(const PhysicalDevice &physical_device, const ExtensionNames &extensions, const DeviceFeatures& features)
-    : m_physical_device(physical_device)
+Device::Device(const PhysicalDevice &physical_device, const ExtensionNames &extensions, DeviceFeatures& features, MemoryAllocator::Backend memory_backend, const std::string &pipeline_cache_path,
+               bool transfer_queue_uploads)
+    : m_physical_device(physical_device), m_enabled_extensions(extensions.begin(), extensions.end())
 {
 
   auto queue_family_count = m_physical_device.get_queue_family_properties().size();
@@ -26,12 +31,42 @@ Device::Device(const PhysicalDevice &physical_device, const ExtensionNames &exte
 
   assert(utils::check_extensions_support(extensions, m_physical_device.get_extensions()));
 
+  // memory type selection weighs the heap budgets, enable the extension that reports them when it is there
+  auto enabled_extensions = extensions;
+  if (!check_extension_enable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) &&
+      utils::check_extensions_support({VK_EXT_MEMORY_BUDGET_EXTENSION_NAME}, m_physical_device.get_extensions()))
+  {
+    enabled_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    m_enabled_extensions.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  }
+
+  // the upload manager signals a timeline semaphore and command buffers record their barriers through
+  // vkCmdPipelineBarrier2. the chain may not hold a feature twice, they are turned on in the vulkan 1.2 and 1.3
+  // structs when the caller passes them
+  if (features.contains(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES))
+  {
+    features.request(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, &VkPhysicalDeviceVulkan12Features::timelineSemaphore);
+  }
+  else
+  {
+    features.request(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES, &VkPhysicalDeviceTimelineSemaphoreFeatures::timelineSemaphore);
+  }
+
+  if (features.contains(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES))
+  {
+    features.request(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES, &VkPhysicalDeviceVulkan13Features::synchronization2);
+  }
+  else
+  {
+    features.request(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES, &VkPhysicalDeviceSynchronization2Features::synchronization2);
+  }
+
   VkDeviceCreateInfo device_info{};
   device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   device_info.queueCreateInfoCount = queue_infos.size();
   device_info.pQueueCreateInfos = queue_infos.data();
-  device_info.enabledExtensionCount = extensions.size();
-  device_info.ppEnabledExtensionNames = extensions.data();
+  device_info.enabledExtensionCount = enabled_extensions.size();
+  device_info.ppEnabledExtensionNames = enabled_extensions.data();
   device_info.pQueueCreateInfos = queue_infos.data();
   device_info.queueCreateInfoCount = queue_infos.size();
   device_info.pEnabledFeatures = nullptr;
@@ -50,15 +85,25 @@ Device::Device(const PhysicalDevice &physical_device, const ExtensionNames &exte
     {
       VkQueue queue;
       vkGetDeviceQueue(m_handle, queue_family_index, queue_index, &queue);
-      queues.emplace_back(Queue{queue, queue_family_index, queue_index});
+      queues.emplace_back(Queue{*this, queue, queue_family_index, queue_index});
     }
   }
 
   m_extension_functions = std::make_unique<DeviceExtensionFunctions>(this);
+
+  m_memory_allocator = MemoryAllocator::create(*this, memory_backend);
+
+  m_upload_manager = std::make_unique<UploadManager>(*this, transfer_queue_uploads);
+
+  m_pipeline_cache = std::make_unique<PipelineCache>(*this, pipeline_cache_path);
 }
 
 Device::~Device()
 {
+  m_pipeline_cache.reset();
+  m_upload_manager.reset();
+  m_memory_allocator.reset();
+
   if (m_handle)
     vkDestroyDevice(m_handle, nullptr);
 }
@@ -83,6 +128,26 @@ const DeviceExtensionFunctions &Device::get_extension_functions() const
   return *m_extension_functions;
 }
 
+MemoryAllocator &Device::get_memory_allocator() const
+{
+  return *m_memory_allocator;
+}
+
+UploadManager &Device::get_upload_manager() const
+{
+  return *m_upload_manager;
+}
+
+PipelineCache &Device::get_pipeline_cache() const
+{
+  return *m_pipeline_cache;
+}
+
+bool Device::check_extension_enable(const char *extension) const
+{
+  return std::find(m_enabled_extensions.begin(), m_enabled_extensions.end(), extension) != m_enabled_extensions.end();
+}
+
 
 void Device::wait_idle() const
 {
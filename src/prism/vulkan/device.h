@@ -4,16 +4,24 @@
 #include "prism/vulkan/queue.h"
 #include "prism/vulkan/device_features.h"
 #include "prism/vulkan/device_extension_functions.h"
+#include "prism/vulkan/memory_allocator.h"
 
 namespace prism
 {
+  class PipelineCache;
+  class UploadManager;
+
   class Device
   {
   public:
     using ExtensionNames = std::vector<const char*>;
 
   public:
-    Device(const PhysicalDevice &physical_device, const ExtensionNames &extensions, const DeviceFeatures &features);
+    // pipelines are created through a cache persisted at pipeline_cache_path, an empty path keeps it in memory.
+    // transfer_queue_uploads moves uploads to a dedicated transfer family, every submit that reads uploaded resources
+    // then has to record UploadManager::acquire(). features the device relies on are turned on in the caller's features
+    Device(const PhysicalDevice &physical_device, const ExtensionNames &extensions, DeviceFeatures &features, MemoryAllocator::Backend memory_backend = MemoryAllocator::Backend::Vma,
+           const std::string &pipeline_cache_path = "", bool transfer_queue_uploads = false);
 
     Device(const Device &) = delete;
 
@@ -33,6 +41,14 @@ namespace prism
 
     const DeviceExtensionFunctions &get_extension_functions() const;
 
+    MemoryAllocator &get_memory_allocator() const;
+
+    UploadManager &get_upload_manager() const;
+
+    PipelineCache &get_pipeline_cache() const;
+
+    bool check_extension_enable(const char *extension) const;
+
     void wait_idle() const;
 
   private:
@@ -42,6 +58,14 @@ namespace prism
 
     std::vector<std::vector<Queue>> m_queues;
 
+    std::vector<std::string> m_enabled_extensions;
+
     std::unique_ptr<DeviceExtensionFunctions> m_extension_functions{nullptr};
+
+    std::unique_ptr<MemoryAllocator> m_memory_allocator{nullptr};
+
+    std::unique_ptr<UploadManager> m_upload_manager{nullptr};
+
+    std::unique_ptr<PipelineCache> m_pipeline_cache{nullptr};
   };
 }
\ No newline at end of file
@@ -7,6 +7,17 @@ DeviceFeatures::~DeviceFeatures()
   clear();
 }
 
+void DeviceFeatures::request(VkBool32 VkPhysicalDeviceFeatures::*member)
+{
+  auto &features2 = get<VkPhysicalDeviceFeatures2>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+  features2.features.*member = VK_TRUE;
+}
+
+bool DeviceFeatures::contains(VkStructureType type) const
+{
+  return m_features.find(type) != m_features.end();
+}
+
 void DeviceFeatures::clear()
 {
   for (auto &feature : m_features)
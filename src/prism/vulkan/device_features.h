@@ -18,6 +18,11 @@ namespace prism
     template <typename T>
     void request(VkStructureType type, VkBool32 T::*member);
 
+    // core features, chained as VkPhysicalDeviceFeatures2 since the device is created without pEnabledFeatures
+    void request(VkBool32 VkPhysicalDeviceFeatures::*member);
+
+    bool contains(VkStructureType type) const;
+
     void clear();
     void *data() const;
 
@@ -1,55 +1,109 @@
 #include "prism/vulkan/device_memory.h"
 
+#include "prism/vulkan/buffer.h"
+#include "prism/vulkan/image.h"
+
 using namespace prism;
 
-DeviceMemory::DeviceMemory(const Device &device, const VkMemoryRequirements &requirements, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags)
+DeviceMemory::DeviceMemory(const Device &device, const VkMemoryRequirements &requirements, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags, VkMemoryPropertyFlags preferred_flags)
     : m_device(device), m_requirements(requirements), m_property_flags(property_flags)
 {
-    uint32_t memory_type_bits = m_requirements.memoryTypeBits;
+    MemoryAllocator::AllocateInfo allocate_info{};
+    allocate_info.requirements = m_requirements;
+    allocate_info.property_flags = m_property_flags;
+    allocate_info.preferred_flags = preferred_flags;
+    allocate_info.allocate_flags = allocate_flags;
 
-    const auto &memory_properties = device.get_physical_device().get_memory_properties();
+    allocate(allocate_info);
+}
 
-    uint32_t memory_type_index = memory_properties.memoryTypeCount;
-    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++)
-    {
-        if ((memory_type_bits & (1 << i)) && (memory_properties.memoryTypes[i].propertyFlags & m_property_flags) == m_property_flags)
-        {
-            memory_type_index = i;
-            break;
-        }
-    }
+DeviceMemory::DeviceMemory(const Buffer &buffer, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags, VkMemoryPropertyFlags preferred_flags)
+    : m_device(buffer.get_device()), m_requirements(buffer.get_memory_requirements()), m_property_flags(property_flags)
+{
+    MemoryAllocator::AllocateInfo allocate_info{};
+    allocate_info.requirements = m_requirements;
+    allocate_info.property_flags = m_property_flags;
+    allocate_info.preferred_flags = preferred_flags;
+    allocate_info.allocate_flags = allocate_flags;
+    allocate_info.linear = true;
+    allocate_info.dedicated = buffer.requires_dedicated_allocation();
+    allocate_info.dedicated_buffer = buffer.get_handle();
+
+    allocate(allocate_info);
+}
 
-    if (memory_type_index == memory_properties.memoryTypeCount)
-    {
-        throw std::runtime_error("Failed to find suitable memory type");
-    }
+DeviceMemory::DeviceMemory(const Image &image, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags, VkMemoryPropertyFlags preferred_flags)
+    : m_device(image.get_device()), m_requirements(image.get_memory_requirements()), m_property_flags(property_flags)
+{
+    MemoryAllocator::AllocateInfo allocate_info{};
+    allocate_info.requirements = m_requirements;
+    allocate_info.property_flags = m_property_flags;
+    allocate_info.preferred_flags = preferred_flags;
+    allocate_info.allocate_flags = allocate_flags;
+    allocate_info.linear = image.get_tiling() == VK_IMAGE_TILING_LINEAR;
+    allocate_info.dedicated = image.requires_dedicated_allocation();
+    allocate_info.dedicated_image = image.get_handle();
+
+    allocate(allocate_info);
+}
 
-    VkMemoryAllocateFlagsInfo flags_info = {};
-    flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-    flags_info.flags = allocate_flags;
-    
-    VkMemoryAllocateInfo allocate_info;
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocate_info.pNext = &flags_info;
-    allocate_info.allocationSize = m_requirements.size;
-    allocate_info.memoryTypeIndex = memory_type_index;
+DeviceMemory::DeviceMemory(const Buffer &buffer, MemoryAllocator::Usage usage, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags)
+    : m_device(buffer.get_device()), m_requirements(buffer.get_memory_requirements()), m_property_flags(property_flags)
+{
+    MemoryAllocator::AllocateInfo allocate_info{};
+    allocate_info.requirements = m_requirements;
+    allocate_info.property_flags = m_property_flags;
+    allocate_info.usage = usage;
+    allocate_info.allocate_flags = allocate_flags;
+    allocate_info.linear = true;
+    allocate_info.dedicated = buffer.requires_dedicated_allocation();
+    allocate_info.dedicated_buffer = buffer.get_handle();
+
+    allocate(allocate_info);
+}
 
-    VK_CHECK(vkAllocateMemory(m_device.get_handle(), &allocate_info, nullptr, &m_handle));
+DeviceMemory::DeviceMemory(const Image &image, MemoryAllocator::Usage usage, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags)
+    : m_device(image.get_device()), m_requirements(image.get_memory_requirements()), m_property_flags(property_flags)
+{
+    MemoryAllocator::AllocateInfo allocate_info{};
+    allocate_info.requirements = m_requirements;
+    allocate_info.property_flags = m_property_flags;
+    allocate_info.usage = usage;
+    allocate_info.allocate_flags = allocate_flags;
+    allocate_info.linear = image.get_tiling() == VK_IMAGE_TILING_LINEAR;
+    allocate_info.dedicated = image.requires_dedicated_allocation();
+    allocate_info.dedicated_image = image.get_handle();
+
+    allocate(allocate_info);
 }
 
 DeviceMemory::DeviceMemory(DeviceMemory &&other) noexcept
-    : m_handle(std::exchange(other.m_handle, VK_NULL_HANDLE)),
-      m_device(other.m_device),
+    : m_device(other.m_device),
+      m_allocation(std::exchange(other.m_allocation, {})),
+      m_mapped_data(std::exchange(other.m_mapped_data, nullptr)),
       m_requirements(other.m_requirements),
-      m_property_flags(other.m_property_flags)
+      m_property_flags(other.m_property_flags),
+      m_relocate_callback(std::move(other.m_relocate_callback))
 {
+    // the allocator tracks relocatable memory by address
+    if (m_relocate_callback)
+    {
+        m_device.get_memory_allocator().register_relocatable(*this);
+    }
 }
 
 DeviceMemory::~DeviceMemory()
 {
-    if (m_handle != VK_NULL_HANDLE)
+    if (m_allocation.memory != VK_NULL_HANDLE)
     {
-        vkFreeMemory(m_device.get_handle(), m_handle, nullptr);
+        auto &allocator = m_device.get_memory_allocator();
+        if (m_relocate_callback)
+        {
+            allocator.unregister_relocatable(m_allocation);
+        }
+        allocator.discard_dirty_ranges(m_allocation);
+        unmap();
+        allocator.free(m_allocation);
     }
 }
 
@@ -58,30 +112,115 @@ void DeviceMemory::upload(VkDeviceSize offset, VkDeviceSize size, const void *sr
     void *dst_data;
     map(offset, size, 0, &dst_data);
     std::memcpy(dst_data, src_data, size);
-    unmap();
+
+    if (!is_coherent())
+    {
+        m_device.get_memory_allocator().add_dirty_range(m_allocation, offset, size);
+    }
 }
 
 void DeviceMemory::download(VkDeviceSize offset, VkDeviceSize size, void *dst_data)
 {
     void *src_data;
     map(offset, size, 0, &src_data);
+    invalidate(offset, size);
     std::memcpy(dst_data, src_data, size);
-    unmap();
 }
 
 void DeviceMemory::map(VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void **pp_data)
 {
-    VK_CHECK(vkMapMemory(m_device.get_handle(), m_handle, offset, size, flags, pp_data));
+    // the allocator owns the mapping of the shared block, offset is relative to this allocation
+    if (m_mapped_data == nullptr)
+    {
+        m_mapped_data = static_cast<uint8_t *>(m_device.get_memory_allocator().map(m_allocation));
+    }
+
+    *pp_data = m_mapped_data + offset;
 }
 
 void DeviceMemory::unmap()
 {
-    vkUnmapMemory(m_device.get_handle(), m_handle);
+    if (m_mapped_data != nullptr)
+    {
+        m_device.get_memory_allocator().unmap(m_allocation);
+        m_mapped_data = nullptr;
+    }
+}
+
+void DeviceMemory::flush(VkDeviceSize offset, VkDeviceSize size)
+{
+    if (is_coherent())
+    {
+        return;
+    }
+
+    auto range = m_device.get_memory_allocator().get_mapped_range(m_allocation, offset, size == VK_WHOLE_SIZE ? m_allocation.size - offset : size);
+    VK_CHECK(vkFlushMappedMemoryRanges(m_device.get_handle(), 1, &range));
+}
+
+void DeviceMemory::invalidate(VkDeviceSize offset, VkDeviceSize size)
+{
+    if (is_coherent())
+    {
+        return;
+    }
+
+    auto range = m_device.get_memory_allocator().get_mapped_range(m_allocation, offset, size == VK_WHOLE_SIZE ? m_allocation.size - offset : size);
+    VK_CHECK(vkInvalidateMappedMemoryRanges(m_device.get_handle(), 1, &range));
+}
+
+bool DeviceMemory::is_coherent() const
+{
+    return (m_property_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+void DeviceMemory::set_relocate_callback(RelocateCallback callback)
+{
+    auto &allocator = m_device.get_memory_allocator();
+
+    m_relocate_callback = std::move(callback);
+    if (m_relocate_callback)
+    {
+        allocator.register_relocatable(*this);
+    }
+    else
+    {
+        allocator.unregister_relocatable(m_allocation);
+    }
+}
+
+void DeviceMemory::allocate(const MemoryAllocator::AllocateInfo &allocate_info)
+{
+    m_allocation = m_device.get_memory_allocator().allocate(allocate_info);
+    m_property_flags = m_device.get_physical_device().get_memory_properties().memoryTypes[m_allocation.memory_type_index].propertyFlags;
+}
+
+void DeviceMemory::relocate(const MemoryAllocator::Allocation &allocation)
+{
+    auto &allocator = m_device.get_memory_allocator();
+
+    // pending host writes have to reach the old location before the owner copies it
+    if (m_mapped_data != nullptr)
+    {
+        flush();
+    }
+    allocator.discard_dirty_ranges(m_allocation);
+    unmap();
+
+    // the backends only move within a memory type, the property flags stay the same
+    m_allocation = allocation;
+
+    m_relocate_callback(*this);
 }
 
 VkDeviceMemory DeviceMemory::get_handle() const
 {
-    return m_handle;
+    return m_allocation.memory;
+}
+
+VkDeviceSize DeviceMemory::get_offset() const
+{
+    return m_allocation.offset;
 }
 
 const Device& DeviceMemory::get_device() const
@@ -98,3 +237,8 @@ VkMemoryPropertyFlags DeviceMemory::get_properties() const
 {
     return m_property_flags;
 }
+
+const MemoryAllocator::Allocation &DeviceMemory::get_allocation() const
+{
+    return m_allocation;
+}
@@ -1,13 +1,36 @@
 #pragma once
 
+#include <functional>
+
 #include "prism/vulkan/device.h"
+#include "prism/vulkan/memory_allocator.h"
 
 namespace prism
 {
+  class Buffer;
+  class Image;
+
+  // host visible memory is mapped on first use and stays mapped until it is destroyed. writes to non coherent
+  // memory are recorded as dirty ranges on the allocator, which flushes them ahead of the next queue submit
   class DeviceMemory
   {
   public:
-    DeviceMemory(const Device& device, const VkMemoryRequirements& requirements, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags = 0);
+    // runs after MemoryAllocator::defragment() moved the memory. it recreates the resource, binds it to the new
+    // location and copies the contents over from the old resource on the gpu, the copy has to be complete when it
+    // returns. the memory must not be mapped from inside the callback
+    using RelocateCallback = std::function<void(DeviceMemory &memory)>;
+
+  public:
+    DeviceMemory(const Device& device, const VkMemoryRequirements& requirements, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags = 0, VkMemoryPropertyFlags preferred_flags = 0);
+
+    DeviceMemory(const Buffer& buffer, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags = 0, VkMemoryPropertyFlags preferred_flags = 0);
+
+    DeviceMemory(const Image& image, VkMemoryPropertyFlags property_flags, VkMemoryAllocateFlags allocate_flags = 0, VkMemoryPropertyFlags preferred_flags = 0);
+
+    // the memory type is ranked by how the memory is used, property_flags are required on top
+    DeviceMemory(const Buffer& buffer, MemoryAllocator::Usage usage, VkMemoryPropertyFlags property_flags = 0, VkMemoryAllocateFlags allocate_flags = 0);
+
+    DeviceMemory(const Image& image, MemoryAllocator::Usage usage, VkMemoryPropertyFlags property_flags = 0, VkMemoryAllocateFlags allocate_flags = 0);
 
     DeviceMemory(const DeviceMemory&) = delete;
 
@@ -19,26 +42,56 @@ namespace prism
 
     DeviceMemory& operator=(DeviceMemory&&) = delete;
 
+    // writes through the persistent mapping, non coherent ranges are left for the flush ahead of the next submit
     void upload(VkDeviceSize offset, VkDeviceSize size, const void* src_data);
-    
+
+    // invalidates non coherent memory before reading it back
     void download(VkDeviceSize offset, VkDeviceSize size, void* dst_data);
 
+    // hands out the persistent mapping, which is created on the first call
     void map(VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void** ppData);
 
+    // releases the persistent mapping early, the next map() maps again
     void unmap();
 
+    // flushes a range right away instead of waiting for the allocator, no-op on coherent memory
+    void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    // makes device writes visible to the host, no-op on coherent memory
+    void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    bool is_coherent() const;
+
+    // memory without a relocate callback is never moved by defragmentation
+    void set_relocate_callback(RelocateCallback callback);
+
     VkDeviceMemory get_handle() const;
+    VkDeviceSize get_offset() const;
     const Device &get_device() const;
     VkMemoryRequirements get_requirements() const;
     VkMemoryPropertyFlags get_properties() const;
+    const MemoryAllocator::Allocation &get_allocation() const;
 
   private:
-    VkDeviceMemory m_handle;
+    friend class MemoryAllocator;
+
+    void allocate(const MemoryAllocator::AllocateInfo& allocate_info);
+
+    // takes over the new location and runs the relocate callback
+    void relocate(const MemoryAllocator::Allocation& allocation);
 
+  private:
     const Device& m_device;
 
+    MemoryAllocator::Allocation m_allocation;
+
+    uint8_t* m_mapped_data{nullptr};
+
     VkMemoryRequirements m_requirements;
+    // the flags of the memory type that was picked, a superset of the requested ones
     VkMemoryPropertyFlags m_property_flags;
 
+    RelocateCallback m_relocate_callback;
+
   }; // class DeviceMemory
-} // namespace prism
\ No newline at end of file
+} // namespace prism
@@ -36,6 +36,11 @@ void Fence::reset()
   VK_CHECK(vkResetFences(m_device.get_handle(), 1, &m_handle));
 }
 
+bool Fence::is_signaled() const
+{
+  return vkGetFenceStatus(m_device.get_handle(), m_handle) == VK_SUCCESS;
+}
+
 VkFence Fence::get_handle() const
 {
   return m_handle;
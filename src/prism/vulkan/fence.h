@@ -23,6 +23,8 @@ namespace prism
 
     void reset();
 
+    bool is_signaled() const;
+
     VkFence get_handle() const;
 
   private:
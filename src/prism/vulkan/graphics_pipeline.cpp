@@ -1,5 +1,7 @@
 #include "prism/vulkan/graphics_pipeline.h"
 
+#include "prism/vulkan/pipeline_cache.h"
+
 using namespace prism;
 
 GraphicsPipelineCreateInfo::GraphicsPipelineCreateInfo()
@@ -93,7 +95,7 @@ GraphicsPipelineCreateInfo& GraphicsPipelineCreateInfo::set_subpass(uint32_t _su
 GraphicsPipeline::GraphicsPipeline(const Device &device, const GraphicsPipelineCreateInfo &create_info)
   : m_device(device)
 {
-  if (vkCreateGraphicsPipelines(m_device.get_handle(), VK_NULL_HANDLE, 1, reinterpret_cast<const VkGraphicsPipelineCreateInfo*>(&create_info), nullptr, &m_handle) != VK_SUCCESS)
+  if (vkCreateGraphicsPipelines(m_device.get_handle(), m_device.get_pipeline_cache().get_handle(), 1, reinterpret_cast<const VkGraphicsPipelineCreateInfo*>(&create_info), nullptr, &m_handle) != VK_SUCCESS)
   {
     throw std::runtime_error("Failed to create graphics pipeline");
   }
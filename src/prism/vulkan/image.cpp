@@ -3,66 +3,11 @@
 #include "prism/vulkan/buffer.h"
 #include "prism/vulkan/command_buffer.h"
 #include "prism/vulkan/device_memory.h"
+#include "prism/vulkan/upload_manager.h"
 #include "prism/vulkan/utils.h"
 
 using namespace prism;
 
-VkAccessFlags access_flags(VkImageLayout layout) {
-  switch (layout) {
-  case VK_IMAGE_LAYOUT_UNDEFINED:
-  case VK_IMAGE_LAYOUT_GENERAL:
-  case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
-    return 0;
-  case VK_IMAGE_LAYOUT_PREINITIALIZED:
-    return VK_ACCESS_HOST_WRITE_BIT;
-  case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-    return VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
-           VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-  case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
-    return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-           VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-  case VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR:
-    return VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR;
-  case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-    return VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
-  case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-    return VK_ACCESS_TRANSFER_READ_BIT;
-  case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-    return VK_ACCESS_TRANSFER_WRITE_BIT;
-  default:
-    assert(false);
-    return 0;
-  }
-}
-
-VkPipelineStageFlags pipeline_stage_flags(VkImageLayout layout) {
-  switch (layout) {
-  case VK_IMAGE_LAYOUT_UNDEFINED:
-    return VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-  case VK_IMAGE_LAYOUT_GENERAL:
-  case VK_IMAGE_LAYOUT_PREINITIALIZED:
-    return VK_PIPELINE_STAGE_HOST_BIT;
-  case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-  case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-    return VK_PIPELINE_STAGE_TRANSFER_BIT;
-  case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-    return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
-    return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-           VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-  case VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR:
-    return VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR;
-  case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-    return VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
-           VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-  case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
-    return VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-  default:
-    assert(false);
-    return 0;
-  }
-}
-
 ImageCreateInfo::ImageCreateInfo()
 {
 	sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -150,16 +95,32 @@ ImageCreateInfo& ImageCreateInfo::set_initial_layout(VkImageLayout initial_layou
 }
 
 Image::Image(const Device &device, const ImageCreateInfo &info, VkImage handle)
-		: m_device(device), m_handle(handle), m_info(info), m_layout(info.initialLayout)
+		: m_device(device), m_handle(handle), m_info(info),
+			m_states(info.mipLevels * info.arrayLayers, {info.initialLayout})
 {
 }
 
 Image::Image(const Device &device, const ImageCreateInfo& info)
-		: m_device(device), m_info(info), m_layout(info.initialLayout)
+		: m_device(device), m_info(info),
+			m_states(info.mipLevels * info.arrayLayers, {info.initialLayout})
 {
 	VK_CHECK(vkCreateImage(m_device.get_handle(), &m_info, nullptr, &m_handle));
 
-	vkGetImageMemoryRequirements(m_device.get_handle(), m_handle, &m_memory_requirements);
+	VkMemoryDedicatedRequirements dedicated_requirements{};
+	dedicated_requirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+
+	VkMemoryRequirements2 memory_requirements{};
+	memory_requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+	memory_requirements.pNext = &dedicated_requirements;
+
+	VkImageMemoryRequirementsInfo2 requirements_info{};
+	requirements_info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+	requirements_info.image = m_handle;
+
+	vkGetImageMemoryRequirements2(m_device.get_handle(), &requirements_info, &memory_requirements);
+
+	m_memory_requirements = memory_requirements.memoryRequirements;
+	m_requires_dedicated_allocation = dedicated_requirements.requiresDedicatedAllocation == VK_TRUE;
 }
 
 Image::Image(Image &&other) noexcept
@@ -167,7 +128,8 @@ Image::Image(Image &&other) noexcept
 			m_device(other.m_device),
 			m_info(other.m_info),
 			m_memory_requirements(other.m_memory_requirements),
-			m_layout(other.m_layout)
+			m_requires_dedicated_allocation(other.m_requires_dedicated_allocation),
+			m_states(std::move(other.m_states))
 {
 }
 
@@ -214,78 +176,50 @@ const VkExtent3D &Image::get_extent() const
 	return m_info.extent;
 }
 
+VkImageTiling Image::get_tiling() const
+{
+	return m_info.tiling;
+}
+
 const VkMemoryRequirements &Image::get_memory_requirements() const
 {
 	return m_memory_requirements;
 }
 
-const VkImageLayout &Image::get_layout() const
+bool Image::requires_dedicated_allocation() const
 {
-	return m_layout;
+	return m_requires_dedicated_allocation;
 }
 
-void Image::bind_memory(const DeviceMemory& memory, VkDeviceSize offset) const
+const VkImageLayout &Image::get_layout() const
 {
-	VK_CHECK(vkBindImageMemory(m_device.get_handle(), m_handle, memory.get_handle(), offset));
+	return m_states.front().layout;
 }
 
-void Image::upload(const CommandPool &command_pool, const void *src_data, VkDeviceSize size, VkImageLayout target_layout) const
+const Image::SubresourceState &Image::get_state(uint32_t mip_level, uint32_t array_layer) const
 {
-	auto stage_buffer = Buffer(m_device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-	auto stage_memory = DeviceMemory(m_device, stage_buffer.get_memory_requirements(), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-	stage_buffer.bind_memory(stage_memory);
-	stage_memory.upload(0, size, src_data);
-
-	VkImageMemoryBarrier barrier{};
-	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.image = m_handle;
-	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	barrier.subresourceRange.baseMipLevel = 0;
-	barrier.subresourceRange.levelCount = m_info.mipLevels;
-	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount = m_info.arrayLayers;
-	barrier.srcAccessMask = 0;
-	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	return m_states[mip_level * m_info.arrayLayers + array_layer];
+}
 
-	auto queue_family_index = m_device.get_physical_device().get_queue_family_index(VK_QUEUE_TRANSFER_BIT);
-  const auto &queue = m_device.get_queue(queue_family_index, 0);
-	utils::submit_commands_to_queue(command_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-		cmd_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, {barrier});
-	});
+void Image::set_state(const SubresourceState &state, uint32_t mip_level, uint32_t array_layer)
+{
+	m_states[mip_level * m_info.arrayLayers + array_layer] = state;
+}
 
-	utils::submit_commands_to_queue(command_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-		
-		VkBufferImageCopy region{};
-		region.bufferOffset = 0;
-		region.bufferRowLength = 0;
-		region.bufferImageHeight = 0;
-		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel = 0;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount = m_info.arrayLayers;
-		region.imageOffset = {0, 0, 0};
-		region.imageExtent = m_info.extent;
-
-		cmd_buffer.copy_buffer_to_image(stage_buffer, *this, {region});
-	});
+void Image::bind_memory(const DeviceMemory& memory, VkDeviceSize offset) const
+{
+	VK_CHECK(vkBindImageMemory(m_device.get_handle(), m_handle, memory.get_handle(), memory.get_offset() + offset));
+}
 
-	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-	barrier.newLayout = target_layout;
-	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-	barrier.dstAccessMask = 0;
-	utils::submit_commands_to_queue(command_pool, queue, [&](const CommandBuffer &cmd_buffer) {	
-		cmd_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, {}, {}, {barrier});
-	});
+uint64_t Image::upload(const void *src_data, VkDeviceSize size, VkImageLayout target_layout)
+{
+	return m_device.get_upload_manager().upload(*this, src_data, size, target_layout);
 }
 
 void Image::download(const CommandPool &command_pool, void *dst_data, VkDeviceSize size, VkImageLayout target_layout) const
 {
 	auto stage_buffer = Buffer(m_device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-	auto stage_memory = DeviceMemory(m_device, stage_buffer.get_memory_requirements(), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+	auto stage_memory = DeviceMemory(stage_buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 	stage_buffer.bind_memory(stage_memory);
 	
 	VkImageMemoryBarrier barrier{};
@@ -303,12 +237,6 @@ void Image::download(const CommandPool &command_pool, void *dst_data, VkDeviceSi
 	barrier.srcAccessMask = 0;
 	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
-	auto queue_family_index = m_device.get_physical_device().get_queue_family_index(VK_QUEUE_TRANSFER_BIT);
-  const auto &queue = m_device.get_queue(queue_family_index, 0);
-	utils::submit_commands_to_queue(command_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-		vkCmdPipelineBarrier(cmd_buffer.get_handle(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-	});
-
 	VkImageSubresourceLayers subresource{};
 	subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	subresource.mipLevel = 0;
@@ -323,17 +251,20 @@ void Image::download(const CommandPool &command_pool, void *dst_data, VkDeviceSi
 	region.imageOffset = {0, 0, 0};
 	region.imageExtent = m_info.extent;
 
+	auto queue_family_index = m_device.get_physical_device().get_queue_family_index(VK_QUEUE_TRANSFER_BIT);
+	const auto &queue = m_device.get_queue(queue_family_index, 0);
+
+	// barrier, copy and barrier go out in a single submission
 	utils::submit_commands_to_queue(command_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-		vkCmdCopyImageToBuffer(cmd_buffer.get_handle(), m_handle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stage_buffer.get_handle(), 1, &region);
-	});
+		vkCmdPipelineBarrier(cmd_buffer.get_handle(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 
-	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-	barrier.newLayout = target_layout;
-	barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-	barrier.dstAccessMask = 0;
+		vkCmdCopyImageToBuffer(cmd_buffer.get_handle(), m_handle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stage_buffer.get_handle(), 1, &region);
 
-	utils::submit_commands_to_queue(command_pool, queue, [&](const CommandBuffer &cmd_buffer) {
-		vkCmdPipelineBarrier(cmd_buffer.get_handle(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = target_layout;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = 0;
+		vkCmdPipelineBarrier(cmd_buffer.get_handle(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 	});
 
 	stage_memory.download(0, size, dst_data);
@@ -341,22 +272,7 @@ void Image::download(const CommandPool &command_pool, void *dst_data, VkDeviceSi
 
 void Image::set_layout(const CommandBuffer &cmd_buffer, VkImageLayout new_layout, VkImageSubresourceRange subresource_range)
 {
-	VkImageMemoryBarrier barrier{};
-	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-	barrier.oldLayout = m_layout;
-	barrier.newLayout = new_layout;
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.image = m_handle;
-	barrier.subresourceRange = subresource_range;
-	barrier.srcAccessMask = access_flags(m_layout);
-	barrier.dstAccessMask = access_flags(new_layout);
-
-	auto src_stage = pipeline_stage_flags(m_layout);
-	auto dst_stage = pipeline_stage_flags(new_layout);
-	cmd_buffer.pipeline_barrier(src_stage, dst_stage, 0, {}, {}, {barrier});
-
-	m_layout = new_layout;
+	cmd_buffer.image_barrier(*this, new_layout, utils::pipeline_stage_flags(new_layout), utils::access_flags(new_layout), subresource_range);
 }
 
 void Image::set_layout(const CommandBuffer &cmd_buffer, VkImageLayout new_layout, VkImageAspectFlags aspect)
@@ -368,20 +284,13 @@ void Image::set_layout(const CommandBuffer &cmd_buffer, VkImageLayout new_layout
 	subresource_range.baseArrayLayer = 0;
 	subresource_range.layerCount = get_array_layer_count();
 
-	VkImageMemoryBarrier barrier{};
-	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-	barrier.oldLayout = m_layout;
-	barrier.newLayout = new_layout;
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.image = m_handle;
-	barrier.subresourceRange = subresource_range;
-	barrier.srcAccessMask = access_flags(m_layout);
-	barrier.dstAccessMask = access_flags(new_layout);
-
-	auto src_stage = pipeline_stage_flags(m_layout);
-	auto dst_stage = pipeline_stage_flags(new_layout);
-	cmd_buffer.pipeline_barrier(src_stage, dst_stage, 0, {}, {}, {barrier});
+	set_layout(cmd_buffer, new_layout, subresource_range);
+}
 
-	m_layout = new_layout;
-}
\ No newline at end of file
+void Image::update_layout(VkImageLayout new_layout, VkPipelineStageFlags2 stage, VkAccessFlags2 access)
+{
+	for (auto &state : m_states)
+	{
+		state = {new_layout, stage, access};
+	}
+}
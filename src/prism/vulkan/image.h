@@ -36,6 +36,18 @@ namespace prism
 
   class Image
   {
+  public:
+    // the layout of a mip level / array layer, the stage and access of its last write or layout transition,
+    // and the reader stages and accesses that write has already been made visible to
+    struct SubresourceState
+    {
+      VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+      VkPipelineStageFlags2 stage{VK_PIPELINE_STAGE_2_NONE};
+      VkAccessFlags2 access{VK_ACCESS_2_NONE};
+      VkPipelineStageFlags2 read_stage{VK_PIPELINE_STAGE_2_NONE};
+      VkAccessFlags2 read_access{VK_ACCESS_2_NONE};
+    };
+
   public:
     Image(const Device &device, const ImageCreateInfo &info, VkImage handle);
 
@@ -65,20 +77,34 @@ namespace prism
 
     const VkExtent3D &get_extent() const;
 
+    VkImageTiling get_tiling() const;
+
     const VkMemoryRequirements &get_memory_requirements() const;
 
+    bool requires_dedicated_allocation() const;
+
+    // layout of the first mip level and array layer
     const VkImageLayout &get_layout() const;
 
+    const SubresourceState &get_state(uint32_t mip_level, uint32_t array_layer) const;
+
+    void set_state(const SubresourceState &state, uint32_t mip_level, uint32_t array_layer);
+
     void bind_memory(const DeviceMemory& memory, VkDeviceSize offset = 0) const;
 
-    void upload(const CommandPool &command_pool, const void *data, VkDeviceSize size, VkImageLayout target_layout = VK_IMAGE_LAYOUT_GENERAL) const;
+    // returns the upload manager token that signals once the data is on the gpu
+    uint64_t upload(const void *data, VkDeviceSize size, VkImageLayout target_layout = VK_IMAGE_LAYOUT_GENERAL);
 
     void download(const CommandPool &command_pool, void *data, VkDeviceSize size, VkImageLayout target_layout = VK_IMAGE_LAYOUT_GENERAL) const;
 
+    // queues the transition on the command buffer, it is recorded with the next draw, dispatch or copy
     void set_layout(const CommandBuffer &cmd_buffer, VkImageLayout new_layout, VkImageSubresourceRange subresource_range);
 
     void set_layout(const CommandBuffer &cmd_buffer, VkImageLayout new_layout, VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
 
+    // records the state left behind by a barrier or a semaphore wait that was built outside of the command buffer
+    void update_layout(VkImageLayout new_layout, VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VkAccessFlags2 access = VK_ACCESS_2_MEMORY_WRITE_BIT);
+
   protected:
     const Device &m_device;
 
@@ -88,6 +114,9 @@ namespace prism
 
     VkMemoryRequirements m_memory_requirements;
 
-    VkImageLayout m_layout;
+    bool m_requires_dedicated_allocation{false};
+
+    // indexed by mip_level * array_layers + array_layer
+    std::vector<SubresourceState> m_states;
   };
 } // namespace prism
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "prism/vulkan/linear_allocator.h"
+
+#include <cstring>
+
+#include "prism/vulkan/utils.h"
+
+using namespace prism;
+
+LinearAllocator::LinearAllocator(const Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage)
+    : m_device(device), m_block_size(block_size), m_usage(usage)
+{
+  const auto &limits = m_device.get_physical_device().get_properties().limits;
+  m_alignment = std::max({limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment, VkDeviceSize{16}});
+
+  create_block(m_block_size);
+}
+
+LinearAllocator::~LinearAllocator()
+{
+  for (auto &block : m_blocks)
+  {
+    block.memory->unmap();
+  }
+}
+
+LinearAllocator::Allocation LinearAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+  if (alignment == 0)
+  {
+    alignment = m_alignment;
+  }
+
+  auto offset = utils::align_up(m_position, alignment);
+  while (offset + size > m_blocks[m_block_index].size)
+  {
+    // the rest of the block is wasted until the next reset
+    if (m_block_index + 1 == m_blocks.size())
+    {
+      create_block(std::max(m_block_size, size));
+    }
+    ++m_block_index;
+    m_position = 0;
+    offset = 0;
+  }
+
+  m_used_size += offset + size - m_position;
+  m_position = offset + size;
+
+  auto &block = m_blocks[m_block_index];
+  return {block.buffer->get_handle(), offset, size, block.data + offset};
+}
+
+LinearAllocator::Allocation LinearAllocator::push(const void *data, VkDeviceSize size, VkDeviceSize alignment)
+{
+  auto allocation = allocate(size, alignment);
+  std::memcpy(allocation.data, data, size);
+  return allocation;
+}
+
+void LinearAllocator::reset()
+{
+  m_block_index = 0;
+  m_position = 0;
+  m_used_size = 0;
+}
+
+VkDeviceSize LinearAllocator::get_used_size() const
+{
+  return m_used_size;
+}
+
+VkDeviceSize LinearAllocator::get_capacity() const
+{
+  VkDeviceSize capacity = 0;
+  for (const auto &block : m_blocks)
+  {
+    capacity += block.size;
+  }
+  return capacity;
+}
+
+void LinearAllocator::create_block(VkDeviceSize size)
+{
+  Block block{};
+  block.size = size;
+  block.buffer = std::make_unique<Buffer>(m_device, size, m_usage);
+  block.memory = std::make_unique<DeviceMemory>(*block.buffer, MemoryAllocator::Usage::Dynamic, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  block.buffer->bind_memory(*block.memory);
+
+  // stays mapped for the lifetime of the block
+  void *data;
+  block.memory->map(0, size, 0, &data);
+  block.data = static_cast<uint8_t *>(data);
+
+  m_blocks.push_back(std::move(block));
+}
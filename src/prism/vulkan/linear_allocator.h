@@ -0,0 +1,97 @@
+#pragma once
+
+#include "prism/vulkan/buffer.h"
+#include "prism/vulkan/device_memory.h"
+
+namespace prism
+{
+  // bump allocates transient data (uniforms, per object data, instance data, indirect arguments) from persistently
+  // mapped host visible blocks. a block that runs out chains the next one, reset() rewinds all of them, so a frame
+  // writing thousands of objects neither maps memory nor allocates once the blocks exist. one allocator per frame in
+  // flight, reset once the frame's fence has signaled
+  class LinearAllocator
+  {
+  public:
+    struct Allocation
+    {
+      VkBuffer buffer{VK_NULL_HANDLE};
+      VkDeviceSize offset{0};
+      VkDeviceSize size{0};
+      void *data{nullptr};
+
+      // for UNIFORM_BUFFER_DYNAMIC and STORAGE_BUFFER_DYNAMIC descriptors written with offset 0
+      uint32_t get_dynamic_offset() const
+      {
+        return static_cast<uint32_t>(offset);
+      }
+    };
+
+  public:
+    LinearAllocator(const Device &device, VkDeviceSize block_size = 4ull * 1024 * 1024,
+                    VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                               VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+    LinearAllocator(const LinearAllocator &) = delete;
+
+    LinearAllocator(LinearAllocator &&) = delete;
+
+    ~LinearAllocator();
+
+    LinearAllocator &operator=(const LinearAllocator &) = delete;
+
+    LinearAllocator &operator=(LinearAllocator &&) = delete;
+
+    // zero alignment uses the larger of the uniform and storage buffer offset alignments
+    Allocation allocate(VkDeviceSize size, VkDeviceSize alignment = 0);
+
+    // allocates and copies
+    Allocation push(const void *data, VkDeviceSize size, VkDeviceSize alignment = 0);
+
+    template <typename T>
+    Allocation push(const T &value)
+    {
+      return push(&value, sizeof(T));
+    }
+
+    // every allocation handed out becomes invalid, the gpu must be done with them
+    void reset();
+
+    // bytes allocated since the last reset, including alignment
+    VkDeviceSize get_used_size() const;
+
+    VkDeviceSize get_capacity() const;
+
+  private:
+    struct Block
+    {
+      std::unique_ptr<Buffer> buffer;
+      std::unique_ptr<DeviceMemory> memory;
+      uint8_t *data{nullptr};
+      VkDeviceSize size{0};
+    };
+
+  private:
+    void create_block(VkDeviceSize size);
+
+  private:
+    const Device &m_device;
+
+    VkDeviceSize m_block_size;
+
+    VkBufferUsageFlags m_usage;
+
+    VkDeviceSize m_alignment;
+
+    std::vector<Block> m_blocks;
+
+    // the block allocated from and the position in it, blocks before it are full
+    size_t m_block_index{0};
+
+    VkDeviceSize m_position{0};
+
+    VkDeviceSize m_used_size{0};
+
+  }; // class LinearAllocator
+
+} // namespace prism
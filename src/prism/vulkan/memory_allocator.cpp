@@ -0,0 +1,323 @@
+#include "prism/vulkan/memory_allocator.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/device_memory.h"
+#include "prism/vulkan/tlsf_memory_allocator.h"
+#include "prism/vulkan/utils.h"
+#include "prism/vulkan/vma_memory_allocator.h"
+
+using namespace prism;
+
+namespace
+{
+  // the bar window of a gpu without resizable bar, larger host visible device local heaps are the whole vram
+  const VkDeviceSize BAR_WINDOW_SIZE = 256ull * 1024 * 1024;
+
+  uint32_t count_bits(VkMemoryPropertyFlags flags)
+  {
+    uint32_t count = 0;
+    for (; flags != 0; flags &= flags - 1)
+    {
+      ++count;
+    }
+    return count;
+  }
+}
+
+std::unique_ptr<MemoryAllocator> MemoryAllocator::create(const Device &device, Backend backend)
+{
+  switch (backend)
+  {
+  case Backend::Vma:
+    return std::make_unique<VmaMemoryAllocator>(device);
+  case Backend::Tlsf:
+  default:
+    return std::make_unique<TlsfMemoryAllocator>(device);
+  }
+}
+
+MemoryAllocator::MemoryAllocator(const Device &device)
+    : m_device(device)
+{
+  const auto &memory_properties = m_device.get_physical_device().get_memory_properties();
+
+  const VkMemoryPropertyFlags bar_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++)
+  {
+    const auto &memory_type = memory_properties.memoryTypes[i];
+    if ((memory_type.propertyFlags & bar_flags) == bar_flags && memory_properties.memoryHeaps[memory_type.heapIndex].size > BAR_WINDOW_SIZE)
+    {
+      m_resizable_bar = true;
+    }
+  }
+}
+
+uint32_t MemoryAllocator::find_memory_type(const AllocateInfo &info) const
+{
+  const auto &memory_types = rank_memory_types(info.requirements.memoryTypeBits, info.property_flags, info.preferred_flags, info.avoided_flags, info.usage);
+  if (memory_types.empty())
+  {
+    throw std::runtime_error("Failed to find suitable memory type");
+  }
+
+  if (memory_types.size() == 1)
+  {
+    return memory_types.front();
+  }
+
+  // budgets come from VK_EXT_memory_budget when it is enabled, otherwise from the heap sizes. querying them costs
+  // as much as a small allocation, the snapshot is only refreshed when it is missing or every heap seems full, frees
+  // since the last query may have made room
+  const auto &memory_properties = m_device.get_physical_device().get_memory_properties();
+
+  std::lock_guard<std::mutex> lock(m_budget_mutex);
+
+  auto memory_type_index = UINT32_MAX;
+  for (uint32_t attempt = 0; attempt < 2 && memory_type_index == UINT32_MAX; ++attempt)
+  {
+    if (m_budgets.empty() || attempt > 0)
+    {
+      m_budgets = get_budgets();
+    }
+
+    for (auto candidate : memory_types)
+    {
+      const auto &budget = m_budgets[memory_properties.memoryTypes[candidate].heapIndex];
+      if (budget.usage + info.requirements.size <= budget.budget)
+      {
+        memory_type_index = candidate;
+        break;
+      }
+    }
+  }
+
+  if (memory_type_index == UINT32_MAX)
+  {
+    memory_type_index = memory_types.front();
+  }
+
+  // the allocation counts against the snapshot until the next query
+  m_budgets[memory_properties.memoryTypes[memory_type_index].heapIndex].usage += info.requirements.size;
+
+  return memory_type_index;
+}
+
+uint32_t MemoryAllocator::find_memory_type(uint32_t memory_type_bits, VkMemoryPropertyFlags property_flags, VkMemoryPropertyFlags preferred_flags) const
+{
+  AllocateInfo info{};
+  info.requirements.memoryTypeBits = memory_type_bits;
+  info.property_flags = property_flags;
+  info.preferred_flags = preferred_flags;
+
+  return find_memory_type(info);
+}
+
+bool MemoryAllocator::has_resizable_bar() const
+{
+  return m_resizable_bar;
+}
+
+void MemoryAllocator::update_budgets()
+{
+  auto budgets = get_budgets();
+
+  std::lock_guard<std::mutex> lock(m_budget_mutex);
+  m_budgets = std::move(budgets);
+}
+
+const std::vector<uint32_t> &MemoryAllocator::rank_memory_types(uint32_t memory_type_bits, VkMemoryPropertyFlags required_flags, VkMemoryPropertyFlags preferred_flags,
+                                                                VkMemoryPropertyFlags avoided_flags, Usage usage) const
+{
+  auto key = std::make_tuple(memory_type_bits, required_flags, preferred_flags, avoided_flags, usage);
+
+  std::lock_guard<std::mutex> lock(m_memory_type_mutex);
+
+  auto it = m_memory_types.find(key);
+  if (it != m_memory_types.end())
+  {
+    return it->second;
+  }
+
+  switch (usage)
+  {
+  case Usage::GpuOnly:
+    preferred_flags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    avoided_flags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    break;
+  case Usage::Upload:
+    required_flags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    preferred_flags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    avoided_flags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    break;
+  case Usage::Readback:
+    required_flags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    preferred_flags |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    break;
+  case Usage::Dynamic:
+    required_flags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    preferred_flags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    avoided_flags |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    // a small bar window is left to the driver, dynamic data only moves into vram when all of it is mappable
+    if (m_resizable_bar)
+    {
+      preferred_flags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
+    break;
+  case Usage::Unknown:
+  default:
+    break;
+  }
+
+  // special purpose types are only taken when asked for
+  avoided_flags |= (VK_MEMORY_PROPERTY_PROTECTED_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT | VK_MEMORY_PROPERTY_DEVICE_COHERENT_BIT_AMD |
+                    VK_MEMORY_PROPERTY_DEVICE_UNCACHED_BIT_AMD) &
+                   ~(required_flags | preferred_flags);
+  avoided_flags &= ~required_flags;
+
+  const auto &memory_properties = m_device.get_physical_device().get_memory_properties();
+
+  std::vector<std::pair<uint32_t, uint32_t>> ranked;
+  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++)
+  {
+    auto flags = memory_properties.memoryTypes[i].propertyFlags;
+    if ((memory_type_bits & (1 << i)) && (flags & required_flags) == required_flags)
+    {
+      ranked.emplace_back(count_bits(preferred_flags & ~flags) + count_bits(avoided_flags & flags), i);
+    }
+  }
+
+  // stable to keep the driver's order between types of the same cost
+  std::stable_sort(ranked.begin(), ranked.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  auto &memory_types = m_memory_types[key];
+  for (const auto &memory_type : ranked)
+  {
+    memory_types.push_back(memory_type.second);
+  }
+
+  return memory_types;
+}
+
+VkMappedMemoryRange MemoryAllocator::get_mapped_range(const Allocation &allocation, VkDeviceSize offset, VkDeviceSize size) const
+{
+  auto atom_size = m_device.get_physical_device().get_properties().limits.nonCoherentAtomSize;
+
+  // widening past the end of the allocation only touches the padding or a neighbour within the same block, both
+  // harmless. the last atom of the memory may be partial, a range reaching into it has to end with the memory
+  auto begin = (allocation.offset + offset) / atom_size * atom_size;
+  auto end = std::min(utils::align_up(allocation.offset + offset + size, atom_size), utils::align_up(allocation.offset + allocation.size, atom_size));
+  end = std::min(end, allocation.memory_size);
+
+  VkMappedMemoryRange range{};
+  range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+  range.memory = allocation.memory;
+  range.offset = begin;
+  range.size = end - begin;
+
+  return range;
+}
+
+void MemoryAllocator::add_dirty_range(const Allocation &allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+  if (size == 0)
+  {
+    return;
+  }
+
+  auto range = get_mapped_range(allocation, offset, size);
+
+  std::lock_guard<std::mutex> lock(m_dirty_mutex);
+
+  auto result = m_dirty_ranges.try_emplace({allocation.memory, allocation.offset}, range.offset, range.offset + range.size);
+  if (!result.second)
+  {
+    auto &dirty = result.first->second;
+    dirty.first = std::min(dirty.first, range.offset);
+    dirty.second = std::max(dirty.second, range.offset + range.size);
+  }
+}
+
+void MemoryAllocator::discard_dirty_ranges(const Allocation &allocation)
+{
+  std::lock_guard<std::mutex> lock(m_dirty_mutex);
+  m_dirty_ranges.erase({allocation.memory, allocation.offset});
+}
+
+void MemoryAllocator::flush_dirty_ranges()
+{
+  std::vector<VkMappedMemoryRange> ranges;
+  {
+    std::lock_guard<std::mutex> lock(m_dirty_mutex);
+    if (m_dirty_ranges.empty())
+    {
+      return;
+    }
+
+    ranges.reserve(m_dirty_ranges.size());
+    for (const auto &dirty : m_dirty_ranges)
+    {
+      VkMappedMemoryRange range{};
+      range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+      range.memory = dirty.first.first;
+      range.offset = dirty.second.first;
+      range.size = dirty.second.second - dirty.second.first;
+      ranges.push_back(range);
+    }
+    m_dirty_ranges.clear();
+  }
+
+  VK_CHECK(vkFlushMappedMemoryRanges(m_device.get_handle(), static_cast<uint32_t>(ranges.size()), ranges.data()));
+}
+
+void MemoryAllocator::register_relocatable(DeviceMemory &memory)
+{
+  const auto &allocation = memory.get_allocation();
+
+  std::lock_guard<std::mutex> lock(m_relocatable_mutex);
+  m_relocatables[{allocation.memory, allocation.offset}] = &memory;
+}
+
+void MemoryAllocator::unregister_relocatable(const Allocation &allocation)
+{
+  std::lock_guard<std::mutex> lock(m_relocatable_mutex);
+  m_relocatables.erase({allocation.memory, allocation.offset});
+}
+
+std::vector<MemoryAllocator::Relocatable> MemoryAllocator::get_relocatables() const
+{
+  std::lock_guard<std::mutex> lock(m_relocatable_mutex);
+
+  std::vector<Relocatable> relocatables;
+  relocatables.reserve(m_relocatables.size());
+  for (const auto &relocatable : m_relocatables)
+  {
+    relocatables.push_back({relocatable.second->get_allocation(), relocatable.second->get_requirements().alignment});
+  }
+
+  return relocatables;
+}
+
+bool MemoryAllocator::relocate(const Allocation &src, const Allocation &dst)
+{
+  DeviceMemory *memory;
+  {
+    std::lock_guard<std::mutex> lock(m_relocatable_mutex);
+
+    auto it = m_relocatables.find({src.memory, src.offset});
+    if (it == m_relocatables.end())
+    {
+      return false;
+    }
+
+    memory = it->second;
+    m_relocatables.erase(it);
+    m_relocatables[{dst.memory, dst.offset}] = memory;
+  }
+
+  // outside the lock, the callback recreates resources and may allocate
+  memory->relocate(dst);
+
+  return true;
+}
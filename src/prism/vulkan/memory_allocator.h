@@ -0,0 +1,201 @@
+#pragma once
+
+#include <mutex>
+#include <tuple>
+
+namespace prism
+{
+  class Device;
+  class DeviceMemory;
+
+  class MemoryAllocator
+  {
+  public:
+    enum class Backend
+    {
+      Tlsf,
+      Vma
+    };
+
+    // how the host and the gpu access the memory, picks the flags a memory type is ranked by
+    enum class Usage
+    {
+      Unknown,
+      // only the gpu accesses it, filled through staging copies
+      GpuOnly,
+      // written once by the host and read once by the gpu, e.g. staging buffers
+      Upload,
+      // written by the gpu and read by the host
+      Readback,
+      // rewritten by the host every frame and read by the gpu, device local when the whole heap is host visible
+      Dynamic
+    };
+
+    struct Allocation
+    {
+      VkDeviceMemory memory{VK_NULL_HANDLE};
+      VkDeviceSize offset{0};
+      VkDeviceSize size{0};
+      uint32_t memory_type_index{0};
+      // size of the whole VkDeviceMemory, flushes widened to nonCoherentAtomSize stop at its end
+      VkDeviceSize memory_size{0};
+      // backend specific bookkeeping
+      uint32_t block_index{UINT32_MAX};
+      uint32_t node{UINT32_MAX};
+      uint32_t pool_index{UINT32_MAX};
+      void *handle{nullptr};
+    };
+
+    struct AllocateInfo
+    {
+      VkMemoryRequirements requirements{};
+      VkMemoryPropertyFlags property_flags{0};
+      // taken when a memory type with the required flags also has these, e.g. HOST_CACHED for readback
+      VkMemoryPropertyFlags preferred_flags{0};
+      // ranks memory types with these flags lower
+      VkMemoryPropertyFlags avoided_flags{0};
+      Usage usage{Usage::Unknown};
+      VkMemoryAllocateFlags allocate_flags{0};
+      // optimal tiling images must not share a bufferImageGranularity page with linear resources
+      bool linear{true};
+      bool dedicated{false};
+      VkBuffer dedicated_buffer{VK_NULL_HANDLE};
+      VkImage dedicated_image{VK_NULL_HANDLE};
+    };
+
+    // dedicated allocations count as blocks holding a single allocation, wasted bytes are the alignment padding in
+    // front of allocations. vma reports neither, both stay zero and its padding counts as free
+    struct Statistics
+    {
+      uint32_t block_count{0};
+      uint32_t dedicated_allocation_count{0};
+      uint32_t allocation_count{0};
+      VkDeviceSize block_bytes{0};
+      VkDeviceSize allocation_bytes{0};
+      VkDeviceSize wasted_bytes{0};
+      VkDeviceSize free_bytes{0};
+      VkDeviceSize largest_free_bytes{0};
+      float fragmentation{0.0f};
+    };
+
+    struct Budget
+    {
+      VkDeviceSize usage{0};
+      VkDeviceSize budget{0};
+    };
+
+  public:
+    static std::unique_ptr<MemoryAllocator> create(const Device &device, Backend backend);
+
+    MemoryAllocator(const Device &device);
+
+    MemoryAllocator(const MemoryAllocator &) = delete;
+
+    MemoryAllocator(MemoryAllocator &&) = delete;
+
+    virtual ~MemoryAllocator() = default;
+
+    MemoryAllocator &operator=(const MemoryAllocator &) = delete;
+
+    MemoryAllocator &operator=(MemoryAllocator &&) = delete;
+
+    virtual Backend get_backend() const = 0;
+
+    virtual Allocation allocate(const AllocateInfo &info) = 0;
+
+    virtual void free(const Allocation &allocation) = 0;
+
+    virtual void *map(const Allocation &allocation) = 0;
+
+    virtual void unmap(const Allocation &allocation) = 0;
+
+    virtual Statistics get_statistics() const = 0;
+
+    // one entry per memory heap
+    virtual std::vector<Budget> get_budgets() const = 0;
+
+    // moves allocations whose DeviceMemory has a relocate callback to compact the blocks, the others stay in place.
+    // not to be called while other threads free relocatable memory. returns the number of allocations that were moved
+    virtual uint32_t defragment() = 0;
+
+    // the best ranked memory type whose heap still has budget for the allocation, the first ranked one when none has.
+    // works from a snapshot of the budgets that counts the allocations placed since, refreshed by update_budgets()
+    // and when no ranked type seems to fit
+    uint32_t find_memory_type(const AllocateInfo &info) const;
+
+    uint32_t find_memory_type(uint32_t memory_type_bits, VkMemoryPropertyFlags property_flags, VkMemoryPropertyFlags preferred_flags = 0) const;
+
+    // a device local heap is host visible as a whole rather than through a 256 MiB window
+    bool has_resizable_bar() const;
+
+    // queries the budgets find_memory_type ranks against again, RenderContext calls it once per frame
+    void update_budgets();
+
+    // the range of the allocation widened to nonCoherentAtomSize and clamped to the memory, offset is relative to the
+    // allocation
+    VkMappedMemoryRange get_mapped_range(const Allocation &allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+    // records a host write to non coherent memory, ranges of the same allocation are merged
+    void add_dirty_range(const Allocation &allocation, VkDeviceSize offset, VkDeviceSize size);
+
+    // drops the pending ranges of an allocation that is about to be freed
+    void discard_dirty_ranges(const Allocation &allocation);
+
+    // flushes every range recorded since the last call with a single vkFlushMappedMemoryRanges, Queue::submit
+    // calls it before every submit
+    void flush_dirty_ranges();
+
+    // called by DeviceMemory when a relocate callback is set and when it is destroyed or moved from
+    void register_relocatable(DeviceMemory &memory);
+
+    void unregister_relocatable(const Allocation &allocation);
+
+  protected:
+    struct Relocatable
+    {
+      Allocation allocation;
+      VkDeviceSize alignment{0};
+    };
+
+    // a snapshot of the allocations defragment() may move
+    std::vector<Relocatable> get_relocatables() const;
+
+    // hands dst to the DeviceMemory that owns src and runs its relocate callback, false when src is not relocatable.
+    // the caller releases src afterwards
+    bool relocate(const Allocation &src, const Allocation &dst);
+
+  protected:
+    const Device &m_device;
+
+  private:
+    // the types allowed by memory_type_bits that have every required flag, ordered by the number of preferred flags
+    // they lack plus the number of avoided flags they have
+    const std::vector<uint32_t> &rank_memory_types(uint32_t memory_type_bits, VkMemoryPropertyFlags required_flags, VkMemoryPropertyFlags preferred_flags,
+                                                   VkMemoryPropertyFlags avoided_flags, Usage usage) const;
+
+  private:
+    bool m_resizable_bar{false};
+
+    mutable std::mutex m_memory_type_mutex;
+
+    // rankings keyed by the memory type bits, the required, preferred and avoided flags and the usage
+    mutable std::map<std::tuple<uint32_t, VkMemoryPropertyFlags, VkMemoryPropertyFlags, VkMemoryPropertyFlags, Usage>, std::vector<uint32_t>> m_memory_types;
+
+    mutable std::mutex m_budget_mutex;
+
+    // empty until the first allocation that has a choice between heaps
+    mutable std::vector<Budget> m_budgets;
+
+    std::mutex m_dirty_mutex;
+
+    // keyed by the memory and offset of the allocation, the value is the aligned [begin, end) of the block
+    std::map<std::pair<VkDeviceMemory, VkDeviceSize>, std::pair<VkDeviceSize, VkDeviceSize>> m_dirty_ranges;
+
+    mutable std::mutex m_relocatable_mutex;
+
+    // keyed by the memory and offset of the allocation like the dirty ranges
+    std::map<std::pair<VkDeviceMemory, VkDeviceSize>, DeviceMemory *> m_relocatables;
+
+  }; // class MemoryAllocator
+
+} // namespace prism
@@ -1,5 +1,8 @@
 #include "prism/vulkan/physical_device.h"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace prism;
 
 PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device)
@@ -18,6 +21,24 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device)
   vkEnumerateDeviceExtensionProperties(m_handle, nullptr, &extension_count, nullptr);
   m_extensions.resize(extension_count);
   vkEnumerateDeviceExtensionProperties(m_handle, nullptr, &extension_count, m_extensions.data());
+
+  m_subgroup_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+  VkPhysicalDeviceProperties2 properties2{};
+  properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties2.pNext = &m_subgroup_properties;
+
+  // extension structures may only be chained when the extension is there
+  m_acceleration_structure_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
+  auto has_acceleration_structure = std::any_of(m_extensions.begin(), m_extensions.end(), [](const VkExtensionProperties &extension) {
+    return strcmp(extension.extensionName, VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME) == 0;
+  });
+  if (has_acceleration_structure)
+  {
+    m_subgroup_properties.pNext = &m_acceleration_structure_properties;
+  }
+
+  vkGetPhysicalDeviceProperties2(m_handle, &properties2);
+  m_subgroup_properties.pNext = nullptr;
 }
 
 VkPhysicalDevice PhysicalDevice::get_handle() const
@@ -40,6 +61,16 @@ const VkPhysicalDeviceMemoryProperties &PhysicalDevice::get_memory_properties()
   return m_memory_properties;
 }
 
+const VkPhysicalDeviceSubgroupProperties &PhysicalDevice::get_subgroup_properties() const
+{
+  return m_subgroup_properties;
+}
+
+const VkPhysicalDeviceAccelerationStructurePropertiesKHR &PhysicalDevice::get_acceleration_structure_properties() const
+{
+  return m_acceleration_structure_properties;
+}
+
 const std::vector<VkQueueFamilyProperties> &PhysicalDevice::get_queue_family_properties() const
 {
   return m_queue_family_properties;
@@ -25,6 +25,12 @@ namespace prism
 
     const VkPhysicalDeviceMemoryProperties &get_memory_properties() const;
 
+    // subgroupSize is the width compute workgroups are best sized in multiples of
+    const VkPhysicalDeviceSubgroupProperties &get_subgroup_properties() const;
+
+    // zeroed when VK_KHR_acceleration_structure is not supported
+    const VkPhysicalDeviceAccelerationStructurePropertiesKHR &get_acceleration_structure_properties() const;
+
     const std::vector<VkQueueFamilyProperties> &get_queue_family_properties() const;
 
     const std::vector<VkExtensionProperties> &get_extensions() const;
@@ -39,6 +45,8 @@ namespace prism
     VkPhysicalDeviceFeatures m_requested_features{};
     VkPhysicalDeviceProperties m_properties;
     VkPhysicalDeviceMemoryProperties m_memory_properties;
+    VkPhysicalDeviceSubgroupProperties m_subgroup_properties{};
+    VkPhysicalDeviceAccelerationStructurePropertiesKHR m_acceleration_structure_properties{};
     std::vector<VkQueueFamilyProperties> m_queue_family_properties;
     std::vector<VkExtensionProperties> m_extensions;
   }; // class PhysicalDevice
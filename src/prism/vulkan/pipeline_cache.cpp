@@ -0,0 +1,191 @@
+#include "prism/vulkan/pipeline_cache.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include "prism/core/filesystem.h"
+#include "prism/vulkan/device.h"
+#include "prism/vulkan/utils.h"
+
+using namespace prism;
+
+namespace
+{
+  const uint32_t PIPELINE_CACHE_MAGIC = 0x50534350; // "PCSP"
+  const uint32_t PIPELINE_CACHE_VERSION = 1;
+}
+
+PipelineCache::PipelineCache(const Device &device, const std::string &path)
+    : m_device(device), m_path(path)
+{
+  auto data = load();
+  m_warm = !data.empty();
+
+  VkPipelineCacheCreateInfo create_info{};
+  create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  create_info.initialDataSize = data.size();
+  create_info.pInitialData = data.empty() ? nullptr : data.data();
+
+  VK_CHECK(vkCreatePipelineCache(m_device.get_handle(), &create_info, nullptr, &m_handle));
+
+  if (m_warm)
+  {
+    LOG_INFO("pipeline cache loaded from {} ({} bytes)", m_path, data.size());
+  }
+}
+
+PipelineCache::~PipelineCache()
+{
+  if (m_handle != VK_NULL_HANDLE)
+  {
+    save();
+    vkDestroyPipelineCache(m_device.get_handle(), m_handle, nullptr);
+  }
+}
+
+VkPipelineCache PipelineCache::get_handle() const
+{
+  return m_handle;
+}
+
+const std::string &PipelineCache::get_path() const
+{
+  return m_path;
+}
+
+bool PipelineCache::is_warm() const
+{
+  return m_warm;
+}
+
+std::vector<uint8_t> PipelineCache::get_data() const
+{
+  size_t size = 0;
+  VK_CHECK(vkGetPipelineCacheData(m_device.get_handle(), m_handle, &size, nullptr));
+
+  std::vector<uint8_t> data(size);
+  VK_CHECK(vkGetPipelineCacheData(m_device.get_handle(), m_handle, &size, data.data()));
+  data.resize(size);
+
+  return data;
+}
+
+bool PipelineCache::save() const
+{
+  if (m_path.empty())
+  {
+    return false;
+  }
+
+  auto data = get_data();
+
+  auto header = make_header();
+  header.data_size = data.size();
+  header.data_hash = utils::hash_bytes(data.data(), data.size());
+
+  // write next to the target and rename, a crash mid-write must not leave a truncated cache behind
+  auto tmp_path = m_path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+      LOG_WARN("failed to open {} for writing", tmp_path);
+      return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    if (!file.good())
+    {
+      LOG_WARN("failed to write pipeline cache {}", tmp_path);
+      return false;
+    }
+  }
+
+  // replaces an existing cache in one step, std::rename fails on an existing target on windows
+  std::error_code error;
+  std::filesystem::rename(tmp_path, m_path, error);
+  if (error)
+  {
+    LOG_WARN("failed to move pipeline cache to {}: {}", m_path, error.message());
+    return false;
+  }
+
+  return true;
+}
+
+PipelineCache::FileHeader PipelineCache::make_header() const
+{
+  const auto &properties = m_device.get_physical_device().get_properties();
+
+  FileHeader header{};
+  header.magic = PIPELINE_CACHE_MAGIC;
+  header.version = PIPELINE_CACHE_VERSION;
+  header.vendor_id = properties.vendorID;
+  header.device_id = properties.deviceID;
+  header.driver_version = properties.driverVersion;
+  std::memcpy(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+  return header;
+}
+
+std::vector<uint8_t> PipelineCache::load() const
+{
+  if (m_path.empty())
+  {
+    return {};
+  }
+
+  auto file = read_file(m_path, true);
+  if (file.empty())
+  {
+    return {};
+  }
+
+  FileHeader header{};
+  if (file.size() < sizeof(header))
+  {
+    LOG_WARN("pipeline cache {} is truncated, ignoring it", m_path);
+    return {};
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+
+  auto expected = make_header();
+  if (header.magic != expected.magic || header.version != expected.version)
+  {
+    LOG_WARN("pipeline cache {} has an unknown format, ignoring it", m_path);
+    return {};
+  }
+
+  if (header.vendor_id != expected.vendor_id || header.device_id != expected.device_id ||
+      header.driver_version != expected.driver_version ||
+      std::memcmp(header.uuid, expected.uuid, VK_UUID_SIZE) != 0)
+  {
+    LOG_INFO("pipeline cache {} was written by another device or driver, ignoring it", m_path);
+    return {};
+  }
+
+  auto data = reinterpret_cast<const uint8_t *>(file.data()) + sizeof(header);
+  if (header.data_size != file.size() - sizeof(header) || header.data_hash != utils::hash_bytes(data, header.data_size))
+  {
+    LOG_WARN("pipeline cache {} is corrupted, ignoring it", m_path);
+    return {};
+  }
+
+  // the driver validates its own header too, but a mismatch there would only be reported as an empty cache
+  VkPipelineCacheHeaderVersionOne vk_header{};
+  if (header.data_size < sizeof(vk_header))
+  {
+    return {};
+  }
+  std::memcpy(&vk_header, data, sizeof(vk_header));
+  if (vk_header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || vk_header.vendorID != expected.vendor_id ||
+      vk_header.deviceID != expected.device_id ||
+      std::memcmp(vk_header.pipelineCacheUUID, expected.uuid, VK_UUID_SIZE) != 0)
+  {
+    LOG_WARN("pipeline cache {} does not match its header, ignoring it", m_path);
+    return {};
+  }
+
+  return std::vector<uint8_t>(data, data + header.data_size);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+namespace prism
+{
+  class Device;
+
+  // a VkPipelineCache that is loaded from a file on creation and written back on destruction, the file is only
+  // accepted when it was written by the same driver on the same device
+  class PipelineCache
+  {
+  public:
+    // an empty path keeps the cache in memory only
+    PipelineCache(const Device &device, const std::string &path = "");
+
+    PipelineCache(const PipelineCache &) = delete;
+
+    PipelineCache(PipelineCache &&) = delete;
+
+    ~PipelineCache();
+
+    PipelineCache &operator=(const PipelineCache &) = delete;
+
+    PipelineCache &operator=(PipelineCache &&) = delete;
+
+    VkPipelineCache get_handle() const;
+
+    const std::string &get_path() const;
+
+    // whether the cache was seeded from the file
+    bool is_warm() const;
+
+    std::vector<uint8_t> get_data() const;
+
+    // writes the cache to its file, returns false when it could not be written
+    bool save() const;
+
+  private:
+    // prefixed to the vulkan cache data, the vulkan header does not carry the driver version
+    struct FileHeader
+    {
+      uint32_t magic;
+      uint32_t version;
+      uint32_t vendor_id;
+      uint32_t device_id;
+      uint32_t driver_version;
+      uint8_t uuid[VK_UUID_SIZE];
+      uint64_t data_size;
+      uint64_t data_hash;
+    };
+
+    FileHeader make_header() const;
+
+    // returns the vulkan cache data of the file, or nothing when it does not match this device
+    std::vector<uint8_t> load() const;
+
+  private:
+    const Device &m_device;
+
+    std::string m_path;
+
+    VkPipelineCache m_handle{VK_NULL_HANDLE};
+
+    bool m_warm{false};
+
+  }; // class PipelineCache
+
+} // namespace prism
@@ -0,0 +1,35 @@
+#include "prism/vulkan/pipeline_compiler.h"
+
+using namespace prism;
+
+PipelineCompiler::PipelineCompiler(const Device &device, uint32_t thread_count)
+    : m_device(device), m_thread_pool(thread_count)
+{
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+  m_thread_pool.wait_idle();
+}
+
+std::future<GraphicsPipeline> PipelineCompiler::compile(const GraphicsPipelineCreateInfo &create_info)
+{
+  return m_thread_pool.submit([this, create_info]()
+                              { return GraphicsPipeline(m_device, create_info); });
+}
+
+std::future<ComputePipeline> PipelineCompiler::compile(const PipelineLayout &pipeline_layout, const ShaderStage &shader_stage)
+{
+  return m_thread_pool.submit([this, &pipeline_layout, shader_stage]()
+                              { return ComputePipeline(m_device, pipeline_layout, shader_stage); });
+}
+
+void PipelineCompiler::wait_idle()
+{
+  m_thread_pool.wait_idle();
+}
+
+uint32_t PipelineCompiler::get_thread_count() const
+{
+  return m_thread_pool.get_thread_count();
+}
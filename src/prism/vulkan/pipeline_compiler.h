@@ -0,0 +1,45 @@
+#pragma once
+
+#include "prism/core/thread_pool.h"
+#include "prism/vulkan/compute_pipeline.h"
+#include "prism/vulkan/graphics_pipeline.h"
+
+namespace prism
+{
+  // compiles pipelines on worker threads through the device's pipeline cache, vulkan synchronizes the cache
+  // internally so every worker shares it. the create info is copied but everything it points to (shader stages,
+  // states, specialization data, entry point names) has to stay alive until the future is ready
+  class PipelineCompiler
+  {
+  public:
+    // zero uses one thread per hardware thread
+    explicit PipelineCompiler(const Device &device, uint32_t thread_count = 0);
+
+    PipelineCompiler(const PipelineCompiler &) = delete;
+
+    PipelineCompiler(PipelineCompiler &&) = delete;
+
+    // finishes the pipelines still queued
+    ~PipelineCompiler();
+
+    PipelineCompiler &operator=(const PipelineCompiler &) = delete;
+
+    PipelineCompiler &operator=(PipelineCompiler &&) = delete;
+
+    std::future<GraphicsPipeline> compile(const GraphicsPipelineCreateInfo &create_info);
+
+    std::future<ComputePipeline> compile(const PipelineLayout &pipeline_layout, const ShaderStage &shader_stage);
+
+    // blocks until every pipeline submitted so far has been compiled
+    void wait_idle();
+
+    uint32_t get_thread_count() const;
+
+  private:
+    const Device &m_device;
+
+    ThreadPool m_thread_pool;
+
+  }; // class PipelineCompiler
+
+} // namespace prism
@@ -35,6 +35,25 @@ PipelineLayout::PipelineLayout(const Device &device, const std::vector<Descripto
   VK_CHECK(vkCreatePipelineLayout(m_device.get_handle(), &pipeline_layout_info, nullptr, &m_handle));
 }
 
+PipelineLayout::PipelineLayout(const Device &device, const std::vector<const DescriptorSetLayout *> &descriptor_set_layouts, const std::vector<VkPushConstantRange> &push_constant_ranges)
+  : m_device(device)
+{
+  std::vector<VkDescriptorSetLayout> descriptor_set_layout_handles;
+  for (const auto *descriptor_set_layout : descriptor_set_layouts)
+  {
+    descriptor_set_layout_handles.push_back(descriptor_set_layout->get_handle());
+  }
+
+  VkPipelineLayoutCreateInfo pipeline_layout_info = {};
+  pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipeline_layout_info.setLayoutCount = static_cast<uint32_t>(descriptor_set_layout_handles.size());
+  pipeline_layout_info.pSetLayouts = descriptor_set_layout_handles.data();
+  pipeline_layout_info.pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size());
+  pipeline_layout_info.pPushConstantRanges = push_constant_ranges.data();
+
+  VK_CHECK(vkCreatePipelineLayout(m_device.get_handle(), &pipeline_layout_info, nullptr, &m_handle));
+}
+
 PipelineLayout::PipelineLayout(PipelineLayout &&other) noexcept
     : m_handle(std::exchange(other.m_handle, VK_NULL_HANDLE)),
       m_device(other.m_device)
@@ -12,6 +12,8 @@ namespace prism
     
     PipelineLayout(const Device &device, const std::vector<DescriptorSetLayout> &descriptor_set_layouts);
 
+    PipelineLayout(const Device &device, const std::vector<const DescriptorSetLayout *> &descriptor_set_layouts, const std::vector<VkPushConstantRange> &push_constant_ranges = {});
+
     PipelineLayout(const PipelineLayout &) = delete;
 
     PipelineLayout(PipelineLayout &&other) noexcept;
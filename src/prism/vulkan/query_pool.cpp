@@ -0,0 +1,60 @@
+#include "prism/vulkan/query_pool.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/command_buffer.h"
+
+using namespace prism;
+
+QueryPool::QueryPool(const Device& device, VkQueryType type, uint32_t count, VkQueryPipelineStatisticFlags pipeline_statistics)
+  : m_device(device), m_count(count)
+{
+  VkQueryPoolCreateInfo create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  create_info.queryType = type;
+  create_info.queryCount = count;
+  create_info.pipelineStatistics = pipeline_statistics;
+
+  VK_CHECK(vkCreateQueryPool(device.get_handle(), &create_info, nullptr, &m_handle));
+}
+
+QueryPool::QueryPool(QueryPool&& other) noexcept
+  : m_handle(std::exchange(other.m_handle, VK_NULL_HANDLE)),
+    m_device(other.m_device),
+    m_count(other.m_count)
+{
+}
+
+QueryPool::~QueryPool()
+{
+  if (m_handle != VK_NULL_HANDLE)
+  {
+    vkDestroyQueryPool(m_device.get_handle(), m_handle, nullptr);
+  }
+}
+
+void QueryPool::reset(const CommandBuffer& cmd_buffer, uint32_t first, uint32_t count) const
+{
+  vkCmdResetQueryPool(cmd_buffer.get_handle(), m_handle, first, std::min(count, m_count - first));
+}
+
+std::vector<uint64_t> QueryPool::get_results(uint32_t first, uint32_t count) const
+{
+  count = std::min(count, m_count - first);
+
+  std::vector<uint64_t> results(count);
+  VK_CHECK(vkGetQueryPoolResults(m_device.get_handle(), m_handle, first, count, results.size() * sizeof(uint64_t), results.data(), sizeof(uint64_t),
+                                 VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+
+  return results;
+}
+
+VkQueryPool QueryPool::get_handle() const
+{
+  return m_handle;
+}
+
+uint32_t QueryPool::get_count() const
+{
+  return m_count;
+}
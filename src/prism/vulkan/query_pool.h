@@ -0,0 +1,41 @@
+#pragma once
+
+#include "prism/vulkan/device.h"
+
+namespace prism
+{
+  class CommandBuffer;
+
+  class QueryPool
+  {
+  public:
+    QueryPool(const Device& device, VkQueryType type, uint32_t count, VkQueryPipelineStatisticFlags pipeline_statistics = 0);
+
+    QueryPool(const QueryPool&) = delete;
+
+    QueryPool(QueryPool&& other) noexcept;
+
+    ~QueryPool();
+
+    QueryPool& operator=(const QueryPool&) = delete;
+
+    QueryPool& operator=(QueryPool&&) = delete;
+
+    // queries have to be reset before they are written
+    void reset(const CommandBuffer& cmd_buffer, uint32_t first = 0, uint32_t count = UINT32_MAX) const;
+
+    // one 64 bit value per query, blocks until the queries are available
+    std::vector<uint64_t> get_results(uint32_t first = 0, uint32_t count = UINT32_MAX) const;
+
+    VkQueryPool get_handle() const;
+
+    uint32_t get_count() const;
+
+  private:
+    VkQueryPool m_handle;
+
+    const Device& m_device;
+
+    uint32_t m_count;
+  };
+}
@@ -1,17 +1,19 @@
 #include "prism/vulkan/queue.h"
 
 #include "prism/vulkan/command_buffer.h"
+#include "prism/vulkan/device.h"
 #include "prism/vulkan/fence.h"
 
 using namespace prism;
 
-Queue::Queue(VkQueue queue, uint32_t family_index, uint32_t index)
-		: m_handle(queue), m_family_index(family_index), m_index(index)
+Queue::Queue(const Device &device, VkQueue queue, uint32_t family_index, uint32_t index)
+		: m_device(device), m_handle(queue), m_family_index(family_index), m_index(index)
 {
 }
 
 Queue::Queue(Queue &&other) noexcept
-		: m_handle(std::exchange(other.m_handle, nullptr)),
+		: m_device(other.m_device),
+		  m_handle(std::exchange(other.m_handle, nullptr)),
 		  m_family_index(std::exchange(other.m_family_index, 0)),
 		  m_index(std::exchange(other.m_index, 0)),
 		  m_can_present(std::exchange(other.m_can_present, VK_FALSE)),
@@ -55,12 +57,20 @@ void Queue::submit(const CommandBuffer &cmd_buffer, VkFence fence) const
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers = &cmd_buffer.get_handle();
 	
-	VK_CHECK(vkQueueSubmit(m_handle, 1, &submit_info, fence));
+	submit(submit_info, fence);
 }
 
 void Queue::submit(const VkSubmitInfo &info, const Fence &fence) const
 {
-	VK_CHECK(vkQueueSubmit(m_handle, 1, &info, fence.get_handle()));
+	submit(info, fence.get_handle());
+}
+
+void Queue::submit(const VkSubmitInfo &info, VkFence fence) const
+{
+	// whatever the command buffers read from non coherent memory has to be flushed first
+	m_device.get_memory_allocator().flush_dirty_ranges();
+
+	VK_CHECK(vkQueueSubmit(m_handle, 1, &info, fence));
 }
 
 VkResult Queue::present(const VkPresentInfoKHR &present_info) const
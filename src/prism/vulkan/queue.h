@@ -3,12 +3,13 @@
 namespace prism
 {
   class CommandBuffer;
+  class Device;
   class Fence;
 
   class Queue
   {
   public:
-    Queue(VkQueue queue, uint32_t family_index, uint32_t index);
+    Queue(const Device &device, VkQueue queue, uint32_t family_index, uint32_t index);
 
     Queue(const Queue &) = default;
 
@@ -30,15 +31,20 @@ namespace prism
 
     VkBool32 support_present() const;
 
+    // every submit flushes the host writes to non coherent memory recorded since the last one
     void submit(const CommandBuffer &cmd_buffer, VkFence fence = VK_NULL_HANDLE) const;
 
     void submit(const VkSubmitInfo& info, const Fence& fence) const;
 
+    void submit(const VkSubmitInfo& info, VkFence fence = VK_NULL_HANDLE) const;
+
     VkResult present(const VkPresentInfoKHR &present_info) const;
 
     void wait_idle() const;
 
   private:
+    const Device &m_device;
+
     VkQueue m_handle;
 
     uint32_t m_family_index;
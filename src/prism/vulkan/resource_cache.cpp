@@ -0,0 +1,449 @@
+#include "prism/vulkan/resource_cache.h"
+
+using namespace prism;
+
+namespace
+{
+  // appends the bytes of a value to a key, only used for types without padding
+  template <typename T>
+  void append(std::string &key, const T &value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "the value has to be copyable as bytes");
+    key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  void append(std::string &key, const std::string &value)
+  {
+    append(key, value.size());
+    key.append(value);
+  }
+
+  // the count is kept when the array is null, dynamic viewports still have one
+  template <typename T>
+  void append_array(std::string &key, const T *values, uint32_t count)
+  {
+    append(key, count);
+    append(key, values != nullptr);
+    if (values != nullptr)
+    {
+      key.append(reinterpret_cast<const char *>(values), sizeof(T) * count);
+    }
+  }
+
+  // extension structures change the created object, one the cache does not know could make different objects
+  // share a key
+  void append_chain(std::string &key, const void *next)
+  {
+    for (auto *header = static_cast<const VkBaseInStructure *>(next); header != nullptr; header = header->pNext)
+    {
+      append(key, header->sType);
+      switch (header->sType)
+      {
+        case VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO:
+        {
+          const auto *rendering = reinterpret_cast<const VkPipelineRenderingCreateInfo *>(header);
+          append(key, rendering->viewMask);
+          append_array(key, rendering->pColorAttachmentFormats, rendering->colorAttachmentCount);
+          append(key, rendering->depthAttachmentFormat);
+          append(key, rendering->stencilAttachmentFormat);
+          break;
+        }
+        default:
+          throw std::runtime_error("Resource cache can not key structure type " + std::to_string(header->sType));
+      }
+    }
+  }
+
+  void append_attachment_references(std::string &key, const VkAttachmentReference *references, uint32_t count, bool compatibility)
+  {
+    append(key, references != nullptr ? count : 0u);
+    for (uint32_t i = 0; references != nullptr && i < count; ++i)
+    {
+      append(key, references[i].attachment);
+      if (!compatibility)
+      {
+        append(key, references[i].layout);
+      }
+    }
+  }
+
+  // render passes differing only in layouts and load and store operations are compatible, pipelines created
+  // against one of them can be used with any other
+  std::string render_pass_key(const std::vector<AttachmentDescription> &attachments, const std::vector<SubpassDescription> &subpasses, const std::vector<SubpassDependency> &dependencies, bool compatibility)
+  {
+    std::string key;
+
+    append(key, attachments.size());
+    for (const auto &attachment : attachments)
+    {
+      append(key, attachment.flags);
+      append(key, attachment.format);
+      append(key, attachment.samples);
+      if (!compatibility)
+      {
+        append(key, attachment.loadOp);
+        append(key, attachment.storeOp);
+        append(key, attachment.stencilLoadOp);
+        append(key, attachment.stencilStoreOp);
+        append(key, attachment.initialLayout);
+        append(key, attachment.finalLayout);
+      }
+    }
+
+    append(key, subpasses.size());
+    for (const auto &subpass : subpasses)
+    {
+      append(key, subpass.flags);
+      append(key, subpass.pipelineBindPoint);
+      append_attachment_references(key, subpass.pInputAttachments, subpass.inputAttachmentCount, compatibility);
+      append_attachment_references(key, subpass.pColorAttachments, subpass.colorAttachmentCount, compatibility);
+      append_attachment_references(key, subpass.pResolveAttachments, subpass.colorAttachmentCount, compatibility);
+      append_attachment_references(key, subpass.pDepthStencilAttachment, 1, compatibility);
+      append_array(key, subpass.pPreserveAttachments, subpass.preserveAttachmentCount);
+    }
+
+    append_array(key, static_cast<const VkSubpassDependency *>(dependencies.data()), static_cast<uint32_t>(dependencies.size()));
+
+    return key;
+  }
+
+  void append_state(std::string &key, const VkPipelineVertexInputStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append_array(key, state->pVertexBindingDescriptions, state->vertexBindingDescriptionCount);
+      append_array(key, state->pVertexAttributeDescriptions, state->vertexAttributeDescriptionCount);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineInputAssemblyStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append(key, state->topology);
+      append(key, state->primitiveRestartEnable);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineTessellationStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append(key, state->patchControlPoints);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineViewportStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      // the arrays are null when viewports and scissors are dynamic
+      append_chain(key, state->pNext);
+      append_array(key, state->pViewports, state->viewportCount);
+      append_array(key, state->pScissors, state->scissorCount);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineRasterizationStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append(key, state->depthClampEnable);
+      append(key, state->rasterizerDiscardEnable);
+      append(key, state->polygonMode);
+      append(key, state->cullMode);
+      append(key, state->frontFace);
+      append(key, state->depthBiasEnable);
+      append(key, state->depthBiasConstantFactor);
+      append(key, state->depthBiasClamp);
+      append(key, state->depthBiasSlopeFactor);
+      append(key, state->lineWidth);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineMultisampleStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append(key, state->rasterizationSamples);
+      append(key, state->sampleShadingEnable);
+      append(key, state->minSampleShading);
+      append_array(key, state->pSampleMask, (state->rasterizationSamples + 31) / 32);
+      append(key, state->alphaToCoverageEnable);
+      append(key, state->alphaToOneEnable);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineDepthStencilStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append(key, state->depthTestEnable);
+      append(key, state->depthWriteEnable);
+      append(key, state->depthCompareOp);
+      append(key, state->depthBoundsTestEnable);
+      append(key, state->stencilTestEnable);
+      append(key, state->front);
+      append(key, state->back);
+      append(key, state->minDepthBounds);
+      append(key, state->maxDepthBounds);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineColorBlendStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append(key, state->logicOpEnable);
+      append(key, state->logicOp);
+      append_array(key, state->pAttachments, state->attachmentCount);
+      append(key, state->blendConstants);
+    }
+  }
+
+  void append_state(std::string &key, const VkPipelineDynamicStateCreateInfo *state)
+  {
+    append(key, state != nullptr);
+    if (state != nullptr)
+    {
+      append_chain(key, state->pNext);
+      append_array(key, state->pDynamicStates, state->dynamicStateCount);
+    }
+  }
+
+  // the number of the class an entry belongs to, equal entries get the same number
+  uint32_t get_id(std::unordered_map<std::string, uint32_t> &ids, std::string entry)
+  {
+    auto id = static_cast<uint32_t>(ids.size());
+    return ids.emplace(std::move(entry), id).first->second;
+  }
+}
+
+template <typename T, typename... Args>
+T &ResourceCache::request(std::unique_lock<std::mutex> &lock, std::unordered_map<std::string, std::unique_ptr<T>> &objects, std::string key, Args &&...args)
+{
+  auto it = objects.find(key);
+  if (it != objects.end())
+  {
+    ++m_statistics.hit_count;
+    return *it->second;
+  }
+
+  ++m_statistics.miss_count;
+
+  // creation may compile a pipeline, other threads keep hitting the cache meanwhile
+  lock.unlock();
+  auto object = std::make_unique<T>(std::forward<Args>(args)...);
+  lock.lock();
+
+  // another thread may have created the same object in the meantime, its entry wins and ours is destroyed
+  return *objects.emplace(std::move(key), std::move(object)).first->second;
+}
+
+ResourceCache::ResourceCache(const Device &device)
+    : m_device(device)
+{
+}
+
+ResourceCache::~ResourceCache()
+{
+  clear();
+}
+
+ShaderModule &ResourceCache::request_shader_module(const std::string &filename, VkShaderStageFlagBits stage, const std::string &entry_point)
+{
+  std::string key;
+  append(key, filename);
+  append(key, stage);
+  append(key, entry_point);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  auto &shader_module = request(lock, m_shader_modules, std::move(key), m_device, filename, stage, entry_point);
+  if (m_shader_module_ids.find(shader_module.get_handle()) == m_shader_module_ids.end())
+  {
+    const auto &code = shader_module.get_code();
+    m_shader_module_ids[shader_module.get_handle()] =
+        get_id(m_shader_code_ids, std::string(reinterpret_cast<const char *>(code.data()), code.size() * sizeof(uint32_t)));
+  }
+  return shader_module;
+}
+
+DescriptorSetLayout &ResourceCache::request_descriptor_set_layout(const DescriptorSetLayout::Bindings &bindings)
+{
+  std::string key;
+  append(key, bindings.size());
+  for (const auto &binding : bindings)
+  {
+    append(key, binding.binding);
+    append(key, binding.descriptorType);
+    append(key, binding.descriptorCount);
+    append(key, binding.stageFlags);
+    append_array(key, binding.pImmutableSamplers, binding.descriptorCount);
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  return request(lock, m_descriptor_set_layouts, std::move(key), m_device, bindings);
+}
+
+PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<const DescriptorSetLayout *> &descriptor_set_layouts, const std::vector<VkPushConstantRange> &push_constant_ranges)
+{
+  std::string key;
+  append(key, descriptor_set_layouts.size());
+  for (const auto *descriptor_set_layout : descriptor_set_layouts)
+  {
+    append(key, descriptor_set_layout->get_handle());
+  }
+  append_array(key, push_constant_ranges.data(), static_cast<uint32_t>(push_constant_ranges.size()));
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  return request(lock, m_pipeline_layouts, std::move(key), m_device, descriptor_set_layouts, push_constant_ranges);
+}
+
+PipelineLayout &ResourceCache::request_pipeline_layout(const ShaderReflection &reflection, uint32_t runtime_array_count)
+{
+  std::vector<const DescriptorSetLayout *> descriptor_set_layouts;
+  for (const auto &bindings : reflection.get_descriptor_set_bindings(runtime_array_count))
+  {
+    descriptor_set_layouts.push_back(&request_descriptor_set_layout(bindings));
+  }
+
+  return request_pipeline_layout(descriptor_set_layouts, reflection.get_push_constant_ranges());
+}
+
+RenderPass &ResourceCache::request_render_pass(const std::vector<AttachmentDescription> &attachments, const std::vector<SubpassDescription> &subpasses, const std::vector<SubpassDependency> &dependencies)
+{
+  auto key = render_pass_key(attachments, subpasses, dependencies, false);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  auto &render_pass = request(lock, m_render_passes, std::move(key), m_device, attachments, subpasses, dependencies);
+  if (m_render_pass_ids.find(render_pass.get_handle()) == m_render_pass_ids.end())
+  {
+    m_render_pass_ids[render_pass.get_handle()] =
+        get_id(m_render_pass_compatibility_ids, render_pass_key(attachments, subpasses, dependencies, true));
+  }
+  return render_pass;
+}
+
+GraphicsPipeline &ResourceCache::request_graphics_pipeline(const GraphicsPipelineCreateInfo &create_info)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  std::string key;
+  append_chain(key, create_info.pNext);
+  append(key, create_info.flags);
+
+  append(key, create_info.stageCount);
+  for (uint32_t i = 0; i < create_info.stageCount; ++i)
+  {
+    append_shader_stage(key, create_info.pStages[i]);
+  }
+
+  append_state(key, create_info.pVertexInputState);
+  append_state(key, create_info.pInputAssemblyState);
+  append_state(key, create_info.pTessellationState);
+  append_state(key, create_info.pViewportState);
+  append_state(key, create_info.pRasterizationState);
+  append_state(key, create_info.pMultisampleState);
+  append_state(key, create_info.pDepthStencilState);
+  append_state(key, create_info.pColorBlendState);
+  append_state(key, create_info.pDynamicState);
+
+  append(key, create_info.layout);
+
+  auto render_pass_it = m_render_pass_ids.find(create_info.renderPass);
+  append(key, render_pass_it != m_render_pass_ids.end());
+  if (render_pass_it != m_render_pass_ids.end())
+  {
+    append(key, render_pass_it->second);
+  }
+  else
+  {
+    append(key, create_info.renderPass);
+  }
+  append(key, create_info.subpass);
+
+  return request(lock, m_graphics_pipelines, std::move(key), m_device, create_info);
+}
+
+ComputePipeline &ResourceCache::request_compute_pipeline(const PipelineLayout &pipeline_layout, const ShaderStage &shader_stage)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  std::string key;
+  append(key, pipeline_layout.get_handle());
+  append_shader_stage(key, shader_stage);
+
+  return request(lock, m_compute_pipelines, std::move(key), m_device, pipeline_layout, shader_stage);
+}
+
+ResourceCache::Statistics ResourceCache::get_statistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_statistics;
+}
+
+void ResourceCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_compute_pipelines.clear();
+  m_graphics_pipelines.clear();
+  m_render_passes.clear();
+  m_pipeline_layouts.clear();
+  m_descriptor_set_layouts.clear();
+  m_shader_modules.clear();
+
+  m_render_pass_ids.clear();
+  m_render_pass_compatibility_ids.clear();
+  m_shader_module_ids.clear();
+  m_shader_code_ids.clear();
+}
+
+void ResourceCache::append_shader_stage(std::string &key, const VkPipelineShaderStageCreateInfo &shader_stage) const
+{
+  append_chain(key, shader_stage.pNext);
+  append(key, shader_stage.flags);
+  append(key, shader_stage.stage);
+
+  auto module_it = m_shader_module_ids.find(shader_stage.module);
+  append(key, module_it != m_shader_module_ids.end());
+  if (module_it != m_shader_module_ids.end())
+  {
+    append(key, module_it->second);
+  }
+  else
+  {
+    append(key, shader_stage.module);
+  }
+
+  append(key, std::string(shader_stage.pName));
+
+  const auto *specialization_info = shader_stage.pSpecializationInfo;
+  append(key, specialization_info != nullptr);
+  if (specialization_info != nullptr)
+  {
+    append_array(key, specialization_info->pMapEntries, specialization_info->mapEntryCount);
+    append(key, specialization_info->dataSize);
+    key.append(static_cast<const char *>(specialization_info->pData), specialization_info->dataSize);
+  }
+}
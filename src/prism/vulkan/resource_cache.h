@@ -0,0 +1,102 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "prism/vulkan/compute_pipeline.h"
+#include "prism/vulkan/descriptor_set_layout.h"
+#include "prism/vulkan/graphics_pipeline.h"
+#include "prism/vulkan/pipeline_layout.h"
+#include "prism/vulkan/render_pass.h"
+#include "prism/vulkan/shader_module.h"
+#include "prism/vulkan/shader_reflection.h"
+
+namespace prism
+{
+  // hands out one object per unique create state. requests serialize the full state the object is created from into
+  // a key and return the existing object when an equal key is known, so identical materials share their layouts and
+  // pipelines. pipelines are keyed by the spir-v of their modules and the compatibility of their render pass rather
+  // than by handles, provided the modules and render passes were requested from the same cache
+  class ResourceCache
+  {
+  public:
+    struct Statistics
+    {
+      uint32_t hit_count{0};
+      uint32_t miss_count{0};
+    };
+
+  public:
+    ResourceCache(const Device &device);
+
+    ResourceCache(const ResourceCache &) = delete;
+
+    ResourceCache(ResourceCache &&) = delete;
+
+    ~ResourceCache();
+
+    ResourceCache &operator=(const ResourceCache &) = delete;
+
+    ResourceCache &operator=(ResourceCache &&) = delete;
+
+    ShaderModule &request_shader_module(const std::string &filename, VkShaderStageFlagBits stage, const std::string &entry_point = "main");
+
+    DescriptorSetLayout &request_descriptor_set_layout(const DescriptorSetLayout::Bindings &bindings);
+
+    PipelineLayout &request_pipeline_layout(const std::vector<const DescriptorSetLayout *> &descriptor_set_layouts, const std::vector<VkPushConstantRange> &push_constant_ranges = {});
+
+    // the set layouts and push constant ranges of the merged stages of a pipeline, runtime arrays get the given count
+    PipelineLayout &request_pipeline_layout(const ShaderReflection &reflection, uint32_t runtime_array_count = 0);
+
+    RenderPass &request_render_pass(const std::vector<AttachmentDescription> &attachments, const std::vector<SubpassDescription> &subpasses, const std::vector<SubpassDependency> &dependencies);
+
+    GraphicsPipeline &request_graphics_pipeline(const GraphicsPipelineCreateInfo &create_info);
+
+    ComputePipeline &request_compute_pipeline(const PipelineLayout &pipeline_layout, const ShaderStage &shader_stage);
+
+    Statistics get_statistics() const;
+
+    // destroys every object, none of them may still be in use
+    void clear();
+
+  private:
+    void append_shader_stage(std::string &key, const VkPipelineShaderStageCreateInfo &shader_stage) const;
+
+    // looks the key up under the held lock and creates a missing object with the lock released
+    template <typename T, typename... Args>
+    T &request(std::unique_lock<std::mutex> &lock, std::unordered_map<std::string, std::unique_ptr<T>> &objects, std::string key, Args &&...args);
+
+  private:
+    const Device &m_device;
+
+    // requests may come from the pipeline compiler's workers
+    mutable std::mutex m_mutex;
+
+    // ids of the distinct spir-v of the requested modules and of the compatibility classes of the requested render
+    // passes, pipeline keys refer to those instead of repeating the code and the attachments
+    std::unordered_map<std::string, uint32_t> m_shader_code_ids;
+
+    std::unordered_map<VkShaderModule, uint32_t> m_shader_module_ids;
+
+    std::unordered_map<std::string, uint32_t> m_render_pass_compatibility_ids;
+
+    std::unordered_map<VkRenderPass, uint32_t> m_render_pass_ids;
+
+    // declared in dependency order, pipelines are destroyed before the layouts and render passes they were made from
+    std::unordered_map<std::string, std::unique_ptr<ShaderModule>> m_shader_modules;
+
+    std::unordered_map<std::string, std::unique_ptr<DescriptorSetLayout>> m_descriptor_set_layouts;
+
+    std::unordered_map<std::string, std::unique_ptr<PipelineLayout>> m_pipeline_layouts;
+
+    std::unordered_map<std::string, std::unique_ptr<RenderPass>> m_render_passes;
+
+    std::unordered_map<std::string, std::unique_ptr<GraphicsPipeline>> m_graphics_pipelines;
+
+    std::unordered_map<std::string, std::unique_ptr<ComputePipeline>> m_compute_pipelines;
+
+    Statistics m_statistics;
+
+  }; // class ResourceCache
+
+} // namespace prism
@@ -0,0 +1,362 @@
+#include "prism/vulkan/shader_compiler.h"
+
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <regex>
+#include <set>
+#include <thread>
+
+#include <SPIRV/GlslangToSpv.h>
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/Public/ShaderLang.h>
+
+#include "prism/core/filesystem.h"
+#include "prism/vulkan/utils.h"
+
+using namespace prism;
+
+namespace
+{
+  // bumped when the way the cache is keyed or laid out changes
+  const uint64_t SHADER_CACHE_VERSION = 1;
+
+  const uint32_t SPIRV_MAGIC = 0x07230203;
+
+  EShLanguage shader_language(VkShaderStageFlagBits stage)
+  {
+    switch (stage)
+    {
+    case VK_SHADER_STAGE_VERTEX_BIT:
+      return EShLangVertex;
+    case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+      return EShLangTessControl;
+    case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+      return EShLangTessEvaluation;
+    case VK_SHADER_STAGE_GEOMETRY_BIT:
+      return EShLangGeometry;
+    case VK_SHADER_STAGE_FRAGMENT_BIT:
+      return EShLangFragment;
+    case VK_SHADER_STAGE_COMPUTE_BIT:
+      return EShLangCompute;
+    case VK_SHADER_STAGE_RAYGEN_BIT_KHR:
+      return EShLangRayGen;
+    case VK_SHADER_STAGE_INTERSECTION_BIT_KHR:
+      return EShLangIntersect;
+    case VK_SHADER_STAGE_ANY_HIT_BIT_KHR:
+      return EShLangAnyHit;
+    case VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR:
+      return EShLangClosestHit;
+    case VK_SHADER_STAGE_MISS_BIT_KHR:
+      return EShLangMiss;
+    case VK_SHADER_STAGE_CALLABLE_BIT_KHR:
+      return EShLangCallable;
+    case VK_SHADER_STAGE_TASK_BIT_EXT:
+      return EShLangTask;
+    case VK_SHADER_STAGE_MESH_BIT_EXT:
+      return EShLangMesh;
+    default:
+      throw std::runtime_error("Unsupported shader stage for GLSL compilation");
+    }
+  }
+
+  // looks next to the including file first for "" includes, then in the include directories
+  std::string resolve_include(const std::string &name, const std::string &includer, bool local, const std::vector<std::string> &include_directories)
+  {
+    if (local)
+    {
+      auto path = std::filesystem::path(includer).parent_path() / name;
+      if (std::filesystem::exists(path))
+      {
+        return path.string();
+      }
+    }
+
+    for (const auto &directory : include_directories)
+    {
+      auto path = std::filesystem::path(directory) / name;
+      if (std::filesystem::exists(path))
+      {
+        return path.string();
+      }
+    }
+
+    return {};
+  }
+
+  // visits every file the code includes once, whether the preprocessor ends up taking the include or not
+  void visit_includes(const std::string &code, const std::string &filename, const std::vector<std::string> &include_directories, std::set<std::string> &visited,
+                      const std::function<void(const std::string &, const std::string &)> &func)
+  {
+    static const std::regex include_regex(R"(#\s*include\s*([<"])([^>"]+)[>"])");
+
+    for (std::sregex_iterator it(code.begin(), code.end(), include_regex, std::regex_constants::match_default), end; it != end; ++it)
+    {
+      auto path = resolve_include((*it)[2].str(), filename, (*it)[1].str() == "\"", include_directories);
+      if (path.empty() || !visited.insert(path).second)
+      {
+        continue;
+      }
+
+      auto include = read_file(path);
+      func(path, include);
+      visit_includes(include, path, include_directories, visited, func);
+    }
+  }
+
+  class Includer : public glslang::TShader::Includer
+  {
+  public:
+    Includer(const std::vector<std::string> &include_directories)
+        : m_include_directories(include_directories)
+    {
+    }
+
+    IncludeResult *includeSystem(const char *header_name, const char *includer_name, size_t) override
+    {
+      return include(header_name, includer_name, false);
+    }
+
+    IncludeResult *includeLocal(const char *header_name, const char *includer_name, size_t) override
+    {
+      return include(header_name, includer_name, true);
+    }
+
+    void releaseInclude(IncludeResult *result) override
+    {
+      if (result != nullptr)
+      {
+        delete static_cast<std::string *>(result->userData);
+        delete result;
+      }
+    }
+
+  private:
+    IncludeResult *include(const char *header_name, const char *includer_name, bool local)
+    {
+      auto path = resolve_include(header_name, includer_name, local, m_include_directories);
+      if (path.empty())
+      {
+        return nullptr;
+      }
+
+      auto content = new std::string(read_file(path));
+      return new IncludeResult(path, content->data(), content->size(), content);
+    }
+
+  private:
+    const std::vector<std::string> &m_include_directories;
+  };
+}
+
+ShaderCompiler::ShaderCompiler(const std::string &cache_directory, uint32_t vulkan_version, const std::vector<std::string> &include_directories)
+    : m_cache_directory(cache_directory), m_vulkan_version(vulkan_version), m_include_directories(include_directories)
+{
+  // reference counted by glslang
+  glslang::InitializeProcess();
+
+  if (!m_cache_directory.empty())
+  {
+    std::error_code error;
+    std::filesystem::create_directories(m_cache_directory, error);
+    if (error)
+    {
+      LOG_WARN("failed to create shader cache {}: {}", m_cache_directory, error.message());
+    }
+  }
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+  glslang::FinalizeProcess();
+}
+
+std::vector<uint32_t> ShaderCompiler::compile(const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point)
+{
+  if (m_cache_directory.empty())
+  {
+    ++m_miss_count;
+    return compile_glsl(source, stage, entry_point);
+  }
+
+  auto key = hash(source, stage, entry_point);
+
+  auto code = load(key);
+  if (!code.empty())
+  {
+    ++m_hit_count;
+    return code;
+  }
+
+  ++m_miss_count;
+  code = compile_glsl(source, stage, entry_point);
+  store(key, code);
+
+  return code;
+}
+
+const std::string &ShaderCompiler::get_cache_directory() const
+{
+  return m_cache_directory;
+}
+
+std::vector<std::string> ShaderCompiler::get_includes(const GlslSource &source) const
+{
+  std::vector<std::string> includes;
+
+  std::set<std::string> visited;
+  visit_includes(source.code, source.filename, m_include_directories, visited, [&includes](const std::string &path, const std::string &) {
+    includes.push_back(path);
+  });
+
+  return includes;
+}
+
+ShaderCompiler::Statistics ShaderCompiler::get_statistics() const
+{
+  return {m_hit_count.load(), m_miss_count.load()};
+}
+
+uint64_t ShaderCompiler::hash(const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point) const
+{
+  // the key ends up in file names, it has to be stable across runs unlike std::hash
+  uint64_t hash = utils::hash_bytes(&SHADER_CACHE_VERSION, sizeof(SHADER_CACHE_VERSION));
+
+  auto generator_version = glslang::GetSpirvGeneratorVersion();
+  hash = utils::hash_bytes(&generator_version, sizeof(generator_version), hash);
+  hash = utils::hash_bytes(&m_vulkan_version, sizeof(m_vulkan_version), hash);
+  hash = utils::hash_bytes(&stage, sizeof(stage), hash);
+  hash = utils::hash_bytes(entry_point.data(), entry_point.size() + 1, hash);
+
+  for (const auto &define : source.defines)
+  {
+    hash = utils::hash_bytes(define.data(), define.size() + 1, hash);
+  }
+
+  hash = utils::hash_bytes(source.code.data(), source.code.size(), hash);
+
+  std::set<std::string> visited;
+  visit_includes(source.code, source.filename, m_include_directories, visited, [&hash](const std::string &path, const std::string &include) {
+    hash = utils::hash_bytes(path.data(), path.size(), hash);
+    hash = utils::hash_bytes(include.data(), include.size(), hash);
+  });
+
+  return hash;
+}
+
+std::vector<uint32_t> ShaderCompiler::compile_glsl(const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point) const
+{
+  auto language = shader_language(stage);
+
+  glslang::EShTargetClientVersion client_version = glslang::EShTargetVulkan_1_0;
+  glslang::EShTargetLanguageVersion spirv_version = glslang::EShTargetSpv_1_0;
+  if (m_vulkan_version >= VK_API_VERSION_1_3)
+  {
+    client_version = glslang::EShTargetVulkan_1_3;
+    spirv_version = glslang::EShTargetSpv_1_6;
+  }
+  else if (m_vulkan_version >= VK_API_VERSION_1_2)
+  {
+    client_version = glslang::EShTargetVulkan_1_2;
+    spirv_version = glslang::EShTargetSpv_1_5;
+  }
+  else if (m_vulkan_version >= VK_API_VERSION_1_1)
+  {
+    client_version = glslang::EShTargetVulkan_1_1;
+    spirv_version = glslang::EShTargetSpv_1_3;
+  }
+
+  // defines go into the preamble like glslang's -D, a define without a value is 1
+  std::string preamble = "#extension GL_GOOGLE_include_directive : require\n";
+  for (const auto &define : source.defines)
+  {
+    auto separator = define.find('=');
+    if (separator == std::string::npos)
+    {
+      preamble += "#define " + define + " 1\n";
+    }
+    else
+    {
+      preamble += "#define " + define.substr(0, separator) + " " + define.substr(separator + 1) + "\n";
+    }
+  }
+
+  const char *code = source.code.c_str();
+  const char *name = source.filename.c_str();
+
+  glslang::TShader shader(language);
+  shader.setStringsWithLengthsAndNames(&code, nullptr, &name, 1);
+  shader.setPreamble(preamble.c_str());
+  shader.setEntryPoint(entry_point.c_str());
+  shader.setEnvInput(glslang::EShSourceGlsl, language, glslang::EShClientVulkan, 100);
+  shader.setEnvClient(glslang::EShClientVulkan, client_version);
+  shader.setEnvTarget(glslang::EShTargetSpv, spirv_version);
+
+  auto messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+
+  Includer includer(m_include_directories);
+  if (!shader.parse(GetDefaultResources(), 100, false, messages, includer))
+  {
+    throw std::runtime_error("Failed to compile " + source.filename + ":\n" + shader.getInfoLog());
+  }
+
+  glslang::TProgram program;
+  program.addShader(&shader);
+  if (!program.link(messages))
+  {
+    throw std::runtime_error("Failed to link " + source.filename + ":\n" + program.getInfoLog());
+  }
+
+  std::vector<uint32_t> spirv;
+  glslang::SpvOptions options{};
+  glslang::GlslangToSpv(*program.getIntermediate(language), spirv, &options);
+
+  return spirv;
+}
+
+std::vector<uint32_t> ShaderCompiler::load(uint64_t key) const
+{
+  auto path = std::filesystem::path(m_cache_directory) / fmt::format("{:016x}.spv", key);
+
+  auto file = read_file(path.string(), true);
+  if (file.size() < sizeof(uint32_t) * 5 || file.size() % sizeof(uint32_t) != 0)
+  {
+    return {};
+  }
+
+  std::vector<uint32_t> code(file.size() / sizeof(uint32_t));
+  std::memcpy(code.data(), file.data(), file.size());
+
+  if (code[0] != SPIRV_MAGIC)
+  {
+    LOG_WARN("ignoring corrupt shader cache entry {}", path.string());
+    return {};
+  }
+
+  return code;
+}
+
+void ShaderCompiler::store(uint64_t key, const std::vector<uint32_t> &code) const
+{
+  auto path = std::filesystem::path(m_cache_directory) / fmt::format("{:016x}.spv", key);
+
+  // per thread so concurrent compiles of the same permutation do not write the same file, the rename is atomic
+  auto tmp_path = path.string() + fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(code.data()), code.size() * sizeof(uint32_t));
+    if (!file.good())
+    {
+      LOG_WARN("failed to write shader cache entry {}", tmp_path);
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tmp_path, path, error);
+  if (error)
+  {
+    LOG_WARN("failed to move shader cache entry to {}: {}", path.string(), error.message());
+    std::filesystem::remove(tmp_path, error);
+  }
+}
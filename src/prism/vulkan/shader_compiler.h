@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+
+namespace prism
+{
+  struct GlslSource
+  {
+    std::string code;
+    // used in messages and to resolve includes relative to the source
+    std::string filename;
+    // NAME or NAME=VALUE, like glslang's -D
+    std::vector<std::string> defines;
+  };
+
+  // compiles glsl to spir-v in process. results are cached in a directory under a hash of the source, everything
+  // it includes, the defines, the stage, the entry point and the target environment, so a permutation is only
+  // compiled the first time it is requested
+  class ShaderCompiler
+  {
+  public:
+    struct Statistics
+    {
+      uint32_t hit_count;
+      uint32_t miss_count;
+    };
+
+  public:
+    // an empty cache directory disables the cache
+    ShaderCompiler(const std::string &cache_directory = "shader_cache", uint32_t vulkan_version = VK_API_VERSION_1_3, const std::vector<std::string> &include_directories = {});
+
+    ShaderCompiler(const ShaderCompiler &) = delete;
+
+    ShaderCompiler(ShaderCompiler &&) = delete;
+
+    ~ShaderCompiler();
+
+    ShaderCompiler &operator=(const ShaderCompiler &) = delete;
+
+    ShaderCompiler &operator=(ShaderCompiler &&) = delete;
+
+    // throws with the compiler log when the source does not compile
+    std::vector<uint32_t> compile(const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point = "main");
+
+    // every file the source includes, directly or not
+    std::vector<std::string> get_includes(const GlslSource &source) const;
+
+    const std::string &get_cache_directory() const;
+
+    Statistics get_statistics() const;
+
+  private:
+    uint64_t hash(const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point) const;
+
+    std::vector<uint32_t> compile_glsl(const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point) const;
+
+    std::vector<uint32_t> load(uint64_t key) const;
+
+    void store(uint64_t key, const std::vector<uint32_t> &code) const;
+
+  private:
+    std::string m_cache_directory;
+
+    uint32_t m_vulkan_version;
+
+    std::vector<std::string> m_include_directories;
+
+    std::atomic<uint32_t> m_hit_count{0};
+
+    std::atomic<uint32_t> m_miss_count{0};
+
+  }; // class ShaderCompiler
+
+} // namespace prism
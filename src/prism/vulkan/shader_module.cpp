@@ -1,6 +1,10 @@
 #include "prism/vulkan/shader_module.h"
 
+#include <cstring>
+
 #include "prism/core/filesystem.h"
+#include "prism/vulkan/shader_compiler.h"
+#include "prism/vulkan/utils.h"
 
 using namespace prism;
 
@@ -8,19 +12,31 @@ ShaderModule::ShaderModule(const Device &device, const std::string &filename, Vk
     : m_device(device), m_stage(stage), m_entry_point(entry_point)
 {
   auto code = read_file(filename, true);
-  VkShaderModuleCreateInfo create_info = {};
-  create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  create_info.codeSize = code.size();
-  create_info.pCode = reinterpret_cast<const uint32_t *>(code.data());
+  m_code.resize(code.size() / sizeof(uint32_t));
+  std::memcpy(m_code.data(), code.data(), m_code.size() * sizeof(uint32_t));
 
-  VK_CHECK(vkCreateShaderModule(m_device.get_handle(), &create_info, nullptr, &m_handle));
+  create();
+}
+
+ShaderModule::ShaderModule(const Device &device, const std::vector<uint32_t> &code, VkShaderStageFlagBits stage, const std::string &entry_point)
+    : m_device(device), m_stage(stage), m_entry_point(entry_point), m_code(code)
+{
+  create();
+}
+
+ShaderModule::ShaderModule(const Device &device, ShaderCompiler &compiler, const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point)
+    : m_device(device), m_stage(stage), m_entry_point(entry_point), m_code(compiler.compile(source, stage, entry_point))
+{
+  create();
 }
 
 ShaderModule::ShaderModule(ShaderModule &&other) noexcept
     : m_handle(std::exchange(other.m_handle, VK_NULL_HANDLE)),
       m_device(other.m_device),
       m_stage(other.m_stage),
-      m_entry_point(std::move(other.m_entry_point))
+      m_entry_point(std::move(other.m_entry_point)),
+      m_code(std::move(other.m_code)),
+      m_hash(other.m_hash)
 {
 }
 
@@ -45,4 +61,26 @@ VkShaderStageFlagBits ShaderModule::get_stage() const
 const std::string &ShaderModule::get_entry_point() const
 {
   return m_entry_point;
+}
+
+const std::vector<uint32_t> &ShaderModule::get_code() const
+{
+  return m_code;
+}
+
+uint64_t ShaderModule::get_hash() const
+{
+  return m_hash;
+}
+
+void ShaderModule::create()
+{
+  VkShaderModuleCreateInfo create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  create_info.codeSize = m_code.size() * sizeof(uint32_t);
+  create_info.pCode = m_code.data();
+
+  VK_CHECK(vkCreateShaderModule(m_device.get_handle(), &create_info, nullptr, &m_handle));
+
+  m_hash = utils::hash_bytes(m_code.data(), m_code.size() * sizeof(uint32_t));
 }
\ No newline at end of file
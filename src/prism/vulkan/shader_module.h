@@ -4,12 +4,20 @@
 
 namespace prism
 {
+  class ShaderCompiler;
+  struct GlslSource;
 
   class ShaderModule
   {
   public:
+    // loads compiled spir-v
     ShaderModule(const Device &device, const std::string &filename, VkShaderStageFlagBits stage, const std::string &entry_point = "main");
 
+    ShaderModule(const Device &device, const std::vector<uint32_t> &code, VkShaderStageFlagBits stage, const std::string &entry_point = "main");
+
+    // compiles glsl, or takes the spir-v from the compiler's cache
+    ShaderModule(const Device &device, ShaderCompiler &compiler, const GlslSource &source, VkShaderStageFlagBits stage, const std::string &entry_point = "main");
+
     ShaderModule(const ShaderModule &) = delete;
 
     ShaderModule(ShaderModule &&other) noexcept;
@@ -26,6 +34,14 @@ namespace prism
 
     const std::string &get_entry_point() const;
 
+    const std::vector<uint32_t> &get_code() const;
+
+    // hash of the spir-v code
+    uint64_t get_hash() const;
+
+  private:
+    void create();
+
   private:
     VkShaderModule m_handle;
 
@@ -34,6 +50,11 @@ namespace prism
     std::string m_entry_point;
 
     VkShaderStageFlagBits m_stage;
+
+    // kept for reflection
+    std::vector<uint32_t> m_code;
+
+    uint64_t m_hash{0};
   };
 
 } // namespace prism
\ No newline at end of file
@@ -0,0 +1,701 @@
+#include "prism/vulkan/shader_reflection.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "prism/vulkan/shader_module.h"
+
+using namespace prism;
+
+namespace
+{
+  // the parts of the spir-v grammar the reflection reads
+  const uint32_t SPIRV_MAGIC = 0x07230203;
+  const uint32_t SPIRV_HEADER_SIZE = 5;
+
+  enum Op : uint32_t
+  {
+    OpName = 5,
+    OpEntryPoint = 15,
+    OpExecutionMode = 16,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstantTrue = 41,
+    OpConstantFalse = 42,
+    OpConstant = 43,
+    OpConstantComposite = 44,
+    OpSpecConstantTrue = 48,
+    OpSpecConstantFalse = 49,
+    OpSpecConstant = 50,
+    OpSpecConstantComposite = 51,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+    OpExecutionModeId = 331,
+    OpTypeAccelerationStructureKHR = 5341,
+  };
+
+  enum Decoration : uint32_t
+  {
+    DecorationSpecId = 1,
+    DecorationBlock = 2,
+    DecorationBufferBlock = 3,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35,
+  };
+
+  enum StorageClass : uint32_t
+  {
+    StorageClassUniformConstant = 0,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12,
+  };
+
+  const uint32_t BUILT_IN_WORKGROUP_SIZE = 25;
+
+  const uint32_t EXECUTION_MODE_LOCAL_SIZE = 17;
+  const uint32_t EXECUTION_MODE_LOCAL_SIZE_ID = 38;
+
+  const uint32_t DIM_BUFFER = 5;
+  const uint32_t DIM_SUBPASS_DATA = 6;
+
+  // indexed by the spir-v image format
+  const VkFormat IMAGE_FORMATS[] = {
+      VK_FORMAT_UNDEFINED,
+      VK_FORMAT_R32G32B32A32_SFLOAT,
+      VK_FORMAT_R16G16B16A16_SFLOAT,
+      VK_FORMAT_R32_SFLOAT,
+      VK_FORMAT_R8G8B8A8_UNORM,
+      VK_FORMAT_R8G8B8A8_SNORM,
+      VK_FORMAT_R32G32_SFLOAT,
+      VK_FORMAT_R16G16_SFLOAT,
+      VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+      VK_FORMAT_R16_SFLOAT,
+      VK_FORMAT_R16G16B16A16_UNORM,
+      VK_FORMAT_A2B10G10R10_UNORM_PACK32,
+      VK_FORMAT_R16G16_UNORM,
+      VK_FORMAT_R8G8_UNORM,
+      VK_FORMAT_R16_UNORM,
+      VK_FORMAT_R8_UNORM,
+      VK_FORMAT_R16G16B16A16_SNORM,
+      VK_FORMAT_R16G16_SNORM,
+      VK_FORMAT_R8G8_SNORM,
+      VK_FORMAT_R16_SNORM,
+      VK_FORMAT_R8_SNORM,
+      VK_FORMAT_R32G32B32A32_SINT,
+      VK_FORMAT_R16G16B16A16_SINT,
+      VK_FORMAT_R8G8B8A8_SINT,
+      VK_FORMAT_R32_SINT,
+      VK_FORMAT_R32G32_SINT,
+      VK_FORMAT_R16G16_SINT,
+      VK_FORMAT_R8G8_SINT,
+      VK_FORMAT_R16_SINT,
+      VK_FORMAT_R8_SINT,
+      VK_FORMAT_R32G32B32A32_UINT,
+      VK_FORMAT_R16G16B16A16_UINT,
+      VK_FORMAT_R8G8B8A8_UINT,
+      VK_FORMAT_R32_UINT,
+      VK_FORMAT_A2B10G10R10_UINT_PACK32,
+      VK_FORMAT_R32G32_UINT,
+      VK_FORMAT_R16G16_UINT,
+      VK_FORMAT_R8G8_UINT,
+      VK_FORMAT_R16_UINT,
+      VK_FORMAT_R8_UINT,
+      VK_FORMAT_R64_UINT,
+      VK_FORMAT_R64_SINT,
+  };
+
+  VkShaderStageFlagBits shader_stage(uint32_t execution_model)
+  {
+    switch (execution_model)
+    {
+    case 0:
+      return VK_SHADER_STAGE_VERTEX_BIT;
+    case 1:
+      return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    case 2:
+      return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    case 3:
+      return VK_SHADER_STAGE_GEOMETRY_BIT;
+    case 4:
+      return VK_SHADER_STAGE_FRAGMENT_BIT;
+    case 5:
+      return VK_SHADER_STAGE_COMPUTE_BIT;
+    case 5313:
+      return VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+    case 5314:
+      return VK_SHADER_STAGE_INTERSECTION_BIT_KHR;
+    case 5315:
+      return VK_SHADER_STAGE_ANY_HIT_BIT_KHR;
+    case 5316:
+      return VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+    case 5317:
+      return VK_SHADER_STAGE_MISS_BIT_KHR;
+    case 5318:
+      return VK_SHADER_STAGE_CALLABLE_BIT_KHR;
+    case 5364:
+      return VK_SHADER_STAGE_TASK_BIT_EXT;
+    case 5365:
+      return VK_SHADER_STAGE_MESH_BIT_EXT;
+    default:
+      throw std::runtime_error("Unsupported SPIR-V execution model " + std::to_string(execution_model));
+    }
+  }
+
+  // what the reflection needs to know about an id, gathered in one pass over the code
+  struct Id
+  {
+    uint32_t opcode{0};
+    // word offset of the instruction defining the id
+    uint32_t offset{0};
+
+    uint32_t set{UINT32_MAX};
+    uint32_t binding{UINT32_MAX};
+    uint32_t spec_id{UINT32_MAX};
+    uint32_t built_in{UINT32_MAX};
+    uint32_t array_stride{0};
+    bool buffer_block{false};
+
+    std::vector<uint32_t> member_offsets;
+    std::vector<uint32_t> member_matrix_strides;
+
+    std::string name;
+  };
+
+  class Parser
+  {
+  public:
+    Parser(const std::vector<uint32_t> &code)
+        : m_code(code)
+    {
+      if (code.size() < SPIRV_HEADER_SIZE || code[0] != SPIRV_MAGIC)
+      {
+        throw std::runtime_error("Invalid SPIR-V code");
+      }
+
+      m_ids.resize(code[3]);
+
+      for (uint32_t offset = SPIRV_HEADER_SIZE; offset < code.size();)
+      {
+        auto word_count = code[offset] >> 16;
+        auto opcode = code[offset] & 0xffff;
+        if (word_count == 0 || offset + word_count > code.size())
+        {
+          throw std::runtime_error("Invalid SPIR-V code");
+        }
+
+        parse(opcode, offset, word_count);
+        m_instructions.push_back(offset);
+
+        offset += word_count;
+      }
+    }
+
+    uint32_t opcode(uint32_t offset) const
+    {
+      return m_code[offset] & 0xffff;
+    }
+
+    uint32_t word_count(uint32_t offset) const
+    {
+      return m_code[offset] >> 16;
+    }
+
+    uint32_t word(uint32_t offset, uint32_t index) const
+    {
+      return m_code[offset + index];
+    }
+
+    std::string string(uint32_t offset, uint32_t index) const
+    {
+      std::string result;
+      for (auto i = offset + index; i < offset + word_count(offset); ++i)
+      {
+        for (uint32_t byte = 0; byte < 4; ++byte)
+        {
+          auto c = static_cast<char>((m_code[i] >> (byte * 8)) & 0xff);
+          if (c == '\0')
+          {
+            return result;
+          }
+          result.push_back(c);
+        }
+      }
+      return result;
+    }
+
+    const Id &id(uint32_t id) const
+    {
+      return m_ids.at(id);
+    }
+
+    const std::vector<uint32_t> &instructions() const
+    {
+      return m_instructions;
+    }
+
+    // value of a scalar constant or the default of a specialization constant
+    uint32_t constant(uint32_t id) const
+    {
+      const auto &constant = m_ids.at(id);
+      switch (constant.opcode)
+      {
+      case OpConstantTrue:
+      case OpSpecConstantTrue:
+        return 1;
+      case OpConstantFalse:
+      case OpSpecConstantFalse:
+        return 0;
+      case OpConstant:
+      case OpSpecConstant:
+        return word(constant.offset, 3);
+      default:
+        throw std::runtime_error("SPIR-V id " + std::to_string(id) + " is not a scalar constant");
+      }
+    }
+
+    // in bytes as laid out in a block, matrix_stride comes from the member decoration
+    uint32_t size_of(uint32_t type, uint32_t matrix_stride = 0) const
+    {
+      const auto &info = m_ids.at(type);
+      switch (info.opcode)
+      {
+      case OpTypeBool:
+        return 4;
+      case OpTypeInt:
+      case OpTypeFloat:
+        return word(info.offset, 2) / 8;
+      case OpTypeVector:
+        return word(info.offset, 3) * size_of(word(info.offset, 2));
+      case OpTypeMatrix:
+        return word(info.offset, 3) * (matrix_stride != 0 ? matrix_stride : size_of(word(info.offset, 2)));
+      case OpTypeArray:
+      {
+        auto stride = info.array_stride != 0 ? info.array_stride : size_of(word(info.offset, 2));
+        return constant(word(info.offset, 3)) * stride;
+      }
+      case OpTypeStruct:
+      {
+        uint32_t size = 0;
+        for (uint32_t member = 0; member + 2 < word_count(info.offset); ++member)
+        {
+          auto member_offset = member < info.member_offsets.size() ? info.member_offsets[member] : 0;
+          auto member_matrix_stride = member < info.member_matrix_strides.size() ? info.member_matrix_strides[member] : 0;
+          size = std::max(size, member_offset + size_of(word(info.offset, member + 2), member_matrix_stride));
+        }
+        return size;
+      }
+      case OpTypePointer:
+        // physical storage buffer references
+        return 8;
+      default:
+        // runtime arrays have no size of their own
+        return 0;
+      }
+    }
+
+  private:
+    void parse(uint32_t opcode, uint32_t offset, uint32_t word_count)
+    {
+      switch (opcode)
+      {
+      case OpName:
+        id_at(word(offset, 1)).name = string(offset, 2);
+        break;
+      case OpDecorate:
+      {
+        auto &target = id_at(word(offset, 1));
+        auto value = word_count > 3 ? word(offset, 3) : 0;
+        switch (word(offset, 2))
+        {
+        case DecorationSpecId:
+          target.spec_id = value;
+          break;
+        case DecorationBufferBlock:
+          target.buffer_block = true;
+          break;
+        case DecorationArrayStride:
+          target.array_stride = value;
+          break;
+        case DecorationBuiltIn:
+          target.built_in = value;
+          break;
+        case DecorationBinding:
+          target.binding = value;
+          break;
+        case DecorationDescriptorSet:
+          target.set = value;
+          break;
+        }
+        break;
+      }
+      case OpMemberDecorate:
+      {
+        auto &target = id_at(word(offset, 1));
+        auto member = word(offset, 2);
+        auto decoration = word(offset, 3);
+        if (decoration == DecorationOffset || decoration == DecorationMatrixStride)
+        {
+          auto &values = decoration == DecorationOffset ? target.member_offsets : target.member_matrix_strides;
+          values.resize(std::max<size_t>(values.size(), member + 1), 0);
+          values[member] = word(offset, 4);
+        }
+        break;
+      }
+      case OpTypeBool:
+      case OpTypeInt:
+      case OpTypeFloat:
+      case OpTypeVector:
+      case OpTypeMatrix:
+      case OpTypeImage:
+      case OpTypeSampler:
+      case OpTypeSampledImage:
+      case OpTypeArray:
+      case OpTypeRuntimeArray:
+      case OpTypeStruct:
+      case OpTypePointer:
+      case OpTypeAccelerationStructureKHR:
+        define(word(offset, 1), opcode, offset);
+        break;
+      case OpConstantTrue:
+      case OpConstantFalse:
+      case OpConstant:
+      case OpConstantComposite:
+      case OpSpecConstantTrue:
+      case OpSpecConstantFalse:
+      case OpSpecConstant:
+      case OpSpecConstantComposite:
+      case OpVariable:
+        define(word(offset, 2), opcode, offset);
+        break;
+      }
+    }
+
+    Id &id_at(uint32_t id)
+    {
+      if (id >= m_ids.size())
+      {
+        throw std::runtime_error("SPIR-V id " + std::to_string(id) + " is out of bounds");
+      }
+      return m_ids[id];
+    }
+
+    void define(uint32_t id, uint32_t opcode, uint32_t offset)
+    {
+      auto &info = id_at(id);
+      info.opcode = opcode;
+      info.offset = offset;
+    }
+
+  private:
+    const std::vector<uint32_t> &m_code;
+
+    std::vector<Id> m_ids;
+
+    std::vector<uint32_t> m_instructions;
+  };
+
+  VkDescriptorType descriptor_type(const Parser &parser, uint32_t storage_class, uint32_t type, VkFormat &format)
+  {
+    const auto &info = parser.id(type);
+
+    if (storage_class == StorageClassStorageBuffer || (storage_class == StorageClassUniform && info.buffer_block))
+    {
+      return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+    if (storage_class == StorageClassUniform)
+    {
+      return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    }
+
+    switch (info.opcode)
+    {
+    case OpTypeSampler:
+      return VK_DESCRIPTOR_TYPE_SAMPLER;
+    case OpTypeSampledImage:
+      return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    case OpTypeAccelerationStructureKHR:
+      return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+    case OpTypeImage:
+    {
+      auto dim = parser.word(info.offset, 3);
+      auto sampled = parser.word(info.offset, 7);
+      auto image_format = parser.word(info.offset, 8);
+      format = image_format < std::size(IMAGE_FORMATS) ? IMAGE_FORMATS[image_format] : VK_FORMAT_UNDEFINED;
+
+      if (dim == DIM_SUBPASS_DATA)
+      {
+        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+      }
+      if (dim == DIM_BUFFER)
+      {
+        return sampled == 1 ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+      }
+      return sampled == 1 ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    }
+    default:
+      throw std::runtime_error("Unsupported SPIR-V resource type");
+    }
+  }
+}
+
+ShaderReflection::ShaderReflection(const ShaderModule &shader_module)
+    : ShaderReflection(shader_module.get_code(), shader_module.get_entry_point())
+{
+}
+
+ShaderReflection::ShaderReflection(const std::vector<uint32_t> &code, const std::string &entry_point)
+{
+  Parser parser(code);
+
+  uint32_t entry_point_id = UINT32_MAX;
+  for (auto offset : parser.instructions())
+  {
+    if (parser.opcode(offset) == OpEntryPoint && parser.string(offset, 3) == entry_point)
+    {
+      m_stages = shader_stage(parser.word(offset, 1));
+      entry_point_id = parser.word(offset, 2);
+      break;
+    }
+  }
+
+  if (entry_point_id == UINT32_MAX)
+  {
+    throw std::runtime_error("SPIR-V entry point " + entry_point + " not found");
+  }
+
+  for (auto offset : parser.instructions())
+  {
+    auto opcode = parser.opcode(offset);
+
+    if ((opcode == OpExecutionMode || opcode == OpExecutionModeId) && parser.word(offset, 1) == entry_point_id)
+    {
+      auto mode = parser.word(offset, 2);
+      if (opcode == OpExecutionMode && mode == EXECUTION_MODE_LOCAL_SIZE)
+      {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+          m_workgroup_size[i] = parser.word(offset, 3 + i);
+        }
+      }
+      else if (opcode == OpExecutionModeId && mode == EXECUTION_MODE_LOCAL_SIZE_ID)
+      {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+          auto component = parser.word(offset, 3 + i);
+          m_workgroup_size[i] = parser.constant(component);
+          m_workgroup_size_ids[i] = parser.id(component).spec_id;
+        }
+      }
+    }
+    else if (opcode == OpSpecConstantTrue || opcode == OpSpecConstantFalse || opcode == OpSpecConstant)
+    {
+      const auto &constant = parser.id(parser.word(offset, 2));
+      if (constant.spec_id == UINT32_MAX)
+      {
+        continue;
+      }
+
+      SpecializationConstant specialization_constant{};
+      specialization_constant.id = constant.spec_id;
+      specialization_constant.size = opcode == OpSpecConstant ? parser.size_of(parser.word(offset, 1)) : 4;
+      specialization_constant.default_value = opcode == OpSpecConstantTrue ? 1 : 0;
+      if (opcode == OpSpecConstant)
+      {
+        specialization_constant.default_value = parser.word(offset, 3);
+        if (parser.word_count(offset) > 4)
+        {
+          specialization_constant.default_value |= static_cast<uint64_t>(parser.word(offset, 4)) << 32;
+        }
+      }
+      specialization_constant.name = constant.name;
+      m_specialization_constants.push_back(specialization_constant);
+    }
+    else if ((opcode == OpConstantComposite || opcode == OpSpecConstantComposite) &&
+             parser.id(parser.word(offset, 2)).built_in == BUILT_IN_WORKGROUP_SIZE)
+    {
+      // the gl_WorkGroupSize constant takes precedence over the execution mode
+      for (uint32_t i = 0; i < 3; ++i)
+      {
+        auto component = parser.word(offset, 3 + i);
+        m_workgroup_size[i] = parser.constant(component);
+        m_workgroup_size_ids[i] = parser.id(component).spec_id;
+      }
+    }
+    else if (opcode == OpVariable)
+    {
+      const auto &variable = parser.id(parser.word(offset, 2));
+      auto storage_class = parser.word(offset, 3);
+      // the pointee of the variable's pointer type
+      auto type = parser.word(parser.id(parser.word(offset, 1)).offset, 3);
+
+      if (storage_class == StorageClassPushConstant)
+      {
+        const auto &block = parser.id(type);
+        auto begin = block.member_offsets.empty() ? 0 : *std::min_element(block.member_offsets.begin(), block.member_offsets.end());
+        m_push_constant_ranges.push_back({m_stages, begin, parser.size_of(type) - begin});
+        continue;
+      }
+
+      if (storage_class != StorageClassUniformConstant && storage_class != StorageClassUniform &&
+          storage_class != StorageClassStorageBuffer)
+      {
+        continue;
+      }
+
+      if (variable.binding == UINT32_MAX)
+      {
+        continue;
+      }
+
+      Binding binding{};
+      binding.set = variable.set != UINT32_MAX ? variable.set : 0;
+      binding.binding = variable.binding;
+      binding.count = 1;
+      binding.stages = m_stages;
+      binding.format = VK_FORMAT_UNDEFINED;
+
+      while (parser.id(type).opcode == OpTypeArray || parser.id(type).opcode == OpTypeRuntimeArray)
+      {
+        const auto &array = parser.id(type);
+        binding.count = array.opcode == OpTypeArray ? binding.count * parser.constant(parser.word(array.offset, 3)) : 0;
+        type = parser.word(array.offset, 2);
+      }
+
+      binding.type = descriptor_type(parser, storage_class, type, binding.format);
+      // blocks without an instance name are known by their type
+      binding.name = !variable.name.empty() ? variable.name : parser.id(type).name;
+
+      m_bindings.push_back(binding);
+    }
+  }
+
+  std::sort(m_bindings.begin(), m_bindings.end(), [](const Binding &a, const Binding &b)
+            { return a.set != b.set ? a.set < b.set : a.binding < b.binding; });
+}
+
+ShaderReflection &ShaderReflection::merge(const ShaderReflection &other)
+{
+  m_stages |= other.m_stages;
+
+  for (const auto &other_binding : other.m_bindings)
+  {
+    auto it = std::find_if(m_bindings.begin(), m_bindings.end(), [&](const Binding &binding)
+                           { return binding.set == other_binding.set && binding.binding == other_binding.binding; });
+    if (it == m_bindings.end())
+    {
+      m_bindings.push_back(other_binding);
+      continue;
+    }
+
+    if (it->type != other_binding.type)
+    {
+      throw std::runtime_error("Binding " + std::to_string(it->binding) + " of set " + std::to_string(it->set) +
+                               " is declared as " + it->name + " and " + other_binding.name + " with different types");
+    }
+    it->stages |= other_binding.stages;
+    // a runtime array in either stage stays one
+    it->count = it->count != 0 && other_binding.count != 0 ? std::max(it->count, other_binding.count) : 0;
+  }
+
+  std::sort(m_bindings.begin(), m_bindings.end(), [](const Binding &a, const Binding &b)
+            { return a.set != b.set ? a.set < b.set : a.binding < b.binding; });
+
+  for (const auto &other_range : other.m_push_constant_ranges)
+  {
+    auto it = std::find_if(m_push_constant_ranges.begin(), m_push_constant_ranges.end(), [&](const VkPushConstantRange &range)
+                           { return range.offset == other_range.offset && range.size == other_range.size; });
+    if (it != m_push_constant_ranges.end())
+    {
+      it->stageFlags |= other_range.stageFlags;
+    }
+    else
+    {
+      m_push_constant_ranges.push_back(other_range);
+    }
+  }
+
+  for (const auto &other_constant : other.m_specialization_constants)
+  {
+    auto it = std::find_if(m_specialization_constants.begin(), m_specialization_constants.end(), [&](const SpecializationConstant &constant)
+                           { return constant.id == other_constant.id; });
+    if (it == m_specialization_constants.end())
+    {
+      m_specialization_constants.push_back(other_constant);
+    }
+  }
+
+  if (m_workgroup_size[0] == 0)
+  {
+    m_workgroup_size = other.m_workgroup_size;
+    m_workgroup_size_ids = other.m_workgroup_size_ids;
+  }
+
+  return *this;
+}
+
+VkShaderStageFlags ShaderReflection::get_stages() const
+{
+  return m_stages;
+}
+
+const std::vector<ShaderReflection::Binding> &ShaderReflection::get_bindings() const
+{
+  return m_bindings;
+}
+
+std::vector<DescriptorSetLayout::Bindings> ShaderReflection::get_descriptor_set_bindings(uint32_t runtime_array_count) const
+{
+  std::vector<DescriptorSetLayout::Bindings> sets;
+  for (const auto &binding : m_bindings)
+  {
+    if (binding.count == 0 && runtime_array_count == 0)
+    {
+      throw std::runtime_error("Binding " + std::to_string(binding.binding) + " of set " + std::to_string(binding.set) +
+                               " (" + binding.name + ") is a runtime array but no descriptor count was given");
+    }
+
+    if (binding.set >= sets.size())
+    {
+      sets.resize(binding.set + 1);
+    }
+    auto count = binding.count != 0 ? binding.count : runtime_array_count;
+    sets[binding.set].push_back({binding.binding, binding.type, count, binding.stages, nullptr});
+  }
+  return sets;
+}
+
+const std::vector<VkPushConstantRange> &ShaderReflection::get_push_constant_ranges() const
+{
+  return m_push_constant_ranges;
+}
+
+const std::vector<ShaderReflection::SpecializationConstant> &ShaderReflection::get_specialization_constants() const
+{
+  return m_specialization_constants;
+}
+
+const std::array<uint32_t, 3> &ShaderReflection::get_workgroup_size() const
+{
+  return m_workgroup_size;
+}
+
+const std::array<uint32_t, 3> &ShaderReflection::get_workgroup_size_ids() const
+{
+  return m_workgroup_size_ids;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+
+#include "prism/vulkan/descriptor_set_layout.h"
+
+namespace prism
+{
+  class ShaderModule;
+
+  // the resource interface of spir-v code: descriptor bindings, push constant ranges, specialization constants and
+  // the workgroup size. reflections of the stages of a pipeline are merged into one to create its layout
+  class ShaderReflection
+  {
+  public:
+    struct Binding
+    {
+      uint32_t set;
+      uint32_t binding;
+      VkDescriptorType type;
+      // zero for runtime arrays, the size is up to the layout
+      uint32_t count;
+      VkShaderStageFlags stages;
+      // the declared format of storage images and texel buffers, undefined when the shader leaves it open
+      VkFormat format;
+      std::string name;
+    };
+
+    struct SpecializationConstant
+    {
+      uint32_t id;
+      // in bytes, booleans are 4 like VkBool32
+      uint32_t size;
+      uint64_t default_value;
+      std::string name;
+    };
+
+  public:
+    ShaderReflection() = default;
+
+    ShaderReflection(const ShaderModule &shader_module);
+
+    // reflects the entry point of the given name, throws when the code is not valid spir-v
+    ShaderReflection(const std::vector<uint32_t> &code, const std::string &entry_point = "main");
+
+    // adds the resources of another stage, throws when both declare the same binding differently
+    ShaderReflection &merge(const ShaderReflection &other);
+
+    VkShaderStageFlags get_stages() const;
+
+    const std::vector<Binding> &get_bindings() const;
+
+    // one entry per set up to the highest set used, sets in between are empty. runtime arrays get the given
+    // descriptor count, throws when the code declares one and the count is zero
+    std::vector<DescriptorSetLayout::Bindings> get_descriptor_set_bindings(uint32_t runtime_array_count = 0) const;
+
+    const std::vector<VkPushConstantRange> &get_push_constant_ranges() const;
+
+    const std::vector<SpecializationConstant> &get_specialization_constants() const;
+
+    // zero for stages without a workgroup
+    const std::array<uint32_t, 3> &get_workgroup_size() const;
+
+    // the specialization constant of each workgroup dimension, UINT32_MAX where the size is fixed
+    const std::array<uint32_t, 3> &get_workgroup_size_ids() const;
+
+  private:
+    VkShaderStageFlags m_stages{0};
+
+    std::vector<Binding> m_bindings;
+
+    std::vector<VkPushConstantRange> m_push_constant_ranges;
+
+    std::vector<SpecializationConstant> m_specialization_constants;
+
+    std::array<uint32_t, 3> m_workgroup_size{0, 0, 0};
+
+    std::array<uint32_t, 3> m_workgroup_size_ids{UINT32_MAX, UINT32_MAX, UINT32_MAX};
+
+  }; // class ShaderReflection
+
+} // namespace prism
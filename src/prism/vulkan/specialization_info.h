@@ -0,0 +1,91 @@
+#pragma once
+
+#include <type_traits>
+
+namespace prism
+{
+  namespace detail
+  {
+    template <typename T>
+    struct MemberPointer;
+
+    template <typename Owner, typename Field>
+    struct MemberPointer<Field Owner::*>
+    {
+      using owner = Owner;
+      using field = Field;
+    };
+  } // namespace detail
+
+  // specialization constants taken from the fields of a struct. the constant id of each field is fixed at compile
+  // time next to the field it reads, e.g. add<0, &Constants::width>(), and the field type decides the size:
+  // 32 bit scalars, 64 bit scalars, or VkBool32 for bool constants
+  template <typename T>
+  class SpecializationInfo : public VkSpecializationInfo
+  {
+  public:
+    explicit SpecializationInfo(const T &data = {})
+        : VkSpecializationInfo{0, nullptr, sizeof(T), nullptr}, m_data(data)
+    {
+      pData = &m_data;
+    }
+
+    // the vulkan struct points into the object
+    SpecializationInfo(const SpecializationInfo &) = delete;
+
+    SpecializationInfo(SpecializationInfo &&) = delete;
+
+    ~SpecializationInfo() = default;
+
+    SpecializationInfo &operator=(const SpecializationInfo &) = delete;
+
+    SpecializationInfo &operator=(SpecializationInfo &&) = delete;
+
+    template <uint32_t ConstantId, auto Member>
+    SpecializationInfo &add()
+    {
+      using Pointer = detail::MemberPointer<decltype(Member)>;
+      using Field = typename Pointer::field;
+      static_assert(std::is_same_v<typename Pointer::owner, T>, "the member does not belong to the constant struct");
+      static_assert(std::is_arithmetic_v<Field> && (sizeof(Field) == 4 || sizeof(Field) == 8),
+                    "specialization constants are 32 or 64 bit scalars, use VkBool32 for bools");
+
+      for (const auto &entry : m_entries)
+      {
+        if (entry.constantID == ConstantId)
+        {
+          throw std::runtime_error("Specialization constant " + std::to_string(ConstantId) + " is mapped twice");
+        }
+      }
+
+      VkSpecializationMapEntry entry{};
+      entry.constantID = ConstantId;
+      entry.offset = static_cast<uint32_t>(reinterpret_cast<const char *>(&(m_data.*Member)) - reinterpret_cast<const char *>(&m_data));
+      entry.size = sizeof(Field);
+      m_entries.push_back(entry);
+
+      mapEntryCount = static_cast<uint32_t>(m_entries.size());
+      pMapEntries = m_entries.data();
+
+      return *this;
+    }
+
+    // changes apply to pipelines created afterwards
+    T &get_data()
+    {
+      return m_data;
+    }
+
+    const T &get_data() const
+    {
+      return m_data;
+    }
+
+  private:
+    T m_data;
+
+    std::vector<VkSpecializationMapEntry> m_entries;
+
+  }; // class SpecializationInfo
+
+} // namespace prism
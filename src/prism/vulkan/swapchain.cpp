@@ -131,6 +131,11 @@ const std::vector<SwapchainImage> &Swapchain::get_images() const
   return m_images;
 }
 
+std::vector<SwapchainImage> &Swapchain::get_images()
+{
+  return m_images;
+}
+
 VkResult Swapchain::acquire_next_image(uint64_t time_out,
                                        const Semaphore &semaphore,
                                        const Fence &fence,
@@ -0,0 +1,66 @@
+#include "prism/vulkan/timeline_semaphore.h"
+
+using namespace prism;
+
+TimelineSemaphore::TimelineSemaphore(const Device& device, uint64_t initial_value)
+  : m_device(device)
+{
+  VkSemaphoreTypeCreateInfo type_info = {};
+  type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  type_info.initialValue = initial_value;
+
+  VkSemaphoreCreateInfo create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  create_info.pNext = &type_info;
+  create_info.flags = 0;
+
+  VK_CHECK(vkCreateSemaphore(device.get_handle(), &create_info, nullptr, &m_handle));
+}
+
+TimelineSemaphore::TimelineSemaphore(TimelineSemaphore&& other) noexcept
+  : m_handle(std::exchange(other.m_handle, VK_NULL_HANDLE)),
+    m_device(other.m_device)
+{
+}
+
+TimelineSemaphore::~TimelineSemaphore()
+{
+  if (m_handle != VK_NULL_HANDLE)
+  {
+    vkDestroySemaphore(m_device.get_handle(), m_handle, nullptr);
+  }
+}
+
+VkSemaphore TimelineSemaphore::get_handle() const
+{
+  return m_handle;
+}
+
+uint64_t TimelineSemaphore::get_value() const
+{
+  uint64_t value;
+  VK_CHECK(vkGetSemaphoreCounterValue(m_device.get_handle(), m_handle, &value));
+  return value;
+}
+
+void TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const
+{
+  VkSemaphoreWaitInfo wait_info = {};
+  wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  wait_info.semaphoreCount = 1;
+  wait_info.pSemaphores = &m_handle;
+  wait_info.pValues = &value;
+
+  VK_CHECK(vkWaitSemaphores(m_device.get_handle(), &wait_info, timeout));
+}
+
+void TimelineSemaphore::signal(uint64_t value) const
+{
+  VkSemaphoreSignalInfo signal_info = {};
+  signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+  signal_info.semaphore = m_handle;
+  signal_info.value = value;
+
+  VK_CHECK(vkSignalSemaphore(m_device.get_handle(), &signal_info));
+}
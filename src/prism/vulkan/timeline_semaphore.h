@@ -0,0 +1,36 @@
+#pragma once
+
+#include "prism/vulkan/device.h"
+
+namespace prism
+{
+  class TimelineSemaphore
+  {
+  public:
+    TimelineSemaphore(const Device& device, uint64_t initial_value = 0);
+
+    TimelineSemaphore(const TimelineSemaphore&) = delete;
+
+    TimelineSemaphore(TimelineSemaphore&& other) noexcept;
+
+    ~TimelineSemaphore();
+
+    TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+
+    TimelineSemaphore& operator=(TimelineSemaphore&&) = delete;
+
+    VkSemaphore get_handle() const;
+
+    // the last value signaled on the gpu
+    uint64_t get_value() const;
+
+    void wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+    void signal(uint64_t value) const;
+
+  private:
+    VkSemaphore m_handle;
+
+    const Device& m_device;
+  };
+}
@@ -0,0 +1,346 @@
+#include "prism/vulkan/tlsf_allocator.h"
+
+#include "prism/vulkan/utils.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace prism;
+
+namespace
+{
+uint32_t find_lsb(uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<uint32_t>(index);
+#else
+  return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+}
+
+uint32_t find_msb(uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<uint32_t>(index);
+#else
+  return 63u - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+}
+
+} // namespace
+
+TlsfAllocator::TlsfAllocator(VkDeviceSize size)
+    : m_size(size)
+{
+  for (auto &heads : m_free_heads)
+  {
+    heads.fill(INVALID_NODE);
+  }
+
+  auto node = create_node();
+  m_nodes[node].offset = 0;
+  m_nodes[node].size = m_size;
+  insert_free_node(node);
+}
+
+bool TlsfAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment, Allocation &allocation)
+{
+  alignment = std::max<VkDeviceSize>(alignment, 1);
+  if (size == 0 || size > m_size || alignment > m_size)
+  {
+    return false;
+  }
+
+  uint32_t fl, sl;
+  mapping_search(size + alignment - 1, fl, sl);
+  if (fl >= FL_INDEX_COUNT)
+  {
+    return false;
+  }
+
+  auto node = find_free_node(fl, sl);
+  if (node == INVALID_NODE)
+  {
+    return false;
+  }
+
+  remove_free_node(node);
+
+  // carve the alignment padding off the front when it is large enough to be reused
+  auto aligned_offset = utils::align_up(m_nodes[node].offset, alignment);
+  auto front_padding = aligned_offset - m_nodes[node].offset;
+  if (front_padding >= MIN_FRAGMENT_SIZE)
+  {
+    auto front = node;
+    node = split_node(front, front_padding);
+    insert_free_node(front);
+    front_padding = 0;
+  }
+
+  if (m_nodes[node].size - front_padding - size >= MIN_FRAGMENT_SIZE)
+  {
+    auto back = split_node(node, front_padding + size);
+    insert_free_node(back);
+  }
+
+  auto &allocated = m_nodes[node];
+  allocated.free = false;
+  allocated.padding = allocated.size - size;
+
+  m_used_size += allocated.size;
+  m_padding_size += allocated.padding;
+  m_allocation_count++;
+
+  allocation.offset = aligned_offset;
+  allocation.size = size;
+  allocation.node = node;
+
+  return true;
+}
+
+void TlsfAllocator::free(uint32_t node)
+{
+  assert(node < m_nodes.size() && !m_nodes[node].free);
+
+  m_used_size -= m_nodes[node].size;
+  m_padding_size -= m_nodes[node].padding;
+  m_allocation_count--;
+
+  m_nodes[node].free = true;
+  m_nodes[node].padding = 0;
+
+  auto next = m_nodes[node].next_physical;
+  if (next != INVALID_NODE && m_nodes[next].free)
+  {
+    remove_free_node(next);
+    m_nodes[node].size += m_nodes[next].size;
+    m_nodes[node].next_physical = m_nodes[next].next_physical;
+    if (m_nodes[node].next_physical != INVALID_NODE)
+    {
+      m_nodes[m_nodes[node].next_physical].prev_physical = node;
+    }
+    release_node(next);
+  }
+
+  auto prev = m_nodes[node].prev_physical;
+  if (prev != INVALID_NODE && m_nodes[prev].free)
+  {
+    remove_free_node(prev);
+    m_nodes[prev].size += m_nodes[node].size;
+    m_nodes[prev].next_physical = m_nodes[node].next_physical;
+    if (m_nodes[prev].next_physical != INVALID_NODE)
+    {
+      m_nodes[m_nodes[prev].next_physical].prev_physical = prev;
+    }
+    release_node(node);
+    node = prev;
+  }
+
+  insert_free_node(node);
+}
+
+VkDeviceSize TlsfAllocator::get_size() const
+{
+  return m_size;
+}
+
+VkDeviceSize TlsfAllocator::get_used_size() const
+{
+  return m_used_size;
+}
+
+VkDeviceSize TlsfAllocator::get_free_size() const
+{
+  return m_size - m_used_size;
+}
+
+VkDeviceSize TlsfAllocator::get_padding_size() const
+{
+  return m_padding_size;
+}
+
+VkDeviceSize TlsfAllocator::get_largest_free_size() const
+{
+  if (m_fl_bitmap == 0)
+  {
+    return 0;
+  }
+
+  auto fl = find_msb(m_fl_bitmap);
+  auto sl = find_msb(m_sl_bitmaps[fl]);
+
+  VkDeviceSize largest = 0;
+  for (auto node = m_free_heads[fl][sl]; node != INVALID_NODE; node = m_nodes[node].next_free)
+  {
+    largest = std::max(largest, m_nodes[node].size);
+  }
+
+  return largest;
+}
+
+uint32_t TlsfAllocator::get_allocation_count() const
+{
+  return m_allocation_count;
+}
+
+bool TlsfAllocator::empty() const
+{
+  return m_allocation_count == 0;
+}
+
+void TlsfAllocator::mapping_insert(VkDeviceSize size, uint32_t &fl, uint32_t &sl)
+{
+  fl = find_msb(size);
+  if (fl < SL_INDEX_COUNT_LOG2)
+  {
+    sl = 0;
+    return;
+  }
+
+  sl = static_cast<uint32_t>(size >> (fl - SL_INDEX_COUNT_LOG2)) - SL_INDEX_COUNT;
+}
+
+void TlsfAllocator::mapping_search(VkDeviceSize size, uint32_t &fl, uint32_t &sl)
+{
+  // round up to the next bin so that every node in the bin found is large enough
+  auto msb = find_msb(size);
+  if (msb < SL_INDEX_COUNT_LOG2)
+  {
+    if (size != (VkDeviceSize{1} << msb))
+    {
+      msb++;
+    }
+    fl = msb;
+    sl = 0;
+    return;
+  }
+
+  auto round = (VkDeviceSize{1} << (msb - SL_INDEX_COUNT_LOG2)) - 1;
+  if (size > UINT64_MAX - round)
+  {
+    fl = FL_INDEX_COUNT;
+    sl = 0;
+    return;
+  }
+
+  mapping_insert(size + round, fl, sl);
+}
+
+uint32_t TlsfAllocator::find_free_node(uint32_t fl, uint32_t sl) const
+{
+  auto sl_bitmap = m_sl_bitmaps[fl] & (~0u << sl);
+  if (sl_bitmap == 0)
+  {
+    auto fl_bitmap = fl + 1 < FL_INDEX_COUNT ? m_fl_bitmap & (~uint64_t{0} << (fl + 1)) : 0;
+    if (fl_bitmap == 0)
+    {
+      return INVALID_NODE;
+    }
+
+    fl = find_lsb(fl_bitmap);
+    sl_bitmap = m_sl_bitmaps[fl];
+  }
+
+  sl = find_lsb(sl_bitmap);
+  return m_free_heads[fl][sl];
+}
+
+void TlsfAllocator::insert_free_node(uint32_t node)
+{
+  uint32_t fl, sl;
+  mapping_insert(m_nodes[node].size, fl, sl);
+
+  auto &head = m_free_heads[fl][sl];
+  m_nodes[node].free = true;
+  m_nodes[node].prev_free = INVALID_NODE;
+  m_nodes[node].next_free = head;
+  if (head != INVALID_NODE)
+  {
+    m_nodes[head].prev_free = node;
+  }
+  head = node;
+
+  m_fl_bitmap |= uint64_t{1} << fl;
+  m_sl_bitmaps[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::remove_free_node(uint32_t node)
+{
+  uint32_t fl, sl;
+  mapping_insert(m_nodes[node].size, fl, sl);
+
+  auto prev = m_nodes[node].prev_free;
+  auto next = m_nodes[node].next_free;
+  if (prev != INVALID_NODE)
+  {
+    m_nodes[prev].next_free = next;
+  }
+  if (next != INVALID_NODE)
+  {
+    m_nodes[next].prev_free = prev;
+  }
+
+  auto &head = m_free_heads[fl][sl];
+  if (head == node)
+  {
+    head = next;
+    if (head == INVALID_NODE)
+    {
+      m_sl_bitmaps[fl] &= ~(1u << sl);
+      if (m_sl_bitmaps[fl] == 0)
+      {
+        m_fl_bitmap &= ~(uint64_t{1} << fl);
+      }
+    }
+  }
+
+  m_nodes[node].free = false;
+  m_nodes[node].prev_free = INVALID_NODE;
+  m_nodes[node].next_free = INVALID_NODE;
+}
+
+uint32_t TlsfAllocator::split_node(uint32_t node, VkDeviceSize size)
+{
+  auto remainder = create_node();
+
+  auto &current = m_nodes[node];
+  auto &next = m_nodes[remainder];
+  next.offset = current.offset + size;
+  next.size = current.size - size;
+  next.prev_physical = node;
+  next.next_physical = current.next_physical;
+  if (next.next_physical != INVALID_NODE)
+  {
+    m_nodes[next.next_physical].prev_physical = remainder;
+  }
+
+  current.size = size;
+  current.next_physical = remainder;
+
+  return remainder;
+}
+
+uint32_t TlsfAllocator::create_node()
+{
+  if (!m_unused_nodes.empty())
+  {
+    auto node = m_unused_nodes.back();
+    m_unused_nodes.pop_back();
+    m_nodes[node] = Node{};
+    return node;
+  }
+
+  m_nodes.emplace_back();
+  return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void TlsfAllocator::release_node(uint32_t node)
+{
+  m_nodes[node] = Node{};
+  m_unused_nodes.push_back(node);
+}
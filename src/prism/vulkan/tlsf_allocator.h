@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+
+namespace prism
+{
+  // Two-level segregated fit allocator over an abstract range [0, size).
+  // It only manages offsets, the owner decides what memory the range refers to.
+  class TlsfAllocator
+  {
+  public:
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    struct Allocation
+    {
+      VkDeviceSize offset{0};
+      VkDeviceSize size{0};
+      uint32_t node{INVALID_NODE};
+    };
+
+  public:
+    explicit TlsfAllocator(VkDeviceSize size);
+
+    TlsfAllocator(const TlsfAllocator &) = delete;
+
+    TlsfAllocator(TlsfAllocator &&other) noexcept = default;
+
+    ~TlsfAllocator() = default;
+
+    TlsfAllocator &operator=(const TlsfAllocator &) = delete;
+
+    TlsfAllocator &operator=(TlsfAllocator &&) = delete;
+
+    bool allocate(VkDeviceSize size, VkDeviceSize alignment, Allocation &allocation);
+
+    void free(uint32_t node);
+
+    VkDeviceSize get_size() const;
+
+    VkDeviceSize get_used_size() const;
+
+    VkDeviceSize get_free_size() const;
+
+    VkDeviceSize get_padding_size() const;
+
+    VkDeviceSize get_largest_free_size() const;
+
+    uint32_t get_allocation_count() const;
+
+    bool empty() const;
+
+  private:
+    static constexpr uint32_t SL_INDEX_COUNT_LOG2 = 4;
+    static constexpr uint32_t SL_INDEX_COUNT = 1u << SL_INDEX_COUNT_LOG2;
+    static constexpr uint32_t FL_INDEX_COUNT = 64;
+    static constexpr VkDeviceSize MIN_FRAGMENT_SIZE = 64;
+
+    struct Node
+    {
+      VkDeviceSize offset{0};
+      VkDeviceSize size{0};
+      VkDeviceSize padding{0};
+      uint32_t prev_physical{INVALID_NODE};
+      uint32_t next_physical{INVALID_NODE};
+      uint32_t prev_free{INVALID_NODE};
+      uint32_t next_free{INVALID_NODE};
+      bool free{false};
+    };
+
+    static void mapping_insert(VkDeviceSize size, uint32_t &fl, uint32_t &sl);
+
+    static void mapping_search(VkDeviceSize size, uint32_t &fl, uint32_t &sl);
+
+    uint32_t find_free_node(uint32_t fl, uint32_t sl) const;
+
+    void insert_free_node(uint32_t node);
+
+    void remove_free_node(uint32_t node);
+
+    uint32_t split_node(uint32_t node, VkDeviceSize size);
+
+    uint32_t create_node();
+
+    void release_node(uint32_t node);
+
+  private:
+    VkDeviceSize m_size;
+
+    VkDeviceSize m_used_size{0};
+
+    VkDeviceSize m_padding_size{0};
+
+    uint32_t m_allocation_count{0};
+
+    uint64_t m_fl_bitmap{0};
+
+    std::array<uint32_t, FL_INDEX_COUNT> m_sl_bitmaps{};
+
+    std::array<std::array<uint32_t, SL_INDEX_COUNT>, FL_INDEX_COUNT> m_free_heads{};
+
+    std::vector<Node> m_nodes;
+
+    std::vector<uint32_t> m_unused_nodes;
+
+  }; // class TlsfAllocator
+
+} // namespace prism
@@ -0,0 +1,437 @@
+#include "prism/vulkan/tlsf_memory_allocator.h"
+
+#include <algorithm>
+
+#include "prism/vulkan/device.h"
+
+using namespace prism;
+
+TlsfMemoryAllocator::TlsfMemoryAllocator(const Device &device, VkDeviceSize preferred_block_size)
+    : MemoryAllocator(device), m_preferred_block_size(preferred_block_size)
+{
+}
+
+TlsfMemoryAllocator::~TlsfMemoryAllocator()
+{
+  for (auto &pool : m_pools)
+  {
+    for (auto &block : pool.blocks)
+    {
+      if (block.memory == VK_NULL_HANDLE)
+      {
+        continue;
+      }
+
+      if (!block.allocator->empty())
+      {
+        LOG_WARN("Memory block of type {} destroyed with {} live allocations", pool.memory_type_index, block.allocator->get_allocation_count());
+      }
+
+      vkFreeMemory(m_device.get_handle(), block.memory, nullptr);
+    }
+  }
+
+  for (auto &dedicated : m_dedicated_allocations)
+  {
+    vkFreeMemory(m_device.get_handle(), dedicated.first, nullptr);
+  }
+}
+
+MemoryAllocator::Backend TlsfMemoryAllocator::get_backend() const
+{
+  return Backend::Tlsf;
+}
+
+MemoryAllocator::Allocation TlsfMemoryAllocator::allocate(const AllocateInfo &info)
+{
+  // ahead of the lock, the budget check reads the pools through get_budgets()
+  auto memory_type_index = find_memory_type(info);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  Allocation allocation{};
+  allocation.size = info.requirements.size;
+  allocation.memory_type_index = memory_type_index;
+
+  auto pool_index = get_pool_index(allocation.memory_type_index, info.allocate_flags, info.linear);
+  auto &pool = m_pools[pool_index];
+
+  if (info.dedicated || info.requirements.size > pool.block_size / 2)
+  {
+    VkMemoryDedicatedAllocateInfo dedicated_info{};
+    dedicated_info.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicated_info.buffer = info.dedicated_buffer;
+    dedicated_info.image = info.dedicated_image;
+
+    auto has_dedicated_info = info.dedicated && (info.dedicated_buffer != VK_NULL_HANDLE || info.dedicated_image != VK_NULL_HANDLE);
+
+    allocation.memory = allocate_device_memory(info.requirements.size, allocation.memory_type_index, info.allocate_flags, has_dedicated_info ? &dedicated_info : nullptr);
+    allocation.offset = 0;
+    allocation.memory_size = info.requirements.size;
+
+    DedicatedAllocation dedicated{};
+    dedicated.memory = allocation.memory;
+    dedicated.size = info.requirements.size;
+    dedicated.memory_type_index = allocation.memory_type_index;
+    m_dedicated_allocations[allocation.memory] = dedicated;
+
+    return allocation;
+  }
+
+  allocation.pool_index = pool_index;
+  allocation.memory_size = pool.block_size;
+
+  TlsfAllocator::Allocation range{};
+  for (uint32_t i = 0; i < pool.blocks.size(); ++i)
+  {
+    auto &block = pool.blocks[i];
+    if (block.memory != VK_NULL_HANDLE && block.allocator->allocate(info.requirements.size, info.requirements.alignment, range))
+    {
+      allocation.memory = block.memory;
+      allocation.offset = range.offset;
+      allocation.block_index = i;
+      allocation.node = range.node;
+      return allocation;
+    }
+  }
+
+  // no block had room, reuse a released slot or append a new block
+  uint32_t block_index = static_cast<uint32_t>(pool.blocks.size());
+  for (uint32_t i = 0; i < pool.blocks.size(); ++i)
+  {
+    if (pool.blocks[i].memory == VK_NULL_HANDLE)
+    {
+      block_index = i;
+      break;
+    }
+  }
+  if (block_index == pool.blocks.size())
+  {
+    pool.blocks.emplace_back();
+  }
+
+  auto &block = pool.blocks[block_index];
+  block.memory = allocate_device_memory(pool.block_size, pool.memory_type_index, pool.allocate_flags);
+  block.allocator = std::make_unique<TlsfAllocator>(pool.block_size);
+  block.mapped_data = nullptr;
+  block.map_count = 0;
+
+  if (!block.allocator->allocate(info.requirements.size, info.requirements.alignment, range))
+  {
+    throw std::runtime_error("Failed to sub-allocate from a new memory block");
+  }
+
+  allocation.memory = block.memory;
+  allocation.offset = range.offset;
+  allocation.block_index = block_index;
+  allocation.node = range.node;
+
+  return allocation;
+}
+
+void TlsfMemoryAllocator::free(const Allocation &allocation)
+{
+  if (allocation.memory == VK_NULL_HANDLE)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (allocation.pool_index == UINT32_MAX)
+  {
+    auto it = m_dedicated_allocations.find(allocation.memory);
+    assert(it != m_dedicated_allocations.end());
+
+    if (it->second.map_count > 0)
+    {
+      vkUnmapMemory(m_device.get_handle(), it->second.memory);
+    }
+    vkFreeMemory(m_device.get_handle(), it->second.memory, nullptr);
+    m_dedicated_allocations.erase(it);
+    return;
+  }
+
+  auto &pool = m_pools[allocation.pool_index];
+  auto &block = pool.blocks[allocation.block_index];
+  block.allocator->free(allocation.node);
+
+  if (!block.allocator->empty())
+  {
+    return;
+  }
+
+  // keep a single empty block per pool around so that create/destroy loops don't thrash the driver
+  auto empty_block_count = std::count_if(pool.blocks.begin(), pool.blocks.end(), [](const Block &other)
+                                         { return other.memory != VK_NULL_HANDLE && other.allocator->empty(); });
+  if (empty_block_count > 1)
+  {
+    if (block.map_count > 0)
+    {
+      vkUnmapMemory(m_device.get_handle(), block.memory);
+    }
+    vkFreeMemory(m_device.get_handle(), block.memory, nullptr);
+    block = Block{};
+  }
+}
+
+void *TlsfMemoryAllocator::map(const Allocation &allocation)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (allocation.pool_index == UINT32_MAX)
+  {
+    auto &dedicated = m_dedicated_allocations.at(allocation.memory);
+    return map_device_memory(dedicated.memory, dedicated.mapped_data, dedicated.map_count);
+  }
+
+  auto &block = m_pools[allocation.pool_index].blocks[allocation.block_index];
+  auto *data = static_cast<uint8_t *>(map_device_memory(block.memory, block.mapped_data, block.map_count));
+  return data + allocation.offset;
+}
+
+void TlsfMemoryAllocator::unmap(const Allocation &allocation)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (allocation.pool_index == UINT32_MAX)
+  {
+    auto &dedicated = m_dedicated_allocations.at(allocation.memory);
+    unmap_device_memory(dedicated.memory, dedicated.mapped_data, dedicated.map_count);
+    return;
+  }
+
+  auto &block = m_pools[allocation.pool_index].blocks[allocation.block_index];
+  unmap_device_memory(block.memory, block.mapped_data, block.map_count);
+}
+
+MemoryAllocator::Statistics TlsfMemoryAllocator::get_statistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  Statistics stats{};
+  for (const auto &pool : m_pools)
+  {
+    for (const auto &block : pool.blocks)
+    {
+      if (block.memory == VK_NULL_HANDLE)
+      {
+        continue;
+      }
+
+      stats.block_count++;
+      stats.allocation_count += block.allocator->get_allocation_count();
+      stats.block_bytes += block.allocator->get_size();
+      stats.allocation_bytes += block.allocator->get_used_size() - block.allocator->get_padding_size();
+      stats.wasted_bytes += block.allocator->get_padding_size();
+      stats.largest_free_bytes = std::max(stats.largest_free_bytes, block.allocator->get_largest_free_size());
+    }
+  }
+
+  for (const auto &dedicated : m_dedicated_allocations)
+  {
+    stats.block_count++;
+    stats.dedicated_allocation_count++;
+    stats.allocation_count++;
+    stats.block_bytes += dedicated.second.size;
+    stats.allocation_bytes += dedicated.second.size;
+  }
+
+  stats.free_bytes = stats.block_bytes - stats.allocation_bytes - stats.wasted_bytes;
+
+  if (stats.free_bytes > 0)
+  {
+    stats.fragmentation = 1.0f - static_cast<float>(stats.largest_free_bytes) / static_cast<float>(stats.free_bytes);
+  }
+
+  return stats;
+}
+
+std::vector<MemoryAllocator::Budget> TlsfMemoryAllocator::get_budgets() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  const auto &memory_properties = m_device.get_physical_device().get_memory_properties();
+
+  std::vector<Budget> budgets(memory_properties.memoryHeapCount);
+
+  // the driver knows the usage of the whole process and what the os leaves to it
+  if (m_device.check_extension_enable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+  {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget_properties{};
+    budget_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2 memory_properties2{};
+    memory_properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memory_properties2.pNext = &budget_properties;
+    vkGetPhysicalDeviceMemoryProperties2(m_device.get_physical_device().get_handle(), &memory_properties2);
+
+    for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i)
+    {
+      budgets[i].usage = budget_properties.heapUsage[i];
+      budgets[i].budget = budget_properties.heapBudget[i];
+    }
+
+    return budgets;
+  }
+
+  for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i)
+  {
+    budgets[i].budget = memory_properties.memoryHeaps[i].size;
+  }
+
+  for (const auto &pool : m_pools)
+  {
+    auto heap_index = memory_properties.memoryTypes[pool.memory_type_index].heapIndex;
+    for (const auto &block : pool.blocks)
+    {
+      if (block.memory != VK_NULL_HANDLE)
+      {
+        budgets[heap_index].usage += pool.block_size;
+      }
+    }
+  }
+
+  for (const auto &dedicated : m_dedicated_allocations)
+  {
+    auto heap_index = memory_properties.memoryTypes[dedicated.second.memory_type_index].heapIndex;
+    budgets[heap_index].usage += dedicated.second.size;
+  }
+
+  return budgets;
+}
+
+uint32_t TlsfMemoryAllocator::defragment()
+{
+  uint32_t move_count = 0;
+
+  for (const auto &relocatable : get_relocatables())
+  {
+    const auto &src = relocatable.allocation;
+
+    // dedicated allocations own their memory, there is nothing to compact
+    if (src.pool_index == UINT32_MAX)
+    {
+      continue;
+    }
+
+    auto dst = src;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      // only into blocks that are fuller than the source, the emptiest blocks drain and are released on free
+      auto &pool = m_pools[src.pool_index];
+      auto src_used_size = pool.blocks[src.block_index].allocator->get_used_size();
+
+      TlsfAllocator::Allocation range{};
+      for (uint32_t i = 0; i < pool.blocks.size(); ++i)
+      {
+        auto &block = pool.blocks[i];
+        if (i == src.block_index || block.memory == VK_NULL_HANDLE || block.allocator->get_used_size() <= src_used_size)
+        {
+          continue;
+        }
+
+        if (block.allocator->allocate(src.size, relocatable.alignment, range))
+        {
+          dst.memory = block.memory;
+          dst.offset = range.offset;
+          dst.block_index = i;
+          dst.node = range.node;
+          break;
+        }
+      }
+    }
+
+    if (dst.memory == src.memory)
+    {
+      continue;
+    }
+
+    if (!relocate(src, dst))
+    {
+      free(dst);
+      continue;
+    }
+
+    free(src);
+    move_count++;
+  }
+
+  return move_count;
+}
+
+uint32_t TlsfMemoryAllocator::get_pool_index(uint32_t memory_type_index, VkMemoryAllocateFlags allocate_flags, bool linear)
+{
+  // with a granularity of 1 linear and optimal resources can share blocks
+  const auto &properties = m_device.get_physical_device().get_properties();
+  if (properties.limits.bufferImageGranularity <= 1)
+  {
+    linear = true;
+  }
+
+  for (uint32_t i = 0; i < m_pools.size(); ++i)
+  {
+    const auto &pool = m_pools[i];
+    if (pool.memory_type_index == memory_type_index && pool.allocate_flags == allocate_flags && pool.linear == linear)
+    {
+      return i;
+    }
+  }
+
+  const auto &memory_properties = m_device.get_physical_device().get_memory_properties();
+  auto heap_size = memory_properties.memoryHeaps[memory_properties.memoryTypes[memory_type_index].heapIndex].size;
+
+  // small heaps (e.g. the 256MiB host visible device local window) get proportionally smaller blocks
+  Pool pool{};
+  pool.memory_type_index = memory_type_index;
+  pool.allocate_flags = allocate_flags;
+  pool.linear = linear;
+  pool.block_size = heap_size <= 1024ull * 1024 * 1024 ? heap_size / 8 : m_preferred_block_size;
+  m_pools.push_back(std::move(pool));
+
+  return static_cast<uint32_t>(m_pools.size() - 1);
+}
+
+VkDeviceMemory TlsfMemoryAllocator::allocate_device_memory(VkDeviceSize size, uint32_t memory_type_index, VkMemoryAllocateFlags allocate_flags, const void *next)
+{
+  VkMemoryAllocateFlagsInfo flags_info{};
+  flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+  flags_info.pNext = next;
+  flags_info.flags = allocate_flags;
+
+  VkMemoryAllocateInfo allocate_info{};
+  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocate_info.pNext = &flags_info;
+  allocate_info.allocationSize = size;
+  allocate_info.memoryTypeIndex = memory_type_index;
+
+  VkDeviceMemory memory;
+  VK_CHECK(vkAllocateMemory(m_device.get_handle(), &allocate_info, nullptr, &memory));
+
+  return memory;
+}
+
+void *TlsfMemoryAllocator::map_device_memory(VkDeviceMemory memory, void *&mapped_data, uint32_t &map_count)
+{
+  // a VkDeviceMemory can only be mapped once, so sub-allocations share one mapping of the whole block
+  if (map_count == 0)
+  {
+    VK_CHECK(vkMapMemory(m_device.get_handle(), memory, 0, VK_WHOLE_SIZE, 0, &mapped_data));
+  }
+
+  map_count++;
+  return mapped_data;
+}
+
+void TlsfMemoryAllocator::unmap_device_memory(VkDeviceMemory memory, void *&mapped_data, uint32_t &map_count)
+{
+  assert(map_count > 0);
+
+  map_count--;
+  if (map_count == 0)
+  {
+    vkUnmapMemory(m_device.get_handle(), memory);
+    mapped_data = nullptr;
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <mutex>
+
+#include "prism/vulkan/memory_allocator.h"
+#include "prism/vulkan/tlsf_allocator.h"
+
+namespace prism
+{
+  class TlsfMemoryAllocator : public MemoryAllocator
+  {
+  public:
+    TlsfMemoryAllocator(const Device &device, VkDeviceSize preferred_block_size = 256ull * 1024 * 1024);
+
+    ~TlsfMemoryAllocator() override;
+
+    Backend get_backend() const override;
+
+    Allocation allocate(const AllocateInfo &info) override;
+
+    void free(const Allocation &allocation) override;
+
+    void *map(const Allocation &allocation) override;
+
+    void unmap(const Allocation &allocation) override;
+
+    Statistics get_statistics() const override;
+
+    std::vector<Budget> get_budgets() const override;
+
+    uint32_t defragment() override;
+
+  private:
+    struct Block
+    {
+      VkDeviceMemory memory{VK_NULL_HANDLE};
+      std::unique_ptr<TlsfAllocator> allocator;
+      void *mapped_data{nullptr};
+      uint32_t map_count{0};
+    };
+
+    struct Pool
+    {
+      uint32_t memory_type_index{0};
+      VkMemoryAllocateFlags allocate_flags{0};
+      bool linear{true};
+      VkDeviceSize block_size{0};
+      std::vector<Block> blocks;
+    };
+
+    struct DedicatedAllocation
+    {
+      VkDeviceMemory memory{VK_NULL_HANDLE};
+      VkDeviceSize size{0};
+      uint32_t memory_type_index{0};
+      void *mapped_data{nullptr};
+      uint32_t map_count{0};
+    };
+
+    uint32_t get_pool_index(uint32_t memory_type_index, VkMemoryAllocateFlags allocate_flags, bool linear);
+
+    VkDeviceMemory allocate_device_memory(VkDeviceSize size, uint32_t memory_type_index, VkMemoryAllocateFlags allocate_flags, const void *next = nullptr);
+
+    void *map_device_memory(VkDeviceMemory memory, void *&mapped_data, uint32_t &map_count);
+
+    void unmap_device_memory(VkDeviceMemory memory, void *&mapped_data, uint32_t &map_count);
+
+  private:
+    VkDeviceSize m_preferred_block_size;
+
+    std::vector<Pool> m_pools;
+
+    std::map<VkDeviceMemory, DedicatedAllocation> m_dedicated_allocations;
+
+    mutable std::mutex m_mutex;
+
+  }; // class TlsfMemoryAllocator
+
+} // namespace prism
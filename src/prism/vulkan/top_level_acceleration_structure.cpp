@@ -0,0 +1,201 @@
+#include "prism/vulkan/top_level_acceleration_structure.h"
+
+#include <algorithm>
+
+using namespace prism;
+
+TopLevelAccelerationStructure::TopLevelAccelerationStructure(const Device &device, uint32_t capacity, uint32_t frames_in_flight, VkBuildAccelerationStructureFlagsKHR flags)
+    : m_device(device), m_capacity(capacity), m_flags(flags)
+{
+  m_instances.reserve(capacity);
+  m_changed.resize(capacity, false);
+  m_live.resize(capacity, false);
+
+  auto buffer_size = std::max<VkDeviceSize>(capacity, 1) * sizeof(VkAccelerationStructureInstanceKHR);
+
+  m_frames.resize(frames_in_flight);
+  for (auto &frame : m_frames)
+  {
+    frame.buffer = std::make_unique<Buffer>(m_device, buffer_size,
+                                            VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+    frame.memory = std::make_unique<DeviceMemory>(*frame.buffer, MemoryAllocator::Usage::Dynamic, 0, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT);
+    frame.buffer->bind_memory(*frame.memory);
+  }
+
+  // sized once for the full capacity, builds only ever use a prefix of it
+  std::vector<AccelerationStructureGeometry> geometries;
+  geometries.emplace_back(AccelerationStructureGeometry::Instances{m_frames.front().buffer->get_device_address(), VK_FALSE, capacity});
+
+  auto build_sizes = AccelerationStructure::get_build_sizes(m_device, VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR, geometries, m_flags);
+  m_acceleration_structure = std::make_unique<AccelerationStructure>(m_device, VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR, build_sizes.accelerationStructureSize, m_flags);
+  m_acceleration_structure->reserve_scratch(geometries);
+}
+
+uint32_t TopLevelAccelerationStructure::add(const AccelerationStructureInstance &instance)
+{
+  uint32_t slot;
+  if (!m_free_slots.empty())
+  {
+    slot = m_free_slots.back();
+    m_free_slots.pop_back();
+  }
+  else
+  {
+    if (m_instances.size() == m_capacity)
+    {
+      throw std::runtime_error("Top level acceleration structure is full");
+    }
+
+    slot = static_cast<uint32_t>(m_instances.size());
+    m_instances.emplace_back();
+  }
+
+  m_instances[slot] = instance.get_handle();
+  m_live[slot] = true;
+  mark_changed(slot);
+  m_rebuild = true;
+
+  return slot;
+}
+
+void TopLevelAccelerationStructure::set(uint32_t slot, const AccelerationStructureInstance &instance)
+{
+  check_live(slot);
+
+  // switching between active and inactive changes the primitives, a refit can only move them
+  auto was_active = m_instances[slot].accelerationStructureReference != 0;
+  auto is_active = instance.get_handle().accelerationStructureReference != 0;
+  if (was_active != is_active)
+  {
+    m_rebuild = true;
+  }
+
+  m_instances[slot] = instance.get_handle();
+  mark_changed(slot);
+}
+
+void TopLevelAccelerationStructure::set_transform(uint32_t slot, const VkTransformMatrixKHR &transform)
+{
+  check_live(slot);
+
+  m_instances[slot].transform = transform;
+  mark_changed(slot);
+}
+
+void TopLevelAccelerationStructure::remove(uint32_t slot)
+{
+  check_live(slot);
+
+  // a null reference makes the instance inactive, the slot keeps its place in the array
+  m_instances[slot] = {};
+  m_live[slot] = false;
+  mark_changed(slot);
+  m_free_slots.push_back(slot);
+  m_rebuild = true;
+}
+
+void TopLevelAccelerationStructure::build(const CommandBuffer &cmd_buffer)
+{
+  // adjacent changed slots become one range, every frame's buffer has to catch up on them
+  if (!m_changed_slots.empty())
+  {
+    std::sort(m_changed_slots.begin(), m_changed_slots.end());
+
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (auto slot : m_changed_slots)
+    {
+      if (!ranges.empty() && ranges.back().second == slot)
+      {
+        ranges.back().second = slot + 1;
+      }
+      else
+      {
+        ranges.emplace_back(slot, slot + 1);
+      }
+      m_changed[slot] = false;
+    }
+    m_changed_slots.clear();
+
+    for (auto &frame : m_frames)
+    {
+      frame.dirty_ranges.insert(frame.dirty_ranges.end(), ranges.begin(), ranges.end());
+    }
+  }
+
+  auto &frame = m_frames[m_frame_index];
+  m_frame_index = (m_frame_index + 1) % static_cast<uint32_t>(m_frames.size());
+
+  // ranges other frames added overlap, merge them before writing
+  std::sort(frame.dirty_ranges.begin(), frame.dirty_ranges.end());
+  uint32_t begin = 0;
+  uint32_t end = 0;
+  for (const auto &range : frame.dirty_ranges)
+  {
+    if (range.first > end)
+    {
+      if (end > begin)
+      {
+        frame.memory->upload(begin * sizeof(VkAccelerationStructureInstanceKHR), (end - begin) * sizeof(VkAccelerationStructureInstanceKHR), &m_instances[begin]);
+      }
+      begin = range.first;
+    }
+    end = std::max(end, range.second);
+  }
+  if (end > begin)
+  {
+    frame.memory->upload(begin * sizeof(VkAccelerationStructureInstanceKHR), (end - begin) * sizeof(VkAccelerationStructureInstanceKHR), &m_instances[begin]);
+  }
+  frame.dirty_ranges.clear();
+
+  auto count = static_cast<uint32_t>(m_instances.size());
+
+  std::vector<AccelerationStructureGeometry> geometries;
+  geometries.emplace_back(AccelerationStructureGeometry::Instances{frame.buffer->get_device_address(), VK_FALSE, count});
+
+  if (m_rebuild || count != m_built_count || !(m_flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR))
+  {
+    m_acceleration_structure->build(cmd_buffer, geometries);
+    m_rebuild = false;
+    m_built_count = count;
+  }
+  else
+  {
+    m_acceleration_structure->update(cmd_buffer, geometries);
+  }
+}
+
+const AccelerationStructure &TopLevelAccelerationStructure::get_acceleration_structure() const
+{
+  return *m_acceleration_structure;
+}
+
+uint32_t TopLevelAccelerationStructure::get_capacity() const
+{
+  return m_capacity;
+}
+
+uint32_t TopLevelAccelerationStructure::get_count() const
+{
+  return static_cast<uint32_t>(m_instances.size());
+}
+
+void TopLevelAccelerationStructure::check_live(uint32_t slot) const
+{
+  if (slot >= m_instances.size())
+  {
+    throw std::runtime_error("Instance slot " + std::to_string(slot) + " was never added");
+  }
+  if (!m_live[slot])
+  {
+    throw std::runtime_error("Instance slot " + std::to_string(slot) + " was already removed");
+  }
+}
+
+void TopLevelAccelerationStructure::mark_changed(uint32_t slot)
+{
+  if (!m_changed[slot])
+  {
+    m_changed[slot] = true;
+    m_changed_slots.push_back(slot);
+  }
+}
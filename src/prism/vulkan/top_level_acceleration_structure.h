@@ -0,0 +1,93 @@
+#pragma once
+
+#include "prism/vulkan/acceleration_structure.h"
+#include "prism/vulkan/acceleration_structure_instance.h"
+
+namespace prism
+{
+  // owns a top level structure and its instances. instances live in slots that keep their index until they are
+  // removed, removed slots stay in the array as inactive instances and are handed out again. every frame in flight has
+  // a persistently mapped instance buffer of its own, changed slots are merged into ranges and each buffer catches
+  // up on the ranges it missed when its frame comes around, so a frame writes only what changed and records one build
+  class TopLevelAccelerationStructure
+  {
+  public:
+    TopLevelAccelerationStructure(const Device &device, uint32_t capacity, uint32_t frames_in_flight,
+                                  VkBuildAccelerationStructureFlagsKHR flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR);
+
+    TopLevelAccelerationStructure(const TopLevelAccelerationStructure &) = delete;
+
+    TopLevelAccelerationStructure(TopLevelAccelerationStructure &&) = delete;
+
+    ~TopLevelAccelerationStructure() = default;
+
+    TopLevelAccelerationStructure &operator=(const TopLevelAccelerationStructure &) = delete;
+
+    TopLevelAccelerationStructure &operator=(TopLevelAccelerationStructure &&) = delete;
+
+    // returns the slot of the instance, throws when the capacity is reached
+    uint32_t add(const AccelerationStructureInstance &instance);
+
+    // set, set_transform and remove throw for slots that were never added or are already removed
+    void set(uint32_t slot, const AccelerationStructureInstance &instance);
+
+    void set_transform(uint32_t slot, const VkTransformMatrixKHR &transform);
+
+    void remove(uint32_t slot);
+
+    // called once per frame. writes the changed slots into this frame's instance buffer and records a refit, or a
+    // build when instances were added or removed. the writes are flushed with the frame's other host writes
+    void build(const CommandBuffer &cmd_buffer);
+
+    const AccelerationStructure &get_acceleration_structure() const;
+
+    uint32_t get_capacity() const;
+
+    // slots in use, removed ones included until they are handed out again
+    uint32_t get_count() const;
+
+  private:
+    struct Frame
+    {
+      std::unique_ptr<Buffer> buffer;
+      std::unique_ptr<DeviceMemory> memory;
+      // [begin, end) slot ranges changed since this buffer was last written
+      std::vector<std::pair<uint32_t, uint32_t>> dirty_ranges;
+    };
+
+    void check_live(uint32_t slot) const;
+
+    void mark_changed(uint32_t slot);
+
+  private:
+    const Device &m_device;
+
+    uint32_t m_capacity;
+
+    VkBuildAccelerationStructureFlagsKHR m_flags;
+
+    std::vector<VkAccelerationStructureInstanceKHR> m_instances;
+
+    std::vector<uint32_t> m_free_slots;
+
+    // slots handed out by add and not removed since
+    std::vector<bool> m_live;
+
+    std::vector<uint32_t> m_changed_slots;
+
+    std::vector<bool> m_changed;
+
+    std::vector<Frame> m_frames;
+
+    uint32_t m_frame_index{0};
+
+    std::unique_ptr<AccelerationStructure> m_acceleration_structure;
+
+    // instances were activated or deactivated, which a refit can not do
+    bool m_rebuild{true};
+
+    uint32_t m_built_count{0};
+
+  }; // class TopLevelAccelerationStructure
+
+} // namespace prism
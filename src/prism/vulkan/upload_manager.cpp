@@ -0,0 +1,478 @@
+#include "prism/vulkan/upload_manager.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "prism/vulkan/image.h"
+#include "prism/vulkan/utils.h"
+
+using namespace prism;
+
+UploadManager::UploadManager(const Device &device, bool transfer_queue, VkDeviceSize capacity)
+    : m_device(device),
+      m_capacity(capacity)
+{
+  const auto &physical_device = m_device.get_physical_device();
+  const auto &families = physical_device.get_queue_family_properties();
+
+  m_dst_queue_family_index = physical_device.get_queue_family_index(VK_QUEUE_GRAPHICS_BIT);
+
+  // take a second graphics queue when there is one so the render thread keeps its queue to itself. a dedicated
+  // transfer family runs copies alongside rendering, but only consumers that record acquire() can use its uploads
+  uint32_t family_index = m_dst_queue_family_index;
+  uint32_t queue_index = families[family_index].queueCount > 1 ? 1 : 0;
+  for (uint32_t i = 0; transfer_queue && i < families.size(); ++i)
+  {
+    auto flags = families[i].queueFlags;
+    if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+    {
+      family_index = i;
+      queue_index = 0;
+      break;
+    }
+  }
+  m_queue = &m_device.get_queue(family_index, queue_index);
+
+  LOG_INFO("Upload manager submits to queue family {} queue {}", family_index, queue_index);
+
+  m_cmd_pool = std::make_unique<CommandPool>(m_device, m_queue->get_family_index(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+
+  m_buffer = std::make_unique<Buffer>(m_device, m_capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+  m_memory = std::make_unique<DeviceMemory>(*m_buffer, MemoryAllocator::Usage::Upload, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  m_buffer->bind_memory(*m_memory);
+
+  // the ring stays mapped for its whole lifetime
+  void *data;
+  m_memory->map(0, m_capacity, 0, &data);
+  m_mapped_data = static_cast<uint8_t *>(data);
+
+  m_semaphore = std::make_unique<TimelineSemaphore>(m_device, 0);
+  m_batch.value = 1;
+}
+
+UploadManager::~UploadManager()
+{
+  wait_idle();
+
+  m_free_cmd_buffers.clear();
+
+  m_memory->unmap();
+  m_memory.reset();
+  m_buffer.reset();
+}
+
+uint64_t UploadManager::upload(const Buffer &dst, const void *data, VkDeviceSize size, VkDeviceSize dst_offset)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  retire(false);
+
+  auto region = stage(data, size, 16);
+
+  VkBufferCopy copy_region{};
+  copy_region.srcOffset = region.offset;
+  copy_region.dstOffset = dst_offset;
+  copy_region.size = size;
+  m_batch.buffer_copies.push_back({region.buffer, dst.get_handle(), copy_region});
+
+  if (transfers_ownership())
+  {
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    barrier.srcQueueFamilyIndex = m_queue->get_family_index();
+    barrier.dstQueueFamilyIndex = m_dst_queue_family_index;
+    barrier.buffer = dst.get_handle();
+    barrier.offset = dst_offset;
+    barrier.size = size;
+    m_batch.buffer_barriers.push_back(barrier);
+  }
+  m_batch.post_stages |= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+  return end_upload(size);
+}
+
+uint64_t UploadManager::upload(Image &dst, const void *data, VkDeviceSize size, VkImageLayout target_layout, VkImageAspectFlags aspect)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  retire(false);
+
+  // the batch records all layout transitions ahead of all copies, a second upload to the same image goes into the next batch
+  auto pending = std::any_of(m_batch.image_copies.begin(), m_batch.image_copies.end(), [&](const ImageCopy &copy) {
+    return copy.dst == dst.get_handle();
+  });
+  if (pending)
+  {
+    flush_batch();
+  }
+
+  const auto &limits = m_device.get_physical_device().get_properties().limits;
+  auto region = stage(data, size, std::max<VkDeviceSize>(16, limits.optimalBufferCopyOffsetAlignment));
+
+  VkImageSubresourceRange subresource_range{};
+  subresource_range.aspectMask = aspect;
+  subresource_range.baseMipLevel = 0;
+  subresource_range.levelCount = dst.get_mip_level_count();
+  subresource_range.baseArrayLayer = 0;
+  subresource_range.layerCount = dst.get_array_layer_count();
+
+  VkImageMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = dst.get_handle();
+  barrier.subresourceRange = subresource_range;
+
+  // a transfer only family cannot wait on graphics stages and does not own the image, its old contents are discarded
+  barrier.oldLayout = transfers_ownership() ? VK_IMAGE_LAYOUT_UNDEFINED : dst.get_layout();
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.srcAccessMask = utils::access_flags(barrier.oldLayout);
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  m_batch.pre_barriers.push_back(barrier);
+  m_batch.pre_stages |= utils::pipeline_stage_flags(barrier.oldLayout);
+
+  VkBufferImageCopy copy_region{};
+  copy_region.bufferOffset = region.offset;
+  copy_region.imageSubresource.aspectMask = aspect;
+  copy_region.imageSubresource.mipLevel = 0;
+  copy_region.imageSubresource.baseArrayLayer = 0;
+  copy_region.imageSubresource.layerCount = dst.get_array_layer_count();
+  copy_region.imageExtent = dst.get_extent();
+  m_batch.image_copies.push_back({region.buffer, dst.get_handle(), copy_region});
+
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = target_layout;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = utils::access_flags(target_layout);
+  if (transfers_ownership())
+  {
+    barrier.srcQueueFamilyIndex = m_queue->get_family_index();
+    barrier.dstQueueFamilyIndex = m_dst_queue_family_index;
+  }
+  m_batch.image_barriers.push_back(barrier);
+  m_batch.post_stages |= utils::pipeline_stage_flags(target_layout);
+
+  dst.update_layout(target_layout);
+
+  return end_upload(size);
+}
+
+uint64_t UploadManager::flush()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  flush_batch();
+
+  return m_batch.value - 1;
+}
+
+uint64_t UploadManager::get_token() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_last_token;
+}
+
+bool UploadManager::is_complete(uint64_t token) const
+{
+  return m_semaphore->get_value() >= token;
+}
+
+void UploadManager::wait(uint64_t token)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (token >= m_batch.value)
+    {
+      flush_batch();
+    }
+  }
+
+  m_semaphore->wait(token);
+}
+
+void UploadManager::wait_idle()
+{
+  wait(get_token());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  retire(false);
+}
+
+void UploadManager::acquire(const CommandBuffer &cmd_buffer, uint64_t token)
+{
+  std::vector<VkBufferMemoryBarrier> buffer_barriers;
+  std::vector<VkImageMemoryBarrier> image_barriers;
+  VkPipelineStageFlags stages = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (token >= m_batch.value)
+    {
+      flush_batch();
+    }
+
+    while (!m_acquires.empty() && m_acquires.front().value <= token)
+    {
+      auto &acquire = m_acquires.front();
+      buffer_barriers.insert(buffer_barriers.end(), acquire.buffer_barriers.begin(), acquire.buffer_barriers.end());
+      image_barriers.insert(image_barriers.end(), acquire.image_barriers.begin(), acquire.image_barriers.end());
+      stages |= acquire.stages;
+      m_acquires.pop_front();
+    }
+  }
+
+  if (buffer_barriers.empty() && image_barriers.empty())
+  {
+    return;
+  }
+
+  // the semaphore wait covers all commands, chaining the acquire behind it
+  cmd_buffer.pipeline_barrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, stages, 0, {}, buffer_barriers, image_barriers);
+}
+
+const TimelineSemaphore &UploadManager::get_semaphore() const
+{
+  return *m_semaphore;
+}
+
+VkDeviceSize UploadManager::get_capacity() const
+{
+  return m_capacity;
+}
+
+uint32_t UploadManager::get_queue_family_index() const
+{
+  return m_queue->get_family_index();
+}
+
+uint32_t UploadManager::get_dst_queue_family_index() const
+{
+  return m_dst_queue_family_index;
+}
+
+bool UploadManager::transfers_ownership() const
+{
+  return m_queue->get_family_index() != m_dst_queue_family_index;
+}
+
+UploadManager::StagingRegion UploadManager::stage(const void *data, VkDeviceSize size, VkDeviceSize alignment)
+{
+  auto region = allocate(size, alignment);
+  std::memcpy(region.data, data, size);
+
+  if (!m_batch.overflow_memories.empty() && m_batch.overflow_buffers.back()->get_handle() == region.buffer)
+  {
+    m_batch.overflow_memories.back()->unmap();
+  }
+
+  return region;
+}
+
+UploadManager::StagingRegion UploadManager::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+  if (size + alignment > m_capacity)
+  {
+    auto buffer = std::make_unique<Buffer>(m_device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    auto memory = std::make_unique<DeviceMemory>(*buffer, MemoryAllocator::Usage::Upload, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    buffer->bind_memory(*memory);
+
+    void *data;
+    memory->map(0, size, 0, &data);
+
+    StagingRegion region{buffer->get_handle(), 0, static_cast<uint8_t *>(data)};
+    m_batch.overflow_buffers.push_back(std::move(buffer));
+    m_batch.overflow_memories.push_back(std::move(memory));
+    return region;
+  }
+
+  while (true)
+  {
+    auto position = m_head % m_capacity;
+    auto offset = utils::align_up(position, alignment);
+    auto head = m_head + (offset - position);
+
+    // never split a region across the end of the ring
+    if (offset + size > m_capacity)
+    {
+      head = m_head + (m_capacity - position);
+      offset = 0;
+    }
+
+    if (head + size - m_tail <= m_capacity)
+    {
+      m_head = head + size;
+      m_batch.ring_end = m_head;
+      return {m_buffer->get_handle(), offset, m_mapped_data + offset};
+    }
+
+    // the pending batch holds part of the ring, get it going before waiting on anything
+    if (!m_batch.buffer_copies.empty() || !m_batch.image_copies.empty())
+    {
+      flush_batch();
+      continue;
+    }
+
+    if (m_in_flight.empty())
+    {
+      m_head = 0;
+      m_tail = 0;
+      m_batch.ring_end = 0;
+      continue;
+    }
+
+    retire(true);
+  }
+}
+
+uint64_t UploadManager::end_upload(VkDeviceSize size)
+{
+  m_last_token = m_batch.value;
+  m_batch.size += size;
+
+  // keep batches small enough that the ring never waits on a single huge one
+  if (m_batch.size >= m_capacity / 4)
+  {
+    flush_batch();
+  }
+
+  return m_last_token;
+}
+
+void UploadManager::flush_batch()
+{
+  if (m_batch.buffer_copies.empty() && m_batch.image_copies.empty())
+  {
+    return;
+  }
+
+  if (m_free_cmd_buffers.empty())
+  {
+    m_batch.cmd_buffer = std::make_unique<CommandBuffer>(*m_cmd_pool);
+  }
+  else
+  {
+    m_batch.cmd_buffer = std::move(m_free_cmd_buffers.back());
+    m_free_cmd_buffers.pop_back();
+    m_batch.cmd_buffer->reset();
+  }
+
+  const auto &cmd_buffer = *m_batch.cmd_buffer;
+  cmd_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+  if (!m_batch.pre_barriers.empty())
+  {
+    cmd_buffer.pipeline_barrier(m_batch.pre_stages, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, m_batch.pre_barriers);
+  }
+
+  for (const auto &copy : m_batch.buffer_copies)
+  {
+    vkCmdCopyBuffer(cmd_buffer.get_handle(), copy.src, copy.dst, 1, &copy.region);
+  }
+
+  for (const auto &copy : m_batch.image_copies)
+  {
+    vkCmdCopyBufferToImage(cmd_buffer.get_handle(), copy.src, copy.dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+  }
+
+  if (transfers_ownership())
+  {
+    // release half of the ownership transfer, the acquire half is handed out through acquire()
+    Acquire acquire{};
+    acquire.value = m_batch.value;
+    acquire.buffer_barriers = m_batch.buffer_barriers;
+    acquire.image_barriers = m_batch.image_barriers;
+    acquire.stages = m_batch.post_stages;
+
+    for (auto &barrier : m_batch.buffer_barriers)
+    {
+      barrier.dstAccessMask = 0;
+    }
+    for (auto &barrier : m_batch.image_barriers)
+    {
+      barrier.dstAccessMask = 0;
+    }
+    cmd_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, {}, m_batch.buffer_barriers, m_batch.image_barriers);
+
+    for (auto &barrier : acquire.buffer_barriers)
+    {
+      barrier.srcAccessMask = 0;
+    }
+    for (auto &barrier : acquire.image_barriers)
+    {
+      barrier.srcAccessMask = 0;
+    }
+    m_acquires.push_back(std::move(acquire));
+  }
+  else
+  {
+    std::vector<VkMemoryBarrier> memory_barriers;
+    if (!m_batch.buffer_copies.empty())
+    {
+      VkMemoryBarrier barrier{};
+      barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+      memory_barriers.push_back(barrier);
+    }
+    cmd_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, m_batch.post_stages, 0, memory_barriers, {}, m_batch.image_barriers);
+  }
+
+  cmd_buffer.end();
+
+  VkTimelineSemaphoreSubmitInfo timeline_info{};
+  timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timeline_info.signalSemaphoreValueCount = 1;
+  timeline_info.pSignalSemaphoreValues = &m_batch.value;
+
+  VkSemaphore semaphore = m_semaphore->get_handle();
+
+  VkSubmitInfo submit_info{};
+  submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submit_info.pNext = &timeline_info;
+  submit_info.commandBufferCount = 1;
+  submit_info.pCommandBuffers = &cmd_buffer.get_handle();
+  submit_info.signalSemaphoreCount = 1;
+  submit_info.pSignalSemaphores = &semaphore;
+
+  m_queue->submit(submit_info);
+
+  auto value = m_batch.value;
+  auto ring_end = m_batch.ring_end;
+  m_in_flight.push_back(std::move(m_batch));
+
+  m_batch = Batch{};
+  m_batch.value = value + 1;
+  m_batch.ring_end = ring_end;
+}
+
+void UploadManager::retire(bool wait_oldest)
+{
+  // batches complete in order on a single queue, so the ring is released front to back
+  auto completed = m_semaphore->get_value();
+  while (!m_in_flight.empty())
+  {
+    auto &batch = m_in_flight.front();
+    if (batch.value > completed)
+    {
+      if (!wait_oldest)
+      {
+        break;
+      }
+
+      m_semaphore->wait(batch.value);
+      completed = batch.value;
+      wait_oldest = false;
+    }
+
+    m_tail = batch.ring_end;
+
+    m_free_cmd_buffers.push_back(std::move(batch.cmd_buffer));
+    m_in_flight.pop_front();
+  }
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "prism/vulkan/buffer.h"
+#include "prism/vulkan/command_buffer.h"
+#include "prism/vulkan/command_pool.h"
+#include "prism/vulkan/device_memory.h"
+#include "prism/vulkan/timeline_semaphore.h"
+
+namespace prism
+{
+  class Image;
+
+  // uploads are staged into a persistent ring and recorded into batches that are submitted on the transfer queue,
+  // each upload returns a token, the timeline semaphore value that signals once its batch has completed.
+  // by default the transfer queue belongs to the graphics family, so uploaded resources need no ownership transfer.
+  // with transfer_queue a dedicated transfer family is taken when there is one, every submit that reads uploaded
+  // resources then has to record acquire() or their contents are undefined
+  class UploadManager
+  {
+  public:
+    UploadManager(const Device &device, bool transfer_queue = false, VkDeviceSize capacity = 64ull * 1024 * 1024);
+
+    UploadManager(const UploadManager &) = delete;
+
+    UploadManager(UploadManager &&) = delete;
+
+    ~UploadManager();
+
+    UploadManager &operator=(const UploadManager &) = delete;
+
+    UploadManager &operator=(UploadManager &&) = delete;
+
+    uint64_t upload(const Buffer &dst, const void *data, VkDeviceSize size, VkDeviceSize dst_offset = 0);
+
+    uint64_t upload(Image &dst, const void *data, VkDeviceSize size, VkImageLayout target_layout, VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+
+    // submits the pending batch, returns the token of the last submitted batch
+    uint64_t flush();
+
+    // token of the most recent upload, submitted or not
+    uint64_t get_token() const;
+
+    bool is_complete(uint64_t token) const;
+
+    void wait(uint64_t token);
+
+    // blocks until every upload issued so far has completed on the gpu
+    void wait_idle();
+
+    // records the queue family ownership acquire of everything up to token into a command buffer of the
+    // destination family, the submission of that command buffer has to wait on the semaphore for token.
+    // records nothing unless the manager was created with transfer_queue
+    void acquire(const CommandBuffer &cmd_buffer, uint64_t token);
+
+    const TimelineSemaphore &get_semaphore() const;
+
+    VkDeviceSize get_capacity() const;
+
+    uint32_t get_queue_family_index() const;
+
+    uint32_t get_dst_queue_family_index() const;
+
+  private:
+    struct StagingRegion
+    {
+      VkBuffer buffer{VK_NULL_HANDLE};
+      VkDeviceSize offset{0};
+      uint8_t *data{nullptr};
+    };
+
+    struct BufferCopy
+    {
+      VkBuffer src;
+      VkBuffer dst;
+      VkBufferCopy region;
+    };
+
+    struct ImageCopy
+    {
+      VkBuffer src;
+      VkImage dst;
+      VkBufferImageCopy region;
+    };
+
+    struct Batch
+    {
+      uint64_t value{0};
+      VkDeviceSize size{0};
+      // ring position that becomes free once the batch has completed
+      VkDeviceSize ring_end{0};
+
+      std::vector<BufferCopy> buffer_copies;
+      std::vector<ImageCopy> image_copies;
+
+      // transitions into TRANSFER_DST_OPTIMAL ahead of the copies
+      std::vector<VkImageMemoryBarrier> pre_barriers;
+      VkPipelineStageFlags pre_stages{0};
+
+      // transitions to the target layouts and ownership releases after the copies
+      std::vector<VkBufferMemoryBarrier> buffer_barriers;
+      std::vector<VkImageMemoryBarrier> image_barriers;
+      VkPipelineStageFlags post_stages{0};
+
+      std::unique_ptr<CommandBuffer> cmd_buffer;
+
+      // uploads larger than the ring get a staging buffer of their own
+      std::vector<std::unique_ptr<Buffer>> overflow_buffers;
+      std::vector<std::unique_ptr<DeviceMemory>> overflow_memories;
+    };
+
+    struct Acquire
+    {
+      uint64_t value{0};
+      std::vector<VkBufferMemoryBarrier> buffer_barriers;
+      std::vector<VkImageMemoryBarrier> image_barriers;
+      VkPipelineStageFlags stages{0};
+    };
+
+    bool transfers_ownership() const;
+
+    StagingRegion stage(const void *data, VkDeviceSize size, VkDeviceSize alignment);
+
+    StagingRegion allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+    uint64_t end_upload(VkDeviceSize size);
+
+    void flush_batch();
+
+    void retire(bool wait_oldest);
+
+  private:
+    const Device &m_device;
+
+    const Queue *m_queue{nullptr};
+
+    // family that receives ownership of the uploaded resources
+    uint32_t m_dst_queue_family_index;
+
+    std::unique_ptr<CommandPool> m_cmd_pool;
+
+    std::unique_ptr<Buffer> m_buffer;
+
+    std::unique_ptr<DeviceMemory> m_memory;
+
+    uint8_t *m_mapped_data{nullptr};
+
+    VkDeviceSize m_capacity;
+
+    // monotonic byte counters, the ring position is the counter modulo the capacity
+    VkDeviceSize m_head{0};
+    VkDeviceSize m_tail{0};
+
+    std::unique_ptr<TimelineSemaphore> m_semaphore;
+
+    Batch m_batch;
+
+    uint64_t m_last_token{0};
+
+    std::deque<Batch> m_in_flight;
+
+    std::deque<Acquire> m_acquires;
+
+    std::vector<std::unique_ptr<CommandBuffer>> m_free_cmd_buffers;
+
+    mutable std::mutex m_mutex;
+
+  }; // class UploadManager
+
+} // namespace prism
@@ -16,6 +16,23 @@ namespace prism
 
     void submit_commands_to_queue(const CommandPool& cmd_pool, const Queue& queue, const std::function<void(const CommandBuffer&)>& func);
 
+    VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment);
+
+    VkAccessFlags access_flags(VkImageLayout layout);
+
+    VkPipelineStageFlags pipeline_stage_flags(VkImageLayout layout);
+
+    bool is_write_access(VkAccessFlags2 access);
+
+    // fnv-1a, stable across runs so it can be stored in files
+    uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+    template <typename T>
+    void hash_combine(uint64_t &seed, const T &value)
+    {
+      seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
   } // namespace utils
 
 } // namespace prism
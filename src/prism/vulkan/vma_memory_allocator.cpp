@@ -0,0 +1,271 @@
+#define VMA_STATIC_VULKAN_FUNCTIONS 0
+#define VMA_DYNAMIC_VULKAN_FUNCTIONS 1
+#define VMA_IMPLEMENTATION
+#include "prism/vulkan/vma_memory_allocator.h"
+
+#include "prism/vulkan/device.h"
+
+using namespace prism;
+
+VmaMemoryAllocator::VmaMemoryAllocator(const Device &device)
+    : MemoryAllocator(device)
+{
+  VmaVulkanFunctions vulkan_functions{};
+  vulkan_functions.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
+  vulkan_functions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
+
+  VmaAllocatorCreateInfo allocator_info{};
+  allocator_info.vulkanApiVersion = VK_API_VERSION_1_3;
+  allocator_info.pVulkanFunctions = &vulkan_functions;
+  allocator_info.physicalDevice = m_device.get_physical_device().get_handle();
+  allocator_info.device = m_device.get_handle();
+  allocator_info.instance = volkGetLoadedInstance();
+
+  if (m_device.check_extension_enable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+  {
+    allocator_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+  }
+
+  if (m_device.check_extension_enable(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME))
+  {
+    allocator_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
+  }
+
+  if (m_device.check_extension_enable(VK_AMD_DEVICE_COHERENT_MEMORY_EXTENSION_NAME))
+  {
+    allocator_info.flags |= VMA_ALLOCATOR_CREATE_AMD_DEVICE_COHERENT_MEMORY_BIT;
+  }
+
+  VK_CHECK(vmaCreateAllocator(&allocator_info, &m_handle));
+}
+
+VmaMemoryAllocator::~VmaMemoryAllocator()
+{
+  for (auto &pool : m_pools)
+  {
+    vmaDestroyPool(m_handle, pool.handle);
+  }
+
+  if (m_handle != VK_NULL_HANDLE)
+  {
+    vmaDestroyAllocator(m_handle);
+  }
+}
+
+MemoryAllocator::Backend VmaMemoryAllocator::get_backend() const
+{
+  return Backend::Vma;
+}
+
+MemoryAllocator::Allocation VmaMemoryAllocator::allocate(const AllocateInfo &info)
+{
+  VmaAllocationCreateInfo create_info{};
+  create_info.usage = VMA_MEMORY_USAGE_UNKNOWN;
+  create_info.requiredFlags = info.property_flags;
+  // the type is ranked by the base allocator, vma only places the allocation
+  create_info.memoryTypeBits = 1u << find_memory_type(info);
+
+  if (info.dedicated)
+  {
+    create_info.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+  }
+
+  // host visible memory stays mapped for its whole lifetime, map() then only hands out the pointer
+  if (info.property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+  {
+    create_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  }
+
+  if (info.allocate_flags != 0)
+  {
+    create_info.pool = get_pool(info.requirements.memoryTypeBits, create_info, info.allocate_flags);
+  }
+
+  VmaAllocation vma_allocation;
+  if (info.dedicated_buffer != VK_NULL_HANDLE)
+  {
+    VK_CHECK(vmaAllocateMemoryForBuffer(m_handle, info.dedicated_buffer, &create_info, &vma_allocation, nullptr));
+  }
+  else if (info.dedicated_image != VK_NULL_HANDLE)
+  {
+    VK_CHECK(vmaAllocateMemoryForImage(m_handle, info.dedicated_image, &create_info, &vma_allocation, nullptr));
+  }
+  else
+  {
+    VK_CHECK(vmaAllocateMemory(m_handle, &info.requirements, &create_info, &vma_allocation, nullptr));
+  }
+
+  return to_allocation(vma_allocation);
+}
+
+void VmaMemoryAllocator::free(const Allocation &allocation)
+{
+  if (allocation.handle == nullptr)
+  {
+    return;
+  }
+
+  vmaFreeMemory(m_handle, static_cast<VmaAllocation>(allocation.handle));
+}
+
+void *VmaMemoryAllocator::map(const Allocation &allocation)
+{
+  void *data;
+  VK_CHECK(vmaMapMemory(m_handle, static_cast<VmaAllocation>(allocation.handle), &data));
+  return data;
+}
+
+void VmaMemoryAllocator::unmap(const Allocation &allocation)
+{
+  vmaUnmapMemory(m_handle, static_cast<VmaAllocation>(allocation.handle));
+}
+
+MemoryAllocator::Statistics VmaMemoryAllocator::get_statistics() const
+{
+  VmaTotalStatistics total{};
+  vmaCalculateStatistics(m_handle, &total);
+
+  Statistics stats{};
+  stats.block_count = total.total.statistics.blockCount;
+  stats.allocation_count = total.total.statistics.allocationCount;
+  stats.block_bytes = total.total.statistics.blockBytes;
+  stats.allocation_bytes = total.total.statistics.allocationBytes;
+  stats.free_bytes = stats.block_bytes - stats.allocation_bytes;
+  stats.largest_free_bytes = total.total.unusedRangeCount > 0 ? total.total.unusedRangeSizeMax : 0;
+
+  if (stats.free_bytes > 0)
+  {
+    stats.fragmentation = 1.0f - static_cast<float>(stats.largest_free_bytes) / static_cast<float>(stats.free_bytes);
+  }
+
+  return stats;
+}
+
+std::vector<MemoryAllocator::Budget> VmaMemoryAllocator::get_budgets() const
+{
+  const auto &memory_properties = m_device.get_physical_device().get_memory_properties();
+
+  std::vector<VmaBudget> vma_budgets(memory_properties.memoryHeapCount);
+  vmaGetHeapBudgets(m_handle, vma_budgets.data());
+
+  std::vector<Budget> budgets(memory_properties.memoryHeapCount);
+  for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i)
+  {
+    budgets[i].usage = vma_budgets[i].usage;
+    budgets[i].budget = vma_budgets[i].budget;
+  }
+
+  return budgets;
+}
+
+uint32_t VmaMemoryAllocator::defragment()
+{
+  VmaDefragmentationInfo defragmentation_info{};
+  defragmentation_info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+
+  VmaDefragmentationContext context;
+  VK_CHECK(vmaBeginDefragmentation(m_handle, &defragmentation_info, &context));
+
+  uint32_t move_count = 0;
+  while (true)
+  {
+    VmaDefragmentationPassMoveInfo pass{};
+    auto result = vmaBeginDefragmentationPass(m_handle, context, &pass);
+    if (result == VK_SUCCESS)
+    {
+      break;
+    }
+    if (result != VK_INCOMPLETE)
+    {
+      VK_CHECK(result);
+    }
+
+    // the relocate callback copies the resource before returning, the source memory is released at the end of the pass
+    for (uint32_t i = 0; i < pass.moveCount; ++i)
+    {
+      auto &vma_move = pass.pMoves[i];
+
+      auto src = to_allocation(vma_move.srcAllocation);
+      auto dst = to_allocation(vma_move.dstTmpAllocation);
+      // once the pass ends the source handle refers to the new location
+      dst.handle = vma_move.srcAllocation;
+
+      if (relocate(src, dst))
+      {
+        move_count++;
+      }
+      else
+      {
+        vma_move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+      }
+    }
+
+    result = vmaEndDefragmentationPass(m_handle, context, &pass);
+    if (result == VK_SUCCESS)
+    {
+      break;
+    }
+    if (result != VK_INCOMPLETE)
+    {
+      VK_CHECK(result);
+    }
+  }
+
+  vmaEndDefragmentation(m_handle, context, nullptr);
+
+  return move_count;
+}
+
+VmaAllocator VmaMemoryAllocator::get_handle() const
+{
+  return m_handle;
+}
+
+VmaPool VmaMemoryAllocator::get_pool(uint32_t memory_type_bits, const VmaAllocationCreateInfo &create_info, VkMemoryAllocateFlags allocate_flags)
+{
+  uint32_t memory_type_index;
+  VK_CHECK(vmaFindMemoryTypeIndex(m_handle, memory_type_bits, &create_info, &memory_type_index));
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (const auto &pool : m_pools)
+  {
+    if (pool.memory_type_index == memory_type_index && pool.allocate_flags == allocate_flags)
+    {
+      return pool.handle;
+    }
+  }
+
+  Pool pool{};
+  pool.memory_type_index = memory_type_index;
+  pool.allocate_flags = allocate_flags;
+  pool.flags_info = std::make_unique<VkMemoryAllocateFlagsInfo>();
+  pool.flags_info->sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+  pool.flags_info->flags = allocate_flags;
+
+  VmaPoolCreateInfo pool_info{};
+  pool_info.memoryTypeIndex = memory_type_index;
+  pool_info.pMemoryAllocateNext = pool.flags_info.get();
+  VK_CHECK(vmaCreatePool(m_handle, &pool_info, &pool.handle));
+
+  m_pools.push_back(std::move(pool));
+
+  return m_pools.back().handle;
+}
+
+MemoryAllocator::Allocation VmaMemoryAllocator::to_allocation(VmaAllocation vma_allocation) const
+{
+  // the block size is the size of the dedicated memory for dedicated allocations
+  VmaAllocationInfo2 allocation_info;
+  vmaGetAllocationInfo2(m_handle, vma_allocation, &allocation_info);
+
+  Allocation allocation{};
+  allocation.memory = allocation_info.allocationInfo.deviceMemory;
+  allocation.offset = allocation_info.allocationInfo.offset;
+  allocation.size = allocation_info.allocationInfo.size;
+  allocation.memory_type_index = allocation_info.allocationInfo.memoryType;
+  allocation.memory_size = allocation_info.blockSize;
+  allocation.handle = vma_allocation;
+
+  return allocation;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mutex>
+
+#include "vk_mem_alloc.h"
+
+#include "prism/vulkan/memory_allocator.h"
+
+namespace prism
+{
+  class VmaMemoryAllocator : public MemoryAllocator
+  {
+  public:
+    VmaMemoryAllocator(const Device &device);
+
+    ~VmaMemoryAllocator() override;
+
+    Backend get_backend() const override;
+
+    Allocation allocate(const AllocateInfo &info) override;
+
+    void free(const Allocation &allocation) override;
+
+    void *map(const Allocation &allocation) override;
+
+    void unmap(const Allocation &allocation) override;
+
+    Statistics get_statistics() const override;
+
+    std::vector<Budget> get_budgets() const override;
+
+    uint32_t defragment() override;
+
+    VmaAllocator get_handle() const;
+
+  private:
+    struct Pool
+    {
+      uint32_t memory_type_index{0};
+      VkMemoryAllocateFlags allocate_flags{0};
+      std::unique_ptr<VkMemoryAllocateFlagsInfo> flags_info;
+      VmaPool handle{VK_NULL_HANDLE};
+    };
+
+    VmaPool get_pool(uint32_t memory_type_bits, const VmaAllocationCreateInfo &create_info, VkMemoryAllocateFlags allocate_flags);
+
+    Allocation to_allocation(VmaAllocation vma_allocation) const;
+
+  private:
+    VmaAllocator m_handle{VK_NULL_HANDLE};
+
+    // VMA applies allocate flags per allocator, custom pools let device address and plain allocations coexist
+    std::vector<Pool> m_pools;
+
+    std::mutex m_mutex;
+
+  }; // class VmaMemoryAllocator
+
+} // namespace prism